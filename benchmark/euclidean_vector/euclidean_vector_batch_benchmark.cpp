@@ -0,0 +1,57 @@
+#include "euclidean_vector_benchmark.hpp"
+
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <comp6771/euclidean_vector.hpp>
+#include <comp6771/euclidean_vector_batch.hpp>
+#include <cstddef>
+#include <vector>
+
+/*
+This file compares scanning a dataset stored as a euclidean_vector_batch against the same dataset
+stored as separate euclidean_vector objects. The total size is fixed at 2^22 doubles (32 MiB) and
+the argument is the dimension of each row.
+*/
+namespace bm = comp6771::benchmarks;
+
+namespace {
+	constexpr auto total_magnitudes = 1 << 22;
+
+	auto make_vectors(int rows, int dimensions) -> std::vector<comp6771::euclidean_vector> {
+		auto vectors = std::vector<comp6771::euclidean_vector>();
+		vectors.reserve(static_cast<std::size_t>(rows));
+		for (auto row = 0; row < rows; ++row) {
+			vectors.push_back(bm::make_vector(dimensions));
+		}
+		return vectors;
+	}
+
+	auto scan_separate_vectors(benchmark::State& state) -> void {
+		auto const dimensions = static_cast<int>(state.range(0));
+		auto const rows = total_magnitudes / dimensions;
+		auto const vectors = make_vectors(rows, dimensions);
+		auto const query = bm::make_vector(dimensions);
+		for (auto _ : state) {
+			auto best = 0.0;
+			for (auto const& vec : vectors) {
+				best = std::max(best, comp6771::dot(vec, query));
+			}
+			benchmark::DoNotOptimize(best);
+		}
+		bm::set_throughput(state, total_magnitudes, 1);
+	}
+	BENCHMARK(scan_separate_vectors)->RangeMultiplier(4)->Range(4, 1024);
+
+	auto scan_batch(benchmark::State& state) -> void {
+		auto const dimensions = static_cast<int>(state.range(0));
+		auto const rows = total_magnitudes / dimensions;
+		auto const batch = comp6771::euclidean_vector_batch(make_vectors(rows, dimensions));
+		auto const query = bm::make_vector(dimensions);
+		for (auto _ : state) {
+			auto const products = batch.dot(query);
+			benchmark::DoNotOptimize(products.data());
+		}
+		bm::set_throughput(state, total_magnitudes, 1);
+	}
+	BENCHMARK(scan_batch)->RangeMultiplier(4)->Range(4, 1024);
+} // namespace
@@ -0,0 +1,131 @@
+#ifndef COMP6771_EUCLIDEAN_VECTOR_BENCHMARK_HPP
+#define COMP6771_EUCLIDEAN_VECTOR_BENCHMARK_HPP
+
+#include <benchmark/benchmark.h>
+#include <comp6771/euclidean_vector.hpp>
+#include <comp6771/knn.hpp>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <utility>
+#include <vector>
+
+/*
+Shared helpers for the euclidean_vector benchmarks.
+
+Every benchmark is parameterised over the number of dimensions, from 2 up to 10^7, so that both
+the small-vector overheads (allocation, dimension checks) and the large-vector memory bandwidth
+show up in the results.
+*/
+namespace comp6771::benchmarks {
+	inline constexpr auto min_dimensions = 2;
+	inline constexpr auto max_dimensions = 10'000'000;
+
+	// Registers the standard dimension sweep on a benchmark.
+	inline auto dimension_sweep(benchmark::internal::Benchmark* b) -> void {
+		b->RangeMultiplier(10)->Range(min_dimensions, max_dimensions);
+	}
+
+	// Magnitudes are drawn from a fixed seed so that runs are comparable.
+	inline auto make_magnitudes(int dimensions) -> std::vector<double> {
+		auto engine = std::mt19937_64(6771);
+		auto distribution = std::uniform_real_distribution<double>(-100.0, 100.0);
+		auto magnitudes = std::vector<double>(static_cast<std::size_t>(dimensions));
+		for (auto& magnitude : magnitudes) {
+			magnitude = distribution(engine);
+		}
+		return magnitudes;
+	}
+
+	template<typename T = double>
+	inline auto make_vector(int dimensions) -> basic_euclidean_vector<T> {
+		auto const magnitudes = make_magnitudes(dimensions);
+		if constexpr (std::same_as<T, double>) {
+			return euclidean_vector(magnitudes.cbegin(), magnitudes.cend());
+		}
+		else {
+			return basic_euclidean_vector<T>(euclidean_vector(magnitudes.cbegin(), magnitudes.cend()));
+		}
+	}
+
+	// `count` vectors with magnitudes drawn uniformly from [-1, 1], from the given seed, so that
+	// datasets and queries can be drawn independently but the same way on every run.
+	inline auto make_random_vectors(int count, int dimensions, unsigned seed)
+	   -> std::vector<euclidean_vector> {
+		auto engine = std::mt19937_64(seed);
+		auto distribution = std::uniform_real_distribution<double>(-1.0, 1.0);
+		auto vectors = std::vector<euclidean_vector>();
+		vectors.reserve(static_cast<std::size_t>(count));
+		for (auto row = 0; row < count; ++row) {
+			auto vec = euclidean_vector(dimensions);
+			for (auto i = 0; i < dimensions; ++i) {
+				vec[i] = distribution(engine);
+			}
+			vectors.push_back(std::move(vec));
+		}
+		return vectors;
+	}
+
+	// `count` vectors drawn around `centres` random centres in [-1, 1]^dimensions, so that
+	// approximate indexes have some structure to find. The centres come from a fixed seed, so
+	// datasets and queries drawn with different seeds share them.
+	inline auto make_clustered_vectors(int count, int dimensions, int centres, unsigned seed)
+	   -> std::vector<euclidean_vector> {
+		auto engine = std::mt19937_64(6771);
+		auto uniform = std::uniform_real_distribution<double>(-1.0, 1.0);
+		auto means = std::vector<euclidean_vector>(static_cast<std::size_t>(centres),
+		                                           euclidean_vector(dimensions));
+		for (auto& mean : means) {
+			for (auto i = 0; i < dimensions; ++i) {
+				mean[i] = uniform(engine);
+			}
+		}
+
+		engine.seed(seed);
+		auto pick = std::uniform_int_distribution<std::size_t>(0, means.size() - 1);
+		auto noise = std::normal_distribution<double>(0.0, 0.25);
+		auto vectors = std::vector<euclidean_vector>();
+		vectors.reserve(static_cast<std::size_t>(count));
+		for (auto row = 0; row < count; ++row) {
+			auto vec = means[pick(engine)];
+			for (auto i = 0; i < dimensions; ++i) {
+				vec[i] += noise(engine);
+			}
+			vectors.push_back(std::move(vec));
+		}
+		return vectors;
+	}
+
+	// Fraction of the exact neighbours of each query that an approximate search found
+	inline auto recall(std::vector<std::vector<neighbour>> const& exact,
+	                   std::vector<std::vector<neighbour>> const& found) -> double {
+		auto hits = 0;
+		auto expected = std::size_t{0};
+		for (auto query = std::size_t{0}; query < exact.size(); ++query) {
+			expected += exact[query].size();
+			for (auto const& target : exact[query]) {
+				for (auto const& result : found[query]) {
+					hits += result.index == target.index ? 1 : 0;
+				}
+			}
+		}
+		return static_cast<double>(hits) / static_cast<double>(expected);
+	}
+
+	// Reports items/second as elements touched and bytes/second as bytes streamed through memory.
+	// `streams` is the number of dimension-sized arrays of `T` read or written per iteration.
+	template<typename T = double>
+	inline auto set_throughput(benchmark::State& state, int dimensions, int streams) -> void {
+		auto const items = static_cast<std::int64_t>(state.iterations()) * dimensions;
+		state.SetItemsProcessed(items);
+		state.SetBytesProcessed(items * streams * static_cast<std::int64_t>(sizeof(T)));
+	}
+
+	// Reports items/second as queries answered, for benchmarks that search `queries` at a time.
+	inline auto set_query_throughput(benchmark::State& state, int queries) -> void {
+		state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()) * queries);
+	}
+} // namespace comp6771::benchmarks
+
+#endif // COMP6771_EUCLIDEAN_VECTOR_BENCHMARK_HPP
@@ -0,0 +1,123 @@
+#include "euclidean_vector_benchmark.hpp"
+
+#include <benchmark/benchmark.h>
+#include <comp6771/euclidean_vector.hpp>
+#include <utility>
+#include <vector>
+
+/*
+This file benchmarks all constructors.
+Each benchmark constructs (and destroys) one euclidean vector per iteration.
+*/
+namespace bm = comp6771::benchmarks;
+
+namespace {
+	auto constructor_default(benchmark::State& state) -> void {
+		for (auto _ : state) {
+			auto ev = comp6771::euclidean_vector();
+			benchmark::DoNotOptimize(ev);
+		}
+		bm::set_throughput(state, 1, 1);
+	}
+	BENCHMARK(constructor_default);
+
+	auto constructor_dimensions(benchmark::State& state) -> void {
+		auto const dimensions = static_cast<int>(state.range(0));
+		for (auto _ : state) {
+			auto ev = comp6771::euclidean_vector(dimensions);
+			benchmark::DoNotOptimize(ev);
+		}
+		bm::set_throughput(state, dimensions, 1);
+	}
+	BENCHMARK(constructor_dimensions)->Apply(bm::dimension_sweep);
+
+	auto constructor_dimensions_and_magnitude(benchmark::State& state) -> void {
+		auto const dimensions = static_cast<int>(state.range(0));
+		for (auto _ : state) {
+			auto ev = comp6771::euclidean_vector(dimensions, 6771.0);
+			benchmark::DoNotOptimize(ev);
+		}
+		bm::set_throughput(state, dimensions, 1);
+	}
+	BENCHMARK(constructor_dimensions_and_magnitude)->Apply(bm::dimension_sweep);
+
+	// Allocation only; the difference from constructor_dimensions is the cost of the single write.
+	auto constructor_uninitialized(benchmark::State& state) -> void {
+		auto const dimensions = static_cast<int>(state.range(0));
+		for (auto _ : state) {
+			auto ev = comp6771::euclidean_vector::uninitialized(dimensions);
+			benchmark::DoNotOptimize(ev);
+		}
+		bm::set_throughput(state, dimensions, 1);
+	}
+	BENCHMARK(constructor_uninitialized)->Apply(bm::dimension_sweep);
+
+	auto constructor_iterators(benchmark::State& state) -> void {
+		auto const dimensions = static_cast<int>(state.range(0));
+		auto const magnitudes = bm::make_magnitudes(dimensions);
+		for (auto _ : state) {
+			auto ev = comp6771::euclidean_vector(magnitudes.cbegin(), magnitudes.cend());
+			benchmark::DoNotOptimize(ev);
+		}
+		bm::set_throughput(state, dimensions, 2);
+	}
+	BENCHMARK(constructor_iterators)->Apply(bm::dimension_sweep);
+
+	// Converting float magnitudes on the way in, as when reading a float32 feature file.
+	auto constructor_float_range(benchmark::State& state) -> void {
+		auto const dimensions = static_cast<int>(state.range(0));
+		auto const doubles = bm::make_magnitudes(dimensions);
+		auto const magnitudes = std::vector<float>(doubles.begin(), doubles.end());
+		for (auto _ : state) {
+			auto ev = comp6771::euclidean_vector(magnitudes);
+			benchmark::DoNotOptimize(ev);
+		}
+		bm::set_throughput(state, dimensions, 2);
+	}
+	BENCHMARK(constructor_float_range)->Apply(bm::dimension_sweep);
+
+	// The initializer list is fixed at compile time, so this only covers small dimensions.
+	auto constructor_initializer_list(benchmark::State& state) -> void {
+		for (auto _ : state) {
+			auto ev = comp6771::euclidean_vector{1.1, -2.2, 3.3, -4.4};
+			benchmark::DoNotOptimize(ev);
+		}
+		bm::set_throughput(state, 4, 2);
+	}
+	BENCHMARK(constructor_initializer_list);
+
+	auto constructor_copy(benchmark::State& state) -> void {
+		auto const dimensions = static_cast<int>(state.range(0));
+		auto const orig = bm::make_vector(dimensions);
+		for (auto _ : state) {
+			auto ev = orig;
+			benchmark::DoNotOptimize(ev);
+		}
+		bm::set_throughput(state, dimensions, 2);
+	}
+	BENCHMARK(constructor_copy)->Apply(bm::dimension_sweep);
+
+	auto constructor_move(benchmark::State& state) -> void {
+		auto const dimensions = static_cast<int>(state.range(0));
+		auto orig = bm::make_vector(dimensions);
+		for (auto _ : state) {
+			auto ev = std::move(orig);
+			benchmark::DoNotOptimize(ev);
+			orig = std::move(ev);
+		}
+		bm::set_throughput(state, dimensions, 0);
+	}
+	BENCHMARK(constructor_move)->Apply(bm::dimension_sweep);
+
+	auto assignment_copy(benchmark::State& state) -> void {
+		auto const dimensions = static_cast<int>(state.range(0));
+		auto const orig = bm::make_vector(dimensions);
+		auto ev = comp6771::euclidean_vector(dimensions);
+		for (auto _ : state) {
+			ev = orig;
+			benchmark::DoNotOptimize(ev);
+		}
+		bm::set_throughput(state, dimensions, 2);
+	}
+	BENCHMARK(assignment_copy)->Apply(bm::dimension_sweep);
+} // namespace
@@ -0,0 +1,197 @@
+#include "euclidean_vector_benchmark.hpp"
+
+#include <benchmark/benchmark.h>
+#include <comp6771/euclidean_vector.hpp>
+#include <comp6771/fixed_euclidean_vector.hpp>
+#include <sstream>
+#include <string>
+
+/*
+This file benchmarks the friend operators.
+The arithmetic operators return a new euclidean vector, so each iteration includes the cost of
+producing (and destroying) the result.
+*/
+namespace bm = comp6771::benchmarks;
+
+namespace {
+	auto operator_equal(benchmark::State& state) -> void {
+		auto const dimensions = static_cast<int>(state.range(0));
+		auto const ev1 = bm::make_vector(dimensions);
+		auto const ev2 = ev1;
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(ev1 == ev2);
+		}
+		bm::set_throughput(state, dimensions, 2);
+	}
+	BENCHMARK(operator_equal)->Apply(bm::dimension_sweep);
+
+	auto approx_equal_relative(benchmark::State& state) -> void {
+		auto const dimensions = static_cast<int>(state.range(0));
+		auto const ev1 = bm::make_vector(dimensions);
+		auto const ev2 = ev1;
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(comp6771::approx_equal(ev1, ev2, 1e-9, 1e-9));
+		}
+		bm::set_throughput(state, dimensions, 2);
+	}
+	BENCHMARK(approx_equal_relative)->Apply(bm::dimension_sweep);
+
+	auto exact_equal(benchmark::State& state) -> void {
+		auto const dimensions = static_cast<int>(state.range(0));
+		auto const ev1 = bm::make_vector(dimensions);
+		auto const ev2 = ev1;
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(comp6771::exact_equal(ev1, ev2));
+		}
+		bm::set_throughput(state, dimensions, 2);
+	}
+	BENCHMARK(exact_equal)->Apply(bm::dimension_sweep);
+
+	auto operator_not_equal(benchmark::State& state) -> void {
+		auto const dimensions = static_cast<int>(state.range(0));
+		auto const ev1 = bm::make_vector(dimensions);
+		auto const ev2 = ev1;
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(ev1 != ev2);
+		}
+		bm::set_throughput(state, dimensions, 2);
+	}
+	BENCHMARK(operator_not_equal)->Apply(bm::dimension_sweep);
+
+	auto operator_plus(benchmark::State& state) -> void {
+		auto const dimensions = static_cast<int>(state.range(0));
+		auto const ev1 = bm::make_vector(dimensions);
+		auto const ev2 = bm::make_vector(dimensions);
+		for (auto _ : state) {
+			auto ev = comp6771::euclidean_vector(ev1 + ev2);
+			benchmark::DoNotOptimize(ev);
+		}
+		bm::set_throughput(state, dimensions, 3);
+	}
+	BENCHMARK(operator_plus)->Apply(bm::dimension_sweep);
+
+	auto operator_minus(benchmark::State& state) -> void {
+		auto const dimensions = static_cast<int>(state.range(0));
+		auto const ev1 = bm::make_vector(dimensions);
+		auto const ev2 = bm::make_vector(dimensions);
+		for (auto _ : state) {
+			auto ev = comp6771::euclidean_vector(ev1 - ev2);
+			benchmark::DoNotOptimize(ev);
+		}
+		bm::set_throughput(state, dimensions, 3);
+	}
+	BENCHMARK(operator_minus)->Apply(bm::dimension_sweep);
+
+	auto operator_multiply(benchmark::State& state) -> void {
+		auto const dimensions = static_cast<int>(state.range(0));
+		auto const ev1 = bm::make_vector(dimensions);
+		for (auto _ : state) {
+			auto ev = comp6771::euclidean_vector(ev1 * 5.16);
+			benchmark::DoNotOptimize(ev);
+		}
+		bm::set_throughput(state, dimensions, 2);
+	}
+	BENCHMARK(operator_multiply)->Apply(bm::dimension_sweep);
+
+	auto operator_divide(benchmark::State& state) -> void {
+		auto const dimensions = static_cast<int>(state.range(0));
+		auto const ev1 = bm::make_vector(dimensions);
+		for (auto _ : state) {
+			auto ev = comp6771::euclidean_vector(ev1 / -10.11);
+			benchmark::DoNotOptimize(ev);
+		}
+		bm::set_throughput(state, dimensions, 2);
+	}
+	BENCHMARK(operator_divide)->Apply(bm::dimension_sweep);
+
+	// The chained pattern from the overall test.
+	auto operator_chained(benchmark::State& state) -> void {
+		auto const dimensions = static_cast<int>(state.range(0));
+		auto const ev1 = bm::make_vector(dimensions);
+		auto const ev2 = bm::make_vector(dimensions);
+		for (auto _ : state) {
+			auto ev = comp6771::euclidean_vector(ev1 * 5.16 + ev2 / -10.11);
+			benchmark::DoNotOptimize(ev);
+		}
+		bm::set_throughput(state, dimensions, 3);
+	}
+	BENCHMARK(operator_chained)->Apply(bm::dimension_sweep);
+
+	// A chain starting from a temporary, which is evaluated in place in the temporary's storage.
+	auto operator_chained_temporary(benchmark::State& state) -> void {
+		auto const dimensions = static_cast<int>(state.range(0));
+		auto const ev1 = bm::make_vector(dimensions);
+		auto const ev2 = bm::make_vector(dimensions);
+		for (auto _ : state) {
+			auto ev = comp6771::euclidean_vector(-ev1 * 5.16 + ev2 / -10.11);
+			benchmark::DoNotOptimize(ev);
+		}
+		bm::set_throughput(state, dimensions, 4);
+	}
+	BENCHMARK(operator_chained_temporary)->Apply(bm::dimension_sweep);
+
+	// The chained expression on 3 dimensions, sized at run time and at compile time.
+	auto operator_chained_3d(benchmark::State& state) -> void {
+		auto const ev1 = bm::make_vector(3);
+		auto const ev2 = bm::make_vector(3);
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(ev1);
+			auto ev = comp6771::euclidean_vector(ev1 * 5.16 + ev2 / -10.11);
+			benchmark::DoNotOptimize(ev);
+		}
+		bm::set_throughput(state, 3, 3);
+	}
+	BENCHMARK(operator_chained_3d);
+
+	auto operator_chained_fixed_3d(benchmark::State& state) -> void {
+		auto const ev1 = comp6771::fixed_euclidean_vector<3>(bm::make_vector(3));
+		auto const ev2 = comp6771::fixed_euclidean_vector<3>(bm::make_vector(3));
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(ev1);
+			auto ev = ev1 * 5.16 + ev2 / -10.11;
+			benchmark::DoNotOptimize(ev);
+		}
+		bm::set_throughput(state, 3, 3);
+	}
+	BENCHMARK(operator_chained_fixed_3d);
+
+	// Output is far slower than arithmetic, so the sweep stops at 10^6 dimensions.
+	auto operator_output_stream(benchmark::State& state) -> void {
+		auto const dimensions = static_cast<int>(state.range(0));
+		auto const ev = bm::make_vector(dimensions);
+		auto oss = std::ostringstream();
+		for (auto _ : state) {
+			oss.str("");
+			oss << ev;
+			benchmark::DoNotOptimize(oss);
+		}
+		bm::set_throughput(state, dimensions, 1);
+	}
+	BENCHMARK(operator_output_stream)->RangeMultiplier(10)->Range(bm::min_dimensions, 1'000'000);
+
+	auto format_to_chars(benchmark::State& state) -> void {
+		auto const dimensions = static_cast<int>(state.range(0));
+		auto const ev = bm::make_vector(dimensions);
+		auto buffer = std::string(comp6771::max_formatted_size<double>(dimensions), '\0');
+		for (auto _ : state) {
+			auto const result = comp6771::to_chars(buffer.data(), buffer.data() + buffer.size(), ev);
+			benchmark::DoNotOptimize(result.ptr);
+		}
+		bm::set_throughput(state, dimensions, 1);
+	}
+	BENCHMARK(format_to_chars)->RangeMultiplier(10)->Range(bm::min_dimensions, 1'000'000);
+
+	auto parse_from_chars(benchmark::State& state) -> void {
+		auto const dimensions = static_cast<int>(state.range(0));
+		auto oss = std::ostringstream();
+		oss << bm::make_vector(dimensions);
+		auto const text = oss.str();
+		auto ev = comp6771::euclidean_vector();
+		for (auto _ : state) {
+			auto const result = comp6771::from_chars(text.data(), text.data() + text.size(), ev);
+			benchmark::DoNotOptimize(result.ptr);
+		}
+		bm::set_throughput(state, dimensions, 1);
+	}
+	BENCHMARK(parse_from_chars)->RangeMultiplier(10)->Range(bm::min_dimensions, 1'000'000);
+} // namespace
@@ -0,0 +1,77 @@
+#include "euclidean_vector_benchmark.hpp"
+
+#include <benchmark/benchmark.h>
+#include <comp6771/euclidean_vector.hpp>
+#include <comp6771/euclidean_vector_batch.hpp>
+#include <comp6771/hnsw_index.hpp>
+#include <comp6771/knn.hpp>
+#include <cstdint>
+#include <execution>
+#include <utility>
+#include <vector>
+
+/*
+This file measures the recall and queries per second of hnsw_index against the exact search of
+knn_search. The dataset is 2^15 rows of 64 doubles drawn around 64 random centres, so that it has
+some structure to find, k is 10 and the argument is ef_search. Recall is the fraction of the exact
+neighbours found, averaged over 256 queries. The index is built once, in parallel.
+*/
+namespace bm = comp6771::benchmarks;
+
+namespace {
+	constexpr auto rows = 1 << 15;
+	constexpr auto dimensions = 64;
+	constexpr auto centres = 64;
+	constexpr auto queries_size = 256;
+	constexpr auto k = 10;
+
+	struct fixture {
+		comp6771::euclidean_vector_batch dataset;
+		std::vector<comp6771::euclidean_vector> queries;
+		std::vector<std::vector<comp6771::neighbour>> exact;
+		comp6771::hnsw_index index;
+	};
+
+	auto shared_fixture() -> fixture const& {
+		static auto const shared = [] {
+			auto const vectors = bm::make_clustered_vectors(rows, dimensions, centres, 1);
+			auto dataset = comp6771::euclidean_vector_batch(vectors);
+			auto queries = bm::make_clustered_vectors(queries_size, dimensions, centres, 2);
+			auto exact = comp6771::knn_search(std::execution::par, queries, dataset, k);
+			auto index = comp6771::hnsw_index(std::execution::par,
+			                                  dataset,
+			                                  comp6771::metric::l2,
+			                                  {.m = 16, .ef_construction = 100});
+			return fixture{std::move(dataset), std::move(queries), std::move(exact), std::move(index)};
+		}();
+		return shared;
+	}
+
+	auto set_throughput(benchmark::State& state) -> void {
+		state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()) * queries_size);
+	}
+
+	auto exact_search(benchmark::State& state) -> void {
+		auto const& shared = shared_fixture();
+		for (auto _ : state) {
+			auto const found = comp6771::knn_search(shared.queries, shared.dataset, k);
+			benchmark::DoNotOptimize(found.data());
+		}
+		set_throughput(state);
+		state.counters["recall"] = 1;
+	}
+	BENCHMARK(exact_search)->Unit(benchmark::kMillisecond);
+
+	auto hnsw_search(benchmark::State& state) -> void {
+		auto index = shared_fixture().index;
+		index.set_ef_search(static_cast<int>(state.range(0)));
+		auto found = std::vector<std::vector<comp6771::neighbour>>();
+		for (auto _ : state) {
+			found = index.search(shared_fixture().queries, k);
+			benchmark::DoNotOptimize(found.data());
+		}
+		set_throughput(state);
+		state.counters["recall"] = bm::recall(shared_fixture().exact, found);
+	}
+	BENCHMARK(hnsw_search)->RangeMultiplier(2)->Range(10, 320)->Unit(benchmark::kMillisecond);
+} // namespace
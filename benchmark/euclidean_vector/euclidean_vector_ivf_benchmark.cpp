@@ -0,0 +1,85 @@
+#include "euclidean_vector_benchmark.hpp"
+
+#include <benchmark/benchmark.h>
+#include <comp6771/euclidean_vector.hpp>
+#include <comp6771/euclidean_vector_batch.hpp>
+#include <comp6771/ivf_index.hpp>
+#include <comp6771/knn.hpp>
+#include <cstdint>
+#include <execution>
+#include <utility>
+#include <vector>
+
+/*
+This file measures the recall and queries per second of ivf_index, and the cost of adding and
+removing vectors once it is trained. The dataset is 2^16 rows of 64 doubles drawn around 256
+random centres, indexed in 256 lists, and k is 10. Search benchmarks take nprobe as the argument,
+and recall is the fraction of the exact neighbours found, averaged over 256 queries.
+*/
+namespace bm = comp6771::benchmarks;
+
+namespace {
+	constexpr auto rows = 1 << 16;
+	constexpr auto dimensions = 64;
+	constexpr auto centres = 256;
+	constexpr auto lists = 256;
+	constexpr auto queries_size = 256;
+	constexpr auto k = 10;
+
+	struct fixture {
+		comp6771::euclidean_vector_batch dataset;
+		std::vector<comp6771::euclidean_vector> queries;
+		std::vector<std::vector<comp6771::neighbour>> exact;
+		comp6771::ivf_index index;
+	};
+
+	auto shared_fixture() -> fixture const& {
+		static auto const shared = [] {
+			auto const vectors = bm::make_clustered_vectors(rows, dimensions, centres, 1);
+			auto dataset = comp6771::euclidean_vector_batch(vectors);
+			auto queries = bm::make_clustered_vectors(queries_size, dimensions, centres, 2);
+			auto exact = comp6771::knn_search(std::execution::par, queries, dataset, k);
+			auto index = comp6771::ivf_index(dataset, lists);
+			return fixture{std::move(dataset), std::move(queries), std::move(exact), std::move(index)};
+		}();
+		return shared;
+	}
+
+	auto exact_search(benchmark::State& state) -> void {
+		auto const& shared = shared_fixture();
+		for (auto _ : state) {
+			auto const found = comp6771::knn_search(shared.queries, shared.dataset, k);
+			benchmark::DoNotOptimize(found.data());
+		}
+		state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()) * queries_size);
+		state.counters["recall"] = 1;
+	}
+	BENCHMARK(exact_search)->Unit(benchmark::kMillisecond);
+
+	auto ivf_search(benchmark::State& state) -> void {
+		auto index = shared_fixture().index;
+		index.set_nprobe(static_cast<int>(state.range(0)));
+		auto found = std::vector<std::vector<comp6771::neighbour>>();
+		for (auto _ : state) {
+			found = index.search(shared_fixture().queries, k);
+			benchmark::DoNotOptimize(found.data());
+		}
+		state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()) * queries_size);
+		state.counters["recall"] = bm::recall(shared_fixture().exact, found);
+	}
+	BENCHMARK(ivf_search)->RangeMultiplier(2)->Range(1, 64)->Unit(benchmark::kMillisecond);
+
+	// Removes a vector and adds it back, so the index is the same size on every iteration.
+	auto ivf_remove_and_add(benchmark::State& state) -> void {
+		auto index = shared_fixture().index;
+		auto const& dataset = shared_fixture().dataset;
+		auto id = 0;
+		for (auto _ : state) {
+			auto const row = dataset[id % rows];
+			index.remove(id);
+			id = index.add(row);
+		}
+		state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()));
+	}
+	BENCHMARK(ivf_remove_and_add);
+} // namespace
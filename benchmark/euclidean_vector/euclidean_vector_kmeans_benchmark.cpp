@@ -0,0 +1,96 @@
+#include "euclidean_vector_benchmark.hpp"
+
+#include <benchmark/benchmark.h>
+#include <comp6771/euclidean_vector.hpp>
+#include <comp6771/euclidean_vector_batch.hpp>
+#include <comp6771/kmeans.hpp>
+#include <cstdint>
+#include <execution>
+#include <vector>
+
+/*
+This file measures how long kmeans takes to cluster 2^16 rows of 64 doubles, drawn around 256
+random centres, into 256 clusters, and the inertia it reaches. Seeding benchmarks run one
+assignment after seeding, so that their inertia shows how good the seeds are. Lloyd's algorithm
+runs a fixed number of iterations, so that serial and parallel runs do the same work, and
+mini-batch k-means at most enough batches to see every row as often.
+*/
+namespace bm = comp6771::benchmarks;
+
+namespace {
+	constexpr auto rows = 1 << 16;
+	constexpr auto dimensions = 64;
+	constexpr auto centres = 256;
+	constexpr auto clusters = 256;
+	constexpr auto iterations = 5;
+
+	auto shared_dataset() -> comp6771::euclidean_vector_batch const& {
+		static auto const dataset =
+		   comp6771::euclidean_vector_batch(bm::make_clustered_vectors(rows, dimensions, centres, 1));
+		return dataset;
+	}
+
+	// Runs `cluster` and reports rows assigned per second and the inertia reached.
+	template<typename Cluster>
+	auto measure(benchmark::State& state, std::int64_t assigned, Cluster cluster) -> void {
+		auto result = comp6771::kmeans_result();
+		for (auto _ : state) {
+			result = cluster(shared_dataset());
+			benchmark::DoNotOptimize(result.assignment.data());
+		}
+		state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()) * assigned);
+		state.counters["inertia"] = result.inertia;
+	}
+
+	auto seeding(benchmark::State& state, comp6771::kmeans_seeding seeds) -> void {
+		measure(state, rows, [&](comp6771::euclidean_vector_batch const& dataset) {
+			return comp6771::kmeans(dataset, clusters, {.seeding = seeds, .iterations = 1});
+		});
+	}
+	BENCHMARK_CAPTURE(seeding, random, comp6771::kmeans_seeding::random)
+	   ->Unit(benchmark::kMillisecond);
+	BENCHMARK_CAPTURE(seeding, plus_plus, comp6771::kmeans_seeding::plus_plus)
+	   ->Unit(benchmark::kMillisecond);
+	BENCHMARK_CAPTURE(seeding, parallel, comp6771::kmeans_seeding::parallel)
+	   ->Unit(benchmark::kMillisecond);
+
+	constexpr auto assigned = std::int64_t{rows} * iterations;
+
+	auto lloyd(benchmark::State& state) -> void {
+		measure(state, assigned, [](comp6771::euclidean_vector_batch const& dataset) {
+			return comp6771::kmeans(dataset,
+			                        clusters,
+			                        {.seeding = comp6771::kmeans_seeding::parallel,
+			                         .iterations = iterations,
+			                         .tolerance = 0});
+		});
+	}
+	BENCHMARK(lloyd)->Unit(benchmark::kMillisecond);
+
+	auto lloyd_par(benchmark::State& state) -> void {
+		measure(state, assigned, [](comp6771::euclidean_vector_batch const& dataset) {
+			return comp6771::kmeans(std::execution::par,
+			                        dataset,
+			                        clusters,
+			                        {.seeding = comp6771::kmeans_seeding::parallel,
+			                         .iterations = iterations,
+			                         .tolerance = 0});
+		});
+	}
+	BENCHMARK(lloyd_par)->Unit(benchmark::kMillisecond);
+
+	// Takes the batch size as the argument
+	auto mini_batch(benchmark::State& state) -> void {
+		auto const batch_size = static_cast<int>(state.range(0));
+		auto const batches = iterations * rows / batch_size;
+		measure(state, assigned, [&](comp6771::euclidean_vector_batch const& dataset) {
+			return comp6771::kmeans(dataset,
+			                        clusters,
+			                        {.seeding = comp6771::kmeans_seeding::parallel,
+			                         .iterations = batches,
+			                         .tolerance = 0,
+			                         .batch_size = batch_size});
+		});
+	}
+	BENCHMARK(mini_batch)->Arg(1024)->Arg(4096)->Unit(benchmark::kMillisecond);
+} // namespace
@@ -0,0 +1,78 @@
+#include "euclidean_vector_benchmark.hpp"
+
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <comp6771/euclidean_vector.hpp>
+#include <comp6771/euclidean_vector_batch.hpp>
+#include <comp6771/knn.hpp>
+#include <cstddef>
+#include <execution>
+#include <numeric>
+#include <vector>
+
+/*
+This file compares knn_search against searching for each query alone by scoring every row with
+euclidean_vector_batch::dot and partially sorting the scores. The dataset is 2^16 rows of 128
+doubles (64 MiB), k is 10 and the argument is the number of queries.
+*/
+namespace bm = comp6771::benchmarks;
+
+namespace {
+	constexpr auto rows = 1 << 16;
+	constexpr auto dimensions = 128;
+	constexpr auto k = 10;
+
+	auto dataset() -> comp6771::euclidean_vector_batch const& {
+		static auto const batch =
+		   comp6771::euclidean_vector_batch(bm::make_random_vectors(rows, dimensions, 6771));
+		return batch;
+	}
+
+	auto search_one_at_a_time(benchmark::State& state) -> void {
+		auto const queries =
+		   bm::make_random_vectors(static_cast<int>(state.range(0)), dimensions, 1);
+		auto const& batch = dataset();
+		auto order = std::vector<int>(static_cast<std::size_t>(rows));
+		for (auto _ : state) {
+			for (auto const& query : queries) {
+				auto const scores = batch.dot(query);
+				std::iota(order.begin(), order.end(), 0);
+				std::partial_sort(order.begin(), order.begin() + k, order.end(), [&](int a, int b) {
+					return scores[static_cast<std::size_t>(a)] > scores[static_cast<std::size_t>(b)];
+				});
+				benchmark::DoNotOptimize(order.data());
+			}
+		}
+		bm::set_query_throughput(state, static_cast<int>(queries.size()));
+	}
+	BENCHMARK(search_one_at_a_time)->RangeMultiplier(4)->Range(1, 64);
+
+	auto knn_search_serial(benchmark::State& state) -> void {
+		auto const queries =
+		   bm::make_random_vectors(static_cast<int>(state.range(0)), dimensions, 1);
+		auto const& batch = dataset();
+		for (auto _ : state) {
+			auto const found =
+			   comp6771::knn_search(queries, batch, k, comp6771::metric::inner_product);
+			benchmark::DoNotOptimize(found.data());
+		}
+		bm::set_query_throughput(state, static_cast<int>(queries.size()));
+	}
+	BENCHMARK(knn_search_serial)->RangeMultiplier(4)->Range(1, 64);
+
+	auto knn_search_parallel(benchmark::State& state) -> void {
+		auto const queries =
+		   bm::make_random_vectors(static_cast<int>(state.range(0)), dimensions, 1);
+		auto const& batch = dataset();
+		for (auto _ : state) {
+			auto const found = comp6771::knn_search(std::execution::par,
+			                                        queries,
+			                                        batch,
+			                                        k,
+			                                        comp6771::metric::inner_product);
+			benchmark::DoNotOptimize(found.data());
+		}
+		bm::set_query_throughput(state, static_cast<int>(queries.size()));
+	}
+	BENCHMARK(knn_search_parallel)->RangeMultiplier(4)->Range(1, 64)->UseRealTime();
+} // namespace
@@ -0,0 +1,63 @@
+#include "euclidean_vector_benchmark.hpp"
+
+#include <benchmark/benchmark.h>
+#include <comp6771/euclidean_vector.hpp>
+
+/*
+This file benchmarks the compound assignment operators.
+They update the left-hand side in place, so no allocation is expected inside the loop.
+*/
+namespace bm = comp6771::benchmarks;
+
+namespace {
+	auto operator_plus_equal(benchmark::State& state) -> void {
+		auto const dimensions = static_cast<int>(state.range(0));
+		auto ev1 = bm::make_vector(dimensions);
+		auto const ev2 = bm::make_vector(dimensions);
+		for (auto _ : state) {
+			ev1 += ev2;
+			benchmark::ClobberMemory();
+		}
+		bm::set_throughput(state, dimensions, 3);
+	}
+	BENCHMARK(operator_plus_equal)->Apply(bm::dimension_sweep);
+
+	auto operator_minus_equal(benchmark::State& state) -> void {
+		auto const dimensions = static_cast<int>(state.range(0));
+		auto ev1 = bm::make_vector(dimensions);
+		auto const ev2 = bm::make_vector(dimensions);
+		for (auto _ : state) {
+			ev1 -= ev2;
+			benchmark::ClobberMemory();
+		}
+		bm::set_throughput(state, dimensions, 3);
+	}
+	BENCHMARK(operator_minus_equal)->Apply(bm::dimension_sweep);
+
+	// Alternate between scaling up and down so the magnitudes stay finite.
+	auto operator_multiply_equal(benchmark::State& state) -> void {
+		auto const dimensions = static_cast<int>(state.range(0));
+		auto ev = bm::make_vector(dimensions);
+		auto scalar = 2.0;
+		for (auto _ : state) {
+			ev *= scalar;
+			scalar = 1 / scalar;
+			benchmark::ClobberMemory();
+		}
+		bm::set_throughput(state, dimensions, 2);
+	}
+	BENCHMARK(operator_multiply_equal)->Apply(bm::dimension_sweep);
+
+	auto operator_divide_equal(benchmark::State& state) -> void {
+		auto const dimensions = static_cast<int>(state.range(0));
+		auto ev = bm::make_vector(dimensions);
+		auto scalar = 2.0;
+		for (auto _ : state) {
+			ev /= scalar;
+			scalar = 1 / scalar;
+			benchmark::ClobberMemory();
+		}
+		bm::set_throughput(state, dimensions, 2);
+	}
+	BENCHMARK(operator_divide_equal)->Apply(bm::dimension_sweep);
+} // namespace
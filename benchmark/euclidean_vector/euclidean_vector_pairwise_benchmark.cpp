@@ -0,0 +1,93 @@
+#include "euclidean_vector_benchmark.hpp"
+
+#include <benchmark/benchmark.h>
+#include <comp6771/euclidean_vector.hpp>
+#include <comp6771/euclidean_vector_batch.hpp>
+#include <comp6771/pairwise.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <execution>
+#include <vector>
+
+/*
+This file measures pairwise_dot and pairwise_l2 against calling dot for every pair. 256 queries
+are multiplied with 8192 rows, all of 128 random doubles, so the rows (8 MiB) do not fit in L2.
+Throughput is reported in pairs and in floating-point operations per second, counting a multiply
+and an add per element of each pair.
+*/
+namespace bm = comp6771::benchmarks;
+
+namespace {
+	constexpr auto queries_size = 256;
+	constexpr auto rows = 8192;
+	constexpr auto dimensions = 128;
+	constexpr auto pairs = std::int64_t{queries_size} * rows;
+
+	struct fixture {
+		comp6771::euclidean_vector_batch queries =
+		   comp6771::euclidean_vector_batch(bm::make_random_vectors(queries_size, dimensions, 1));
+		comp6771::euclidean_vector_batch dataset =
+		   comp6771::euclidean_vector_batch(bm::make_random_vectors(rows, dimensions, 2));
+	};
+
+	auto shared_fixture() -> fixture const& {
+		static auto const shared = fixture();
+		return shared;
+	}
+
+	auto report(benchmark::State& state) -> void {
+		state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()) * pairs);
+		state.counters["flops"] =
+		   benchmark::Counter(static_cast<double>(state.iterations()) * pairs * dimensions * 2,
+		                      benchmark::Counter::kIsRate);
+	}
+
+	auto dot_per_pair(benchmark::State& state) -> void {
+		auto const& shared = shared_fixture();
+		auto out = std::vector<double>(static_cast<std::size_t>(pairs));
+		for (auto _ : state) {
+			for (auto query = 0; query < queries_size; ++query) {
+				for (auto row = 0; row < rows; ++row) {
+					out[static_cast<std::size_t>(query * rows + row)] =
+					   comp6771::dot(shared.queries[query], shared.dataset[row]);
+				}
+			}
+			benchmark::DoNotOptimize(out.data());
+		}
+		report(state);
+	}
+	BENCHMARK(dot_per_pair)->Unit(benchmark::kMillisecond);
+
+	auto pairwise_dot(benchmark::State& state) -> void {
+		auto const& shared = shared_fixture();
+		auto out = std::vector<double>(static_cast<std::size_t>(pairs));
+		for (auto _ : state) {
+			comp6771::pairwise_dot(shared.queries, shared.dataset, out);
+			benchmark::DoNotOptimize(out.data());
+		}
+		report(state);
+	}
+	BENCHMARK(pairwise_dot)->Unit(benchmark::kMillisecond);
+
+	auto pairwise_dot_par(benchmark::State& state) -> void {
+		auto const& shared = shared_fixture();
+		auto out = std::vector<double>(static_cast<std::size_t>(pairs));
+		for (auto _ : state) {
+			comp6771::pairwise_dot(std::execution::par, shared.queries, shared.dataset, out);
+			benchmark::DoNotOptimize(out.data());
+		}
+		report(state);
+	}
+	BENCHMARK(pairwise_dot_par)->Unit(benchmark::kMillisecond);
+
+	auto pairwise_l2(benchmark::State& state) -> void {
+		auto const& shared = shared_fixture();
+		auto out = std::vector<double>(static_cast<std::size_t>(pairs));
+		for (auto _ : state) {
+			comp6771::pairwise_l2(shared.queries, shared.dataset, out);
+			benchmark::DoNotOptimize(out.data());
+		}
+		report(state);
+	}
+	BENCHMARK(pairwise_l2)->Unit(benchmark::kMillisecond);
+} // namespace
@@ -0,0 +1,129 @@
+#include "euclidean_vector_benchmark.hpp"
+
+#include <benchmark/benchmark.h>
+#include <comp6771/euclidean_vector.hpp>
+#include <comp6771/euclidean_vector_batch.hpp>
+#include <comp6771/knn.hpp>
+#include <comp6771/product_quantiser.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <execution>
+#include <utility>
+#include <vector>
+
+/*
+This file measures how fast and how accurately product_quantiser searches codes, against the
+exact search of knn_search. The dataset is 2^16 rows of 64 doubles (512 bytes each) drawn around
+256 random centres, split into 16 subspaces: 8-bit codes are 16 bytes and 4-bit codes are 8 bytes,
+32 and 64 times smaller. k is 10, and recall is the fraction of the exact neighbours found,
+averaged over 64 queries.
+*/
+namespace bm = comp6771::benchmarks;
+
+namespace {
+	constexpr auto rows = 1 << 16;
+	constexpr auto dimensions = 64;
+	constexpr auto centres = 256;
+	constexpr auto subspaces = 16;
+	constexpr auto queries_size = 64;
+	constexpr auto k = 10;
+
+	struct quantised {
+		comp6771::product_quantiser quantiser;
+		std::vector<std::uint8_t> codes;
+	};
+
+	auto quantise(comp6771::euclidean_vector_batch const& dataset, int bits) -> quantised {
+		auto quantiser = comp6771::product_quantiser(dataset,
+		                                             subspaces,
+		                                             comp6771::metric::l2,
+		                                             {.bits = bits, .sample_per_centroid = 64});
+		auto codes = quantiser.encode(dataset);
+		return {std::move(quantiser), std::move(codes)};
+	}
+
+	struct fixture {
+		comp6771::euclidean_vector_batch dataset;
+		std::vector<comp6771::euclidean_vector> queries;
+		std::vector<std::vector<comp6771::neighbour>> exact;
+		quantised eight_bit;
+		quantised four_bit;
+		comp6771::pq_packed_codes packed;
+	};
+
+	auto shared_fixture() -> fixture const& {
+		static auto const shared = [] {
+			auto const vectors = bm::make_clustered_vectors(rows, dimensions, centres, 1);
+			auto dataset = comp6771::euclidean_vector_batch(vectors);
+			auto queries = bm::make_clustered_vectors(queries_size, dimensions, centres, 2);
+			auto exact = comp6771::knn_search(std::execution::par, queries, dataset, k);
+			auto eight_bit = quantise(dataset, 8);
+			auto four_bit = quantise(dataset, 4);
+			auto packed = four_bit.quantiser.pack(four_bit.codes);
+			return fixture{std::move(dataset),
+			               std::move(queries),
+			               std::move(exact),
+			               std::move(eight_bit),
+			               std::move(four_bit),
+			               std::move(packed)};
+		}();
+		return shared;
+	}
+
+	// Runs `search` for every query, and reports queries per second and recall.
+	template<typename Search>
+	auto measure(benchmark::State& state, Search search) -> void {
+		auto const& queries = shared_fixture().queries;
+		auto found = std::vector<std::vector<comp6771::neighbour>>(queries.size());
+		for (auto _ : state) {
+			for (auto query = std::size_t{0}; query < queries.size(); ++query) {
+				found[query] = search(queries[query]);
+			}
+			benchmark::DoNotOptimize(found.data());
+		}
+		state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()) * queries_size);
+		state.counters["recall"] = bm::recall(shared_fixture().exact, found);
+	}
+
+	auto exact_search(benchmark::State& state) -> void {
+		auto const& dataset = shared_fixture().dataset;
+		measure(state, [&](comp6771::euclidean_vector const& query) {
+			return comp6771::knn_search(query, dataset, k);
+		});
+	}
+	BENCHMARK(exact_search)->Unit(benchmark::kMillisecond);
+
+	auto pq8_search(benchmark::State& state) -> void {
+		auto const& [quantiser, codes] = shared_fixture().eight_bit;
+		measure(state, [&](comp6771::euclidean_vector const& query) {
+			return quantiser.search(query, codes, k);
+		});
+	}
+	BENCHMARK(pq8_search)->Unit(benchmark::kMillisecond);
+
+	auto pq4_search(benchmark::State& state) -> void {
+		auto const& [quantiser, codes] = shared_fixture().four_bit;
+		measure(state, [&](comp6771::euclidean_vector const& query) {
+			return quantiser.search(query, codes, k);
+		});
+	}
+	BENCHMARK(pq4_search)->Unit(benchmark::kMillisecond);
+
+	auto pq4_fast_scan(benchmark::State& state) -> void {
+		auto const& shared = shared_fixture();
+		measure(state, [&](comp6771::euclidean_vector const& query) {
+			return shared.four_bit.quantiser.search(query, shared.packed, k);
+		});
+	}
+	BENCHMARK(pq4_fast_scan)->Unit(benchmark::kMillisecond);
+
+	auto pq8_encode(benchmark::State& state) -> void {
+		auto const& shared = shared_fixture();
+		for (auto _ : state) {
+			auto const codes = shared.eight_bit.quantiser.encode(shared.queries);
+			benchmark::DoNotOptimize(codes.data());
+		}
+		state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()) * queries_size);
+	}
+	BENCHMARK(pq8_encode);
+} // namespace
@@ -0,0 +1,98 @@
+#include "euclidean_vector_benchmark.hpp"
+
+#include <benchmark/benchmark.h>
+#include <comp6771/euclidean_vector.hpp>
+#include <comp6771/serialisation.hpp>
+#include <cstddef>
+#include <span>
+#include <string>
+#include <vector>
+
+/*
+This file benchmarks the binary serialisation against the text round trip it replaces.
+Buffers are allocated once, outside the loop, so only the encoding and decoding are measured.
+*/
+namespace bm = comp6771::benchmarks;
+
+namespace {
+	// A buffer of doubles so that views of it are aligned
+	auto make_record(comp6771::euclidean_vector const& ev, comp6771::checksum sum)
+	   -> std::vector<double> {
+		auto buffer = std::vector<double>(comp6771::binary_size<double>(ev.dimensions()) / 8);
+		comp6771::write_binary(std::as_writable_bytes(std::span(buffer)), ev, sum);
+		return buffer;
+	}
+
+	auto write_binary_buffer(benchmark::State& state) -> void {
+		auto const dimensions = static_cast<int>(state.range(0));
+		auto const ev = bm::make_vector(dimensions);
+		auto buffer = std::vector<std::byte>(comp6771::binary_size<double>(dimensions));
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(comp6771::write_binary(std::span(buffer), ev));
+			benchmark::ClobberMemory();
+		}
+		bm::set_throughput(state, dimensions, 2);
+	}
+	BENCHMARK(write_binary_buffer)->Apply(bm::dimension_sweep);
+
+	auto write_binary_crc32c(benchmark::State& state) -> void {
+		auto const dimensions = static_cast<int>(state.range(0));
+		auto const ev = bm::make_vector(dimensions);
+		auto buffer = std::vector<std::byte>(comp6771::binary_size<double>(dimensions));
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(
+			   comp6771::write_binary(std::span(buffer), ev, comp6771::checksum::crc32c));
+			benchmark::ClobberMemory();
+		}
+		bm::set_throughput(state, dimensions, 2);
+	}
+	BENCHMARK(write_binary_crc32c)->Apply(bm::dimension_sweep);
+
+	auto read_binary_buffer(benchmark::State& state) -> void {
+		auto const dimensions = static_cast<int>(state.range(0));
+		auto const record = make_record(bm::make_vector(dimensions), comp6771::checksum::none);
+		for (auto _ : state) {
+			auto ev = comp6771::read_binary<double>(std::as_bytes(std::span(record)));
+			benchmark::DoNotOptimize(ev);
+		}
+		bm::set_throughput(state, dimensions, 2);
+	}
+	BENCHMARK(read_binary_buffer)->Apply(bm::dimension_sweep);
+
+	auto view_binary_unchecked(benchmark::State& state) -> void {
+		auto const dimensions = static_cast<int>(state.range(0));
+		auto const record = make_record(bm::make_vector(dimensions), comp6771::checksum::crc32c);
+		auto const bytes = std::as_bytes(std::span(record));
+		for (auto _ : state) {
+			auto const view = comp6771::view_binary<double>(bytes, comp6771::checksum::none);
+			benchmark::DoNotOptimize(view.data());
+		}
+		bm::set_throughput(state, dimensions, 0);
+	}
+	BENCHMARK(view_binary_unchecked)->Apply(bm::dimension_sweep);
+
+	auto view_binary_crc32c(benchmark::State& state) -> void {
+		auto const dimensions = static_cast<int>(state.range(0));
+		auto const record = make_record(bm::make_vector(dimensions), comp6771::checksum::crc32c);
+		for (auto _ : state) {
+			auto const view = comp6771::view_binary<double>(std::as_bytes(std::span(record)));
+			benchmark::DoNotOptimize(view.data());
+		}
+		bm::set_throughput(state, dimensions, 1);
+	}
+	BENCHMARK(view_binary_crc32c)->Apply(bm::dimension_sweep);
+
+	// Text is far slower, so the sweep stops at 10^6 dimensions.
+	auto text_round_trip(benchmark::State& state) -> void {
+		auto const dimensions = static_cast<int>(state.range(0));
+		auto const ev = bm::make_vector(dimensions);
+		auto text = std::string(comp6771::max_formatted_size<double>(dimensions), '\0');
+		auto parsed = comp6771::euclidean_vector();
+		for (auto _ : state) {
+			auto const written = comp6771::to_chars(text.data(), text.data() + text.size(), ev);
+			benchmark::DoNotOptimize(comp6771::from_chars(text.data(), written.ptr, parsed));
+		}
+		bm::set_throughput(state, dimensions, 2);
+	}
+	BENCHMARK(text_round_trip)->RangeMultiplier(10)->Range(bm::min_dimensions, 1'000'000);
+} // namespace
@@ -0,0 +1,79 @@
+#include "euclidean_vector_benchmark.hpp"
+
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <comp6771/euclidean_vector.hpp>
+#include <comp6771/euclidean_vector_store.hpp>
+#include <filesystem>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+/*
+This file benchmarks scanning a mapped euclidean_vector_store, in order and in random order, with
+the matching access hint. As in the batch benchmarks the total size is fixed at 2^22 doubles
+(32 MiB) and the argument is the dimension of each row. The file is written once per dimension
+and stays in the page cache, so this measures the mapping rather than the disk.
+*/
+namespace bm = comp6771::benchmarks;
+
+namespace {
+	constexpr auto total_magnitudes = 1 << 22;
+
+	auto store_path(int dimensions) -> std::string {
+		return (std::filesystem::temp_directory_path()
+		        / ("euclidean_vector_store_benchmark." + std::to_string(dimensions) + ".evst"))
+		   .string();
+	}
+
+	auto make_store(int dimensions) -> comp6771::euclidean_vector_store {
+		auto const path = store_path(dimensions);
+		std::filesystem::remove(path);
+		{
+			auto writer = comp6771::euclidean_vector_store_writer(path, dimensions);
+			auto const row = bm::make_vector(dimensions);
+			for (auto i = 0; i < total_magnitudes / dimensions; ++i) {
+				writer.append(row);
+			}
+		}
+		auto store = comp6771::euclidean_vector_store(path);
+		std::filesystem::remove(path);
+		return store;
+	}
+
+	auto scan_store_sequential(benchmark::State& state) -> void {
+		auto const dimensions = static_cast<int>(state.range(0));
+		auto const store = make_store(dimensions);
+		store.advise(comp6771::euclidean_vector_store::access_pattern::sequential);
+		auto const query = bm::make_vector(dimensions);
+		for (auto _ : state) {
+			auto best = 0.0;
+			for (auto row = 0; row < store.rows(); ++row) {
+				best = std::max(best, comp6771::dot(store[row], query));
+			}
+			benchmark::DoNotOptimize(best);
+		}
+		bm::set_throughput(state, total_magnitudes, 1);
+	}
+	BENCHMARK(scan_store_sequential)->RangeMultiplier(4)->Range(4, 1024);
+
+	auto scan_store_random(benchmark::State& state) -> void {
+		auto const dimensions = static_cast<int>(state.range(0));
+		auto const store = make_store(dimensions);
+		store.advise(comp6771::euclidean_vector_store::access_pattern::random);
+		auto const query = bm::make_vector(dimensions);
+		auto order = std::vector<int>(static_cast<std::size_t>(store.rows()));
+		std::iota(order.begin(), order.end(), 0);
+		std::shuffle(order.begin(), order.end(), std::mt19937_64(6771));
+		for (auto _ : state) {
+			auto best = 0.0;
+			for (auto const row : order) {
+				best = std::max(best, comp6771::dot(store[row], query));
+			}
+			benchmark::DoNotOptimize(best);
+		}
+		bm::set_throughput(state, total_magnitudes, 1);
+	}
+	BENCHMARK(scan_store_random)->RangeMultiplier(4)->Range(4, 1024);
+} // namespace
@@ -0,0 +1,120 @@
+#include "euclidean_vector_benchmark.hpp"
+
+#include <benchmark/benchmark.h>
+#include <comp6771/euclidean_vector.hpp>
+#include <comp6771/kernels.hpp>
+#include <comp6771/parallel.hpp>
+#include <cstdint>
+#include <execution>
+
+/*
+This file benchmarks the utility functions.
+*/
+namespace bm = comp6771::benchmarks;
+
+namespace {
+	auto euclidean_norm(benchmark::State& state) -> void {
+		auto const dimensions = static_cast<int>(state.range(0));
+		auto const ev = bm::make_vector(dimensions);
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(comp6771::euclidean_norm(ev));
+		}
+		bm::set_throughput(state, dimensions, 1);
+	}
+	BENCHMARK(euclidean_norm)->Apply(bm::dimension_sweep);
+
+	// Writing through operator[] drops the cached norm, so every call recomputes it.
+	auto euclidean_norm_uncached(benchmark::State& state) -> void {
+		auto const dimensions = static_cast<int>(state.range(0));
+		auto ev = bm::make_vector(dimensions);
+		for (auto _ : state) {
+			ev[0] = 1.0;
+			benchmark::DoNotOptimize(comp6771::euclidean_norm(ev));
+		}
+		bm::set_throughput(state, dimensions, 1);
+	}
+	BENCHMARK(euclidean_norm_uncached)->Apply(bm::dimension_sweep);
+
+	auto unit(benchmark::State& state) -> void {
+		auto const dimensions = static_cast<int>(state.range(0));
+		auto const ev = bm::make_vector(dimensions);
+		for (auto _ : state) {
+			auto ev_unit = comp6771::unit(ev);
+			benchmark::DoNotOptimize(ev_unit);
+		}
+		bm::set_throughput(state, dimensions, 3);
+	}
+	BENCHMARK(unit)->Apply(bm::dimension_sweep);
+
+	auto dot(benchmark::State& state) -> void {
+		auto const dimensions = static_cast<int>(state.range(0));
+		auto const ev1 = bm::make_vector(dimensions);
+		auto const ev2 = bm::make_vector(dimensions);
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(comp6771::dot(ev1, ev2));
+		}
+		bm::set_throughput(state, dimensions, 2);
+	}
+	BENCHMARK(dot)->Apply(bm::dimension_sweep);
+
+	// The same dot product for each element type; narrower types stream fewer bytes.
+	template<typename T>
+	auto dot_per_type(benchmark::State& state) -> void {
+		auto const dimensions = static_cast<int>(state.range(0));
+		auto const ev1 = bm::make_vector<T>(dimensions);
+		auto const ev2 = bm::make_vector<T>(dimensions);
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(comp6771::dot(ev1, ev2));
+		}
+		bm::set_throughput<T>(state, dimensions, 2);
+	}
+	BENCHMARK_TEMPLATE(dot_per_type, double)->Apply(bm::dimension_sweep);
+	BENCHMARK_TEMPLATE(dot_per_type, float)->Apply(bm::dimension_sweep);
+	BENCHMARK_TEMPLATE(dot_per_type, std::int16_t)->Apply(bm::dimension_sweep);
+	BENCHMARK_TEMPLATE(dot_per_type, std::int8_t)->Apply(bm::dimension_sweep);
+
+	// Compares the instruction sets on the same dot product; the first argument is the isa.
+	auto dot_per_isa(benchmark::State& state) -> void {
+		auto const level = static_cast<comp6771::kernels::isa>(state.range(0));
+		if (not comp6771::kernels::supported(level)) {
+			state.SkipWithError("instruction set not supported");
+			return;
+		}
+		auto const original = comp6771::kernels::active_isa();
+		comp6771::kernels::use_isa(level);
+
+		auto const dimensions = static_cast<int>(state.range(1));
+		auto const ev1 = bm::make_vector(dimensions);
+		auto const ev2 = bm::make_vector(dimensions);
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(comp6771::dot(ev1, ev2));
+		}
+		bm::set_throughput(state, dimensions, 2);
+		comp6771::kernels::use_isa(original);
+	}
+	BENCHMARK(dot_per_isa)->ArgsProduct({{0, 1, 2, 3}, {1'000, 100'000, 10'000'000}});
+
+	// The same dot product split across thread_pool::shared(), to compare against `dot` above.
+	// Sizes below parallel_threshold() run serially.
+	auto dot_parallel(benchmark::State& state) -> void {
+		auto const dimensions = static_cast<int>(state.range(0));
+		auto const ev1 = bm::make_vector(dimensions);
+		auto const ev2 = bm::make_vector(dimensions);
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(comp6771::dot(std::execution::par, ev1, ev2));
+		}
+		bm::set_throughput(state, dimensions, 2);
+	}
+	BENCHMARK(dot_parallel)->Apply(bm::dimension_sweep)->UseRealTime();
+
+	auto euclidean_norm_parallel(benchmark::State& state) -> void {
+		auto const dimensions = static_cast<int>(state.range(0));
+		auto ev = bm::make_vector(dimensions);
+		for (auto _ : state) {
+			ev[0] = 1.0;
+			benchmark::DoNotOptimize(comp6771::euclidean_norm(std::execution::par, ev));
+		}
+		bm::set_throughput(state, dimensions, 1);
+	}
+	BENCHMARK(euclidean_norm_parallel)->Apply(bm::dimension_sweep)->UseRealTime();
+} // namespace
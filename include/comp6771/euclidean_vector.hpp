@@ -2,18 +2,36 @@
 #define COMP6771_EUCLIDEAN_VECTOR_HPP
 
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <charconv>
 #include <cmath>
+#include <comp6771/kernels.hpp>
+#include <concepts>
+#include <cstdint>
+#include <cstring>
 #include <functional>
 #include <iostream>
+#include <iterator>
+#include <limits>
 #include <list>
 #include <memory>
+#include <memory_resource>
 #include <numeric>
-#include <sstream>
+#include <ranges>
 #include <stdexcept>
 #include <string>
+#include <system_error>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
+// Number of magnitudes stored inside the object itself. Vectors with at most this many dimensions
+// never allocate. It changes the class layout, so every translation unit must agree on it.
+#ifndef COMP6771_EUCLIDEAN_VECTOR_INLINE_CAPACITY
+#	define COMP6771_EUCLIDEAN_VECTOR_INLINE_CAPACITY 4
+#endif
+
 namespace comp6771 {
 	class euclidean_vector_error : public std::runtime_error {
 	public:
@@ -21,139 +39,1038 @@ namespace comp6771 {
 		: std::runtime_error(what) {}
 	};
 
-	class euclidean_vector {
+	// Element types a euclidean vector can hold. float halves the memory and doubles the SIMD lanes
+	// of double; std::int8_t and std::int16_t hold quantised magnitudes.
+	template<typename T>
+	concept euclidean_vector_value =
+	   std::same_as<T, double> or std::same_as<T, float> or kernels::quantised<T>;
+
+	template<euclidean_vector_value T>
+	class basic_euclidean_vector;
+
+	using euclidean_vector = basic_euclidean_vector<double>;
+
+	namespace detail {
+		// Memoised euclidean norm; a negative value means it has not been computed yet. Relaxed
+		// atomics keep concurrent euclidean_norm calls on the same const vector race-free.
+		class norm_cache {
+		public:
+			norm_cache() noexcept = default;
+
+			norm_cache(norm_cache const& other) noexcept
+			: value_{other.load()} {}
+
+			auto operator=(norm_cache const& other) noexcept -> norm_cache& {
+				store(other.load());
+				return *this;
+			}
+
+			~norm_cache() = default;
+
+			[[nodiscard]] auto load() const noexcept -> double {
+				return value_.load(std::memory_order_relaxed);
+			}
+
+			auto store(double norm) const noexcept -> void {
+				value_.store(norm, std::memory_order_relaxed);
+			}
+
+			auto invalidate() noexcept -> void {
+				store(-1.0);
+			}
+
+		private:
+			mutable std::atomic<double> value_ = -1.0;
+		};
+
+		// Returns heap magnitudes to the memory resource they came from, or to the global heap when
+		// there is none. Small vectors keep their resource here too, for when they grow. Magnitudes
+		// adopted from a std::vector stay owned by that vector, which is destroyed instead.
+		template<typename T>
+		class magnitude_deleter {
+		public:
+			magnitude_deleter() noexcept = default;
+
+			magnitude_deleter(std::pmr::memory_resource* resource, std::size_t size) noexcept
+			: resource_{resource}
+			, size_{size} {}
+
+			explicit magnitude_deleter(std::vector<T>* owner) noexcept
+			: owner_{owner} {}
+
+			auto operator()(T* magnitude) const noexcept -> void {
+				if (owner_ != nullptr) {
+					delete owner_;
+					return;
+				}
+				if (resource_ == nullptr) {
+					delete[] magnitude;
+					return;
+				}
+				resource_->deallocate(magnitude, size_ * sizeof(T), alignof(T));
+			}
+
+			[[nodiscard]] auto resource() const noexcept -> std::pmr::memory_resource* {
+				return resource_;
+			}
+
+			// The std::vector the magnitudes were adopted from, if any
+			[[nodiscard]] auto owner() const noexcept -> std::vector<T>* {
+				return owner_;
+			}
+
+		private:
+			std::pmr::memory_resource* resource_ = nullptr;
+			std::size_t size_ = 0;
+			std::vector<T>* owner_ = nullptr;
+		};
+
+		// Scalars are applied to floating-point magnitudes in their own precision, and to quantised
+		// ones in double before rounding back.
+		template<typename T>
+		using scalar_t = std::conditional_t<std::floating_point<T>, T, double>;
+
+		// Returns the cached norm of `vec`, computing and caching it with compute() if needed.
+		template<typename T, typename Compute>
+		auto cached_norm(basic_euclidean_vector<T> const& vec, Compute const& compute) -> double;
+
+		template<typename T>
+		inline constexpr auto is_euclidean_vector = false;
+
+		template<typename T>
+		inline constexpr auto is_euclidean_vector<basic_euclidean_vector<T>> = true;
+	} // namespace detail
+
+	// Base of the lazily evaluated expressions returned by the arithmetic friend operators.
+	// An expression such as `ev1 * 5.16 + ev2 / -10.11` is only evaluated when it is assigned to, or
+	// used to construct, a euclidean_vector, and is then computed in a single pass with no
+	// temporaries. Expressions refer to lvalue euclidean_vector operands, so they must not outlive
+	// them; rvalue operands are moved into the expression. For quantised magnitudes only the final
+	// result is rounded and saturated.
+	template<typename Derived, typename T>
+	class vector_expression {
 	public:
+		explicit operator std::vector<T>() const;
+		explicit operator std::list<T>() const;
+	};
+
+	template<typename E>
+	concept euclidean_vector_expression = requires {
+		typename std::remove_cvref_t<E>::value_type;
+	} and std::derived_from<std::remove_cvref_t<E>,
+	                        vector_expression<std::remove_cvref_t<E>,
+	                                          typename std::remove_cvref_t<E>::value_type>>;
+
+	// Anything that exposes its magnitudes as one contiguous array, such as euclidean_vector and
+	// euclidean_vector_view. These work with every operator and utility function. Collections of
+	// rows, such as euclidean_vector_batch, also have data() and dimensions(), but have rows() too
+	// and are not vectors themselves.
+	template<typename T>
+	concept contiguous_euclidean_vector = requires(std::remove_cvref_t<T> const& vec) {
+		{ vec.dimensions() } -> std::same_as<int>;
+		requires euclidean_vector_value<std::remove_cvref_t<decltype(*vec.data())>>;
+	} and not requires(std::remove_cvref_t<T> const& vec) { vec.rows(); };
+
+	template<typename T>
+	concept euclidean_vector_operand =
+	   contiguous_euclidean_vector<T> or euclidean_vector_expression<T>;
+
+	namespace detail {
+		template<typename V>
+		struct value_type_of {
+			using type = std::remove_cvref_t<decltype(*std::declval<V const&>().data())>;
+		};
+
+		template<euclidean_vector_expression E>
+		struct value_type_of<E> {
+			using type = typename E::value_type;
+		};
+
+		// Element type of a euclidean vector, view or expression
+		template<typename V>
+		using value_type_t = typename value_type_of<std::remove_cvref_t<V>>::type;
+
+		// Arithmetic elements that a euclidean vector of T can be built from
+		template<typename U, typename T>
+		concept magnitude_source = std::is_arithmetic_v<U> and std::convertible_to<U, T>;
+
+		// Number of elements in [first, last) if it can be known before reading them, otherwise 0.
+		template<typename I, typename S>
+		auto initial_dimensions(I const& first, S const& last) -> int {
+			if constexpr (std::sized_sentinel_for<S, I>) {
+				return static_cast<int>(last - first);
+			}
+			else if constexpr (std::forward_iterator<I>) {
+				return static_cast<int>(std::ranges::distance(first, last));
+			}
+			else {
+				return 0;
+			}
+		}
+
+		// Writes the `size` elements of [first, last) to `out`, converting each to T.
+		template<typename T, typename I, typename S>
+		auto convert_copy(I first, S last, T* out, std::size_t size) -> void {
+			if constexpr (std::contiguous_iterator<I>) {
+				auto const* const source = std::to_address(first);
+				if constexpr (std::same_as<std::iter_value_t<I>, T>) {
+					if (size != 0) {
+						std::memcpy(out, source, size * sizeof(T));
+					}
+				}
+				else {
+					std::transform(source, source + size, out, [](auto const val) {
+						return kernels::narrow<T>(val);
+					});
+				}
+			}
+			else {
+				for (; first != last; ++first, ++out) {
+					*out = kernels::narrow<T>(*first);
+				}
+			}
+		}
+
+		// Returns the sum of x[i] * y[i], widened to double.
+		template<typename T>
+		auto inner_product(T const* x, T const* y, std::size_t size) noexcept -> double {
+			return static_cast<double>(kernels::dot(x, y, size));
+		}
+
+		// Most characters that one magnitude takes when formatted, e.g. "-1.23457e-308" or "-32768"
+		template<typename T>
+		constexpr auto max_magnitude_chars =
+		   std::floating_point<T> ? std::size_t{13}
+		                          : static_cast<std::size_t>(std::numeric_limits<T>::digits10) + 2;
+
+		// Writes "[x0 x1 ...]", with floating-point magnitudes as printf's %.6g would. Returns
+		// {last, std::errc::value_too_large} if the buffer is too small.
+		template<typename T>
+		auto write_magnitudes(char* first, char* last, T const* data, std::size_t size) noexcept
+		   -> std::to_chars_result {
+			auto const too_large = std::to_chars_result{last, std::errc::value_too_large};
+			if (first == last) {
+				return too_large;
+			}
+			*first++ = '[';
+			for (auto i = std::size_t{0}; i < size; ++i) {
+				if (i != 0) {
+					if (first == last) {
+						return too_large;
+					}
+					*first++ = ' ';
+				}
+				auto const result = [&] {
+					if constexpr (std::floating_point<T>) {
+						return std::to_chars(first, last, data[i], std::chars_format::general, 6);
+					}
+					else {
+						return std::to_chars(first, last, data[i]);
+					}
+				}();
+				if (result.ec != std::errc()) {
+					return too_large;
+				}
+				first = result.ptr;
+			}
+			if (first == last) {
+				return too_large;
+			}
+			*first++ = ']';
+			return {first, std::errc()};
+		}
+
+		// Formats into a stack buffer when the vector is small enough, otherwise into the heap.
+		template<typename T, typename Out>
+		auto format_magnitudes(T const* data, std::size_t size, Out const& out) -> void {
+			constexpr auto small = std::size_t{256};
+			auto const bound = 2 + size * (max_magnitude_chars<T> + 1);
+			if (bound <= small) {
+				auto buffer = std::array<char, small>();
+				auto const result = write_magnitudes(buffer.data(), buffer.data() + small, data, size);
+				out(buffer.data(), result.ptr);
+			}
+			else {
+				auto const buffer = std::make_unique_for_overwrite<char[]>(bound);
+				auto const result = write_magnitudes(buffer.get(), buffer.get() + bound, data, size);
+				out(buffer.get(), result.ptr);
+			}
+		}
+
+		// Whether every x[i] is within max(abs_tol, rel_tol * max(|x[i]|, |y[i]|)) of y[i].
+		template<typename T>
+		auto approx_equal(T const* x,
+		                  T const* y,
+		                  std::size_t size,
+		                  double abs_tol,
+		                  double rel_tol) noexcept -> bool {
+			if constexpr (std::same_as<T, float>) {
+				return kernels::approx_equal(x,
+				                             y,
+				                             size,
+				                             static_cast<float>(abs_tol),
+				                             static_cast<float>(rel_tol));
+			}
+			else {
+				return kernels::approx_equal(x, y, size, abs_tol, rel_tol);
+			}
+		}
+	} // namespace detail
+
+	// Magnitudes that do not fit inline come from the global heap, or from the memory resource
+	// passed to the constructor, e.g. a std::pmr::monotonic_buffer_resource arena for request-scoped
+	// work. The resource must outlive the vector. Like the std::pmr containers, a vector keeps its
+	// resource when assigned to, copies use the global heap unless given one, and move construction
+	// takes the buffer and its resource along.
+	//
+	// Norms and inner products are computed and returned as double for every element type.
+	// Arithmetic on quantised magnitudes rounds to nearest and saturates.
+	template<euclidean_vector_value T>
+	class basic_euclidean_vector {
+	public:
+		using value_type = T;
+
+		static constexpr auto inline_capacity = COMP6771_EUCLIDEAN_VECTOR_INLINE_CAPACITY;
+
 		// Constructors
-		euclidean_vector();
+		basic_euclidean_vector();
+
+		explicit basic_euclidean_vector(int dimensions);
+
+		basic_euclidean_vector(int dimensions,
+		                       T magnitude,
+		                       std::pmr::memory_resource* resource = nullptr);
+
+		// Copies the magnitudes in [first, last), e.g. from a std::array, std::deque, std::span or a
+		// raw double* buffer, converting each element to T. Contiguous sources are copied with
+		// memcpy, or converted in one vectorisable loop. Single-pass sources grow the storage
+		// geometrically.
+		template<std::input_iterator I, std::sentinel_for<I> S>
+		requires detail::magnitude_source<std::iter_value_t<I>, T>
+		basic_euclidean_vector(I first, S last, std::pmr::memory_resource* resource = nullptr);
+
+		// Copies the magnitudes of any input range, as above.
+		template<std::ranges::input_range R>
+		requires detail::magnitude_source<std::ranges::range_value_t<R>, T>
+		         and (not contiguous_euclidean_vector<R>)
+		explicit basic_euclidean_vector(R&& range, std::pmr::memory_resource* resource = nullptr);
+
+		basic_euclidean_vector(std::initializer_list<T> list,
+		                       std::pmr::memory_resource* resource = nullptr);
 
-		explicit euclidean_vector(int dimensions);
+		// Evaluates an expression directly into the new vector's storage.
+		template<euclidean_vector_expression E>
+		requires std::same_as<detail::value_type_t<E>, T>
+		basic_euclidean_vector(E const& expr, // NOLINT(google-explicit-constructor)
+		                       std::pmr::memory_resource* resource = nullptr);
 
-		euclidean_vector(int dimensions, double magnitude);
+		// Evaluates an expiring expression in place into a temporary euclidean_vector it holds, as in
+		// `f() + b`, and takes that vector's storage. Falls back to allocating when there is no such
+		// operand or it uses another memory resource.
+		template<euclidean_vector_expression E>
+		requires std::same_as<detail::value_type_t<E>, T>
+		         and std::same_as<E, std::remove_cvref_t<E>>
+		basic_euclidean_vector(E&& expr, // NOLINT(google-explicit-constructor)
+		                       std::pmr::memory_resource* resource = nullptr);
 
-		euclidean_vector(std::vector<double>::const_iterator cbegin,
-		                 std::vector<double>::const_iterator cend);
+		// Copies the magnitudes of a row or other non-owning vector, or of a vector with another
+		// element type.
+		template<contiguous_euclidean_vector V>
+		requires(not std::same_as<V, basic_euclidean_vector<T>>) explicit basic_euclidean_vector(
+		   V const& vec,
+		   std::pmr::memory_resource* resource = nullptr);
 
-		euclidean_vector(std::initializer_list<double> list);
+		// Copies `orig` into storage from `resource`.
+		basic_euclidean_vector(basic_euclidean_vector const& orig,
+		                       std::pmr::memory_resource* resource);
+
+		// A vector whose magnitudes are left uninitialised, for callers that fill data() themselves.
+		// Every magnitude must be written before it is read.
+		[[nodiscard]] static auto uninitialized(int dimensions,
+		                                        std::pmr::memory_resource* resource = nullptr)
+		   -> basic_euclidean_vector;
+
+		// Takes the magnitudes of a std::vector without copying them; the vector's buffer is kept
+		// alive as this vector's storage. Small vectors are copied inline instead.
+		explicit basic_euclidean_vector(std::vector<T>&& magnitudes);
+
+		// Takes ownership of `dimensions` magnitudes allocated with new[], without copying them.
+		[[nodiscard]] static auto adopt(std::unique_ptr<T[]> magnitudes, int dimensions)
+		   -> basic_euclidean_vector;
 
 		// Rule of 5!
 		// Copy constructor
-		euclidean_vector(euclidean_vector const& orig);
+		basic_euclidean_vector(basic_euclidean_vector const& orig);
 
 		// Move constructor
-		euclidean_vector(euclidean_vector&& orig) noexcept;
+		basic_euclidean_vector(basic_euclidean_vector&& orig) noexcept;
 
 		// Destructor
-		~euclidean_vector() = default;
+		~basic_euclidean_vector() = default;
 
 		// Copy assignment
-		auto operator=(euclidean_vector const& orig) -> euclidean_vector&;
+		auto operator=(basic_euclidean_vector const& orig) -> basic_euclidean_vector&;
+
+		// Move assignment, which copies if `orig` uses a different memory resource
+		auto operator=(basic_euclidean_vector&& orig) -> basic_euclidean_vector&;
 
-		// Move assignment
-		auto operator=(euclidean_vector&& orig) noexcept -> euclidean_vector&;
+		// Expression assignment, in place when the dimensions already match
+		template<euclidean_vector_expression E>
+		requires std::same_as<detail::value_type_t<E>, T>
+		auto operator=(E const& expr) -> basic_euclidean_vector&;
 
 		// Operations
-		auto operator[](int index) const noexcept -> double;
-		auto operator[](int index) noexcept -> double&;
+		auto operator[](int index) const noexcept -> T;
+		auto operator[](int index) noexcept -> T&;
 
-		auto operator+() const noexcept -> euclidean_vector;
-		auto operator-() const noexcept -> euclidean_vector;
+		auto operator+() const& noexcept -> basic_euclidean_vector;
+		auto operator-() const& noexcept -> basic_euclidean_vector;
+		// An expiring vector is returned, or negated, in its own storage.
+		auto operator+() && noexcept -> basic_euclidean_vector;
+		auto operator-() && noexcept -> basic_euclidean_vector;
 
-		auto operator+=(euclidean_vector const& other) -> euclidean_vector&;
-		auto operator-=(euclidean_vector const& other) -> euclidean_vector&;
+		auto operator+=(basic_euclidean_vector const& other) -> basic_euclidean_vector&;
+		auto operator-=(basic_euclidean_vector const& other) -> basic_euclidean_vector&;
 
-		auto operator*=(double scalar) noexcept -> euclidean_vector&;
-		auto operator/=(double scalar) -> euclidean_vector&;
+		auto operator*=(double scalar) noexcept -> basic_euclidean_vector&;
+		auto operator/=(double scalar) -> basic_euclidean_vector&;
 
-		explicit operator std::vector<double>() const noexcept;
-		explicit operator std::list<double>() const noexcept;
+		template<euclidean_vector_expression E>
+		requires std::same_as<detail::value_type_t<E>, T>
+		auto operator+=(E const& expr) -> basic_euclidean_vector&;
+		template<euclidean_vector_expression E>
+		requires std::same_as<detail::value_type_t<E>, T>
+		auto operator-=(E const& expr) -> basic_euclidean_vector&;
+
+		explicit operator std::vector<T>() const& noexcept;
+		// Hands back the std::vector this vector was built from without copying, and copies
+		// otherwise. Either way this vector is left with 0 dimensions.
+		explicit operator std::vector<T>() && noexcept;
+		explicit operator std::list<T>() const noexcept;
 
 		// Member functions
-		[[nodiscard]] auto at(int index) const -> double;
-		auto at(int index) -> double&;
+		[[nodiscard]] auto at(int index) const -> T;
+		auto at(int index) -> T&;
 		[[nodiscard]] auto dimensions() const noexcept -> int;
 
+		// Hands the magnitudes to the caller as a new[] buffer of dimensions() elements, leaving this
+		// vector with 0 dimensions. Heap magnitudes are released without copying; inline ones,
+		// those from a memory resource and those adopted from a std::vector are copied out.
+		[[nodiscard]] auto release() -> std::unique_ptr<T[]>;
+
+		// Where heap magnitudes are allocated; nullptr for the global heap.
+		[[nodiscard]] auto resource() const noexcept -> std::pmr::memory_resource* {
+			return magnitude_.get_deleter().resource();
+		}
+
+		// Contiguous storage of the magnitudes, inline so that expression evaluation stays tight.
+		// Every mutating path goes through the non-const overload, which drops the cached norm.
+		// Writes through a pointer or reference kept across a later euclidean_norm() call are not
+		// seen.
+		[[nodiscard]] auto data() const noexcept -> T const* {
+			return magnitude_ ? magnitude_.get() : inline_magnitude_.data();
+		}
+		[[nodiscard]] auto data() noexcept -> T* {
+			norm_.invalidate();
+			return magnitude_ ? magnitude_.get() : inline_magnitude_.data();
+		}
+
 		// Friends
-		friend auto operator==(euclidean_vector const& vec1, euclidean_vector const& vec2) noexcept
-		   -> bool {
+		friend auto operator==(basic_euclidean_vector const& vec1,
+		                       basic_euclidean_vector const& vec2) noexcept -> bool {
 			// equal if they are same object, otherwise compare dimensions and magnitude
 			return std::addressof(vec1) == std::addressof(vec2)
 			       or (vec1.dimensions_ == vec2.dimensions_
-			           and std::equal(vec1.magnitude_.get(),
-			                          vec1.magnitude_.get() + vec1.dimensions_,
-			                          vec2.magnitude_.get(),
-			                          vec2.magnitude_.get() + vec2.dimensions_,
-			                          [](double const& val1, double const& val2) {
-				                          return std::abs(val1 - val2) < 1e-6;
-			                          }));
+			           and detail::approx_equal(vec1.data(),
+			                                    vec2.data(),
+			                                    static_cast<std::size_t>(vec1.dimensions_),
+			                                    1e-6,
+			                                    0.0));
 		};
 
-		friend auto operator!=(euclidean_vector const& vec1, euclidean_vector const& vec2) noexcept
-		   -> bool {
+		friend auto operator!=(basic_euclidean_vector const& vec1,
+		                       basic_euclidean_vector const& vec2) noexcept -> bool {
 			return not(vec1 == vec2);
 		};
 
-		friend auto operator+(euclidean_vector const& vec1, euclidean_vector const& vec2)
-		   -> euclidean_vector {
-			auto new_vec = vec1;
-			new_vec += vec2;
-			return new_vec;
+		friend auto operator<<(std::ostream& os, basic_euclidean_vector const& vec) noexcept
+		   -> std::ostream& {
+			detail::format_magnitudes(vec.data(),
+			                          static_cast<std::size_t>(vec.dimensions_),
+			                          [&os](char const* first, char const* last) {
+				                          os.write(first, last - first);
+			                          });
+			return os;
 		};
 
-		friend auto operator-(euclidean_vector const& vec1, euclidean_vector const& vec2)
-		   -> euclidean_vector {
-			auto new_vec = vec1;
-			new_vec -= vec2;
-			return new_vec;
-		};
+		// Reads and fills the cached norm
+		template<typename U, typename Compute>
+		friend auto detail::cached_norm(basic_euclidean_vector<U> const& vec, Compute const& compute)
+		   -> double;
 
-		friend auto operator*(euclidean_vector const& vec, double scalar) noexcept -> euclidean_vector {
-			auto new_vec = vec;
-			new_vec *= scalar;
-			return new_vec;
+		// Vectorised inner product, see kernels::dot()
+		friend auto euclidean_inner_product(basic_euclidean_vector const& vec1,
+		                                    basic_euclidean_vector const& vec2) noexcept -> double {
+			return detail::inner_product(vec1.data(),
+			                             vec2.data(),
+			                             static_cast<size_t>(vec1.dimensions_));
 		};
 
-		friend auto operator*(double scalar, euclidean_vector const& vec) noexcept -> euclidean_vector {
-			return vec * scalar;
-		};
+	private:
+		// NOLINTNEXTLINE(modernize-avoid-c-arrays)
+		using storage = std::unique_ptr<T[], detail::magnitude_deleter<T>>;
 
-		friend auto operator/(euclidean_vector const& vec, double scalar) -> euclidean_vector {
-			auto new_vec = vec;
-			new_vec /= scalar;
-			return new_vec;
-		};
+		struct uninitialized_t {};
 
-		friend auto operator<<(std::ostream& os, euclidean_vector const& vec) noexcept
-		   -> std::ostream& {
-			auto oss = std::ostringstream();
-			oss.precision(6);
-			std::for_each (vec.magnitude_.get(),
-			               vec.magnitude_.get() + vec.dimensions_,
-			               [&oss](double const& val) { oss << val << " "; });
-			return (os << "[" << oss.str().substr(0, oss.str().size() - 1) << "]");
-		};
+		// Appends the elements of a single-pass range, doubling the heap storage whenever it fills.
+		template<typename I, typename S>
+		auto append(I first, S last) -> void;
 
-		// Wrapper of std::inner_product()
-		friend auto euclidean_inner_product(euclidean_vector const& vec1,
-		                                    euclidean_vector const& vec2) noexcept -> double {
-			return std::inner_product(vec1.magnitude_.get(),
-			                          vec1.magnitude_.get() + vec1.dimensions_,
-			                          vec2.magnitude_.get(),
-			                          0.0);
-		};
+		// Allocates storage for `dimensions` magnitudes without writing them.
+		basic_euclidean_vector(uninitialized_t, int dimensions, std::pmr::memory_resource* resource);
+
+		// Drops the magnitudes, keeping the memory resource.
+		auto clear() noexcept -> void;
+
+		static auto allocate(int dimensions, std::pmr::memory_resource* resource) -> storage;
 
-	private:
 		int dimensions_;
-		// NOLINTNEXTLINE(modernize-avoid-c-arrays)
-		std::unique_ptr<double[]> magnitude_;
+		// Only allocated when dimensions_ > inline_capacity, otherwise inline_magnitude_ is used.
+		storage magnitude_;
+		std::array<T, inline_capacity> inline_magnitude_ = {};
+		detail::norm_cache norm_;
 	};
 
 	// Utility functions
-	auto euclidean_norm(euclidean_vector const& v) noexcept -> double;
-	auto unit(euclidean_vector const& v) -> euclidean_vector;
-	auto dot(euclidean_vector const& x, euclidean_vector const& y) -> double;
+	template<euclidean_vector_value T>
+	auto euclidean_norm(basic_euclidean_vector<T> const& v) noexcept -> double;
+	template<euclidean_vector_value T>
+	auto unit(basic_euclidean_vector<T> const& v) -> basic_euclidean_vector<T>;
+	template<euclidean_vector_value T>
+	auto dot(basic_euclidean_vector<T> const& x, basic_euclidean_vector<T> const& y) -> double;
 
 	// Helper functions
-	auto check_dimensions_equal(euclidean_vector const& vec1, euclidean_vector const& vec2) -> void;
-	auto check_index_valid(euclidean_vector const& vec, int index) -> void;
+	template<euclidean_vector_value T>
+	auto check_dimensions_equal(basic_euclidean_vector<T> const& vec1,
+	                            basic_euclidean_vector<T> const& vec2) -> void;
+	auto check_dimensions_equal(int lhs_dimensions, int rhs_dimensions) -> void;
+	auto check_dimensions_valid(int dimensions) -> void;
+	template<euclidean_vector_value T>
+	auto check_index_valid(basic_euclidean_vector<T> const& vec, int index) -> void;
+	auto check_divisor_valid(double scalar) -> void;
+	auto check_unit_vector_exists(int dimensions, double norm) -> void;
+
+	namespace detail {
+		// euclidean_vector lvalues are held by reference; rvalues and sub-expressions by value.
+		template<typename V>
+		using operand_t = std::conditional_t<std::is_lvalue_reference_v<V>
+		                                        and is_euclidean_vector<std::remove_cvref_t<V>>,
+		                                     std::remove_cvref_t<V> const&,
+		                                     std::remove_cvref_t<V>>;
+
+		// The euclidean_vector held by value as `operand`, or inside it if it is an expression, whose
+		// storage can be reused for the result. Operands held by reference are never reused.
+		template<typename Held, typename Operand>
+		auto expiring_operand(Operand& operand) noexcept
+		   -> basic_euclidean_vector<value_type_t<Operand>>* {
+			if constexpr (std::is_reference_v<Held>) {
+				return nullptr;
+			}
+			else if constexpr (is_euclidean_vector<Operand>) {
+				return &operand;
+			}
+			else if constexpr (euclidean_vector_expression<Operand>) {
+				return operand.expiring_operand();
+			}
+			else {
+				return nullptr;
+			}
+		}
+
+		template<contiguous_euclidean_vector V>
+		auto element(V const& vec, int index) noexcept {
+			return vec.data()[index];
+		}
+
+		template<euclidean_vector_expression E>
+		auto element(E const& expr, int index) noexcept {
+			return expr[index];
+		}
+
+		// The single fused loop every expression is evaluated with.
+		template<euclidean_vector_expression E>
+		auto evaluate(E const& expr, value_type_t<E>* out) noexcept -> void {
+			auto const dimensions = expr.dimensions();
+			for (auto i = 0; i < dimensions; ++i) {
+				out[i] = kernels::narrow<value_type_t<E>>(expr[i]);
+			}
+		}
+
+		template<typename BinaryOp, typename Lhs, typename Rhs>
+		class binary_expression
+		: public vector_expression<binary_expression<BinaryOp, Lhs, Rhs>, value_type_t<Lhs>> {
+		public:
+			using value_type = value_type_t<Lhs>;
+
+			binary_expression(Lhs lhs, Rhs rhs)
+			: lhs_{std::forward<Lhs>(lhs)}
+			, rhs_{std::forward<Rhs>(rhs)} {
+				check_dimensions_equal(lhs_.dimensions(), rhs_.dimensions());
+			}
+
+			[[nodiscard]] auto dimensions() const noexcept -> int {
+				return lhs_.dimensions();
+			}
+
+			auto operator[](int index) const noexcept {
+				return BinaryOp{}(element(lhs_, index), element(rhs_, index));
+			}
+
+			auto expiring_operand() noexcept -> basic_euclidean_vector<value_type>* {
+				if (auto* const vec = detail::expiring_operand<Lhs>(lhs_)) {
+					return vec;
+				}
+				return detail::expiring_operand<Rhs>(rhs_);
+			}
+
+		private:
+			Lhs lhs_;
+			Rhs rhs_;
+		};
+
+		template<typename BinaryOp, typename Vec>
+		class scalar_expression
+		: public vector_expression<scalar_expression<BinaryOp, Vec>, value_type_t<Vec>> {
+		public:
+			using value_type = value_type_t<Vec>;
+
+			scalar_expression(Vec vec, double scalar) noexcept
+			: vec_{std::forward<Vec>(vec)}
+			, scalar_{static_cast<scalar_t<value_type>>(scalar)} {}
+
+			[[nodiscard]] auto dimensions() const noexcept -> int {
+				return vec_.dimensions();
+			}
+
+			auto operator[](int index) const noexcept {
+				return BinaryOp{}(element(vec_, index), scalar_);
+			}
+
+			auto expiring_operand() noexcept -> basic_euclidean_vector<value_type>* {
+				return detail::expiring_operand<Vec>(vec_);
+			}
+
+		private:
+			Vec vec_;
+			scalar_t<value_type> scalar_;
+		};
+
+		template<typename UnaryOp, typename Vec>
+		class unary_expression
+		: public vector_expression<unary_expression<UnaryOp, Vec>, value_type_t<Vec>> {
+		public:
+			using value_type = value_type_t<Vec>;
+
+			explicit unary_expression(Vec vec) noexcept
+			: vec_{std::forward<Vec>(vec)} {}
+
+			[[nodiscard]] auto dimensions() const noexcept -> int {
+				return vec_.dimensions();
+			}
+
+			auto operator[](int index) const noexcept {
+				return UnaryOp{}(element(vec_, index));
+			}
+
+			auto expiring_operand() noexcept -> basic_euclidean_vector<value_type>* {
+				return detail::expiring_operand<Vec>(vec_);
+			}
+
+		private:
+			Vec vec_;
+		};
+	} // namespace detail
+
+	// Lazy arithmetic operators
+	template<euclidean_vector_operand L, euclidean_vector_operand R>
+	requires std::same_as<detail::value_type_t<L>, detail::value_type_t<R>>
+	auto operator+(L&& vec1, R&& vec2)
+	   -> detail::binary_expression<std::plus<>, detail::operand_t<L>, detail::operand_t<R>> {
+		return {std::forward<L>(vec1), std::forward<R>(vec2)};
+	}
+
+	template<euclidean_vector_operand L, euclidean_vector_operand R>
+	requires std::same_as<detail::value_type_t<L>, detail::value_type_t<R>>
+	auto operator-(L&& vec1, R&& vec2)
+	   -> detail::binary_expression<std::minus<>, detail::operand_t<L>, detail::operand_t<R>> {
+		return {std::forward<L>(vec1), std::forward<R>(vec2)};
+	}
+
+	template<euclidean_vector_operand V>
+	auto operator*(V&& vec, double scalar) noexcept
+	   -> detail::scalar_expression<std::multiplies<>, detail::operand_t<V>> {
+		return {std::forward<V>(vec), scalar};
+	}
+
+	template<euclidean_vector_operand V>
+	auto operator*(double scalar, V&& vec) noexcept
+	   -> detail::scalar_expression<std::multiplies<>, detail::operand_t<V>> {
+		return {std::forward<V>(vec), scalar};
+	}
+
+	template<euclidean_vector_operand V>
+	auto operator/(V&& vec, double scalar)
+	   -> detail::scalar_expression<std::divides<>, detail::operand_t<V>> {
+		check_divisor_valid(scalar);
+		return {std::forward<V>(vec), scalar};
+	}
+
+	template<euclidean_vector_expression E>
+	auto operator+(E&& expr) noexcept -> std::remove_cvref_t<E> {
+		return std::forward<E>(expr);
+	}
+
+	// Unary plus on a non-owning vector makes an owning copy, like euclidean_vector's own
+	template<contiguous_euclidean_vector V>
+	requires(not detail::is_euclidean_vector<V>) auto operator+(V const& vec)
+	   -> basic_euclidean_vector<detail::value_type_t<V>> {
+		return basic_euclidean_vector<detail::value_type_t<V>>(vec);
+	}
+
+	template<euclidean_vector_operand V>
+	requires(not detail::is_euclidean_vector<std::remove_cvref_t<V>>)
+	auto operator-(V&& vec) noexcept
+	   -> detail::unary_expression<std::negate<>, detail::operand_t<V>> {
+		return detail::unary_expression<std::negate<>, detail::operand_t<V>>(std::forward<V>(vec));
+	}
+
+	// Comparison and output of unevaluated expressions, non-owning vectors and vectors of different
+	// element types
+	template<euclidean_vector_operand L, euclidean_vector_operand R>
+	requires(not(detail::is_euclidean_vector<L> and std::same_as<L, R>))
+	auto operator==(L const& vec1, R const& vec2) noexcept -> bool {
+		if (vec1.dimensions() != vec2.dimensions()) {
+			return false;
+		}
+		if constexpr (contiguous_euclidean_vector<L> and contiguous_euclidean_vector<R>
+		              and std::same_as<detail::value_type_t<L>, detail::value_type_t<R>>)
+		{
+			return detail::approx_equal(vec1.data(),
+			                            vec2.data(),
+			                            static_cast<std::size_t>(vec1.dimensions()),
+			                            1e-6,
+			                            0.0);
+		}
+		// Otherwise each side is evaluated a block at a time, in its own element type, and the blocks
+		// are compared in the element type they share, or as doubles.
+		using left = detail::value_type_t<L>;
+		using right = detail::value_type_t<R>;
+		using common = std::conditional_t<std::same_as<left, right>, left, double>;
+		constexpr auto block = 64;
+		auto lhs = std::array<common, block>{};
+		auto rhs = std::array<common, block>{};
+		auto const dimensions = vec1.dimensions();
+		for (auto first = 0; first < dimensions; first += block) {
+			auto const size = std::min(block, dimensions - first);
+			for (auto i = 0; i < size; ++i) {
+				auto const value1 = kernels::narrow<left>(detail::element(vec1, first + i));
+				auto const value2 = kernels::narrow<right>(detail::element(vec2, first + i));
+				lhs[static_cast<std::size_t>(i)] = static_cast<common>(value1);
+				rhs[static_cast<std::size_t>(i)] = static_cast<common>(value2);
+			}
+			if (not detail::approx_equal(lhs.data(),
+			                             rhs.data(),
+			                             static_cast<std::size_t>(size),
+			                             1e-6,
+			                             0.0))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	template<euclidean_vector_operand L, euclidean_vector_operand R>
+	requires(not(detail::is_euclidean_vector<L> and std::same_as<L, R>))
+	auto operator!=(L const& vec1, R const& vec2) noexcept -> bool {
+		return not(vec1 == vec2);
+	}
+
+	template<euclidean_vector_operand V>
+	requires(not detail::is_euclidean_vector<V>)
+	auto operator<<(std::ostream& os, V const& vec) -> std::ostream& {
+		if constexpr (contiguous_euclidean_vector<V>) {
+			detail::format_magnitudes(vec.data(),
+			                          static_cast<std::size_t>(vec.dimensions()),
+			                          [&os](char const* first, char const* last) {
+				                          os.write(first, last - first);
+			                          });
+			return os;
+		}
+		else {
+			return os << basic_euclidean_vector<detail::value_type_t<V>>(vec);
+		}
+	}
+
+	// The most characters that to_chars writes for a vector of `dimensions` magnitudes of type T
+	template<euclidean_vector_value T>
+	constexpr auto max_formatted_size(int dimensions) noexcept -> std::size_t {
+		return 2 + static_cast<std::size_t>(dimensions) * (detail::max_magnitude_chars<T> + 1);
+	}
+
+	// Writes the same "[x0 x1 ...]" text as operator<< into [first, last), without allocating. Like
+	// std::to_chars, returns {last, std::errc::value_too_large} if the buffer is too small, in which
+	// case its contents are unspecified.
+	template<contiguous_euclidean_vector V>
+	auto to_chars(char* first, char* last, V const& vec) noexcept -> std::to_chars_result {
+		return detail::write_magnitudes(first,
+		                                last,
+		                                vec.data(),
+		                                static_cast<std::size_t>(vec.dimensions()));
+	}
+
+	// Parses "[x0 x1 ...]" as written by to_chars or operator<<, with any number of spaces between
+	// magnitudes, into `vec`. On failure `vec` is unchanged and, like std::from_chars, the result
+	// holds std::errc::invalid_argument, or std::errc::result_out_of_range for a magnitude that does
+	// not fit in T, and points at the offending character.
+	template<euclidean_vector_value T>
+	auto from_chars(char const* first, char const* last, basic_euclidean_vector<T>& vec)
+	   -> std::from_chars_result {
+		auto const skip_spaces = [last](char const* p) {
+			while (p != last and *p == ' ') {
+				++p;
+			}
+			return p;
+		};
+		if (first == last or *first != '[') {
+			return {first, std::errc::invalid_argument};
+		}
+		auto magnitudes = std::vector<T>();
+		auto p = skip_spaces(first + 1);
+		while (p != last and *p != ']') {
+			auto magnitude = T{};
+			auto const result = std::from_chars(p, last, magnitude);
+			if (result.ec != std::errc()) {
+				return {p, result.ec};
+			}
+			magnitudes.push_back(magnitude);
+			p = skip_spaces(result.ptr);
+			if (p == result.ptr and p != last and *p != ']') {
+				return {p, std::errc::invalid_argument};
+			}
+		}
+		if (p == last) {
+			return {p, std::errc::invalid_argument};
+		}
+		vec = basic_euclidean_vector<T>(std::move(magnitudes));
+		return {p + 1, std::errc()};
+	}
+
+	// Utility functions for non-owning vectors, which have no cached norm, and for expressions,
+	// which are evaluated first.
+	template<euclidean_vector_operand V>
+	requires(not detail::is_euclidean_vector<V>)
+	auto euclidean_norm(V const& v) noexcept -> double {
+		if constexpr (euclidean_vector_expression<V>) {
+			return euclidean_norm(basic_euclidean_vector<detail::value_type_t<V>>(v));
+		}
+		else {
+			auto const size = static_cast<std::size_t>(v.dimensions());
+			return size == 0 ? 0 : std::sqrt(detail::inner_product(v.data(), v.data(), size));
+		}
+	}
+
+	template<euclidean_vector_operand V>
+	requires(not detail::is_euclidean_vector<V>)
+	auto unit(V const& v) -> basic_euclidean_vector<detail::value_type_t<V>> {
+		if constexpr (euclidean_vector_expression<V>) {
+			return unit(basic_euclidean_vector<detail::value_type_t<V>>(v));
+		}
+		else {
+			auto const norm = euclidean_norm(v);
+			check_unit_vector_exists(v.dimensions(), norm);
+			return v / norm;
+		}
+	}
+
+	template<contiguous_euclidean_vector X, contiguous_euclidean_vector Y>
+	requires(not(detail::is_euclidean_vector<X> and std::same_as<X, Y>))
+	        and std::same_as<detail::value_type_t<X>, detail::value_type_t<Y>>
+	auto euclidean_inner_product(X const& vec1, Y const& vec2) noexcept -> double {
+		return detail::inner_product(vec1.data(),
+		                             vec2.data(),
+		                             static_cast<std::size_t>(vec1.dimensions()));
+	}
+
+	template<contiguous_euclidean_vector X, contiguous_euclidean_vector Y>
+	requires(not(detail::is_euclidean_vector<X> and std::same_as<X, Y>))
+	        and std::same_as<detail::value_type_t<X>, detail::value_type_t<Y>>
+	auto dot(X const& x, Y const& y) -> double {
+		check_dimensions_equal(x.dimensions(), y.dimensions());
+		return detail::inner_product(x.data(), y.data(), static_cast<std::size_t>(x.dimensions()));
+	}
+
+	// Comparison with a chosen tolerance: each pair of magnitudes must be equal or within
+	// max(abs_tol, rel_tol * max(|x[i]|, |y[i]|)) of each other. operator== is
+	// approx_equal(x, y, 1e-6, 0). NaNs are never approximately equal.
+	template<contiguous_euclidean_vector X, contiguous_euclidean_vector Y>
+	requires std::same_as<detail::value_type_t<X>, detail::value_type_t<Y>>
+	auto approx_equal(X const& x, Y const& y, double abs_tol = 1e-6, double rel_tol = 0) noexcept
+	   -> bool {
+		return x.dimensions() == y.dimensions()
+		       and detail::approx_equal(x.data(),
+		                                y.data(),
+		                                static_cast<std::size_t>(x.dimensions()),
+		                                abs_tol,
+		                                rel_tol);
+	}
+
+	// Bitwise comparison of the magnitudes, e.g. for deduplication and cache keys: 0.0 and -0.0
+	// differ, and NaNs with the same bits are equal.
+	template<contiguous_euclidean_vector X, contiguous_euclidean_vector Y>
+	requires std::same_as<detail::value_type_t<X>, detail::value_type_t<Y>>
+	auto exact_equal(X const& x, Y const& y) noexcept -> bool {
+		auto const size = static_cast<std::size_t>(x.dimensions());
+		return x.dimensions() == y.dimensions()
+		       and (size == 0
+		            or std::memcmp(x.data(), y.data(), size * sizeof(detail::value_type_t<X>)) == 0);
+	}
+
+	template<typename T, typename Compute>
+	auto detail::cached_norm(basic_euclidean_vector<T> const& vec, Compute const& compute)
+	   -> double {
+		if (auto const cached = vec.norm_.load(); cached >= 0) {
+			return cached;
+		}
+		auto const norm = compute();
+		vec.norm_.store(norm);
+		return norm;
+	}
+
+	// Template member definitions
+	template<typename Derived, typename T>
+	vector_expression<Derived, T>::operator std::vector<T>() const {
+		auto const& expr = static_cast<Derived const&>(*this);
+		auto vec = std::vector<T>(static_cast<std::size_t>(expr.dimensions()));
+		detail::evaluate(expr, vec.data());
+		return vec;
+	}
+
+	template<typename Derived, typename T>
+	vector_expression<Derived, T>::operator std::list<T>() const {
+		return static_cast<std::list<T>>(
+		   basic_euclidean_vector<T>(static_cast<Derived const&>(*this)));
+	}
+
+	template<euclidean_vector_value T>
+	template<std::input_iterator I, std::sentinel_for<I> S>
+	requires detail::magnitude_source<std::iter_value_t<I>, T>
+	basic_euclidean_vector<T>::basic_euclidean_vector(I first,
+	                                                  S last,
+	                                                  std::pmr::memory_resource* resource)
+	: basic_euclidean_vector(uninitialized_t{}, detail::initial_dimensions(first, last), resource) {
+		if constexpr (std::forward_iterator<I> or std::sized_sentinel_for<S, I>) {
+			detail::convert_copy(std::move(first),
+			                     std::move(last),
+			                     data(),
+			                     static_cast<std::size_t>(dimensions_));
+		}
+		else {
+			append(std::move(first), std::move(last));
+		}
+	}
+
+	template<euclidean_vector_value T>
+	template<std::ranges::input_range R>
+	requires detail::magnitude_source<std::ranges::range_value_t<R>, T>
+	         and (not contiguous_euclidean_vector<R>)
+	basic_euclidean_vector<T>::basic_euclidean_vector(R&& range, std::pmr::memory_resource* resource)
+	: basic_euclidean_vector(std::ranges::begin(range), std::ranges::end(range), resource) {}
+
+	template<euclidean_vector_value T>
+	template<typename I, typename S>
+	auto basic_euclidean_vector<T>::append(I first, S last) -> void {
+		auto capacity = std::max(dimensions_, inline_capacity);
+		for (; first != last; ++first) {
+			if (dimensions_ == capacity) {
+				capacity = std::max(2 * capacity, 8);
+				auto grown = allocate(capacity, resource());
+				std::copy(data(), data() + dimensions_, grown.get());
+				magnitude_ = std::move(grown);
+			}
+			data()[dimensions_] = kernels::narrow<T>(*first);
+			++dimensions_;
+		}
+	}
+
+	template<euclidean_vector_value T>
+	template<euclidean_vector_expression E>
+	requires std::same_as<detail::value_type_t<E>, T>
+	basic_euclidean_vector<T>::basic_euclidean_vector(E const& expr,
+	                                                  std::pmr::memory_resource* resource)
+	: basic_euclidean_vector(uninitialized_t{}, expr.dimensions(), resource) {
+		detail::evaluate(expr, data());
+	}
+
+	// Each element only depends on the same index of its operands, so evaluating into an operand is
+	// safe.
+	template<euclidean_vector_value T>
+	template<euclidean_vector_expression E>
+	requires std::same_as<detail::value_type_t<E>, T>
+	         and std::same_as<E, std::remove_cvref_t<E>>
+	basic_euclidean_vector<T>::basic_euclidean_vector(E&& expr, std::pmr::memory_resource* resource)
+	: basic_euclidean_vector([&expr, resource] {
+		auto* const operand = expr.expiring_operand();
+		if (operand == nullptr or operand->resource() != resource) {
+			return basic_euclidean_vector(std::as_const(expr), resource);
+		}
+		detail::evaluate(expr, operand->data());
+		return std::move(*operand);
+	}()) {}
+
+	template<euclidean_vector_value T>
+	template<contiguous_euclidean_vector V>
+	requires(not std::same_as<V, basic_euclidean_vector<T>>)
+	basic_euclidean_vector<T>::basic_euclidean_vector(V const& vec,
+	                                                  std::pmr::memory_resource* resource)
+	: basic_euclidean_vector(uninitialized_t{}, vec.dimensions(), resource) {
+		std::transform(vec.data(), vec.data() + dimensions_, data(), [](auto const val) {
+			return kernels::narrow<T>(val);
+		});
+	}
+
+	template<euclidean_vector_value T>
+	template<euclidean_vector_expression E>
+	requires std::same_as<detail::value_type_t<E>, T>
+	auto basic_euclidean_vector<T>::operator=(E const& expr) -> basic_euclidean_vector& {
+		// Each element only depends on the same index of its operands, so evaluating in place is
+		// safe even when *this appears in the expression.
+		if (expr.dimensions() != dimensions_) {
+			return *this = basic_euclidean_vector(expr, resource());
+		}
+		detail::evaluate(expr, data());
+		return *this;
+	}
+
+	template<euclidean_vector_value T>
+	template<euclidean_vector_expression E>
+	requires std::same_as<detail::value_type_t<E>, T>
+	auto basic_euclidean_vector<T>::operator+=(E const& expr) -> basic_euclidean_vector& {
+		return *this = *this + expr;
+	}
+
+	template<euclidean_vector_value T>
+	template<euclidean_vector_expression E>
+	requires std::same_as<detail::value_type_t<E>, T>
+	auto basic_euclidean_vector<T>::operator-=(E const& expr) -> basic_euclidean_vector& {
+		return *this = *this - expr;
+	}
+
+	// Defined in euclidean_vector.cpp for every element type
+	extern template class basic_euclidean_vector<double>;
+	extern template class basic_euclidean_vector<float>;
+	extern template class basic_euclidean_vector<std::int16_t>;
+	extern template class basic_euclidean_vector<std::int8_t>;
 } // namespace comp6771
+
 #endif // COMP6771_EUCLIDEAN_VECTOR_HPP
@@ -0,0 +1,106 @@
+#ifndef COMP6771_EUCLIDEAN_VECTOR_BATCH_HPP
+#define COMP6771_EUCLIDEAN_VECTOR_BATCH_HPP
+
+#include <comp6771/euclidean_vector.hpp>
+#include <comp6771/euclidean_vector_view.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <vector>
+
+namespace comp6771 {
+	// Many euclidean vectors of equal dimension stored row-major in one allocation.
+	// The first row starts on a 64-byte boundary. Only with row_padding::cache_line is every row
+	// padded with zeros to a whole number of cache lines, so that each row starts on a cache line
+	// and no row shares one with its neighbours.
+	// Rows are handed out as views into the batch's storage.
+	template<euclidean_vector_value T>
+	class basic_euclidean_vector_batch {
+	public:
+		using value_type = T;
+		using row_type = basic_euclidean_vector_view<T>;
+		using const_row_type = basic_euclidean_vector_view<T const>;
+
+		enum class row_padding { none, cache_line };
+
+		static constexpr auto alignment = std::size_t{64};
+
+		// Constructors
+		basic_euclidean_vector_batch();
+
+		basic_euclidean_vector_batch(int rows,
+		                             int dimensions,
+		                             row_padding padding = row_padding::none);
+
+		explicit basic_euclidean_vector_batch(std::vector<basic_euclidean_vector<T>> const& vectors,
+		                                      row_padding padding = row_padding::none);
+
+		// Rule of 5!
+		basic_euclidean_vector_batch(basic_euclidean_vector_batch const& orig);
+		basic_euclidean_vector_batch(basic_euclidean_vector_batch&& orig) noexcept;
+		~basic_euclidean_vector_batch() = default;
+		auto operator=(basic_euclidean_vector_batch const& orig) -> basic_euclidean_vector_batch&;
+		auto operator=(basic_euclidean_vector_batch&& orig) noexcept -> basic_euclidean_vector_batch&;
+
+		// Operations
+		auto operator[](int row) noexcept -> row_type {
+			return {data() + offset(row), dimensions_};
+		}
+		auto operator[](int row) const noexcept -> const_row_type {
+			return {data() + offset(row), dimensions_};
+		}
+
+		// Member functions
+		[[nodiscard]] auto at(int row) -> row_type;
+		[[nodiscard]] auto at(int row) const -> const_row_type;
+
+		[[nodiscard]] auto rows() const noexcept -> int;
+		[[nodiscard]] auto dimensions() const noexcept -> int;
+		// Distance in elements between the starts of consecutive rows
+		[[nodiscard]] auto stride() const noexcept -> int;
+
+		[[nodiscard]] auto data() const noexcept -> T const* {
+			return magnitude_.get();
+		}
+		[[nodiscard]] auto data() noexcept -> T* {
+			return magnitude_.get();
+		}
+
+		// Batched kernels, processing every row in one call
+		[[nodiscard]] auto euclidean_norms() const -> std::vector<double>;
+		[[nodiscard]] auto dot(const_row_type query) const -> std::vector<double>;
+		// Scales every row to unit length. Throws, leaving the batch untouched, if any row has no
+		// unit vector.
+		auto normalise() -> void;
+
+	private:
+		struct aligned_deleter {
+			auto operator()(T* magnitude) const noexcept -> void {
+				::operator delete[](magnitude, std::align_val_t{alignment});
+			}
+		};
+
+		[[nodiscard]] auto offset(int row) const noexcept -> std::size_t {
+			return static_cast<std::size_t>(row) * static_cast<std::size_t>(stride_);
+		}
+
+		auto check_row_valid(int row) const -> void;
+
+		int rows_;
+		int dimensions_;
+		int stride_;
+		// NOLINTNEXTLINE(modernize-avoid-c-arrays)
+		std::unique_ptr<T[], aligned_deleter> magnitude_;
+	};
+
+	using euclidean_vector_batch = basic_euclidean_vector_batch<double>;
+
+	// Defined in euclidean_vector_batch.cpp for every element type
+	extern template class basic_euclidean_vector_batch<double>;
+	extern template class basic_euclidean_vector_batch<float>;
+	extern template class basic_euclidean_vector_batch<std::int16_t>;
+	extern template class basic_euclidean_vector_batch<std::int8_t>;
+} // namespace comp6771
+
+#endif // COMP6771_EUCLIDEAN_VECTOR_BATCH_HPP
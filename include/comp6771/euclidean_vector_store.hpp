@@ -0,0 +1,166 @@
+#ifndef COMP6771_EUCLIDEAN_VECTOR_STORE_HPP
+#define COMP6771_EUCLIDEAN_VECTOR_STORE_HPP
+
+#include <comp6771/euclidean_vector.hpp>
+#include <comp6771/euclidean_vector_view.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace comp6771 {
+	// A file of euclidean vectors with equal dimensions, mapped into memory rather than read onto
+	// the heap, for datasets larger than is comfortable to load. Rows are handed out as read-only
+	// views into the mapping, so they work with every operator and utility function, and pages are
+	// only read from disk when a row is touched.
+	//
+	// The file is a 64-byte header followed by the rows back to back:
+	//
+	//    offset  size  field
+	//         0     4  magic "EVST"
+	//         4     1  format version, currently 1
+	//         5     1  element type, as in the binary record format
+	//         6     1  byte order of the magnitudes: 0 little-endian, 1 big-endian
+	//         8     4  dimensions, little-endian
+	//        12     4  stride, the distance in elements between row starts, little-endian
+	//        16     8  rows, little-endian
+	//
+	// Every other header byte is zero. The first row starts 64 bytes into the file, so with
+	// row_padding::cache_line every row starts on a cache line.
+	//
+	// Stores are written with basic_euclidean_vector_store_writer and map the rows that were in the
+	// file when they were opened.
+	template<euclidean_vector_value T>
+	class basic_euclidean_vector_store {
+	public:
+		using value_type = T;
+		using row_type = basic_euclidean_vector_view<T const>;
+
+		enum class row_padding { none, cache_line };
+
+		// How rows are about to be read, passed on to the kernel with madvise(2)
+		enum class access_pattern { normal, sequential, random, will_need };
+
+		static constexpr auto header_size = std::size_t{64};
+
+		// Constructors
+		// Maps the store at `path`. Throws std::system_error if it cannot be opened or mapped, and
+		// euclidean_vector_error if it is not a store of T in native byte order or is truncated.
+		explicit basic_euclidean_vector_store(std::string const& path);
+
+		// Rule of 5!
+		basic_euclidean_vector_store(basic_euclidean_vector_store const&) = delete;
+		basic_euclidean_vector_store(basic_euclidean_vector_store&& orig) noexcept;
+		~basic_euclidean_vector_store() = default;
+		auto operator=(basic_euclidean_vector_store const&) -> basic_euclidean_vector_store& = delete;
+		auto operator=(basic_euclidean_vector_store&& orig) noexcept -> basic_euclidean_vector_store&;
+
+		// Operations
+		auto operator[](int row) const noexcept -> row_type {
+			return {data() + offset(row), dimensions_};
+		}
+
+		// Member functions
+		[[nodiscard]] auto at(int row) const -> row_type;
+
+		[[nodiscard]] auto rows() const noexcept -> int;
+		[[nodiscard]] auto dimensions() const noexcept -> int;
+		// Distance in elements between the starts of consecutive rows
+		[[nodiscard]] auto stride() const noexcept -> int;
+
+		[[nodiscard]] auto data() const noexcept -> T const* {
+			return mapping_ ? reinterpret_cast<T const*>(mapping_.get() + header_size) : nullptr;
+		}
+
+		auto advise(access_pattern pattern) const -> void;
+
+	private:
+		struct unmapper {
+			std::size_t size_ = 0;
+			auto operator()(std::byte const* address) const noexcept -> void;
+		};
+
+		[[nodiscard]] auto offset(int row) const noexcept -> std::size_t {
+			return static_cast<std::size_t>(row) * static_cast<std::size_t>(stride_);
+		}
+
+		auto check_row_valid(int row) const -> void;
+
+		int rows_ = 0;
+		int dimensions_ = 0;
+		int stride_ = 0;
+		std::unique_ptr<std::byte const, unmapper> mapping_;
+	};
+
+	// Appends rows to a store, creating it if the file does not exist. Rows are buffered and
+	// written by flush(), which then updates the row count in the header, so a store opened while
+	// rows are being appended only ever sees whole rows.
+	template<euclidean_vector_value T>
+	class basic_euclidean_vector_store_writer {
+	public:
+		using value_type = T;
+		using row_padding = typename basic_euclidean_vector_store<T>::row_padding;
+
+		// Constructors
+		// Opens the store at `path` for appending. A new store gets `dimensions` and `padding`; an
+		// existing one must hold T and have `dimensions`, and keeps its own padding. Throws
+		// std::system_error if the file cannot be opened, and euclidean_vector_error if it is not a
+		// matching store.
+		basic_euclidean_vector_store_writer(std::string const& path,
+		                                    int dimensions,
+		                                    row_padding padding = row_padding::none);
+
+		// Rule of 5!
+		basic_euclidean_vector_store_writer(basic_euclidean_vector_store_writer const&) = delete;
+		basic_euclidean_vector_store_writer(basic_euclidean_vector_store_writer&& orig) noexcept;
+		// Flushes, ignoring errors; call flush() first to see them.
+		~basic_euclidean_vector_store_writer();
+		auto operator=(basic_euclidean_vector_store_writer const&)
+		   -> basic_euclidean_vector_store_writer& = delete;
+		auto operator=(basic_euclidean_vector_store_writer&& orig) noexcept
+		   -> basic_euclidean_vector_store_writer&;
+
+		// Member functions
+		// Appends a copy of `vec`, which must have the store's dimensions.
+		template<contiguous_euclidean_vector V>
+		requires std::same_as<detail::value_type_t<V>, T>
+		auto append(V const& vec) -> void {
+			append(vec.data(), vec.dimensions());
+		}
+
+		// Writes the buffered rows and updates the header. Throws std::system_error on failure.
+		auto flush() -> void;
+
+		// Rows in the store, including those not yet flushed
+		[[nodiscard]] auto rows() const noexcept -> int;
+		[[nodiscard]] auto dimensions() const noexcept -> int;
+		[[nodiscard]] auto stride() const noexcept -> int;
+
+	private:
+		auto append(T const* magnitudes, int dimensions) -> void;
+		auto close() noexcept -> void;
+
+		int fd_ = -1;
+		int rows_ = 0;
+		int flushed_rows_ = 0;
+		int dimensions_ = 0;
+		int stride_ = 0;
+		std::vector<T> pending_;
+	};
+
+	using euclidean_vector_store = basic_euclidean_vector_store<double>;
+	using euclidean_vector_store_writer = basic_euclidean_vector_store_writer<double>;
+
+	// Defined in euclidean_vector_store.cpp for every element type
+	extern template class basic_euclidean_vector_store<double>;
+	extern template class basic_euclidean_vector_store<float>;
+	extern template class basic_euclidean_vector_store<std::int16_t>;
+	extern template class basic_euclidean_vector_store<std::int8_t>;
+	extern template class basic_euclidean_vector_store_writer<double>;
+	extern template class basic_euclidean_vector_store_writer<float>;
+	extern template class basic_euclidean_vector_store_writer<std::int16_t>;
+	extern template class basic_euclidean_vector_store_writer<std::int8_t>;
+} // namespace comp6771
+
+#endif // COMP6771_EUCLIDEAN_VECTOR_STORE_HPP
@@ -0,0 +1,194 @@
+#ifndef COMP6771_EUCLIDEAN_VECTOR_VIEW_HPP
+#define COMP6771_EUCLIDEAN_VECTOR_VIEW_HPP
+
+#include <comp6771/euclidean_vector.hpp>
+#include <comp6771/kernels.hpp>
+#include <concepts>
+#include <cstddef>
+#include <list>
+#include <ranges>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace comp6771 {
+	// A non-owning euclidean vector over memory the caller already owns: a std::vector<double>, a
+	// mapped file, a network buffer, a euclidean_vector or a row of a euclidean_vector_batch.
+	// It works with all operators and utility functions without copying the magnitudes.
+	//
+	// `T` is the element type, e.g. `double` for a mutable view and `double const` for a read-only
+	// one. Like std::span,
+	// copying or assigning a view rebinds it rather than copying magnitudes; use assign() to write
+	// through it. Creating a mutable view of a euclidean_vector drops that vector's cached norm, as
+	// data() does, so keep such views short-lived.
+	template<typename T>
+	class basic_euclidean_vector_view;
+
+	namespace detail {
+		template<typename T>
+		inline constexpr auto is_euclidean_vector_view = false;
+
+		template<typename T>
+		inline constexpr auto is_euclidean_vector_view<basic_euclidean_vector_view<T>> = true;
+	} // namespace detail
+
+	template<typename T>
+	class basic_euclidean_vector_view {
+	public:
+		static_assert(euclidean_vector_value<std::remove_const_t<T>>);
+
+		using value_type = std::remove_const_t<T>;
+
+		// Constructors
+		basic_euclidean_vector_view() noexcept = default;
+
+		// NOLINTNEXTLINE(google-explicit-constructor)
+		basic_euclidean_vector_view(std::span<T> magnitude) noexcept
+		: magnitude_{magnitude} {}
+
+		basic_euclidean_vector_view(T* magnitude, int dimensions) noexcept
+		: magnitude_{magnitude, static_cast<std::size_t>(dimensions)} {}
+
+		// Any contiguous range of magnitudes, e.g. std::vector<double> or std::array<float, N>
+		template<std::ranges::contiguous_range R>
+		requires std::convertible_to<R&, std::span<T>>
+		         and (not detail::is_euclidean_vector_view<std::remove_cv_t<R>>)
+		explicit basic_euclidean_vector_view(R& range) noexcept
+		: magnitude_{range} {}
+
+		// NOLINTNEXTLINE(google-explicit-constructor)
+		basic_euclidean_vector_view(basic_euclidean_vector<value_type>& vec) noexcept
+		: basic_euclidean_vector_view(vec.data(), vec.dimensions()) {}
+
+		// NOLINTNEXTLINE(google-explicit-constructor)
+		basic_euclidean_vector_view(basic_euclidean_vector<value_type> const& vec) noexcept
+		   requires std::is_const_v<T>
+		: basic_euclidean_vector_view(vec.data(), vec.dimensions()) {}
+
+		// A mutable view converts to a read-only one
+		// NOLINTNEXTLINE(google-explicit-constructor)
+		operator basic_euclidean_vector_view<T const>() const noexcept
+		   requires(not std::is_const_v<T>) {
+			return {data(), dimensions()};
+		}
+
+		// Operations
+		auto operator[](int index) const noexcept -> T& {
+			return magnitude_[static_cast<std::size_t>(index)];
+		}
+
+		template<euclidean_vector_operand V>
+		requires(not std::is_const_v<T>) and std::same_as<detail::value_type_t<V>, value_type>
+		auto operator+=(V const& vec) const
+		   -> basic_euclidean_vector_view {
+			check_dimensions_equal(dimensions(), vec.dimensions());
+			if constexpr (contiguous_euclidean_vector<V>) {
+				kernels::add(data(), vec.data(), magnitude_.size());
+			}
+			else {
+				detail::evaluate(*this + vec, data());
+			}
+			return *this;
+		}
+
+		template<euclidean_vector_operand V>
+		requires(not std::is_const_v<T>) and std::same_as<detail::value_type_t<V>, value_type>
+		auto operator-=(V const& vec) const
+		   -> basic_euclidean_vector_view {
+			check_dimensions_equal(dimensions(), vec.dimensions());
+			if constexpr (contiguous_euclidean_vector<V>) {
+				kernels::subtract(data(), vec.data(), magnitude_.size());
+			}
+			else {
+				detail::evaluate(*this - vec, data());
+			}
+			return *this;
+		}
+
+		auto operator*=(double scalar) const noexcept -> basic_euclidean_vector_view
+		requires(not std::is_const_v<T>) {
+			kernels::multiply(data(),
+			                  static_cast<detail::scalar_t<value_type>>(scalar),
+			                  magnitude_.size());
+			return *this;
+		}
+
+		auto operator/=(double scalar) const -> basic_euclidean_vector_view
+		requires(not std::is_const_v<T>) {
+			check_divisor_valid(scalar);
+			kernels::divide(data(),
+			                static_cast<detail::scalar_t<value_type>>(scalar),
+			                magnitude_.size());
+			return *this;
+		}
+
+		explicit operator std::vector<value_type>() const {
+			return std::vector<value_type>(begin(), end());
+		}
+
+		explicit operator std::list<value_type>() const {
+			return std::list<value_type>(begin(), end());
+		}
+
+		// Member functions
+		[[nodiscard]] auto at(int index) const -> T& {
+			if (index < 0 or index >= dimensions()) {
+				throw euclidean_vector_error("Index " + std::to_string(index)
+				                             + " is not valid for this "
+				                               "euclidean_vector_view object");
+			}
+			return (*this)[index];
+		}
+
+		[[nodiscard]] auto dimensions() const noexcept -> int {
+			return static_cast<int>(magnitude_.size());
+		}
+
+		[[nodiscard]] auto data() const noexcept -> T* {
+			return magnitude_.data();
+		}
+
+		[[nodiscard]] auto span() const noexcept -> std::span<T> {
+			return magnitude_;
+		}
+
+		[[nodiscard]] auto begin() const noexcept -> T* {
+			return data();
+		}
+
+		[[nodiscard]] auto end() const noexcept -> T* {
+			return data() + magnitude_.size();
+		}
+
+		// Writes the magnitudes of `vec`, which must have the same dimensions, into the viewed
+		// memory.
+		template<euclidean_vector_operand V>
+		requires(not std::is_const_v<T>) and std::same_as<detail::value_type_t<V>, value_type>
+		auto assign(V const& vec) const
+		   -> basic_euclidean_vector_view {
+			check_dimensions_equal(dimensions(), vec.dimensions());
+			if constexpr (contiguous_euclidean_vector<V>) {
+				std::copy(vec.data(), vec.data() + dimensions(), data());
+			}
+			else {
+				detail::evaluate(vec, data());
+			}
+			return *this;
+		}
+
+	private:
+		std::span<T> magnitude_;
+	};
+
+	using euclidean_vector_view = basic_euclidean_vector_view<double>;
+	using const_euclidean_vector_view = basic_euclidean_vector_view<double const>;
+
+	template<typename T>
+	basic_euclidean_vector_view(basic_euclidean_vector<T>&)->basic_euclidean_vector_view<T>;
+	template<typename T>
+	basic_euclidean_vector_view(basic_euclidean_vector<T> const&)
+	   ->basic_euclidean_vector_view<T const>;
+} // namespace comp6771
+
+#endif // COMP6771_EUCLIDEAN_VECTOR_VIEW_HPP
@@ -0,0 +1,242 @@
+#ifndef COMP6771_FIXED_EUCLIDEAN_VECTOR_HPP
+#define COMP6771_FIXED_EUCLIDEAN_VECTOR_HPP
+
+#include <array>
+#include <cmath>
+#include <comp6771/euclidean_vector.hpp>
+#include <comp6771/kernels.hpp>
+#include <concepts>
+#include <cstddef>
+#include <list>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace comp6771 {
+	namespace detail {
+		// Calls op(0), op(1), ..., op(N - 1) with no loop left at run time.
+		template<int N, typename Op>
+		constexpr auto unroll(Op&& op) -> void {
+			[&op]<std::size_t... I>(std::index_sequence<I...>) {
+				(op(I), ...);
+			}(std::make_index_sequence<static_cast<std::size_t>(N)>{});
+		}
+	} // namespace detail
+
+	// A euclidean vector whose number of dimensions is part of its type, for 2, 3 and 4 dimensional
+	// geometry. Magnitudes live inside the object and every loop is unrolled at compile time. Mixing
+	// dimensions does not compile, so nothing is checked at run time.
+	//
+	// It has the same operators and utility functions as euclidean_vector. Arithmetic between fixed
+	// vectors is evaluated eagerly and, for float and double, everything except euclidean_norm() and
+	// unit() is constexpr. Mixing with euclidean_vector gives the usual lazy expressions. Converting
+	// either way is explicit and copies each magnitude once; vectors of up to inline_capacity
+	// dimensions convert without allocating.
+	template<int N, euclidean_vector_value T = double>
+	class fixed_euclidean_vector {
+	public:
+		static_assert(N >= 0);
+
+		using value_type = T;
+
+		// Constructors
+		constexpr fixed_euclidean_vector() noexcept = default;
+
+		template<std::convertible_to<T>... Ts>
+		requires(sizeof...(Ts) == N and N > 0)
+		constexpr fixed_euclidean_vector(Ts... magnitudes) noexcept
+		: magnitude_{static_cast<T>(magnitudes)...} {}
+
+		constexpr explicit fixed_euclidean_vector(
+		   std::array<T, static_cast<std::size_t>(N)> const& magnitudes) noexcept
+		: magnitude_{magnitudes} {}
+
+		// Copies a euclidean_vector, view or expression, which must have N dimensions.
+		template<euclidean_vector_operand V>
+		requires(not std::same_as<V, fixed_euclidean_vector>) explicit fixed_euclidean_vector(
+		   V const& vec) {
+			check_dimensions_equal(N, vec.dimensions());
+			detail::unroll<N>([&](std::size_t i) {
+				magnitude_[i] = kernels::narrow<T>(detail::element(vec, static_cast<int>(i)));
+			});
+		}
+
+		// Operations
+		constexpr auto operator[](int index) const noexcept -> T {
+			return magnitude_[static_cast<std::size_t>(index)];
+		}
+		constexpr auto operator[](int index) noexcept -> T& {
+			return magnitude_[static_cast<std::size_t>(index)];
+		}
+
+		constexpr auto operator+=(fixed_euclidean_vector const& other) noexcept
+		   -> fixed_euclidean_vector& {
+			detail::unroll<N>([&](std::size_t i) {
+				magnitude_[i] = kernels::narrow<T>(magnitude_[i] + other.magnitude_[i]);
+			});
+			return *this;
+		}
+
+		constexpr auto operator-=(fixed_euclidean_vector const& other) noexcept
+		   -> fixed_euclidean_vector& {
+			detail::unroll<N>([&](std::size_t i) {
+				magnitude_[i] = kernels::narrow<T>(magnitude_[i] - other.magnitude_[i]);
+			});
+			return *this;
+		}
+
+		constexpr auto operator*=(double scalar) noexcept -> fixed_euclidean_vector& {
+			auto const factor = static_cast<detail::scalar_t<T>>(scalar);
+			detail::unroll<N>(
+			   [&](std::size_t i) { magnitude_[i] = kernels::narrow<T>(magnitude_[i] * factor); });
+			return *this;
+		}
+
+		constexpr auto operator/=(double scalar) -> fixed_euclidean_vector& {
+			if (scalar == 0) {
+				throw euclidean_vector_error("Invalid vector division by 0");
+			}
+			auto const divisor = static_cast<detail::scalar_t<T>>(scalar);
+			detail::unroll<N>(
+			   [&](std::size_t i) { magnitude_[i] = kernels::narrow<T>(magnitude_[i] / divisor); });
+			return *this;
+		}
+
+		explicit operator std::vector<T>() const {
+			return std::vector<T>(magnitude_.begin(), magnitude_.end());
+		}
+
+		explicit operator std::list<T>() const {
+			return std::list<T>(magnitude_.begin(), magnitude_.end());
+		}
+
+		// Member functions
+		[[nodiscard]] constexpr auto at(int index) const -> T {
+			check_index(index);
+			return (*this)[index];
+		}
+
+		constexpr auto at(int index) -> T& {
+			check_index(index);
+			return (*this)[index];
+		}
+
+		[[nodiscard]] static constexpr auto dimensions() noexcept -> int {
+			return N;
+		}
+
+		[[nodiscard]] constexpr auto data() const noexcept -> T const* {
+			return magnitude_.data();
+		}
+		[[nodiscard]] constexpr auto data() noexcept -> T* {
+			return magnitude_.data();
+		}
+
+		// Friends
+		// These take their operands by value so that they are preferred over the lazy operators for
+		// both lvalues and rvalues.
+		// Compared with the same rule as euclidean_vector, applied one magnitude at a time. N is
+		// known, so the unrolled comparison beats a call through the SIMD dispatch table.
+		friend constexpr auto operator==(fixed_euclidean_vector vec1,
+		                                 fixed_euclidean_vector vec2) noexcept -> bool {
+			using compared = detail::scalar_t<T>;
+			auto equal = true;
+			detail::unroll<N>([&](std::size_t i) {
+				equal = equal
+				        and kernels::close(static_cast<compared>(vec1.magnitude_[i]),
+				                           static_cast<compared>(vec2.magnitude_[i]),
+				                           static_cast<compared>(1e-6),
+				                           compared{0});
+			});
+			return equal;
+		}
+
+		friend constexpr auto operator!=(fixed_euclidean_vector vec1,
+		                                 fixed_euclidean_vector vec2) noexcept -> bool {
+			return not(vec1 == vec2);
+		}
+
+		friend constexpr auto operator+(fixed_euclidean_vector vec) noexcept
+		   -> fixed_euclidean_vector {
+			return vec;
+		}
+
+		friend constexpr auto operator-(fixed_euclidean_vector vec) noexcept
+		   -> fixed_euclidean_vector {
+			detail::unroll<N>(
+			   [&](std::size_t i) { vec.magnitude_[i] = kernels::narrow<T>(-vec.magnitude_[i]); });
+			return vec;
+		}
+
+		friend constexpr auto operator+(fixed_euclidean_vector vec1,
+		                                fixed_euclidean_vector vec2) noexcept
+		   -> fixed_euclidean_vector {
+			return vec1 += vec2;
+		}
+
+		friend constexpr auto operator-(fixed_euclidean_vector vec1,
+		                                fixed_euclidean_vector vec2) noexcept
+		   -> fixed_euclidean_vector {
+			return vec1 -= vec2;
+		}
+
+		friend constexpr auto operator*(fixed_euclidean_vector vec, double scalar) noexcept
+		   -> fixed_euclidean_vector {
+			return vec *= scalar;
+		}
+
+		friend constexpr auto operator*(double scalar, fixed_euclidean_vector vec) noexcept
+		   -> fixed_euclidean_vector {
+			return vec *= scalar;
+		}
+
+		friend constexpr auto operator/(fixed_euclidean_vector vec, double scalar)
+		   -> fixed_euclidean_vector {
+			return vec /= scalar;
+		}
+
+	private:
+		constexpr auto check_index(int index) const -> void {
+			if (index < 0 or index >= N) {
+				throw euclidean_vector_error("Index " + std::to_string(index)
+				                             + " is not valid for this "
+				                               "fixed_euclidean_vector object");
+			}
+		}
+
+		std::array<T, static_cast<std::size_t>(N)> magnitude_ = {};
+	};
+
+	// Utility functions. The inner product is summed in double.
+	template<int N, euclidean_vector_value T>
+	constexpr auto euclidean_inner_product(fixed_euclidean_vector<N, T> const& vec1,
+	                                       fixed_euclidean_vector<N, T> const& vec2) noexcept
+	   -> double {
+		auto sum = 0.0;
+		detail::unroll<N>([&](std::size_t i) {
+			auto const index = static_cast<int>(i);
+			sum += static_cast<double>(vec1[index]) * static_cast<double>(vec2[index]);
+		});
+		return sum;
+	}
+
+	template<int N, euclidean_vector_value T>
+	constexpr auto dot(fixed_euclidean_vector<N, T> const& x,
+	                   fixed_euclidean_vector<N, T> const& y) noexcept -> double {
+		return euclidean_inner_product(x, y);
+	}
+
+	template<int N, euclidean_vector_value T>
+	auto euclidean_norm(fixed_euclidean_vector<N, T> const& v) noexcept -> double {
+		return std::sqrt(euclidean_inner_product(v, v));
+	}
+
+	template<int N, euclidean_vector_value T>
+	auto unit(fixed_euclidean_vector<N, T> const& v) -> fixed_euclidean_vector<N, T> {
+		auto const norm = euclidean_norm(v);
+		check_unit_vector_exists(N, norm);
+		return v / norm;
+	}
+} // namespace comp6771
+
+#endif // COMP6771_FIXED_EUCLIDEAN_VECTOR_HPP
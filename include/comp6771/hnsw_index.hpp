@@ -0,0 +1,228 @@
+#ifndef COMP6771_HNSW_INDEX_HPP
+#define COMP6771_HNSW_INDEX_HPP
+
+#include <comp6771/euclidean_vector.hpp>
+#include <comp6771/euclidean_vector_view.hpp>
+#include <comp6771/knn.hpp>
+#include <comp6771/parallel.hpp>
+#include <comp6771/thread_pool.hpp>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace comp6771 {
+	struct hnsw_parameters {
+		// Links per node on every level above 0. Level 0 has twice as many.
+		int m = 16;
+		// Candidates kept while looking for the neighbours of a new node
+		int ef_construction = 200;
+		// Candidates kept while searching, raised to k when k is larger
+		int ef_search = 64;
+		// Seeds the choice of each node's level
+		std::uint32_t seed = 6771;
+	};
+
+	// An approximate nearest neighbour index: a hierarchical navigable small world graph
+	// (Malkov and Yashunin, 2018) over copies of the vectors added to it. Searches greedily descend
+	// the sparse upper levels and then explore the densest one, comparing the query with a small
+	// fraction of the vectors. Larger m, ef_construction and ef_search raise recall at the cost of
+	// memory, build time and search time respectively.
+	//
+	// Indexes are built serially, which is reproducible for a given seed, or in parallel, which is
+	// not. Searching is thread-safe, but adding vectors is not safe while searching.
+	template<euclidean_vector_value T>
+	class basic_hnsw_index {
+	public:
+		using value_type = T;
+		using row_type = basic_euclidean_vector_view<T const>;
+
+		// Constructors
+		// An empty index of vectors with `dimensions`. Throws if the parameters are not positive, or
+		// m is less than 2.
+		explicit basic_hnsw_index(int dimensions,
+		                          metric measure = metric::l2,
+		                          hnsw_parameters parameters = {});
+
+		// An index of every row of `dataset`, which is built serially.
+		template<euclidean_vector_dataset D>
+		requires std::same_as<detail::dataset_value_t<D>, T>
+		explicit basic_hnsw_index(D const& dataset,
+		                          metric measure = metric::l2,
+		                          hnsw_parameters parameters = {})
+		: basic_hnsw_index(static_cast<thread_pool*>(nullptr), dataset, measure, parameters) {}
+
+		// As above, inserting rows in parallel as described in parallel.hpp. Datasets with fewer
+		// than parallel_threshold() magnitudes in total are built serially.
+		template<execution_policy P, euclidean_vector_dataset D>
+		requires std::same_as<detail::dataset_value_t<D>, T>
+		basic_hnsw_index(P&& policy,
+		                 D const& dataset,
+		                 metric measure = metric::l2,
+		                 hnsw_parameters parameters = {})
+		: basic_hnsw_index(detail::pool_for(policy), dataset, measure, parameters) {}
+
+		// Reads an index written by save(). Throws std::system_error if the file cannot be read,
+		// and euclidean_vector_error if it is not an index of T in native byte order.
+		[[nodiscard]] static auto load(std::string const& path) -> basic_hnsw_index;
+
+		// Member functions
+		// Adds a copy of `vec`, which must have the index's dimensions, and returns its index.
+		template<contiguous_euclidean_vector V>
+		requires std::same_as<detail::value_type_t<V>, T>
+		auto add(V const& vec) -> int {
+			append(vec.data(), vec.dimensions());
+			auto const node = size() - 1;
+			build(nullptr, node);
+			return node;
+		}
+
+		// The k nearest vectors to `query` that the index finds, nearest first, with distances as
+		// knn_search() measures them.
+		template<contiguous_euclidean_vector V>
+		requires(not euclidean_vector_dataset<V>) and std::same_as<detail::value_type_t<V>, T>
+		[[nodiscard]] auto search(V const& query, int k) const -> std::vector<neighbour> {
+			check_search(query.dimensions(), k);
+			return search(query.data(), k);
+		}
+
+		// The k nearest vectors for each of `queries`
+		template<euclidean_vector_dataset Q>
+		requires std::same_as<detail::dataset_value_t<Q>, T>
+		[[nodiscard]] auto search(Q const& queries, int k) const
+		   -> std::vector<std::vector<neighbour>> {
+			return search_all(nullptr, queries, k);
+		}
+
+		// As above, searching for each query in parallel.
+		template<execution_policy P, euclidean_vector_dataset Q>
+		requires std::same_as<detail::dataset_value_t<Q>, T>
+		[[nodiscard]] auto search(P&& policy, Q const& queries, int k) const
+		   -> std::vector<std::vector<neighbour>> {
+			return search_all(detail::pool_for(policy), queries, k);
+		}
+
+		// Writes the vectors and the graph to `path`, replacing any file there. Throws
+		// std::system_error on failure.
+		auto save(std::string const& path) const -> void;
+
+		// The vector with index `node`
+		[[nodiscard]] auto operator[](int node) const noexcept -> row_type {
+			return {vectors_.data() + offset(node), dimensions_};
+		}
+
+		[[nodiscard]] auto size() const noexcept -> int;
+		[[nodiscard]] auto dimensions() const noexcept -> int;
+		[[nodiscard]] auto measure() const noexcept -> metric;
+		[[nodiscard]] auto parameters() const noexcept -> hnsw_parameters;
+
+		// Changes the candidates kept while searching. Throws if it is not positive.
+		auto set_ef_search(int ef_search) -> void;
+
+	private:
+		template<euclidean_vector_dataset D>
+		basic_hnsw_index(thread_pool* pool,
+		                 D const& dataset,
+		                 metric measure,
+		                 hnsw_parameters parameters)
+		: basic_hnsw_index(detail::dataset_rows(dataset) == 0
+		                      ? 0
+		                      : detail::dataset_row(dataset, 0).dimensions(),
+		                   measure,
+		                   parameters) {
+			auto const rows = detail::dataset_rows(dataset);
+			reserve(rows);
+			for (auto row = 0; row < rows; ++row) {
+				auto const& vec = detail::dataset_row(dataset, row);
+				append(vec.data(), vec.dimensions());
+			}
+			auto const work = static_cast<std::size_t>(rows) * static_cast<std::size_t>(dimensions_);
+			build(work < parallel_threshold() ? nullptr : pool, 0);
+		}
+
+		template<euclidean_vector_dataset Q>
+		auto search_all(thread_pool* pool, Q const& queries, int k) const
+		   -> std::vector<std::vector<neighbour>> {
+			auto const queries_size = detail::dataset_rows(queries);
+			for (auto query = 0; query < queries_size; ++query) {
+				check_search(detail::dataset_row(queries, query).dimensions(), k);
+			}
+			auto results = std::vector<std::vector<neighbour>>(static_cast<std::size_t>(queries_size));
+			auto const search_one = [&](std::size_t query) {
+				auto const& vec = detail::dataset_row(queries, static_cast<int>(query));
+				results[query] = search(vec.data(), k);
+			};
+			if (pool == nullptr) {
+				for (auto query = std::size_t{0}; query < results.size(); ++query) {
+					search_one(query);
+				}
+			}
+			else {
+				pool->run(results.size(), search_one);
+			}
+			return results;
+		}
+
+		[[nodiscard]] auto offset(int node) const noexcept -> std::size_t {
+			return static_cast<std::size_t>(node) * static_cast<std::size_t>(dimensions_);
+		}
+
+		// Links of `node` on `level`: a count followed by room for max_links(level) indices
+		[[nodiscard]] auto links(int node, int level) noexcept -> int*;
+		[[nodiscard]] auto links(int node, int level) const noexcept -> int const*;
+		[[nodiscard]] auto max_links(int level) const noexcept -> int;
+
+		auto reserve(int nodes) -> void;
+		auto append(T const* magnitudes, int dimensions) -> void;
+		// Links nodes [first, size()) into the graph, in parallel when `pool` is not null.
+		auto build(thread_pool* pool, int first) -> void;
+		auto insert(int node, std::mutex* locks, std::mutex* entry_lock) -> void;
+		auto connect(int node, int neighbour, int level, std::mutex* locks) -> void;
+
+		auto check_search(int dimensions, int k) const -> void;
+		[[nodiscard]] auto search(T const* query, int k) const -> std::vector<neighbour>;
+		[[nodiscard]] auto distance(T const* query, double query_norm, int node) const noexcept
+		   -> double;
+		[[nodiscard]] auto greedy_search(T const* query,
+		                                 double query_norm,
+		                                 neighbour nearest,
+		                                 int level,
+		                                 std::mutex* locks) const -> neighbour;
+		[[nodiscard]] auto search_level(T const* query,
+		                                double query_norm,
+		                                neighbour entry,
+		                                int ef,
+		                                int level,
+		                                std::mutex* locks) const -> std::vector<neighbour>;
+		[[nodiscard]] auto select_neighbours(std::vector<neighbour> const& candidates, int m) const
+		   -> std::vector<int>;
+
+		int dimensions_ = 0;
+		metric measure_ = metric::l2;
+		hnsw_parameters parameters_;
+		std::mt19937 engine_;
+		int entry_point_ = -1;
+		int max_level_ = -1;
+		std::vector<T> vectors_;
+		// metric_norm() of each vector
+		std::vector<double> norms_;
+		std::vector<int> levels_;
+		// Level 0 links of every node, 2m + 1 ints per node
+		std::vector<int> base_links_;
+		// Links on levels 1 and above, m + 1 ints per level per node
+		std::vector<std::vector<int>> upper_links_;
+	};
+
+	using hnsw_index = basic_hnsw_index<double>;
+
+	// Defined in hnsw_index.cpp for every element type
+	extern template class basic_hnsw_index<double>;
+	extern template class basic_hnsw_index<float>;
+	extern template class basic_hnsw_index<std::int16_t>;
+	extern template class basic_hnsw_index<std::int8_t>;
+} // namespace comp6771
+
+#endif // COMP6771_HNSW_INDEX_HPP
@@ -0,0 +1,244 @@
+#ifndef COMP6771_IVF_INDEX_HPP
+#define COMP6771_IVF_INDEX_HPP
+
+#include <algorithm>
+#include <comp6771/euclidean_vector.hpp>
+#include <comp6771/euclidean_vector_view.hpp>
+#include <comp6771/knn.hpp>
+#include <comp6771/parallel.hpp>
+#include <comp6771/thread_pool.hpp>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace comp6771 {
+	struct ivf_parameters {
+		// Lists searched for each query
+		int nprobe = 8;
+		// Most iterations of k-means while training
+		int iterations = 20;
+		// Training samples at most this many vectors for each list
+		int sample_per_list = 256;
+		// Seeds the training sample and the initial centroids
+		std::uint32_t seed = 6771;
+	};
+
+	// An approximate nearest neighbour index that partitions vectors into inverted lists, one per
+	// centroid found by k-means, and searches only the nprobe lists whose centroids are nearest the
+	// query. Each list holds its vectors back to back, so a probe is one sequential scan, and the
+	// only memory beyond the vectors is the centroids and an id per vector. Vectors can be added and
+	// removed at any time without retraining, although recall falls if they drift far from the
+	// data the index was trained on.
+	//
+	// Vectors are identified by the ids add() returns, which are never reused. Searching is
+	// thread-safe, but adding or removing vectors is not safe while searching.
+	template<euclidean_vector_value T>
+	class basic_ivf_index {
+	public:
+		using value_type = T;
+		using row_type = basic_euclidean_vector_view<T const>;
+
+		// Constructors
+		// An untrained index of vectors with `dimensions`, which will have `lists` lists. Throws if
+		// `lists` or any of the parameters is not positive.
+		basic_ivf_index(int dimensions,
+		                int lists,
+		                metric measure = metric::l2,
+		                ivf_parameters parameters = {});
+
+		// An index trained on `dataset` that holds every row, with ids 0 to rows - 1.
+		template<euclidean_vector_dataset D>
+		requires std::same_as<detail::dataset_value_t<D>, T>
+		basic_ivf_index(D const& dataset,
+		                int lists,
+		                metric measure = metric::l2,
+		                ivf_parameters parameters = {})
+		: basic_ivf_index(detail::dataset_rows(dataset) == 0
+		                     ? 0
+		                     : detail::dataset_row(dataset, 0).dimensions(),
+		                  lists,
+		                  measure,
+		                  parameters) {
+			train(dataset);
+			add(dataset);
+		}
+
+		// Member functions
+		// Finds the centroids of the lists with k-means over a sample of `dataset`, which must have
+		// at least as many rows as there are lists. Only an empty index can be trained.
+		template<euclidean_vector_dataset D>
+		requires std::same_as<detail::dataset_value_t<D>, T>
+		auto train(D const& dataset) -> void {
+			auto const rows = detail::dataset_rows(dataset);
+			check_trainable(rows);
+			auto const chosen = sample_rows(rows);
+			auto sample = std::vector<double>(chosen.size() * static_cast<std::size_t>(dimensions_));
+			auto* out = sample.data();
+			for (auto const row : chosen) {
+				auto const& vec = detail::dataset_row(dataset, row);
+				check_dimensions_equal(dimensions_, vec.dimensions());
+				out = std::copy(vec.data(), vec.data() + dimensions_, out);
+			}
+			train(sample);
+		}
+
+		[[nodiscard]] auto trained() const noexcept -> bool;
+
+		// Adds a copy of `vec` to the list with the nearest centroid and returns its id. Throws if
+		// the index is not trained.
+		template<contiguous_euclidean_vector V>
+		requires(not euclidean_vector_dataset<V>) and std::same_as<detail::value_type_t<V>, T>
+		auto add(V const& vec) -> int {
+			return append(vec.data(), vec.dimensions());
+		}
+
+		// Adds every row of `dataset`, giving them consecutive ids, and returns the first id. Adds
+		// nothing if any row has the wrong dimensions.
+		template<euclidean_vector_dataset D>
+		requires std::same_as<detail::dataset_value_t<D>, T>
+		auto add(D const& dataset) -> int {
+			auto const rows = detail::dataset_rows(dataset);
+			for (auto row = 0; row < rows; ++row) {
+				check_dimensions_equal(dimensions_, detail::dataset_row(dataset, row).dimensions());
+			}
+			auto const first = static_cast<int>(locations_.size());
+			for (auto row = 0; row < rows; ++row) {
+				append(detail::dataset_row(dataset, row).data(), dimensions_);
+			}
+			return first;
+		}
+
+		// Removes the vector with `id`, returning false if there is none.
+		auto remove(int id) -> bool;
+
+		[[nodiscard]] auto contains(int id) const noexcept -> bool;
+
+		// The vector with `id`, which must be in the index
+		[[nodiscard]] auto operator[](int id) const noexcept -> row_type {
+			auto const& found = locations_[static_cast<std::size_t>(id)];
+			auto const& list = inverted_lists_[static_cast<std::size_t>(found.list)];
+			return {list.vectors.data() + offset(found.position), dimensions_};
+		}
+
+		// The k nearest vectors to `query` in the nprobe nearest lists, nearest first, with ids as
+		// indices and distances as knn_search() measures them.
+		template<contiguous_euclidean_vector V>
+		requires(not euclidean_vector_dataset<V>) and std::same_as<detail::value_type_t<V>, T>
+		[[nodiscard]] auto search(V const& query, int k) const -> std::vector<neighbour> {
+			check_search(query.dimensions(), k);
+			return search(query.data(), k, nullptr);
+		}
+
+		// As above, scanning the lists in parallel as described in parallel.hpp. Searches that
+		// compare fewer than parallel_threshold() magnitudes in total run serially.
+		template<execution_policy P, contiguous_euclidean_vector V>
+		requires(not euclidean_vector_dataset<V>) and std::same_as<detail::value_type_t<V>, T>
+		[[nodiscard]] auto search(P&& policy, V const& query, int k) const
+		   -> std::vector<neighbour> {
+			check_search(query.dimensions(), k);
+			return search(query.data(), k, detail::pool_for(policy));
+		}
+
+		// The k nearest vectors for each of `queries`. Queries that probe the same list share one
+		// scan of it, so searching for many queries at once is faster than one at a time.
+		template<euclidean_vector_dataset Q>
+		requires std::same_as<detail::dataset_value_t<Q>, T>
+		[[nodiscard]] auto search(Q const& queries, int k) const
+		   -> std::vector<std::vector<neighbour>> {
+			return search_all(nullptr, queries, k);
+		}
+
+		// As above, scanning the lists in parallel.
+		template<execution_policy P, euclidean_vector_dataset Q>
+		requires std::same_as<detail::dataset_value_t<Q>, T>
+		[[nodiscard]] auto search(P&& policy, Q const& queries, int k) const
+		   -> std::vector<std::vector<neighbour>> {
+			return search_all(detail::pool_for(policy), queries, k);
+		}
+
+		// Vectors in the index
+		[[nodiscard]] auto size() const noexcept -> int;
+		[[nodiscard]] auto dimensions() const noexcept -> int;
+		[[nodiscard]] auto lists() const noexcept -> int;
+		[[nodiscard]] auto measure() const noexcept -> metric;
+		[[nodiscard]] auto parameters() const noexcept -> ivf_parameters;
+
+		// Vectors in `list`
+		[[nodiscard]] auto list_size(int list) const -> int;
+		// Centroid of `list`. The index must be trained.
+		[[nodiscard]] auto centroid(int list) const -> row_type;
+
+		// Changes the lists searched for each query. Throws if it is not positive.
+		auto set_nprobe(int nprobe) -> void;
+
+	private:
+		struct inverted_list {
+			std::vector<T> vectors;
+			// metric_norm() of each vector
+			std::vector<double> norms;
+			std::vector<int> ids;
+		};
+
+		// Where the vector with an id is, or a list of -1 once it is removed
+		struct location {
+			int list = -1;
+			int position = 0;
+		};
+
+		template<euclidean_vector_dataset Q>
+		auto search_all(thread_pool* pool, Q const& queries, int k) const
+		   -> std::vector<std::vector<neighbour>> {
+			auto const queries_size = detail::dataset_rows(queries);
+			// Each query is a reference or a view, so its magnitudes outlive the loop.
+			auto rows = std::vector<T const*>(static_cast<std::size_t>(queries_size));
+			for (auto query = 0; query < queries_size; ++query) {
+				auto const& vec = detail::dataset_row(queries, query);
+				check_search(vec.dimensions(), k);
+				rows[static_cast<std::size_t>(query)] = vec.data();
+			}
+			return search(rows, k, pool);
+		}
+
+		[[nodiscard]] auto offset(int position) const noexcept -> std::size_t {
+			return static_cast<std::size_t>(position) * static_cast<std::size_t>(dimensions_);
+		}
+
+		auto check_trainable(int rows) const -> void;
+		auto check_search(int dimensions, int k) const -> void;
+		[[nodiscard]] auto sample_rows(int rows) const -> std::vector<int>;
+		auto train(std::vector<double> const& sample) -> void;
+		auto append(T const* magnitudes, int dimensions) -> int;
+		[[nodiscard]] auto norm(T const* magnitudes) const noexcept -> double;
+		[[nodiscard]] auto nearest_lists(T const* query, double query_norm, int count) const
+		   -> std::vector<int>;
+		auto scan(int list, T const* query, double query_norm, detail::top_k& found) const -> void;
+		[[nodiscard]] auto search(T const* query, int k, thread_pool* pool) const
+		   -> std::vector<neighbour>;
+		[[nodiscard]] auto
+		search(std::vector<T const*> const& queries, int k, thread_pool* pool) const
+		   -> std::vector<std::vector<neighbour>>;
+
+		int dimensions_ = 0;
+		int lists_ = 0;
+		metric measure_ = metric::l2;
+		ivf_parameters parameters_;
+		int size_ = 0;
+		// One centroid per list, back to back, and the metric_norm() of each
+		std::vector<T> centroids_;
+		std::vector<double> centroid_norms_;
+		std::vector<inverted_list> inverted_lists_;
+		// Indexed by id
+		std::vector<location> locations_;
+	};
+
+	using ivf_index = basic_ivf_index<double>;
+
+	// Defined in ivf_index.cpp for every element type
+	extern template class basic_ivf_index<double>;
+	extern template class basic_ivf_index<float>;
+	extern template class basic_ivf_index<std::int16_t>;
+	extern template class basic_ivf_index<std::int8_t>;
+} // namespace comp6771
+
+#endif // COMP6771_IVF_INDEX_HPP
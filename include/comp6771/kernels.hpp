@@ -0,0 +1,189 @@
+#ifndef COMP6771_KERNELS_HPP
+#define COMP6771_KERNELS_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+// Vectorised loops behind euclidean_vector's arithmetic and reductions.
+//
+// Every kernel has a portable version and, on x86, SSE2, AVX2 and AVX-512 versions for double
+// and float. The widest instruction set the running CPU supports is picked the first time a kernel
+// is called, so one binary runs on every host. The reductions keep several independent
+// accumulators, so their results can differ from a serial loop in the last few bits.
+//
+// The std::int8_t and std::int16_t kernels are plain loops the compiler vectorises. Their dot
+// product is exact, and their arithmetic rounds to nearest and saturates.
+namespace comp6771::kernels {
+	enum class isa { portable, sse2, avx2, avx512 };
+
+	// Instruction set the kernels currently dispatch to.
+	[[nodiscard]] auto active_isa() noexcept -> isa;
+
+	// Whether the running CPU can execute kernels for `level`.
+	[[nodiscard]] auto supported(isa level) noexcept -> bool;
+
+	// Pins dispatch to `level`, e.g. to compare instruction sets in tests and benchmarks.
+	// Throws euclidean_vector_error if the running CPU does not support it.
+	auto use_isa(isa level) -> void;
+
+	// Returns the sum of x[i] * y[i].
+	[[nodiscard]] auto dot(double const* x, double const* y, std::size_t size) noexcept -> double;
+	[[nodiscard]] auto dot(float const* x, float const* y, std::size_t size) noexcept -> float;
+
+	// x[i] += y[i]
+	auto add(double* x, double const* y, std::size_t size) noexcept -> void;
+	auto add(float* x, float const* y, std::size_t size) noexcept -> void;
+
+	// x[i] -= y[i]
+	auto subtract(double* x, double const* y, std::size_t size) noexcept -> void;
+	auto subtract(float* x, float const* y, std::size_t size) noexcept -> void;
+
+	// x[i] *= scalar
+	auto multiply(double* x, double scalar, std::size_t size) noexcept -> void;
+	auto multiply(float* x, float scalar, std::size_t size) noexcept -> void;
+
+	// x[i] /= scalar, as a true division so results match the scalar loop exactly
+	auto divide(double* x, double scalar, std::size_t size) noexcept -> void;
+	auto divide(float* x, float scalar, std::size_t size) noexcept -> void;
+
+	// Whether a == b or |a - b| <= max(abs_tol, rel_tol * max(|a|, |b|)). The tolerance is capped
+	// at the largest finite value, so infinities are only close to themselves, and NaNs never are.
+	template<std::floating_point T>
+	constexpr auto close(T a, T b, T abs_tol, T rel_tol) noexcept -> bool {
+		auto const magnitude = [](T value) { return value < 0 ? -value : value; };
+		auto const tolerance = std::max(abs_tol, rel_tol * std::max(magnitude(a), magnitude(b)));
+		return a == b or magnitude(a - b) <= std::min(tolerance, std::numeric_limits<T>::max());
+	}
+
+	// Whether close(x[i], y[i], abs_tol, rel_tol) for every i. Returns at the end of the first
+	// block with a mismatch.
+	[[nodiscard]] auto approx_equal(double const* x,
+	                                double const* y,
+	                                std::size_t size,
+	                                double abs_tol,
+	                                double rel_tol) noexcept -> bool;
+	[[nodiscard]] auto approx_equal(float const* x,
+	                                float const* y,
+	                                std::size_t size,
+	                                float abs_tol,
+	                                float rel_tol) noexcept -> bool;
+
+	// Vectors per block of fast-scan codes
+	inline constexpr auto lookup_block = std::size_t{32};
+
+	// Sums table lookups for 4-bit product-quantisation codes, 32 vectors at a time. `codes` holds
+	// `blocks` blocks of `pairs` rows of 32 bytes. Row p of a block packs the codes of subspaces 2p
+	// (low nibble) and 2p + 1 (high nibble), with vector v in byte 2v when v < 16 and in byte
+	// 2(v - 16) + 1 otherwise. `tables` holds 16 bytes for each of the 2 * pairs subspaces.
+	// Writes tables[j][code of v in j] summed over j to sums[32 * block + v], which cannot overflow
+	// while pairs <= 128. The AVX2 and AVX-512 versions look up 32 codes with each byte shuffle.
+	auto lookup_accumulate(std::uint8_t const* codes,
+	                       std::uint8_t const* tables,
+	                       std::size_t pairs,
+	                       std::size_t blocks,
+	                       std::uint16_t* sums) noexcept -> void;
+
+	// Rows and columns of the tiles dot_tile computes
+	inline constexpr auto tile_size = std::size_t{8};
+
+	// The inner kernel of a matrix product: the products of tile_size rows with tile_size columns
+	// of `depth` elements. Both are packed, so element k of row i is a[tile_size * k + i] and
+	// element k of column j is b[tile_size * k + j]. Writes the product of row i and column j to
+	// tile[tile_size * i + j]. The AVX2 and AVX-512 versions hold the tile in registers, so every
+	// element loaded is used tile_size times.
+	auto dot_tile(double const* a, double const* b, std::size_t depth, double* tile) noexcept
+	   -> void;
+
+	template<typename T>
+	concept quantised = std::same_as<T, std::int8_t> or std::same_as<T, std::int16_t>;
+
+	// Converts an arithmetic result to T. Integers are rounded to nearest and saturated.
+	template<typename T, typename U>
+	[[nodiscard]] constexpr auto narrow(U value) noexcept -> T {
+		if constexpr (std::floating_point<T>) {
+			return static_cast<T>(value);
+		}
+		else if constexpr (std::floating_point<U>) {
+			return static_cast<T>(std::clamp(std::nearbyint(static_cast<double>(value)),
+			                                 static_cast<double>(std::numeric_limits<T>::lowest()),
+			                                 static_cast<double>(std::numeric_limits<T>::max())));
+		}
+		else {
+			return static_cast<T>(std::clamp(static_cast<std::int64_t>(value),
+			                                 std::int64_t{std::numeric_limits<T>::lowest()},
+			                                 std::int64_t{std::numeric_limits<T>::max()}));
+		}
+	}
+
+	// std::int8_t products are summed in 32 bits over blocks short enough not to overflow, which the
+	// compiler vectorises well; std::int16_t products need 64 bits throughout.
+	template<quantised T>
+	[[nodiscard]] auto dot(T const* x, T const* y, std::size_t size) noexcept -> std::int64_t {
+		auto sum = std::int64_t{0};
+		if constexpr (std::same_as<T, std::int8_t>) {
+			constexpr auto block = std::size_t{1} << 16U;
+			for (auto first = std::size_t{0}; first < size; first += block) {
+				auto const last = std::min(size, first + block);
+				auto partial = std::int32_t{0};
+				for (auto i = first; i < last; ++i) {
+					partial += std::int32_t{x[i]} * std::int32_t{y[i]};
+				}
+				sum += partial;
+			}
+		}
+		else {
+			for (auto i = std::size_t{0}; i < size; ++i) {
+				sum += std::int32_t{x[i]} * std::int32_t{y[i]};
+			}
+		}
+		return sum;
+	}
+
+	template<quantised T>
+	auto add(T* x, T const* y, std::size_t size) noexcept -> void {
+		for (auto i = std::size_t{0}; i < size; ++i) {
+			x[i] = narrow<T>(std::int32_t{x[i]} + std::int32_t{y[i]});
+		}
+	}
+
+	template<quantised T>
+	auto subtract(T* x, T const* y, std::size_t size) noexcept -> void {
+		for (auto i = std::size_t{0}; i < size; ++i) {
+			x[i] = narrow<T>(std::int32_t{x[i]} - std::int32_t{y[i]});
+		}
+	}
+
+	template<quantised T>
+	auto multiply(T* x, double scalar, std::size_t size) noexcept -> void {
+		for (auto i = std::size_t{0}; i < size; ++i) {
+			x[i] = narrow<T>(x[i] * scalar);
+		}
+	}
+
+	template<quantised T>
+	auto divide(T* x, double scalar, std::size_t size) noexcept -> void {
+		for (auto i = std::size_t{0}; i < size; ++i) {
+			x[i] = narrow<T>(x[i] / scalar);
+		}
+	}
+
+	template<quantised T>
+	auto approx_equal(T const* x,
+	                  T const* y,
+	                  std::size_t size,
+	                  double abs_tol,
+	                  double rel_tol) noexcept -> bool {
+		for (auto i = std::size_t{0}; i < size; ++i) {
+			if (not close(static_cast<double>(x[i]), static_cast<double>(y[i]), abs_tol, rel_tol)) {
+				return false;
+			}
+		}
+		return true;
+	}
+} // namespace comp6771::kernels
+
+#endif // COMP6771_KERNELS_HPP
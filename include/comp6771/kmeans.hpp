@@ -0,0 +1,97 @@
+#ifndef COMP6771_KMEANS_HPP
+#define COMP6771_KMEANS_HPP
+
+#include <comp6771/euclidean_vector.hpp>
+#include <comp6771/euclidean_vector_batch.hpp>
+#include <comp6771/knn.hpp>
+#include <comp6771/parallel.hpp>
+#include <comp6771/thread_pool.hpp>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace comp6771 {
+	// How the first centroids are chosen
+	enum class kmeans_seeding {
+		// k distinct rows chosen uniformly
+		random,
+		// k-means++ (Arthur and Vassilvitskii, 2007): each centroid is a row chosen with
+		// probability proportional to its squared distance from the centroids chosen so far. Takes
+		// k passes over the dataset.
+		plus_plus,
+		// k-means|| (Bahmani et al., 2012): two passes each choose about 2k rows as k-means++
+		// does, but all at once, and k-means++ then picks k of them, weighted by the rows nearest
+		// each. Does more arithmetic than k-means++ but in a handful of passes rather than k, so
+		// it is the faster of the two with enough threads, and its seeds are usually better.
+		parallel,
+	};
+
+	struct kmeans_parameters {
+		kmeans_seeding seeding = kmeans_seeding::plus_plus;
+		// Most passes that assign rows to centroids, or batches with a batch_size
+		int iterations = 25;
+		// Stops once the inertia falls by no more than this fraction in an iteration
+		double tolerance = 1e-4;
+		// Rows sampled for each mini-batch iteration (Sculley, 2010), or 0 to use every row
+		int batch_size = 0;
+		// Seeds the seeding and the mini-batches
+		std::uint32_t seed = 6771;
+	};
+
+	// What one iteration did
+	struct kmeans_iteration {
+		// Sum of the squared distances from the rows assigned in the iteration, which are every row
+		// or the mini-batch, to their nearest centroids before they moved
+		double inertia = 0;
+		// Furthest any centroid moved
+		double shift = 0;
+	};
+
+	struct kmeans_result {
+		// One row per centroid
+		euclidean_vector_batch centroids;
+		// Index of the centroid nearest each row of the dataset
+		std::vector<int> assignment;
+		// Sum of the squared distances from every row to its nearest centroid
+		double inertia = 0;
+		// Whether the inertia stopped falling before the iterations ran out
+		bool converged = false;
+		std::vector<kmeans_iteration> history;
+	};
+
+	namespace detail {
+		template<euclidean_vector_value T>
+		auto kmeans(std::vector<T const*> const& rows,
+		            int dimensions,
+		            int k,
+		            kmeans_parameters const& parameters,
+		            thread_pool* pool) -> kmeans_result;
+	} // namespace detail
+
+	// Clusters the rows of `dataset` into k clusters with Lloyd's algorithm, or with mini-batch
+	// k-means when parameters.batch_size is positive. Centroids are computed in double whatever the
+	// element type. Throws if k is not positive, if there are fewer rows than k, or if any
+	// parameter is out of range.
+	template<euclidean_vector_dataset D>
+	auto kmeans(D const& dataset, int k, kmeans_parameters const& parameters = {})
+	   -> kmeans_result {
+		auto const rows = detail::row_pointers(dataset);
+		auto const dimensions = rows.empty() ? 0 : detail::dataset_row(dataset, 0).dimensions();
+		return detail::kmeans(rows, dimensions, k, parameters, nullptr);
+	}
+
+	// As above, assigning rows and seeding in parallel as described in parallel.hpp. Each thread
+	// sums the rows assigned to each centroid on its own, and the sums are added in thread order,
+	// so results are reproducible for a given pool size. Datasets with fewer than
+	// parallel_threshold() magnitudes in total are clustered serially.
+	template<execution_policy P, euclidean_vector_dataset D>
+	auto kmeans(P&& policy, D const& dataset, int k, kmeans_parameters const& parameters = {})
+	   -> kmeans_result {
+		auto const rows = detail::row_pointers(dataset);
+		auto const dimensions = rows.empty() ? 0 : detail::dataset_row(dataset, 0).dimensions();
+		return detail::kmeans(rows, dimensions, k, parameters, detail::pool_for(policy));
+	}
+} // namespace comp6771
+
+#endif // COMP6771_KMEANS_HPP
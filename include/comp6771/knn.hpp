@@ -0,0 +1,334 @@
+#ifndef COMP6771_KNN_HPP
+#define COMP6771_KNN_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <comp6771/euclidean_vector.hpp>
+#include <comp6771/euclidean_vector_view.hpp>
+#include <comp6771/parallel.hpp>
+#include <concepts>
+#include <cstddef>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace comp6771 {
+	// How far apart two vectors are for knn_search. Smaller distances are nearer:
+	//    - l2: the euclidean distance |x - y|
+	//    - inner_product: -dot(x, y), so the largest inner products are nearest
+	//    - cosine: 1 - cos(x, y), taking cos to be 0 when either vector is zero
+	enum class metric { l2, inner_product, cosine };
+
+	struct neighbour {
+		// Row of the dataset
+		int index = 0;
+		double distance = 0;
+
+		friend auto operator==(neighbour const&, neighbour const&) -> bool = default;
+	};
+
+	namespace detail {
+		// A row whose data() outlives the expression that produced it: a reference to a vector
+		// the dataset holds, or a view of its memory. A vector returned by value is not.
+		template<typename R>
+		concept dataset_row_reference =
+		   contiguous_euclidean_vector<R>
+		   and (std::is_lvalue_reference_v<R> or is_euclidean_vector_view<std::remove_cvref_t<R>>);
+	} // namespace detail
+
+	// Anything holding rows of equal element type that can be indexed with an int: a
+	// euclidean_vector_batch or euclidean_vector_store, which have rows(), or a random access range
+	// of vectors or views such as std::vector<euclidean_vector>.
+	template<typename D>
+	concept euclidean_vector_dataset =
+	   requires(D const& dataset) {
+		   { dataset.rows() } -> std::same_as<int>;
+		   { dataset[0] } -> detail::dataset_row_reference;
+	   }
+	   or (std::ranges::random_access_range<D const> and std::ranges::sized_range<D const>
+	       and detail::dataset_row_reference<std::ranges::range_reference_t<D const>>);
+
+	namespace detail {
+		template<euclidean_vector_dataset D>
+		auto dataset_rows(D const& dataset) -> int {
+			if constexpr (requires { dataset.rows(); }) {
+				return dataset.rows();
+			}
+			else {
+				return static_cast<int>(std::ranges::size(dataset));
+			}
+		}
+
+		template<euclidean_vector_dataset D>
+		auto dataset_row(D const& dataset, int row) -> decltype(auto) {
+			if constexpr (requires { dataset.rows(); }) {
+				return dataset[row];
+			}
+			else {
+				return std::ranges::begin(dataset)[row];
+			}
+		}
+
+		template<euclidean_vector_dataset D>
+		using dataset_value_t = value_type_t<decltype(dataset_row(std::declval<D const&>(), 0))>;
+
+		// Pointers to the magnitudes of every row of `dataset`, which stay valid as long as the
+		// dataset does because each row is a reference or a view. Throws if the rows' dimensions
+		// differ.
+		template<euclidean_vector_dataset D>
+		auto row_pointers(D const& dataset) -> std::vector<dataset_value_t<D> const*> {
+			auto const size = dataset_rows(dataset);
+			auto rows = std::vector<dataset_value_t<D> const*>(static_cast<std::size_t>(size));
+			auto const dimensions = size == 0 ? 0 : dataset_row(dataset, 0).dimensions();
+			for (auto row = 0; row < size; ++row) {
+				auto const& vec = dataset_row(dataset, row);
+				check_dimensions_equal(dimensions, vec.dimensions());
+				rows[static_cast<std::size_t>(row)] = vec.data();
+			}
+			return rows;
+		}
+
+		// The norm `measure` needs of a vector whose squared euclidean norm is `squared`
+		inline auto metric_norm(metric measure, double squared) noexcept -> double {
+			switch (measure) {
+			case metric::l2: return squared;
+			case metric::inner_product: return 0;
+			case metric::cosine: return std::sqrt(squared);
+			}
+			return 0;
+		}
+
+		// Distance under `measure` between vectors with inner product `product` and metric_norm()s
+		// `x_norm` and `y_norm`. L2 distances are left squared.
+		inline auto
+		metric_distance(metric measure, double product, double x_norm, double y_norm) noexcept
+		   -> double {
+			switch (measure) {
+			case metric::l2: return std::max(0.0, x_norm + y_norm - 2 * product);
+			case metric::inner_product: return -product;
+			case metric::cosine:
+				return x_norm == 0 or y_norm == 0 ? 1.0 : 1 - product / (x_norm * y_norm);
+			}
+			return 0;
+		}
+
+		// Nearest first, breaking ties by index so that results do not depend on the search order.
+		inline auto nearer(neighbour const& a, neighbour const& b) noexcept -> bool {
+			return a.distance < b.distance or (a.distance == b.distance and a.index < b.index);
+		}
+
+		// The k nearest neighbours seen so far, as a max-heap with the furthest on top.
+		class top_k {
+		public:
+			explicit top_k(int k)
+			: k_{static_cast<std::size_t>(k)} {
+				heap_.reserve(k_);
+			}
+
+			auto push(neighbour const& candidate) -> void {
+				if (heap_.size() < k_) {
+					heap_.push_back(candidate);
+					std::push_heap(heap_.begin(), heap_.end(), nearer);
+				}
+				else if (k_ > 0 and nearer(candidate, heap_.front())) {
+					std::pop_heap(heap_.begin(), heap_.end(), nearer);
+					heap_.back() = candidate;
+					std::push_heap(heap_.begin(), heap_.end(), nearer);
+				}
+			}
+
+			// Whether a candidate `distance` away could be kept, ignoring ties
+			[[nodiscard]] auto accepts(double distance) const noexcept -> bool {
+				return heap_.size() < k_ or (k_ > 0 and distance <= heap_.front().distance);
+			}
+
+			// Nearest first
+			[[nodiscard]] auto take() && -> std::vector<neighbour> {
+				std::sort_heap(heap_.begin(), heap_.end(), nearer);
+				return std::move(heap_);
+			}
+
+		private:
+			std::size_t k_;
+			std::vector<neighbour> heap_;
+		};
+
+		// Queries are searched in blocks of this many, so that each block of dataset rows is read
+		// from memory once per query block rather than once per query.
+		inline constexpr auto knn_query_block = 16;
+		// Dataset rows are taken in blocks of about this many bytes, which stay in L2 while every
+		// query in the block is compared against them.
+		inline constexpr auto knn_row_block_bytes = std::size_t{128} << 10U;
+
+		// Searches `dataset` for the neighbours of queries [first, last), which hold `norms`, and
+		// writes them to results[first, last).
+		template<typename Queries, euclidean_vector_dataset D>
+		auto knn_search_block(Queries const& queries,
+		                      std::vector<double> const& norms,
+		                      int first,
+		                      int last,
+		                      D const& dataset,
+		                      int k,
+		                      metric measure,
+		                      std::vector<std::vector<neighbour>>& results) -> void {
+			using value_type = dataset_value_t<D>;
+			auto const rows = dataset_rows(dataset);
+			auto const dimensions = static_cast<std::size_t>(dataset_row(queries, first).dimensions());
+			auto const row_block = static_cast<int>(
+			   std::max(std::size_t{1}, knn_row_block_bytes / std::max(std::size_t{1}, dimensions)
+			                               / sizeof(value_type)));
+
+			auto heaps = std::vector<top_k>();
+			heaps.reserve(static_cast<std::size_t>(last - first));
+			for (auto query = first; query < last; ++query) {
+				heaps.emplace_back(k);
+			}
+			auto row_norms = std::vector<double>(static_cast<std::size_t>(row_block));
+
+			for (auto block = 0; block < rows; block += row_block) {
+				auto const block_end = std::min(rows, block + row_block);
+				if (measure != metric::inner_product) {
+					for (auto row = block; row < block_end; ++row) {
+						auto const& vec = dataset_row(dataset, row);
+						row_norms[static_cast<std::size_t>(row - block)] =
+						   metric_norm(measure, inner_product(vec.data(), vec.data(), dimensions));
+					}
+				}
+				for (auto query = first; query < last; ++query) {
+					auto const& q = dataset_row(queries, query);
+					auto const query_norm = norms[static_cast<std::size_t>(query)];
+					auto& heap = heaps[static_cast<std::size_t>(query - first)];
+					for (auto row = block; row < block_end; ++row) {
+						auto const product =
+						   inner_product(q.data(), dataset_row(dataset, row).data(), dimensions);
+						auto const row_norm = row_norms[static_cast<std::size_t>(row - block)];
+						heap.push({row, metric_distance(measure, product, query_norm, row_norm)});
+					}
+				}
+			}
+
+			for (auto query = first; query < last; ++query) {
+				auto& result = results[static_cast<std::size_t>(query)];
+				result = std::move(heaps[static_cast<std::size_t>(query - first)]).take();
+				if (measure == metric::l2) {
+					for (auto& found : result) {
+						found.distance = std::sqrt(found.distance);
+					}
+				}
+			}
+		}
+
+		// Checks every query and row has the same dimensions before any thread starts, as tasks
+		// on the pool must not throw.
+		template<typename Queries, euclidean_vector_dataset D>
+		auto check_knn_arguments(Queries const& queries, D const& dataset, int k) -> void {
+			if (k < 0) {
+				throw euclidean_vector_error("Cannot search for a negative number of neighbours");
+			}
+			auto const queries_size = dataset_rows(queries);
+			if (queries_size == 0) {
+				return;
+			}
+			auto const dimensions = dataset_row(queries, 0).dimensions();
+			for (auto query = 1; query < queries_size; ++query) {
+				check_dimensions_equal(dimensions, dataset_row(queries, query).dimensions());
+			}
+			auto const rows = dataset_rows(dataset);
+			for (auto row = 0; row < rows; ++row) {
+				check_dimensions_equal(dimensions, dataset_row(dataset, row).dimensions());
+			}
+		}
+
+		template<typename P, typename Queries, euclidean_vector_dataset D>
+		auto knn_search(P* policy, Queries const& queries, D const& dataset, int k, metric measure)
+		   -> std::vector<std::vector<neighbour>> {
+			check_knn_arguments(queries, dataset, k);
+			auto const queries_size = dataset_rows(queries);
+			auto results = std::vector<std::vector<neighbour>>(static_cast<std::size_t>(queries_size));
+			if (queries_size == 0) {
+				return results;
+			}
+
+			auto norms = std::vector<double>(static_cast<std::size_t>(queries_size));
+			auto const dimensions = static_cast<std::size_t>(dataset_row(queries, 0).dimensions());
+			if (measure != metric::inner_product) {
+				for (auto query = 0; query < queries_size; ++query) {
+					auto const& q = dataset_row(queries, query);
+					norms[static_cast<std::size_t>(query)] =
+					   metric_norm(measure, inner_product(q.data(), q.data(), dimensions));
+				}
+			}
+
+			auto const blocks = (queries_size + knn_query_block - 1) / knn_query_block;
+			auto const search = [&](std::size_t block) {
+				auto const first = static_cast<int>(block) * knn_query_block;
+				auto const last = std::min(queries_size, first + knn_query_block);
+				knn_search_block(queries, norms, first, last, dataset, k, measure, results);
+			};
+			auto const work = static_cast<std::size_t>(queries_size)
+			                  * static_cast<std::size_t>(dataset_rows(dataset)) * dimensions;
+			auto* const pool = policy == nullptr or work < parallel_threshold() ? nullptr
+			                                                                    : pool_for(*policy);
+			if (pool == nullptr or blocks == 1) {
+				for (auto block = std::size_t{0}; block < static_cast<std::size_t>(blocks); ++block) {
+					search(block);
+				}
+			}
+			else {
+				pool->run(static_cast<std::size_t>(blocks), search);
+			}
+			return results;
+		}
+
+		// A single query seen as a dataset of one row
+		template<typename V>
+		struct single_query {
+			V const& query;
+
+			[[nodiscard]] auto rows() const noexcept -> int {
+				return 1;
+			}
+			auto operator[](int) const noexcept -> V const& {
+				return query;
+			}
+		};
+	} // namespace detail
+
+	// The k rows of `dataset` nearest to `query` under `measure`, nearest first, or every row if
+	// the dataset has fewer than k. Equally distant rows are ordered by index.
+	template<contiguous_euclidean_vector V, euclidean_vector_dataset D>
+	requires(not euclidean_vector_dataset<V>)
+	        and std::same_as<detail::value_type_t<V>, detail::dataset_value_t<D>>
+	auto knn_search(V const& query, D const& dataset, int k, metric measure = metric::l2)
+	   -> std::vector<neighbour> {
+		auto results = detail::knn_search(static_cast<thread_pool*>(nullptr),
+		                                  detail::single_query<V>{query},
+		                                  dataset,
+		                                  k,
+		                                  measure);
+		return std::move(results.front());
+	}
+
+	// The k nearest rows of `dataset` for each of `queries`, as knn_search does for one query.
+	template<euclidean_vector_dataset Q, euclidean_vector_dataset D>
+	requires std::same_as<detail::dataset_value_t<Q>, detail::dataset_value_t<D>>
+	auto knn_search(Q const& queries, D const& dataset, int k, metric measure = metric::l2)
+	   -> std::vector<std::vector<neighbour>> {
+		return detail::knn_search(static_cast<thread_pool*>(nullptr), queries, dataset, k, measure);
+	}
+
+	// As above, searching blocks of queries in parallel as described in parallel.hpp. Searches
+	// that compare fewer than parallel_threshold() magnitudes in total run serially.
+	template<execution_policy P, euclidean_vector_dataset Q, euclidean_vector_dataset D>
+	requires std::same_as<detail::dataset_value_t<Q>, detail::dataset_value_t<D>>
+	auto knn_search(P&& policy,
+	                Q const& queries,
+	                D const& dataset,
+	                int k,
+	                metric measure = metric::l2) -> std::vector<std::vector<neighbour>> {
+		return detail::knn_search(&policy, queries, dataset, k, measure);
+	}
+} // namespace comp6771
+
+#endif // COMP6771_KNN_HPP
@@ -0,0 +1,106 @@
+#ifndef COMP6771_PAIRWISE_HPP
+#define COMP6771_PAIRWISE_HPP
+
+#include <comp6771/euclidean_vector.hpp>
+#include <comp6771/knn.hpp>
+#include <comp6771/parallel.hpp>
+#include <comp6771/thread_pool.hpp>
+#include <concepts>
+#include <cstddef>
+#include <span>
+#include <vector>
+
+namespace comp6771 {
+	namespace detail {
+		enum class pairwise_measure { dot, l2 };
+
+		// Packed copies of the vectors being multiplied, kept so that repeated products need not
+		// allocate them again.
+		struct pairwise_buffers {
+			std::vector<double> rows;
+			std::vector<double> columns;
+		};
+
+		// Writes the inner product or L2 distance between a[i] and b[j], vectors of `dimensions`,
+		// to out[i * b.size() + j].
+		template<euclidean_vector_value T>
+		auto pairwise(std::span<T const* const> a,
+		              std::span<T const* const> b,
+		              std::size_t dimensions,
+		              pairwise_measure measure,
+		              double* out,
+		              thread_pool* pool) -> void;
+
+		// As above, serially, packing into `buffers`.
+		template<euclidean_vector_value T>
+		auto pairwise(std::span<T const* const> a,
+		              std::span<T const* const> b,
+		              std::size_t dimensions,
+		              pairwise_measure measure,
+		              double* out,
+		              pairwise_buffers& buffers) -> void;
+
+		template<euclidean_vector_dataset A, euclidean_vector_dataset B>
+		auto pairwise(thread_pool* pool,
+		              A const& a,
+		              B const& b,
+		              pairwise_measure measure,
+		              std::span<double> out) -> void {
+			auto const rows = row_pointers(a);
+			auto const columns = row_pointers(b);
+			if (rows.empty() or columns.empty()) {
+				return;
+			}
+			auto const dimensions = dataset_row(a, 0).dimensions();
+			check_dimensions_equal(dimensions, dataset_row(b, 0).dimensions());
+			if (out.size() < rows.size() * columns.size()) {
+				throw euclidean_vector_error("Output is too small to hold every pair of vectors");
+			}
+			auto const width = static_cast<std::size_t>(dimensions);
+			auto const work = rows.size() * columns.size() * width;
+			pairwise<dataset_value_t<A>>(rows,
+			                             columns,
+			                             width,
+			                             measure,
+			                             out.data(),
+			                             work < parallel_threshold() ? nullptr : pool);
+		}
+	} // namespace detail
+
+	// Writes the inner product of row i of `a` and row j of `b` to out[i * rows of b + j], as a
+	// matrix product. Rows are multiplied in tiles of 8 by 8 held in registers, from blocks of
+	// rows packed to stay in cache, so each row is read from memory once per block rather than
+	// once per pair. Elements of every type are multiplied as doubles. Throws if any rows'
+	// dimensions differ, or if `out` is smaller than the rows of `a` times the rows of `b`.
+	template<euclidean_vector_dataset A, euclidean_vector_dataset B>
+	requires std::same_as<detail::dataset_value_t<A>, detail::dataset_value_t<B>>
+	auto pairwise_dot(A const& a, B const& b, std::span<double> out) -> void {
+		detail::pairwise(nullptr, a, b, detail::pairwise_measure::dot, out);
+	}
+
+	// As above, multiplying tiles in parallel as described in parallel.hpp. Each product is
+	// summed in the same order whatever the number of threads. Products of fewer than
+	// parallel_threshold() multiplications run serially.
+	template<execution_policy P, euclidean_vector_dataset A, euclidean_vector_dataset B>
+	requires std::same_as<detail::dataset_value_t<A>, detail::dataset_value_t<B>>
+	auto pairwise_dot(P&& policy, A const& a, B const& b, std::span<double> out) -> void {
+		detail::pairwise(detail::pool_for(policy), a, b, detail::pairwise_measure::dot, out);
+	}
+
+	// As pairwise_dot, writing the L2 distance between the rows instead, found from their
+	// products as sqrt(|a|^2 + |b|^2 - 2a.b). Distances much smaller than the rows' norms lose
+	// precision to the subtraction.
+	template<euclidean_vector_dataset A, euclidean_vector_dataset B>
+	requires std::same_as<detail::dataset_value_t<A>, detail::dataset_value_t<B>>
+	auto pairwise_l2(A const& a, B const& b, std::span<double> out) -> void {
+		detail::pairwise(nullptr, a, b, detail::pairwise_measure::l2, out);
+	}
+
+	template<execution_policy P, euclidean_vector_dataset A, euclidean_vector_dataset B>
+	requires std::same_as<detail::dataset_value_t<A>, detail::dataset_value_t<B>>
+	auto pairwise_l2(P&& policy, A const& a, B const& b, std::span<double> out) -> void {
+		detail::pairwise(detail::pool_for(policy), a, b, detail::pairwise_measure::l2, out);
+	}
+} // namespace comp6771
+
+#endif // COMP6771_PAIRWISE_HPP
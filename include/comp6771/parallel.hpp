@@ -0,0 +1,212 @@
+#ifndef COMP6771_PARALLEL_HPP
+#define COMP6771_PARALLEL_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <comp6771/euclidean_vector.hpp>
+#include <comp6771/kernels.hpp>
+#include <comp6771/thread_pool.hpp>
+#include <concepts>
+#include <cstddef>
+#include <execution>
+#include <type_traits>
+#include <vector>
+
+namespace comp6771 {
+	// Overloads of dot, euclidean_norm, unit and the compound operators that split large vectors
+	// into one chunk per thread. The first argument says where to run:
+	//    - std::execution::par or par_unseq run on thread_pool::shared()
+	//    - a thread_pool runs on that pool
+	//    - std::execution::seq or unseq run serially on the calling thread
+	// Vectors with fewer than parallel_threshold() dimensions always run serially, as splitting them
+	// costs more than it saves. Parallel reductions add the per-chunk sums in chunk order, so a
+	// result is reproducible for a given pool size but may differ from the serial one in the last
+	// bits.
+	template<typename P>
+	concept execution_policy = std::is_execution_policy_v<std::remove_cvref_t<P>>
+	                           or std::same_as<std::remove_cvref_t<P>, thread_pool>;
+
+	// Smallest number of dimensions that is split across threads. Defaults to 2^17.
+	[[nodiscard]] auto parallel_threshold() noexcept -> std::size_t;
+	auto set_parallel_threshold(std::size_t dimensions) noexcept -> void;
+
+	namespace detail {
+		template<execution_policy P>
+		auto pool_for(P& policy) -> thread_pool* {
+			using policy_type = std::remove_cvref_t<P>;
+			if constexpr (std::same_as<policy_type, thread_pool>) {
+				return &policy;
+			}
+			else if constexpr (std::same_as<policy_type, std::execution::parallel_policy>
+			                   or std::same_as<policy_type,
+			                                   std::execution::parallel_unsequenced_policy>)
+			{
+				return &thread_pool::shared();
+			}
+			else {
+				return nullptr;
+			}
+		}
+
+		// Calls f(first, last) over [0, size): once when running serially, otherwise once per thread
+		// with chunk boundaries on whole cache lines.
+		template<typename T, execution_policy P, typename F>
+		auto for_each_chunk(P& policy, std::size_t size, F const& f) -> void {
+			auto* const pool = size < parallel_threshold() ? nullptr : pool_for(policy);
+			if (pool == nullptr or pool->size() == 1) {
+				f(std::size_t{0}, size);
+				return;
+			}
+			constexpr auto per_line = 64 / sizeof(T);
+			auto const chunks = std::size_t{pool->size()};
+			auto const chunk_size =
+			   ((size + chunks - 1) / chunks + per_line - 1) / per_line * per_line;
+			pool->run(chunks, [&](std::size_t chunk) {
+				auto const first = std::min(size, chunk * chunk_size);
+				auto const last = std::min(size, first + chunk_size);
+				if (first < last) {
+					f(first, last);
+				}
+			});
+		}
+
+		// Sums f(first, last) over the chunks of [0, size), in chunk order.
+		template<typename T, execution_policy P, typename F>
+		auto sum_chunks(P& policy, std::size_t size, F const& f) -> double {
+			auto* const pool = size < parallel_threshold() ? nullptr : pool_for(policy);
+			if (pool == nullptr or pool->size() == 1) {
+				return f(std::size_t{0}, size);
+			}
+			// Each partial sum has its own cache line so that the threads do not contend.
+			struct alignas(64) partial_sum {
+				double value = 0;
+			};
+			auto partials = std::vector<partial_sum>(pool->size());
+			constexpr auto per_line = 64 / sizeof(T);
+			auto const chunks = partials.size();
+			auto const chunk_size =
+			   ((size + chunks - 1) / chunks + per_line - 1) / per_line * per_line;
+			pool->run(chunks, [&](std::size_t chunk) {
+				auto const first = std::min(size, chunk * chunk_size);
+				auto const last = std::min(size, first + chunk_size);
+				partials[chunk].value = first < last ? f(first, last) : 0.0;
+			});
+			auto sum = 0.0;
+			for (auto const& partial : partials) {
+				sum += partial.value;
+			}
+			return sum;
+		}
+
+		// Anything whose magnitudes can be written through data(), e.g. a euclidean_vector or a
+		// mutable view.
+		template<typename V>
+		concept mutable_euclidean_vector =
+		   contiguous_euclidean_vector<V> and requires(std::remove_cvref_t<V>& vec) {
+			   { vec.data() } -> std::same_as<value_type_t<V>*>;
+		   };
+	} // namespace detail
+
+	template<execution_policy P, contiguous_euclidean_vector X, contiguous_euclidean_vector Y>
+	requires std::same_as<detail::value_type_t<X>, detail::value_type_t<Y>>
+	auto dot(P&& policy, X const& x, Y const& y) -> double {
+		check_dimensions_equal(x.dimensions(), y.dimensions());
+		return detail::sum_chunks<detail::value_type_t<X>>(
+		   policy,
+		   static_cast<std::size_t>(x.dimensions()),
+		   [&](std::size_t first, std::size_t last) {
+			   return detail::inner_product(x.data() + first, y.data() + first, last - first);
+		   });
+	}
+
+	template<execution_policy P, contiguous_euclidean_vector V>
+	auto euclidean_norm(P&& policy, V const& v) -> double {
+		auto const compute = [&] {
+			auto const size = static_cast<std::size_t>(v.dimensions());
+			return size == 0 ? 0 : std::sqrt(dot(policy, v, v));
+		};
+		if constexpr (detail::is_euclidean_vector<V>) {
+			return detail::cached_norm(v, compute);
+		}
+		else {
+			return compute();
+		}
+	}
+
+	template<execution_policy P, contiguous_euclidean_vector V>
+	auto unit(P&& policy, V const& v) -> basic_euclidean_vector<detail::value_type_t<V>> {
+		using value_type = detail::value_type_t<V>;
+		auto const norm = euclidean_norm(policy, v);
+		check_unit_vector_exists(v.dimensions(), norm);
+		auto result = basic_euclidean_vector<value_type>::uninitialized(v.dimensions());
+		auto* const out = result.data();
+		detail::for_each_chunk<value_type>(
+		   policy,
+		   static_cast<std::size_t>(v.dimensions()),
+		   [&](std::size_t first, std::size_t last) {
+			   std::copy(v.data() + first, v.data() + last, out + first);
+			   kernels::divide(out + first,
+			                   static_cast<detail::scalar_t<value_type>>(norm),
+			                   last - first);
+		   });
+		return result;
+	}
+
+	// Parallel forms of vec += other, vec -= other, vec *= scalar and vec /= scalar
+	template<execution_policy P, detail::mutable_euclidean_vector V, contiguous_euclidean_vector W>
+	requires std::same_as<detail::value_type_t<V>, detail::value_type_t<W>>
+	auto add_assign(P&& policy, V&& vec, W const& other) -> void {
+		check_dimensions_equal(vec.dimensions(), other.dimensions());
+		auto* const out = vec.data();
+		detail::for_each_chunk<detail::value_type_t<V>>(
+		   policy,
+		   static_cast<std::size_t>(vec.dimensions()),
+		   [&](std::size_t first, std::size_t last) {
+			   kernels::add(out + first, other.data() + first, last - first);
+		   });
+	}
+
+	template<execution_policy P, detail::mutable_euclidean_vector V, contiguous_euclidean_vector W>
+	requires std::same_as<detail::value_type_t<V>, detail::value_type_t<W>>
+	auto subtract_assign(P&& policy, V&& vec, W const& other) -> void {
+		check_dimensions_equal(vec.dimensions(), other.dimensions());
+		auto* const out = vec.data();
+		detail::for_each_chunk<detail::value_type_t<V>>(
+		   policy,
+		   static_cast<std::size_t>(vec.dimensions()),
+		   [&](std::size_t first, std::size_t last) {
+			   kernels::subtract(out + first, other.data() + first, last - first);
+		   });
+	}
+
+	template<execution_policy P, detail::mutable_euclidean_vector V>
+	auto multiply_assign(P&& policy, V&& vec, double scalar) -> void {
+		using value_type = detail::value_type_t<V>;
+		auto* const out = vec.data();
+		detail::for_each_chunk<value_type>(
+		   policy,
+		   static_cast<std::size_t>(vec.dimensions()),
+		   [&](std::size_t first, std::size_t last) {
+			   kernels::multiply(out + first,
+			                     static_cast<detail::scalar_t<value_type>>(scalar),
+			                     last - first);
+		   });
+	}
+
+	template<execution_policy P, detail::mutable_euclidean_vector V>
+	auto divide_assign(P&& policy, V&& vec, double scalar) -> void {
+		using value_type = detail::value_type_t<V>;
+		check_divisor_valid(scalar);
+		auto* const out = vec.data();
+		detail::for_each_chunk<value_type>(
+		   policy,
+		   static_cast<std::size_t>(vec.dimensions()),
+		   [&](std::size_t first, std::size_t last) {
+			   kernels::divide(out + first,
+			                   static_cast<detail::scalar_t<value_type>>(scalar),
+			                   last - first);
+		   });
+	}
+} // namespace comp6771
+
+#endif // COMP6771_PARALLEL_HPP
@@ -0,0 +1,218 @@
+#ifndef COMP6771_PRODUCT_QUANTISER_HPP
+#define COMP6771_PRODUCT_QUANTISER_HPP
+
+#include <algorithm>
+#include <comp6771/euclidean_vector.hpp>
+#include <comp6771/euclidean_vector_view.hpp>
+#include <comp6771/knn.hpp>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace comp6771 {
+	struct pq_parameters {
+		// Bits in the code of each subspace: 8 for 256 centroids, or 4 for 16, which halves the
+		// codes and lets them be packed for fast scans
+		int bits = 8;
+		// Most iterations of k-means for each subspace
+		int iterations = 25;
+		// Training samples at most this many vectors for each centroid
+		int sample_per_centroid = 256;
+		// Seeds the training sample and the initial centroids
+		std::uint32_t seed = 6771;
+	};
+
+	template<euclidean_vector_value T>
+	class basic_product_quantiser;
+
+	// 4-bit codes rearranged in blocks of kernels::lookup_block vectors, so that a fast scan looks
+	// up a whole block's codes with each byte shuffle. Made by basic_product_quantiser::pack().
+	class pq_packed_codes {
+	public:
+		// Codes held
+		[[nodiscard]] auto size() const noexcept -> int {
+			return size_;
+		}
+
+	private:
+		template<euclidean_vector_value T>
+		friend class basic_product_quantiser;
+
+		int size_ = 0;
+		// Bytes in the code of one vector
+		std::size_t code_size_ = 0;
+		std::vector<std::uint8_t> codes_;
+	};
+
+	// A product quantiser (Jegou, Douze and Schmid, 2011) that splits vectors into `subspaces`
+	// equal parts and encodes each part as the nearest of 2^bits centroids found by k-means, so a
+	// vector is stored in `subspaces` bytes, or half that with 4-bit codes. Searches compare a query
+	// with codes without decoding them: each subspace's distances from the query to its centroids
+	// are tabulated once, and the distance to a code is the sum of one table entry per subspace.
+	//
+	// Codes are spans of bytes, code_size() per vector, and search results index them in order.
+	// Only the L2 and inner product metrics are supported, as cosine distances do not split into
+	// sums over subspaces.
+	template<euclidean_vector_value T>
+	class basic_product_quantiser {
+	public:
+		using value_type = T;
+		using row_type = basic_euclidean_vector_view<T const>;
+
+		// Constructors
+		// An untrained quantiser of vectors with `dimensions`, which `subspaces` must divide. Throws
+		// if bits is not 4 or 8, or any other parameter is not positive.
+		basic_product_quantiser(int dimensions,
+		                        int subspaces,
+		                        metric measure = metric::l2,
+		                        pq_parameters parameters = {});
+
+		// A quantiser trained on `dataset`
+		template<euclidean_vector_dataset D>
+		requires std::same_as<detail::dataset_value_t<D>, T>
+		basic_product_quantiser(D const& dataset,
+		                        int subspaces,
+		                        metric measure = metric::l2,
+		                        pq_parameters parameters = {})
+		: basic_product_quantiser(detail::dataset_rows(dataset) == 0
+		                             ? 0
+		                             : detail::dataset_row(dataset, 0).dimensions(),
+		                          subspaces,
+		                          measure,
+		                          parameters) {
+			train(dataset);
+		}
+
+		// Member functions
+		// Finds the centroids of each subspace with k-means over a sample of `dataset`, which must
+		// have at least 2^bits rows. Codes made before training again no longer decode correctly.
+		template<euclidean_vector_dataset D>
+		requires std::same_as<detail::dataset_value_t<D>, T>
+		auto train(D const& dataset) -> void {
+			auto const rows = detail::dataset_rows(dataset);
+			check_trainable(rows);
+			auto const chosen = sample_rows(rows);
+			auto sample = std::vector<double>(chosen.size() * static_cast<std::size_t>(dimensions_));
+			auto* out = sample.data();
+			for (auto const row : chosen) {
+				auto const& vec = detail::dataset_row(dataset, row);
+				check_dimensions_equal(dimensions_, vec.dimensions());
+				out = std::copy(vec.data(), vec.data() + dimensions_, out);
+			}
+			train(sample);
+		}
+
+		[[nodiscard]] auto trained() const noexcept -> bool;
+
+		// Bytes in the code of one vector
+		[[nodiscard]] auto code_size() const noexcept -> int;
+
+		// The code of `vec`. Throws if the quantiser is not trained.
+		template<contiguous_euclidean_vector V>
+		requires(not euclidean_vector_dataset<V>) and std::same_as<detail::value_type_t<V>, T>
+		[[nodiscard]] auto encode(V const& vec) const -> std::vector<std::uint8_t> {
+			check_encodable(vec.dimensions());
+			auto code = std::vector<std::uint8_t>(static_cast<std::size_t>(code_size()));
+			encode(vec.data(), code.data());
+			return code;
+		}
+
+		// The codes of every row of `dataset`, back to back
+		template<euclidean_vector_dataset D>
+		requires std::same_as<detail::dataset_value_t<D>, T>
+		[[nodiscard]] auto encode(D const& dataset) const -> std::vector<std::uint8_t> {
+			auto const rows = detail::dataset_rows(dataset);
+			for (auto row = 0; row < rows; ++row) {
+				check_encodable(detail::dataset_row(dataset, row).dimensions());
+			}
+			auto const size = static_cast<std::size_t>(code_size());
+			auto codes = std::vector<std::uint8_t>(static_cast<std::size_t>(rows) * size);
+			for (auto row = 0; row < rows; ++row) {
+				encode(detail::dataset_row(dataset, row).data(),
+				       codes.data() + static_cast<std::size_t>(row) * size);
+			}
+			return codes;
+		}
+
+		// The vector made of the centroids that `code` names
+		[[nodiscard]] auto decode(std::span<std::uint8_t const> code) const
+		   -> basic_euclidean_vector<T>;
+
+		// The k codes nearest to `query`, nearest first, with positions in `codes` as indices and
+		// distances as knn_search() measures them, but to the decoded vectors.
+		template<contiguous_euclidean_vector V>
+		requires(not euclidean_vector_dataset<V>) and std::same_as<detail::value_type_t<V>, T>
+		[[nodiscard]] auto search(V const& query, std::span<std::uint8_t const> codes, int k) const
+		   -> std::vector<neighbour> {
+			check_search(query.dimensions(), k);
+			return search(query.data(), codes, k);
+		}
+
+		// Rearranges 4-bit `codes` for fast scans. Throws if the codes are 8 bits.
+		[[nodiscard]] auto pack(std::span<std::uint8_t const> codes) const -> pq_packed_codes;
+
+		// As above, but first bounds the distance to every code with a SIMD scan of tables quantised
+		// to bytes, and only sums the exact tables for codes that could be among the k nearest. The
+		// results are the same as searching the unpacked codes.
+		template<contiguous_euclidean_vector V>
+		requires(not euclidean_vector_dataset<V>) and std::same_as<detail::value_type_t<V>, T>
+		[[nodiscard]] auto search(V const& query, pq_packed_codes const& codes, int k) const
+		   -> std::vector<neighbour> {
+			check_search(query.dimensions(), k);
+			return search(query.data(), codes, k);
+		}
+
+		[[nodiscard]] auto dimensions() const noexcept -> int;
+		[[nodiscard]] auto subspaces() const noexcept -> int;
+		[[nodiscard]] auto measure() const noexcept -> metric;
+		[[nodiscard]] auto parameters() const noexcept -> pq_parameters;
+
+		// Centroid `index` of `subspace`. The quantiser must be trained.
+		[[nodiscard]] auto centroid(int subspace, int index) const -> row_type;
+
+	private:
+		[[nodiscard]] auto centroids() const noexcept -> std::size_t {
+			return std::size_t{1} << static_cast<unsigned>(parameters_.bits);
+		}
+
+		[[nodiscard]] auto subspace_dimensions() const noexcept -> std::size_t {
+			return static_cast<std::size_t>(dimensions_ / subspaces_);
+		}
+
+		auto check_trainable(int rows) const -> void;
+		auto check_encodable(int dimensions) const -> void;
+		auto check_search(int dimensions, int k) const -> void;
+		auto check_codes(std::size_t bytes) const -> void;
+		[[nodiscard]] auto sample_rows(int rows) const -> std::vector<int>;
+		auto train(std::vector<double> const& sample) -> void;
+		auto encode(T const* magnitudes, std::uint8_t* code) const noexcept -> void;
+		[[nodiscard]] auto code_of(std::uint8_t const* code, std::size_t subspace) const noexcept
+		   -> std::size_t;
+		[[nodiscard]] auto distance_tables(T const* query) const -> std::vector<double>;
+		[[nodiscard]] auto search(T const* query, std::span<std::uint8_t const> codes, int k) const
+		   -> std::vector<neighbour>;
+		[[nodiscard]] auto search(T const* query, pq_packed_codes const& codes, int k) const
+		   -> std::vector<neighbour>;
+		[[nodiscard]] auto finish(detail::top_k&& found) const -> std::vector<neighbour>;
+
+		int dimensions_ = 0;
+		int subspaces_ = 0;
+		metric measure_ = metric::l2;
+		pq_parameters parameters_;
+		// The centroids of each subspace in turn, back to back, and the squared norm of each
+		std::vector<T> centroids_;
+		std::vector<double> centroid_norms_;
+	};
+
+	using product_quantiser = basic_product_quantiser<double>;
+
+	// Defined in product_quantiser.cpp for every element type
+	extern template class basic_product_quantiser<double>;
+	extern template class basic_product_quantiser<float>;
+	extern template class basic_product_quantiser<std::int16_t>;
+	extern template class basic_product_quantiser<std::int8_t>;
+} // namespace comp6771
+
+#endif // COMP6771_PRODUCT_QUANTISER_HPP
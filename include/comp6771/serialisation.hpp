@@ -0,0 +1,304 @@
+#ifndef COMP6771_SERIALISATION_HPP
+#define COMP6771_SERIALISATION_HPP
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <comp6771/euclidean_vector.hpp>
+#include <comp6771/euclidean_vector_view.hpp>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <optional>
+#include <ostream>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace comp6771 {
+	// A binary record holds one euclidean vector: a 16-byte header, the magnitudes, then zeros up to
+	// the next multiple of 8 bytes so that records written back to back stay aligned.
+	//
+	//    offset  size  field
+	//         0     4  magic "EVEC"
+	//         4     1  format version, currently 1
+	//         5     1  element type, see element_type
+	//         6     1  byte order of the magnitudes: 0 little-endian, 1 big-endian
+	//         7     1  checksum type, see checksum
+	//         8     4  dimensions, little-endian
+	//        12     4  CRC-32C of the magnitudes, little-endian, or 0 without a checksum
+	//        16        magnitudes
+	//
+	// Writers always store little-endian magnitudes, straight from the vector's memory on
+	// little-endian hosts. Readers accept either byte order, and view_binary() hands out a view of
+	// the buffer itself when the magnitudes are in native byte order and suitably aligned, e.g. in
+	// a mapped file.
+	enum class element_type : std::uint8_t { float64 = 1, float32 = 2, int16 = 3, int8 = 4 };
+
+	enum class checksum : std::uint8_t { none = 0, crc32c = 1 };
+
+	inline constexpr auto binary_format_version = std::uint8_t{1};
+	inline constexpr auto binary_header_size = std::size_t{16};
+
+	struct binary_header {
+		std::uint8_t version = binary_format_version;
+		element_type type = element_type::float64;
+		std::endian byte_order = std::endian::little;
+		checksum checksum_type = checksum::none;
+		int dimensions = 0;
+		std::uint32_t payload_checksum = 0;
+
+		// Bytes of magnitudes, without padding
+		[[nodiscard]] auto payload_size() const noexcept -> std::size_t;
+		// Bytes from the start of this record to the start of the next
+		[[nodiscard]] auto record_size() const noexcept -> std::size_t;
+	};
+
+	// Decodes and validates the header at the start of `buffer`. Throws euclidean_vector_error if
+	// the buffer is too short, is not a binary record or has an unsupported version.
+	[[nodiscard]] auto read_binary_header(std::span<std::byte const> buffer) -> binary_header;
+
+	namespace detail {
+		template<typename T>
+		inline constexpr auto element_type_of = element_type::float64;
+		template<>
+		inline constexpr auto element_type_of<float> = element_type::float32;
+		template<>
+		inline constexpr auto element_type_of<std::int16_t> = element_type::int16;
+		template<>
+		inline constexpr auto element_type_of<std::int8_t> = element_type::int8;
+
+		// CRC-32C (Castagnoli) of `bytes`, continuing from the CRC of the bytes before them.
+		[[nodiscard]] auto crc32c(std::span<std::byte const> bytes, std::uint32_t crc = 0) noexcept
+		   -> std::uint32_t;
+
+		[[nodiscard]] auto encode_binary_header(binary_header const& header)
+		   -> std::array<std::byte, binary_header_size>;
+
+		// Throw euclidean_vector_error unless the record holds magnitudes of `type`, or unless
+		// `payload` matches the record's checksum when it has one.
+		auto check_element_type(binary_header const& header, element_type type) -> void;
+		auto check_payload(binary_header const& header, std::span<std::byte const> payload) -> void;
+
+		auto write_all(int fd, std::span<std::span<std::byte const> const> parts) -> void;
+		auto read_all(int fd, std::span<std::byte> bytes) -> void;
+
+		// Bytes left to read from a seekable stream or regular file, or nullopt for pipes, sockets
+		// and anything else whose size is not known in advance.
+		[[nodiscard]] auto remaining_bytes(std::istream& is) -> std::optional<std::size_t>;
+		[[nodiscard]] auto remaining_bytes(int fd) -> std::optional<std::size_t>;
+
+		// Bytes of magnitudes read at once from a source of unknown size
+		inline constexpr auto binary_read_block = std::size_t{1} << 20U;
+
+		inline constexpr auto binary_padding = std::array<std::byte, 8>{};
+
+		template<std::unsigned_integral U>
+		auto store_little_endian(std::byte* out, U value) noexcept -> void {
+			for (auto i = 0U; i < sizeof(U); ++i) {
+				out[i] = static_cast<std::byte>(value >> (8 * i));
+			}
+		}
+
+		template<std::unsigned_integral U>
+		auto load_little_endian(std::byte const* in) noexcept -> U {
+			auto value = U{0};
+			for (auto i = 0U; i < sizeof(U); ++i) {
+				value |= static_cast<U>(std::to_integer<U>(in[i]) << (8 * i));
+			}
+			return value;
+		}
+
+		template<typename T>
+		auto swap_bytes(T* data, std::size_t size) noexcept -> void {
+			if constexpr (sizeof(T) > 1) {
+				auto* const bytes = reinterpret_cast<std::byte*>(data);
+				for (auto i = std::size_t{0}; i < size; ++i) {
+					std::reverse(bytes + i * sizeof(T), bytes + (i + 1) * sizeof(T));
+				}
+			}
+		}
+
+		// Calls write(parts) once with the header, magnitudes and padding of a record for `vec`.
+		template<contiguous_euclidean_vector V, typename Write>
+		auto write_record(V const& vec, checksum sum, Write const& write) -> void {
+			using value_type = value_type_t<V>;
+			auto const size = static_cast<std::size_t>(vec.dimensions());
+			auto payload = std::span<std::byte const>(reinterpret_cast<std::byte const*>(vec.data()),
+			                                          size * sizeof(value_type));
+			auto little_endian = std::vector<value_type>();
+			if constexpr (std::endian::native != std::endian::little) {
+				little_endian.assign(vec.data(), vec.data() + size);
+				swap_bytes(little_endian.data(), size);
+				payload = std::as_bytes(std::span(little_endian));
+			}
+			auto const header = encode_binary_header({
+			   .type = element_type_of<value_type>,
+			   .checksum_type = sum,
+			   .dimensions = vec.dimensions(),
+			   .payload_checksum = sum == checksum::crc32c ? crc32c(payload) : 0,
+			});
+			auto const padding = (8 - payload.size() % 8) % 8;
+			auto const parts = std::array<std::span<std::byte const>, 3>{
+			   std::span<std::byte const>(header),
+			   payload,
+			   std::span<std::byte const>(binary_padding).first(padding),
+			};
+			write(std::span<std::span<std::byte const> const>(parts));
+		}
+
+		// Builds a vector from a record, calling read(bytes) to fill each part of it in turn.
+		// `available` is the number of bytes the source holds from the start of the record, if
+		// known. The dimensions in the header are not trusted: magnitudes are only allocated once
+		// the source is known to hold them, and otherwise are read binary_read_block bytes at a
+		// time, so a damaged header cannot allocate much more than the bytes that are there.
+		template<euclidean_vector_value T, typename Read>
+		auto read_record(Read const& read, std::optional<std::size_t> available)
+		   -> basic_euclidean_vector<T> {
+			auto header_bytes = std::array<std::byte, binary_header_size>();
+			read(std::span<std::byte>(header_bytes));
+			auto const header = read_binary_header(header_bytes);
+			check_element_type(header, element_type_of<T>);
+			if (available.has_value() and *available < header.record_size()) {
+				throw euclidean_vector_error("Binary euclidean_vector is truncated");
+			}
+			auto const size = static_cast<std::size_t>(header.dimensions);
+			auto vec = [&] {
+				if (available.has_value() or header.payload_size() <= binary_read_block) {
+					auto known = basic_euclidean_vector<T>::uninitialized(header.dimensions);
+					read(std::span<std::byte>(reinterpret_cast<std::byte*>(known.data()),
+					                          header.payload_size()));
+					return known;
+				}
+				auto magnitudes = std::vector<T>();
+				while (magnitudes.size() < size) {
+					auto const first = magnitudes.size();
+					auto const grown = std::max(binary_read_block / sizeof(T), 2 * first);
+					magnitudes.resize(std::min(size, grown));
+					read(std::as_writable_bytes(std::span(magnitudes).subspan(first)));
+				}
+				return basic_euclidean_vector<T>(std::move(magnitudes));
+			}();
+			auto const payload = std::as_bytes(std::span<T const>(std::as_const(vec).data(), size));
+			auto padding = std::array<std::byte, 8>();
+			read(std::span<std::byte>(padding).first(header.record_size() - binary_header_size
+			                                         - payload.size()));
+			check_payload(header, payload);
+			if (header.byte_order != std::endian::native) {
+				swap_bytes(vec.data(), static_cast<std::size_t>(header.dimensions));
+			}
+			return vec;
+		}
+	} // namespace detail
+
+	// Bytes that write_binary() uses for a vector of `dimensions` magnitudes of type T
+	template<euclidean_vector_value T>
+	[[nodiscard]] constexpr auto binary_size(int dimensions) noexcept -> std::size_t {
+		auto const payload = static_cast<std::size_t>(dimensions) * sizeof(T);
+		return binary_header_size + (payload + 7) / 8 * 8;
+	}
+
+	// Writers, each of which writes one record. Like operator<<, the stream writer reports failure
+	// through the stream's state. The file descriptor writer throws std::system_error, and the
+	// buffer writer throws euclidean_vector_error if `buffer` is smaller than binary_size().
+	template<contiguous_euclidean_vector V>
+	auto write_binary(std::ostream& os, V const& vec, checksum sum = checksum::none)
+	   -> std::ostream& {
+		detail::write_record(vec, sum, [&os](std::span<std::span<std::byte const> const> parts) {
+			for (auto const part : parts) {
+				os.write(reinterpret_cast<char const*>(part.data()),
+				         static_cast<std::streamsize>(part.size()));
+			}
+		});
+		return os;
+	}
+
+	template<contiguous_euclidean_vector V>
+	auto write_binary(int fd, V const& vec, checksum sum = checksum::none) -> void {
+		detail::write_record(vec, sum, [fd](std::span<std::span<std::byte const> const> parts) {
+			detail::write_all(fd, parts);
+		});
+	}
+
+	// Returns the number of bytes written.
+	template<contiguous_euclidean_vector V>
+	auto write_binary(std::span<std::byte> buffer, V const& vec, checksum sum = checksum::none)
+	   -> std::size_t {
+		if (buffer.size() < binary_size<detail::value_type_t<V>>(vec.dimensions())) {
+			throw euclidean_vector_error("Buffer is too small for a binary euclidean_vector");
+		}
+		auto* out = buffer.data();
+		detail::write_record(vec, sum, [&out](std::span<std::span<std::byte const> const> parts) {
+			for (auto const part : parts) {
+				out = std::copy(part.begin(), part.end(), out);
+			}
+		});
+		return static_cast<std::size_t>(out - buffer.data());
+	}
+
+	// Readers, which copy one record into a new vector. They throw euclidean_vector_error if the
+	// record is not valid, is truncated, holds another element type or fails its checksum. The
+	// file descriptor reader throws std::system_error if reading fails.
+	template<euclidean_vector_value T>
+	auto read_binary(std::istream& is) -> basic_euclidean_vector<T> {
+		auto const available = detail::remaining_bytes(is);
+		return detail::read_record<T>(
+		   [&is](std::span<std::byte> bytes) {
+			   if (not is.read(reinterpret_cast<char*>(bytes.data()),
+			                   static_cast<std::streamsize>(bytes.size()))) {
+				   throw euclidean_vector_error("Binary euclidean_vector is truncated");
+			   }
+		   },
+		   available);
+	}
+
+	template<euclidean_vector_value T>
+	auto read_binary(int fd) -> basic_euclidean_vector<T> {
+		return detail::read_record<T>(
+		   [fd](std::span<std::byte> bytes) { detail::read_all(fd, bytes); },
+		   detail::remaining_bytes(fd));
+	}
+
+	template<euclidean_vector_value T>
+	auto read_binary(std::span<std::byte const> buffer) -> basic_euclidean_vector<T> {
+		auto const available = buffer.size();
+		return detail::read_record<T>(
+		   [&buffer](std::span<std::byte> bytes) {
+			   if (buffer.size() < bytes.size()) {
+				   throw euclidean_vector_error("Binary euclidean_vector is truncated");
+			   }
+			   auto const part = buffer.first(bytes.size());
+			   std::copy(part.begin(), part.end(), bytes.begin());
+			   buffer = buffer.subspan(bytes.size());
+		   },
+		   available);
+	}
+
+	// A view of the magnitudes of the record at the start of `buffer`, without copying them. The
+	// buffer must outlive the view. Besides the readers' checks, throws if the magnitudes are not
+	// in native byte order or not aligned for T. Pass checksum::none to skip reading the magnitudes
+	// to verify their checksum.
+	template<euclidean_vector_value T>
+	auto view_binary(std::span<std::byte const> buffer, checksum verify = checksum::crc32c)
+	   -> basic_euclidean_vector_view<T const> {
+		auto const header = read_binary_header(buffer);
+		if (buffer.size() < header.record_size()) {
+			throw euclidean_vector_error("Binary euclidean_vector is truncated");
+		}
+		detail::check_element_type(header, detail::element_type_of<T>);
+		auto const payload = buffer.subspan(binary_header_size, header.payload_size());
+		if (verify == checksum::crc32c) {
+			detail::check_payload(header, payload);
+		}
+		if (header.byte_order != std::endian::native) {
+			throw euclidean_vector_error("Binary euclidean_vector is not in native byte order");
+		}
+		if (reinterpret_cast<std::uintptr_t>(payload.data()) % alignof(T) != 0) {
+			throw euclidean_vector_error("Binary euclidean_vector is not aligned for a view");
+		}
+		return {reinterpret_cast<T const*>(payload.data()), header.dimensions};
+	}
+} // namespace comp6771
+
+#endif // COMP6771_SERIALISATION_HPP
@@ -0,0 +1,76 @@
+#ifndef COMP6771_THREAD_POOL_HPP
+#define COMP6771_THREAD_POOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace comp6771 {
+	// A fixed set of worker threads for fork-join loops. run() hands out chunks of work to the
+	// workers and to the calling thread, and returns once every chunk is done.
+	//
+	// One run() executes at a time; concurrent callers wait their turn. Tasks must not throw and
+	// must not call run() on the pool that is running them.
+	class thread_pool {
+	public:
+		// Constructors
+		// `threads` counts the thread that calls run(), so a pool of 1 runs everything inline.
+		explicit thread_pool(unsigned threads = std::thread::hardware_concurrency());
+
+		thread_pool(thread_pool const&) = delete;
+		thread_pool(thread_pool&&) = delete;
+		~thread_pool();
+		auto operator=(thread_pool const&) -> thread_pool& = delete;
+		auto operator=(thread_pool&&) -> thread_pool& = delete;
+
+		// Member functions
+		// Number of threads working on each run(), including the caller
+		[[nodiscard]] auto size() const noexcept -> unsigned;
+
+		// Calls task(chunk) once for every chunk in [0, chunks), in no particular order.
+		template<typename Task>
+		auto run(std::size_t chunks, Task const& task) -> void {
+			run_chunks(
+			   chunks,
+			   [](void const* context, std::size_t chunk) noexcept {
+				   (*static_cast<Task const*>(context))(chunk);
+			   },
+			   &task);
+		}
+
+		// The pool used for std::execution::par and par_unseq, with one thread per hardware thread.
+		static auto shared() -> thread_pool&;
+
+	private:
+		using task_function = void (*)(void const*, std::size_t) noexcept;
+
+		auto run_chunks(std::size_t chunks, task_function function, void const* context) -> void;
+		auto work() -> void;
+		// Runs chunks until none are left and returns how many this thread ran.
+		auto drain(task_function function, void const* context, std::size_t chunks) noexcept
+		   -> std::size_t;
+
+		std::vector<std::thread> workers_;
+		std::mutex run_mutex_;
+		std::mutex mutex_;
+		std::condition_variable wake_;
+		std::condition_variable done_;
+
+		// The current job, guarded by mutex_. It is only replaced while no worker is active.
+		task_function function_ = nullptr;
+		void const* context_ = nullptr;
+		std::size_t chunks_ = 0;
+		std::size_t remaining_ = 0;
+		unsigned active_ = 0;
+		std::uint64_t generation_ = 0;
+		bool stopping_ = false;
+
+		std::atomic<std::size_t> next_chunk_ = 0;
+	};
+} // namespace comp6771
+
+#endif // COMP6771_THREAD_POOL_HPP
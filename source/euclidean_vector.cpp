@@ -5,180 +5,387 @@
 
 namespace comp6771 {
 	// Constructors
-	euclidean_vector::euclidean_vector()
-	: euclidean_vector(1, 0){};
+	template<euclidean_vector_value T>
+	basic_euclidean_vector<T>::basic_euclidean_vector()
+	: basic_euclidean_vector(1, 0){};
 
-	euclidean_vector::euclidean_vector(int dimensions)
-	: euclidean_vector(dimensions, 0){};
+	template<euclidean_vector_value T>
+	basic_euclidean_vector<T>::basic_euclidean_vector(int dimensions)
+	: basic_euclidean_vector(dimensions, 0){};
 
-	euclidean_vector::euclidean_vector(int dimensions, double magnitude)
-	: dimensions_{dimensions} // NOLINTNEXTLINE(modernize-avoid-c-arrays)
-	, magnitude_{std::make_unique<double[]>(static_cast<size_t>(dimensions_))} {
-		std::fill(magnitude_.get(), magnitude_.get() + dimensions, magnitude);
+	template<euclidean_vector_value T>
+	basic_euclidean_vector<T>::basic_euclidean_vector(int dimensions,
+	                                                  T magnitude,
+	                                                  std::pmr::memory_resource* resource)
+	: basic_euclidean_vector(uninitialized_t{}, dimensions, resource) {
+		std::fill(data(), data() + dimensions_, magnitude);
 	};
 
-	euclidean_vector::euclidean_vector(std::vector<double>::const_iterator cbegin,
-	                                   std::vector<double>::const_iterator cend)
-	: dimensions_{static_cast<int>(std::distance(cbegin, cend))}
-	// NOLINTNEXTLINE(modernize-avoid-c-arrays)
-	, magnitude_{std::make_unique<double[]>(static_cast<size_t>(dimensions_))} {
-		std::copy(cbegin, cend, magnitude_.get());
+	template<euclidean_vector_value T>
+	basic_euclidean_vector<T>::basic_euclidean_vector(std::initializer_list<T> list,
+	                                                  std::pmr::memory_resource* resource)
+	: basic_euclidean_vector(uninitialized_t{}, static_cast<int>(list.size()), resource) {
+		std::copy(list.begin(), list.end(), data());
 	};
 
-	euclidean_vector::euclidean_vector(std::initializer_list<double> list)
-	: dimensions_{static_cast<int>(list.size())} // NOLINTNEXTLINE(modernize-avoid-c-arrays)
-	, magnitude_{std::make_unique<double[]>(static_cast<size_t>(dimensions_))} {
-		std::copy(list.begin(), list.end(), magnitude_.get());
+	template<euclidean_vector_value T>
+	basic_euclidean_vector<T>::basic_euclidean_vector(basic_euclidean_vector const& orig,
+	                                                  std::pmr::memory_resource* resource)
+	: basic_euclidean_vector(uninitialized_t{}, orig.dimensions_, resource) {
+		std::copy(orig.data(), orig.data() + dimensions_, data());
 	};
 
-	// Copy constructor
-	euclidean_vector::euclidean_vector(euclidean_vector const& orig)
-	: dimensions_{orig.dimensions_} // NOLINTNEXTLINE(modernize-avoid-c-arrays)
-	, magnitude_{std::make_unique<double[]>(static_cast<size_t>(dimensions_))} {
-		std::copy(orig.magnitude_.get(), orig.magnitude_.get() + dimensions_, magnitude_.get());
+	template<euclidean_vector_value T>
+	basic_euclidean_vector<T>::basic_euclidean_vector(uninitialized_t,
+	                                                  int dimensions,
+	                                                  std::pmr::memory_resource* resource)
+	: dimensions_{dimensions}
+	, magnitude_{allocate(dimensions_, resource)} {};
+
+	template<euclidean_vector_value T>
+	auto basic_euclidean_vector<T>::uninitialized(int dimensions,
+	                                              std::pmr::memory_resource* resource)
+	   -> basic_euclidean_vector {
+		return basic_euclidean_vector(uninitialized_t{}, dimensions, resource);
+	};
+
+	template<euclidean_vector_value T>
+	basic_euclidean_vector<T>::basic_euclidean_vector(std::vector<T>&& magnitudes)
+	: dimensions_{static_cast<int>(magnitudes.size())} {
+		if (dimensions_ <= inline_capacity) {
+			std::copy(magnitudes.begin(), magnitudes.end(), inline_magnitude_.begin());
+			return;
+		}
+		auto owner = std::make_unique<std::vector<T>>(std::move(magnitudes));
+		auto* const magnitude = owner->data();
+		magnitude_ = storage(magnitude, detail::magnitude_deleter<T>(owner.release()));
+	};
+
+	template<euclidean_vector_value T>
+	auto basic_euclidean_vector<T>::adopt(std::unique_ptr<T[]> magnitudes, int dimensions)
+	   -> basic_euclidean_vector {
+		check_dimensions_valid(dimensions);
+		if (magnitudes == nullptr and dimensions > 0) {
+			throw euclidean_vector_error("Cannot adopt a null buffer of " + std::to_string(dimensions)
+			                             + " dimensions");
+		}
+		auto vec = basic_euclidean_vector(uninitialized_t{}, 0, nullptr);
+		vec.dimensions_ = dimensions;
+		if (dimensions <= inline_capacity) {
+			std::copy(magnitudes.get(), magnitudes.get() + dimensions, vec.inline_magnitude_.begin());
+			return vec;
+		}
+		vec.magnitude_ = storage(magnitudes.release(), {});
+		return vec;
 	};
 
+	// Copy constructor
+	template<euclidean_vector_value T>
+	basic_euclidean_vector<T>::basic_euclidean_vector(basic_euclidean_vector const& orig)
+	: basic_euclidean_vector(orig, nullptr){};
+
 	// Move constructor
-	euclidean_vector::euclidean_vector(euclidean_vector&& orig) noexcept
+	// Inline magnitudes cannot be stolen, so the (small) inline buffer is always copied across.
+	// Moving a unique_ptr copies its deleter, so orig's is reset to forget any std::vector owner.
+	template<euclidean_vector_value T>
+	basic_euclidean_vector<T>::basic_euclidean_vector(basic_euclidean_vector&& orig) noexcept
 	: dimensions_{std::exchange(orig.dimensions_, 0)}
-	, magnitude_{std::move(orig.magnitude_)} {};
+	, magnitude_{std::move(orig.magnitude_)}
+	, inline_magnitude_{orig.inline_magnitude_}
+	, norm_{std::exchange(orig.norm_, {})} {
+		orig.clear();
+	};
 
 	// Copy assignment
-	auto euclidean_vector::operator=(euclidean_vector const& orig) -> euclidean_vector& {
-		auto copy = orig;
+	// Keeps this vector's memory resource, so the copy is made from it.
+	template<euclidean_vector_value T>
+	auto basic_euclidean_vector<T>::operator=(basic_euclidean_vector const& orig)
+	   -> basic_euclidean_vector& {
+		auto copy = basic_euclidean_vector(orig, resource());
 		std::swap(copy, *this);
 		return *this;
 	};
 
 	// Move assignment
-	auto euclidean_vector::operator=(euclidean_vector&& orig) noexcept -> euclidean_vector& {
-		std::swap(dimensions_, orig.dimensions_);
-		orig.dimensions_ = 0;
+	// Buffers only change hands between vectors sharing a memory resource.
+	template<euclidean_vector_value T>
+	auto basic_euclidean_vector<T>::operator=(basic_euclidean_vector&& orig)
+	   -> basic_euclidean_vector& {
+		if (&orig == this) {
+			return *this;
+		}
+		if (orig.resource() != resource()) {
+			return *this = std::as_const(orig);
+		}
+		dimensions_ = std::exchange(orig.dimensions_, 0);
 		magnitude_ = std::move(orig.magnitude_);
+		inline_magnitude_ = orig.inline_magnitude_;
+		norm_ = std::exchange(orig.norm_, {});
+		orig.clear();
 		return *this;
 	}
 
 	// Operations
-	auto euclidean_vector::operator[](int index) const noexcept -> double {
-		return magnitude_.get()[index];
+	template<euclidean_vector_value T>
+	auto basic_euclidean_vector<T>::operator[](int index) const noexcept -> T {
+		return data()[index];
 	};
 
-	auto euclidean_vector::operator[](int index) noexcept -> double& {
-		return magnitude_.get()[index];
+	template<euclidean_vector_value T>
+	auto basic_euclidean_vector<T>::operator[](int index) noexcept -> T& {
+		return data()[index];
 	};
 
-	auto euclidean_vector::operator+() const noexcept -> euclidean_vector {
+	template<euclidean_vector_value T>
+	auto basic_euclidean_vector<T>::operator+() const& noexcept -> basic_euclidean_vector {
 		return *this;
 	};
 
-	auto euclidean_vector::operator-() const noexcept -> euclidean_vector {
-		auto copy = *this;
-		std::transform(magnitude_.get(),
-		               magnitude_.get() + dimensions_,
-		               copy.magnitude_.get(),
-		               [](auto& val) { return -val; });
-		return copy;
+	template<euclidean_vector_value T>
+	auto basic_euclidean_vector<T>::operator-() const& noexcept -> basic_euclidean_vector {
+		auto negated = uninitialized(dimensions_);
+		std::transform(data(), data() + dimensions_, negated.data(), [](auto& val) {
+			return kernels::narrow<T>(-val);
+		});
+		return negated;
+	};
+
+	template<euclidean_vector_value T>
+	auto basic_euclidean_vector<T>::operator+() && noexcept -> basic_euclidean_vector {
+		return std::move(*this);
 	};
 
-	auto euclidean_vector::operator+=(euclidean_vector const& other) -> euclidean_vector& {
+	template<euclidean_vector_value T>
+	auto basic_euclidean_vector<T>::operator-() && noexcept -> basic_euclidean_vector {
+		std::transform(data(), data() + dimensions_, data(), [](auto const val) {
+			return kernels::narrow<T>(-val);
+		});
+		return std::move(*this);
+	};
+
+	template<euclidean_vector_value T>
+	auto basic_euclidean_vector<T>::operator+=(basic_euclidean_vector const& other)
+	   -> basic_euclidean_vector& {
 		check_dimensions_equal(*this, other);
-		std::transform(magnitude_.get(),
-		               magnitude_.get() + dimensions_,
-		               other.magnitude_.get(),
-		               magnitude_.get(),
-		               [](auto& val1, auto& val2) { return val1 += val2; });
+		kernels::add(data(), other.data(), static_cast<size_t>(dimensions_));
 		return *this;
 	};
 
-	auto euclidean_vector::operator-=(euclidean_vector const& other) -> euclidean_vector& {
+	template<euclidean_vector_value T>
+	auto basic_euclidean_vector<T>::operator-=(basic_euclidean_vector const& other)
+	   -> basic_euclidean_vector& {
 		check_dimensions_equal(*this, other);
-		std::transform(magnitude_.get(),
-		               magnitude_.get() + dimensions_,
-		               other.magnitude_.get(),
-		               magnitude_.get(),
-		               [](auto& val1, auto& val2) { return val1 -= val2; });
+		kernels::subtract(data(), other.data(), static_cast<size_t>(dimensions_));
 		return *this;
 	};
 
-	auto euclidean_vector::operator*=(double scalar) noexcept -> euclidean_vector& {
-		std::transform(magnitude_.get(),
-		               magnitude_.get() + dimensions_,
-		               magnitude_.get(),
-		               [&scalar](auto& val) { return val *= scalar; });
+	template<euclidean_vector_value T>
+	auto basic_euclidean_vector<T>::operator*=(double scalar) noexcept -> basic_euclidean_vector& {
+		kernels::multiply(data(),
+		                  static_cast<detail::scalar_t<T>>(scalar),
+		                  static_cast<size_t>(dimensions_));
 		return *this;
 	};
 
-	auto euclidean_vector::operator/=(double scalar) -> euclidean_vector& {
-		if (scalar == 0) {
-			throw euclidean_vector_error("Invalid vector division by 0");
-		}
-		std::transform(magnitude_.get(),
-		               magnitude_.get() + dimensions_,
-		               magnitude_.get(),
-		               [&scalar](auto& val) { return val /= scalar; });
+	template<euclidean_vector_value T>
+	auto basic_euclidean_vector<T>::operator/=(double scalar) -> basic_euclidean_vector& {
+		check_divisor_valid(scalar);
+		kernels::divide(data(),
+		                static_cast<detail::scalar_t<T>>(scalar),
+		                static_cast<size_t>(dimensions_));
 		return *this;
 	};
 
-	euclidean_vector::operator std::vector<double>() const noexcept {
-		return std::vector<double>(magnitude_.get(), magnitude_.get() + dimensions_);
+	template<euclidean_vector_value T>
+	basic_euclidean_vector<T>::operator std::vector<T>() const& noexcept {
+		return std::vector<T>(data(), data() + dimensions_);
+	};
+
+	template<euclidean_vector_value T>
+	basic_euclidean_vector<T>::operator std::vector<T>() && noexcept {
+		auto vec = std::vector<T>();
+		if (auto* const owner = magnitude_.get_deleter().owner();
+		    magnitude_ != nullptr and owner != nullptr)
+		{
+			vec = std::move(*owner);
+		}
+		else {
+			vec.assign(data(), data() + dimensions_);
+		}
+		clear();
+		return vec;
 	};
 
-	euclidean_vector::operator std::list<double>() const noexcept {
-		return std::list<double>(magnitude_.get(), magnitude_.get() + dimensions_);
+	template<euclidean_vector_value T>
+	basic_euclidean_vector<T>::operator std::list<T>() const noexcept {
+		return std::list<T>(data(), data() + dimensions_);
 	};
 
 	// Member functions
-	[[nodiscard]] auto euclidean_vector::at(int index) const -> double {
+	template<euclidean_vector_value T>
+	[[nodiscard]] auto basic_euclidean_vector<T>::at(int index) const -> T {
 		check_index_valid(*this, index);
-		return magnitude_.get()[index];
+		return data()[index];
 	};
 
-	auto euclidean_vector::at(int index) -> double& {
+	template<euclidean_vector_value T>
+	auto basic_euclidean_vector<T>::at(int index) -> T& {
 		check_index_valid(*this, index);
-		return magnitude_.get()[index];
+		return data()[index];
 	};
 
-	[[nodiscard]] auto euclidean_vector::dimensions() const noexcept -> int {
+	template<euclidean_vector_value T>
+	[[nodiscard]] auto basic_euclidean_vector<T>::dimensions() const noexcept -> int {
 		return dimensions_;
 	};
 
+	template<euclidean_vector_value T>
+	auto basic_euclidean_vector<T>::release() -> std::unique_ptr<T[]> {
+		auto released = std::unique_ptr<T[]>();
+		if (magnitude_ != nullptr and resource() == nullptr
+		    and magnitude_.get_deleter().owner() == nullptr) {
+			released.reset(magnitude_.release());
+		}
+		else {
+			released = std::make_unique_for_overwrite<T[]>(static_cast<std::size_t>(dimensions_));
+			std::copy(data(), data() + dimensions_, released.get());
+		}
+		clear();
+		return released;
+	};
+
+	template<euclidean_vector_value T>
+	auto basic_euclidean_vector<T>::clear() noexcept -> void {
+		magnitude_ = storage(nullptr, {resource(), 0});
+		dimensions_ = 0;
+		norm_.invalidate();
+	};
+
+	// Every constructor writes all magnitudes exactly once, so heap memory is left uninitialised.
+	// Inline magnitudes are small enough that they are always zeroed.
+	template<euclidean_vector_value T>
+	auto basic_euclidean_vector<T>::allocate(int dimensions, std::pmr::memory_resource* resource)
+	   -> storage {
+		check_dimensions_valid(dimensions);
+		auto const size = static_cast<std::size_t>(dimensions);
+		if (dimensions <= inline_capacity) {
+			return storage(nullptr, {resource, 0});
+		}
+		if (resource == nullptr) {
+			// NOLINTNEXTLINE(modernize-avoid-c-arrays)
+			return storage(std::make_unique_for_overwrite<T[]>(size).release(), {});
+		}
+		return storage(static_cast<T*>(resource->allocate(size * sizeof(T), alignof(T))),
+		               {resource, size});
+	};
+
 	// Utility functions
-	auto euclidean_norm(euclidean_vector const& v) noexcept -> double {
-		return v.dimensions() == 0 ? 0 : std::sqrt(euclidean_inner_product(v, v));
+	template<euclidean_vector_value T>
+	auto euclidean_norm(basic_euclidean_vector<T> const& v) noexcept -> double {
+		return detail::cached_norm(v, [&v] {
+			return v.dimensions() == 0 ? 0 : std::sqrt(euclidean_inner_product(v, v));
+		});
 	};
 
-	auto unit(euclidean_vector const& v) -> euclidean_vector {
-		if (v.dimensions() == 0) {
-			throw euclidean_vector_error("euclidean_vector with no dimensions "
-			                             "does not have a unit vector");
-		};
+	template<euclidean_vector_value T>
+	auto unit(basic_euclidean_vector<T> const& v) -> basic_euclidean_vector<T> {
 		auto norm = euclidean_norm(v);
-		if (norm == 0) {
-			throw euclidean_vector_error("euclidean_vector with zero euclidean "
-			                             "normal does not have a unit vector");
-		};
-		return v / euclidean_norm(v);
+		check_unit_vector_exists(v.dimensions(), norm);
+		return v / norm;
 	};
 
-	auto dot(euclidean_vector const& x, euclidean_vector const& y) -> double {
+	template<euclidean_vector_value T>
+	auto dot(basic_euclidean_vector<T> const& x, basic_euclidean_vector<T> const& y) -> double {
 		check_dimensions_equal(x, y);
 		return euclidean_inner_product(x, y);
 	};
 
 	// helper functions
-	auto check_dimensions_equal(euclidean_vector const& vec1, euclidean_vector const& vec2) -> void {
-		if (vec1.dimensions() != vec2.dimensions()) {
-			throw euclidean_vector_error("Dimensions of LHS(" + std::to_string(vec1.dimensions())
-			                             + ") and RHS(" + std::to_string(vec2.dimensions())
+	template<euclidean_vector_value T>
+	auto check_dimensions_equal(basic_euclidean_vector<T> const& vec1,
+	                            basic_euclidean_vector<T> const& vec2) -> void {
+		check_dimensions_equal(vec1.dimensions(), vec2.dimensions());
+	};
+
+	auto check_dimensions_equal(int lhs_dimensions, int rhs_dimensions) -> void {
+		if (lhs_dimensions != rhs_dimensions) {
+			throw euclidean_vector_error("Dimensions of LHS(" + std::to_string(lhs_dimensions)
+			                             + ") and RHS(" + std::to_string(rhs_dimensions)
 			                             + ") do not match");
 		}
 	};
 
-	auto check_index_valid(euclidean_vector const& vec, int index) -> void {
+	auto check_dimensions_valid(int dimensions) -> void {
+		if (dimensions < 0) {
+			throw euclidean_vector_error("euclidean_vector cannot have negative dimensions");
+		}
+	};
+
+	template<euclidean_vector_value T>
+	auto check_index_valid(basic_euclidean_vector<T> const& vec, int index) -> void {
 		if (index < 0 or index >= vec.dimensions()) {
 			throw euclidean_vector_error("Index " + std::to_string(index)
 			                             + " is not valid for this "
 			                               "euclidean_vector object");
 		};
 	};
+	auto check_divisor_valid(double scalar) -> void {
+		if (scalar == 0) {
+			throw euclidean_vector_error("Invalid vector division by 0");
+		}
+	};
+
+	auto check_unit_vector_exists(int dimensions, double norm) -> void {
+		if (dimensions == 0) {
+			throw euclidean_vector_error("euclidean_vector with no dimensions "
+			                             "does not have a unit vector");
+		};
+		if (norm == 0) {
+			throw euclidean_vector_error("euclidean_vector with zero euclidean "
+			                             "normal does not have a unit vector");
+		};
+	};
+
+	// Explicit instantiations for every element type
+	template class basic_euclidean_vector<double>;
+	template class basic_euclidean_vector<float>;
+	template class basic_euclidean_vector<std::int16_t>;
+	template class basic_euclidean_vector<std::int8_t>;
+
+	template auto euclidean_norm(basic_euclidean_vector<double> const& v) noexcept -> double;
+	template auto euclidean_norm(basic_euclidean_vector<float> const& v) noexcept -> double;
+	template auto euclidean_norm(basic_euclidean_vector<std::int16_t> const& v) noexcept -> double;
+	template auto euclidean_norm(basic_euclidean_vector<std::int8_t> const& v) noexcept -> double;
+
+	template auto unit(basic_euclidean_vector<double> const& v) -> basic_euclidean_vector<double>;
+	template auto unit(basic_euclidean_vector<float> const& v) -> basic_euclidean_vector<float>;
+	template auto unit(basic_euclidean_vector<std::int16_t> const& v)
+	   -> basic_euclidean_vector<std::int16_t>;
+	template auto unit(basic_euclidean_vector<std::int8_t> const& v)
+	   -> basic_euclidean_vector<std::int8_t>;
+
+	template auto dot(basic_euclidean_vector<double> const& x,
+	                  basic_euclidean_vector<double> const& y) -> double;
+	template auto dot(basic_euclidean_vector<float> const& x,
+	                  basic_euclidean_vector<float> const& y) -> double;
+	template auto dot(basic_euclidean_vector<std::int16_t> const& x,
+	                  basic_euclidean_vector<std::int16_t> const& y) -> double;
+	template auto dot(basic_euclidean_vector<std::int8_t> const& x,
+	                  basic_euclidean_vector<std::int8_t> const& y) -> double;
+
+	template auto check_dimensions_equal(basic_euclidean_vector<double> const& vec1,
+	                                     basic_euclidean_vector<double> const& vec2) -> void;
+	template auto check_dimensions_equal(basic_euclidean_vector<float> const& vec1,
+	                                     basic_euclidean_vector<float> const& vec2) -> void;
+	template auto check_dimensions_equal(basic_euclidean_vector<std::int16_t> const& vec1,
+	                                     basic_euclidean_vector<std::int16_t> const& vec2) -> void;
+	template auto check_dimensions_equal(basic_euclidean_vector<std::int8_t> const& vec1,
+	                                     basic_euclidean_vector<std::int8_t> const& vec2) -> void;
+
+	template auto check_index_valid(basic_euclidean_vector<double> const& vec, int index) -> void;
+	template auto check_index_valid(basic_euclidean_vector<float> const& vec, int index) -> void;
+	template auto check_index_valid(basic_euclidean_vector<std::int16_t> const& vec, int index)
+	   -> void;
+	template auto check_index_valid(basic_euclidean_vector<std::int8_t> const& vec, int index)
+	   -> void;
 } // namespace comp6771
@@ -0,0 +1,194 @@
+// Copyright (c) Christopher Di Bella.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+#include <comp6771/euclidean_vector_batch.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <utility>
+
+namespace comp6771 {
+	namespace {
+		// Rounds the row length up to whole cache lines when padding is requested.
+		template<typename T>
+		auto row_stride(int dimensions, typename basic_euclidean_vector_batch<T>::row_padding padding)
+		   -> int {
+			constexpr auto per_line =
+			   static_cast<int>(basic_euclidean_vector_batch<T>::alignment / sizeof(T));
+			if (padding == basic_euclidean_vector_batch<T>::row_padding::none) {
+				return dimensions;
+			}
+			return (dimensions + per_line - 1) / per_line * per_line;
+		}
+
+		// Checked before any member is initialised, since the allocation size depends on both.
+		auto checked_rows(int rows, int dimensions) -> int {
+			check_dimensions_valid(dimensions);
+			if (rows < 0) {
+				throw euclidean_vector_error("euclidean_vector_batch cannot have negative rows");
+			}
+			return rows;
+		}
+
+		template<typename T>
+		auto allocate_zeroed(std::size_t size) -> T* {
+			if (size == 0) {
+				return nullptr;
+			}
+			auto* const magnitude = static_cast<T*>(
+			   ::operator new[](size * sizeof(T),
+			                    std::align_val_t{basic_euclidean_vector_batch<T>::alignment}));
+			std::fill(magnitude, magnitude + size, T{0});
+			return magnitude;
+		}
+	} // namespace
+
+	// Constructors
+	template<euclidean_vector_value T>
+	basic_euclidean_vector_batch<T>::basic_euclidean_vector_batch()
+	: basic_euclidean_vector_batch(0, 0){};
+
+	template<euclidean_vector_value T>
+	basic_euclidean_vector_batch<T>::basic_euclidean_vector_batch(int rows,
+	                                                              int dimensions,
+	                                                              row_padding padding)
+	: rows_{checked_rows(rows, dimensions)}
+	, dimensions_{dimensions}
+	, stride_{row_stride<T>(dimensions, padding)}
+	, magnitude_{allocate_zeroed<T>(offset(rows_))} {};
+
+	template<euclidean_vector_value T>
+	basic_euclidean_vector_batch<T>::basic_euclidean_vector_batch(
+	   std::vector<basic_euclidean_vector<T>> const& vectors,
+	   row_padding padding)
+	: basic_euclidean_vector_batch(static_cast<int>(vectors.size()),
+	                               vectors.empty() ? 0 : vectors.front().dimensions(),
+	                               padding) {
+		for (auto row = 0; row < rows_; ++row) {
+			(*this)[row].assign(vectors[static_cast<std::size_t>(row)]);
+		}
+	};
+
+	// Copy constructor
+	template<euclidean_vector_value T>
+	basic_euclidean_vector_batch<T>::basic_euclidean_vector_batch(
+	   basic_euclidean_vector_batch const& orig)
+	: rows_{orig.rows_}
+	, dimensions_{orig.dimensions_}
+	, stride_{orig.stride_}
+	, magnitude_{allocate_zeroed<T>(offset(rows_))} {
+		std::copy(orig.data(), orig.data() + offset(rows_), data());
+	};
+
+	// Move constructor
+	template<euclidean_vector_value T>
+	basic_euclidean_vector_batch<T>::basic_euclidean_vector_batch(
+	   basic_euclidean_vector_batch&& orig) noexcept
+	: rows_{std::exchange(orig.rows_, 0)}
+	, dimensions_{std::exchange(orig.dimensions_, 0)}
+	, stride_{std::exchange(orig.stride_, 0)}
+	, magnitude_{std::move(orig.magnitude_)} {};
+
+	// Copy assignment
+	template<euclidean_vector_value T>
+	auto basic_euclidean_vector_batch<T>::operator=(basic_euclidean_vector_batch const& orig)
+	   -> basic_euclidean_vector_batch& {
+		auto copy = orig;
+		std::swap(copy, *this);
+		return *this;
+	};
+
+	// Move assignment
+	template<euclidean_vector_value T>
+	auto basic_euclidean_vector_batch<T>::operator=(basic_euclidean_vector_batch&& orig) noexcept
+	   -> basic_euclidean_vector_batch& {
+		rows_ = std::exchange(orig.rows_, 0);
+		dimensions_ = std::exchange(orig.dimensions_, 0);
+		stride_ = std::exchange(orig.stride_, 0);
+		magnitude_ = std::move(orig.magnitude_);
+		return *this;
+	};
+
+	// Member functions
+	template<euclidean_vector_value T>
+	auto basic_euclidean_vector_batch<T>::at(int row) -> row_type {
+		check_row_valid(row);
+		return (*this)[row];
+	};
+
+	template<euclidean_vector_value T>
+	auto basic_euclidean_vector_batch<T>::at(int row) const -> const_row_type {
+		check_row_valid(row);
+		return (*this)[row];
+	};
+
+	template<euclidean_vector_value T>
+	auto basic_euclidean_vector_batch<T>::rows() const noexcept -> int {
+		return rows_;
+	};
+
+	template<euclidean_vector_value T>
+	auto basic_euclidean_vector_batch<T>::dimensions() const noexcept -> int {
+		return dimensions_;
+	};
+
+	template<euclidean_vector_value T>
+	auto basic_euclidean_vector_batch<T>::stride() const noexcept -> int {
+		return stride_;
+	};
+
+	template<euclidean_vector_value T>
+	auto basic_euclidean_vector_batch<T>::euclidean_norms() const -> std::vector<double> {
+		auto norms = std::vector<double>(static_cast<std::size_t>(rows_));
+		auto const size = static_cast<std::size_t>(dimensions_);
+		for (auto row = 0; row < rows_; ++row) {
+			auto const* const magnitude = data() + offset(row);
+			norms[static_cast<std::size_t>(row)] =
+			   std::sqrt(detail::inner_product(magnitude, magnitude, size));
+		}
+		return norms;
+	};
+
+	template<euclidean_vector_value T>
+	auto basic_euclidean_vector_batch<T>::dot(const_row_type query) const -> std::vector<double> {
+		check_dimensions_equal(dimensions_, query.dimensions());
+		auto products = std::vector<double>(static_cast<std::size_t>(rows_));
+		auto const size = static_cast<std::size_t>(dimensions_);
+		for (auto row = 0; row < rows_; ++row) {
+			products[static_cast<std::size_t>(row)] =
+			   detail::inner_product(data() + offset(row), query.data(), size);
+		}
+		return products;
+	};
+
+	template<euclidean_vector_value T>
+	auto basic_euclidean_vector_batch<T>::normalise() -> void {
+		auto const norms = euclidean_norms();
+		for (auto const norm : norms) {
+			check_unit_vector_exists(dimensions_, norm);
+		}
+		auto const size = static_cast<std::size_t>(dimensions_);
+		for (auto row = 0; row < rows_; ++row) {
+			kernels::divide(data() + offset(row),
+			                static_cast<detail::scalar_t<T>>(norms[static_cast<std::size_t>(row)]),
+			                size);
+		}
+	};
+
+	// helper functions
+	template<euclidean_vector_value T>
+	auto basic_euclidean_vector_batch<T>::check_row_valid(int row) const -> void {
+		if (row < 0 or row >= rows_) {
+			throw euclidean_vector_error("Row " + std::to_string(row)
+			                             + " is not valid for this "
+			                               "euclidean_vector_batch object");
+		};
+	};
+
+	// Explicit instantiations for every element type
+	template class basic_euclidean_vector_batch<double>;
+	template class basic_euclidean_vector_batch<float>;
+	template class basic_euclidean_vector_batch<std::int16_t>;
+	template class basic_euclidean_vector_batch<std::int8_t>;
+} // namespace comp6771
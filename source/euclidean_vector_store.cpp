@@ -0,0 +1,414 @@
+// Copyright (c) Christopher Di Bella.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+#include <comp6771/euclidean_vector_store.hpp>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cerrno>
+#include <comp6771/serialisation.hpp>
+#include <fcntl.h>
+#include <limits>
+#include <span>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <system_error>
+#include <unistd.h>
+#include <utility>
+
+namespace comp6771 {
+	namespace {
+		constexpr auto magic = std::array<std::byte, 4>{std::byte{'E'},
+		                                                std::byte{'V'},
+		                                                std::byte{'S'},
+		                                                std::byte{'T'}};
+		constexpr auto version = std::uint8_t{1};
+		constexpr auto header_size = basic_euclidean_vector_store<double>::header_size;
+
+		struct store_header {
+			element_type type;
+			std::endian byte_order;
+			int dimensions;
+			int stride;
+			int rows;
+		};
+
+		// Writers always store rows in the byte order of the host that maps them.
+		auto encode(store_header const& header) -> std::array<std::byte, header_size> {
+			auto bytes = std::array<std::byte, header_size>();
+			std::copy(magic.begin(), magic.end(), bytes.begin());
+			bytes[4] = std::byte{version};
+			bytes[5] = static_cast<std::byte>(header.type);
+			bytes[6] = std::byte{header.byte_order == std::endian::little ? std::uint8_t{0}
+			                                                               : std::uint8_t{1}};
+			auto* const fields = bytes.data();
+			detail::store_little_endian(fields + 8, static_cast<std::uint32_t>(header.dimensions));
+			detail::store_little_endian(fields + 12, static_cast<std::uint32_t>(header.stride));
+			detail::store_little_endian(fields + 16, static_cast<std::uint64_t>(header.rows));
+			return bytes;
+		}
+
+		// Throws unless `bytes` starts with the header of a store of T in native byte order.
+		template<typename T>
+		auto decode(std::span<std::byte const> bytes) -> store_header {
+			constexpr auto max = static_cast<std::uint64_t>(std::numeric_limits<int>::max());
+			if (bytes.size() < header_size
+			    or not std::equal(magic.begin(), magic.end(), bytes.begin())
+			    or std::to_integer<std::uint8_t>(bytes[4]) != version)
+			{
+				throw euclidean_vector_error("File is not a euclidean_vector_store");
+			}
+			auto const dimensions = detail::load_little_endian<std::uint32_t>(bytes.data() + 8);
+			auto const stride = detail::load_little_endian<std::uint32_t>(bytes.data() + 12);
+			auto const rows = detail::load_little_endian<std::uint64_t>(bytes.data() + 16);
+			if (static_cast<element_type>(std::to_integer<std::uint8_t>(bytes[5]))
+			    != detail::element_type_of<T>) {
+				throw euclidean_vector_error("euclidean_vector_store does not hold this element type");
+			}
+			auto const big_endian = std::to_integer<std::uint8_t>(bytes[6]) != 0;
+			if (big_endian != (std::endian::native == std::endian::big)) {
+				throw euclidean_vector_error("euclidean_vector_store is not in native byte order");
+			}
+			if (stride < dimensions or stride > max or rows > max) {
+				throw euclidean_vector_error("File is not a euclidean_vector_store");
+			}
+			return {
+			   .type = detail::element_type_of<T>,
+			   .byte_order = std::endian::native,
+			   .dimensions = static_cast<int>(dimensions),
+			   .stride = static_cast<int>(stride),
+			   .rows = static_cast<int>(rows),
+			};
+		}
+
+		[[noreturn]] auto throw_system_error(std::string const& what) -> void {
+			throw std::system_error(errno, std::generic_category(), what);
+		}
+
+		auto open_file(std::string const& path, int flags) -> int {
+			auto const fd = ::open(path.c_str(), flags | O_CLOEXEC, 0644);
+			if (fd < 0) {
+				throw_system_error("Could not open euclidean_vector_store " + path);
+			}
+			return fd;
+		}
+
+		// Dimensions are checked first, so that no file is created for a store that cannot exist.
+		auto open_writer_file(std::string const& path, int dimensions) -> int {
+			check_dimensions_valid(dimensions);
+			return open_file(path, O_RDWR | O_CREAT);
+		}
+
+		auto file_size(int fd) -> std::size_t {
+			struct stat status = {};
+			if (::fstat(fd, &status) != 0) {
+				throw_system_error("Could not read the size of a euclidean_vector_store");
+			}
+			return static_cast<std::size_t>(status.st_size);
+		}
+
+		// Maps the whole file read-only. The mapping outlives the file descriptor.
+		auto map_file(std::string const& path) -> std::span<std::byte const> {
+			auto const fd = open_file(path, O_RDONLY);
+			auto size = std::size_t{0};
+			try {
+				size = file_size(fd);
+			} catch (...) {
+				::close(fd);
+				throw;
+			}
+			auto* const address =
+			   size < header_size ? MAP_FAILED : ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+			auto const error = errno;
+			::close(fd);
+			if (size < header_size) {
+				throw euclidean_vector_error("File is not a euclidean_vector_store");
+			}
+			if (address == MAP_FAILED) {
+				throw std::system_error(error,
+				                        std::generic_category(),
+				                        "Could not map euclidean_vector_store " + path);
+			}
+			return {static_cast<std::byte const*>(address), size};
+		}
+
+		// Writes all of `bytes` at `offset`, however many calls it takes.
+		auto write_at(int fd, std::span<std::byte const> bytes, std::size_t offset) -> void {
+			while (not bytes.empty()) {
+				auto const written =
+				   ::pwrite(fd, bytes.data(), bytes.size(), static_cast<off_t>(offset));
+				if (written < 0) {
+					if (errno == EINTR) {
+						continue;
+					}
+					throw_system_error("Could not write to a euclidean_vector_store");
+				}
+				bytes = bytes.subspan(static_cast<std::size_t>(written));
+				offset += static_cast<std::size_t>(written);
+			}
+		}
+
+		auto read_at(int fd, std::span<std::byte> bytes, std::size_t offset) -> void {
+			while (not bytes.empty()) {
+				auto const got = ::pread(fd, bytes.data(), bytes.size(), static_cast<off_t>(offset));
+				if (got < 0) {
+					if (errno == EINTR) {
+						continue;
+					}
+					throw_system_error("Could not read a euclidean_vector_store");
+				}
+				if (got == 0) {
+					throw euclidean_vector_error("File is not a euclidean_vector_store");
+				}
+				bytes = bytes.subspan(static_cast<std::size_t>(got));
+				offset += static_cast<std::size_t>(got);
+			}
+		}
+
+		// Rounds the row length up to whole cache lines when padding is requested.
+		template<typename T>
+		auto row_stride(int dimensions,
+		                typename basic_euclidean_vector_store<T>::row_padding padding) -> int {
+			constexpr auto per_line = static_cast<int>(64 / sizeof(T));
+			if (padding == basic_euclidean_vector_store<T>::row_padding::none) {
+				return dimensions;
+			}
+			return (dimensions + per_line - 1) / per_line * per_line;
+		}
+	} // namespace
+
+	// Constructors
+	template<euclidean_vector_value T>
+	basic_euclidean_vector_store<T>::basic_euclidean_vector_store(std::string const& path) {
+		auto const mapped = map_file(path);
+		mapping_ = std::unique_ptr<std::byte const, unmapper>(mapped.data(), unmapper{mapped.size()});
+		auto const header = decode<T>(mapped);
+		auto const available = (mapped.size() - header_size) / sizeof(T);
+		if (static_cast<std::size_t>(header.rows) * static_cast<std::size_t>(header.stride)
+		    > available) {
+			throw euclidean_vector_error("euclidean_vector_store is truncated");
+		}
+		rows_ = header.rows;
+		dimensions_ = header.dimensions;
+		stride_ = header.stride;
+	};
+
+	// Move constructor
+	template<euclidean_vector_value T>
+	basic_euclidean_vector_store<T>::basic_euclidean_vector_store(
+	   basic_euclidean_vector_store&& orig) noexcept
+	: rows_{std::exchange(orig.rows_, 0)}
+	, dimensions_{std::exchange(orig.dimensions_, 0)}
+	, stride_{std::exchange(orig.stride_, 0)}
+	, mapping_{std::move(orig.mapping_)} {};
+
+	// Move assignment
+	template<euclidean_vector_value T>
+	auto basic_euclidean_vector_store<T>::operator=(basic_euclidean_vector_store&& orig) noexcept
+	   -> basic_euclidean_vector_store& {
+		rows_ = std::exchange(orig.rows_, 0);
+		dimensions_ = std::exchange(orig.dimensions_, 0);
+		stride_ = std::exchange(orig.stride_, 0);
+		mapping_ = std::move(orig.mapping_);
+		return *this;
+	};
+
+	// Member functions
+	template<euclidean_vector_value T>
+	auto basic_euclidean_vector_store<T>::at(int row) const -> row_type {
+		check_row_valid(row);
+		return (*this)[row];
+	};
+
+	template<euclidean_vector_value T>
+	auto basic_euclidean_vector_store<T>::rows() const noexcept -> int {
+		return rows_;
+	};
+
+	template<euclidean_vector_value T>
+	auto basic_euclidean_vector_store<T>::dimensions() const noexcept -> int {
+		return dimensions_;
+	};
+
+	template<euclidean_vector_value T>
+	auto basic_euclidean_vector_store<T>::stride() const noexcept -> int {
+		return stride_;
+	};
+
+	template<euclidean_vector_value T>
+	auto basic_euclidean_vector_store<T>::advise(access_pattern pattern) const -> void {
+		if (not mapping_) {
+			return;
+		}
+		auto const advice = [pattern] {
+			switch (pattern) {
+			case access_pattern::normal: return MADV_NORMAL;
+			case access_pattern::sequential: return MADV_SEQUENTIAL;
+			case access_pattern::random: return MADV_RANDOM;
+			case access_pattern::will_need: return MADV_WILLNEED;
+			}
+			return MADV_NORMAL;
+		}();
+		// NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+		auto* const address = const_cast<std::byte*>(mapping_.get());
+		if (::madvise(address, mapping_.get_deleter().size_, advice) != 0) {
+			throw_system_error("Could not advise on a euclidean_vector_store");
+		}
+	};
+
+	template<euclidean_vector_value T>
+	auto basic_euclidean_vector_store<T>::unmapper::operator()(
+	   std::byte const* address) const noexcept -> void {
+		// NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+		::munmap(const_cast<std::byte*>(address), size_);
+	};
+
+	// helper functions
+	template<euclidean_vector_value T>
+	auto basic_euclidean_vector_store<T>::check_row_valid(int row) const -> void {
+		if (row < 0 or row >= rows_) {
+			throw euclidean_vector_error("Row " + std::to_string(row)
+			                             + " is not valid for this "
+			                               "euclidean_vector_store object");
+		};
+	};
+
+	// Constructors
+	template<euclidean_vector_value T>
+	basic_euclidean_vector_store_writer<T>::basic_euclidean_vector_store_writer(
+	   std::string const& path,
+	   int dimensions,
+	   row_padding padding)
+	: fd_{open_writer_file(path, dimensions)} {
+		try {
+			if (file_size(fd_) == 0) {
+				stride_ = row_stride<T>(dimensions, padding);
+				dimensions_ = dimensions;
+				write_at(fd_,
+				         encode({.type = detail::element_type_of<T>,
+				                 .byte_order = std::endian::native,
+				                 .dimensions = dimensions_,
+				                 .stride = stride_,
+				                 .rows = 0}),
+				         0);
+			}
+			else {
+				auto bytes = std::array<std::byte, header_size>();
+				read_at(fd_, bytes, 0);
+				auto const header = decode<T>(bytes);
+				check_dimensions_equal(header.dimensions, dimensions);
+				dimensions_ = header.dimensions;
+				stride_ = header.stride;
+				rows_ = header.rows;
+				flushed_rows_ = header.rows;
+			}
+		} catch (...) {
+			close();
+			throw;
+		}
+	};
+
+	// Move constructor
+	template<euclidean_vector_value T>
+	basic_euclidean_vector_store_writer<T>::basic_euclidean_vector_store_writer(
+	   basic_euclidean_vector_store_writer&& orig) noexcept
+	: fd_{std::exchange(orig.fd_, -1)}
+	, rows_{std::exchange(orig.rows_, 0)}
+	, flushed_rows_{std::exchange(orig.flushed_rows_, 0)}
+	, dimensions_{std::exchange(orig.dimensions_, 0)}
+	, stride_{std::exchange(orig.stride_, 0)}
+	, pending_{std::move(orig.pending_)} {};
+
+	// Destructor
+	template<euclidean_vector_value T>
+	basic_euclidean_vector_store_writer<T>::~basic_euclidean_vector_store_writer() {
+		close();
+	};
+
+	// Move assignment
+	template<euclidean_vector_value T>
+	auto basic_euclidean_vector_store_writer<T>::operator=(
+	   basic_euclidean_vector_store_writer&& orig) noexcept -> basic_euclidean_vector_store_writer& {
+		close();
+		fd_ = std::exchange(orig.fd_, -1);
+		rows_ = std::exchange(orig.rows_, 0);
+		flushed_rows_ = std::exchange(orig.flushed_rows_, 0);
+		dimensions_ = std::exchange(orig.dimensions_, 0);
+		stride_ = std::exchange(orig.stride_, 0);
+		pending_ = std::move(orig.pending_);
+		return *this;
+	};
+
+	// Member functions
+	template<euclidean_vector_value T>
+	auto basic_euclidean_vector_store_writer<T>::flush() -> void {
+		if (fd_ < 0 or rows_ == flushed_rows_) {
+			return;
+		}
+		auto const row_size = static_cast<std::size_t>(stride_) * sizeof(T);
+		write_at(fd_,
+		         std::as_bytes(std::span(pending_)),
+		         header_size + static_cast<std::size_t>(flushed_rows_) * row_size);
+		// The row count is only updated once the rows it covers are in the file.
+		auto rows = std::array<std::byte, 8>();
+		detail::store_little_endian(rows.data(), static_cast<std::uint64_t>(rows_));
+		write_at(fd_, rows, 16);
+		flushed_rows_ = rows_;
+		pending_.clear();
+	};
+
+	template<euclidean_vector_value T>
+	auto basic_euclidean_vector_store_writer<T>::rows() const noexcept -> int {
+		return rows_;
+	};
+
+	template<euclidean_vector_value T>
+	auto basic_euclidean_vector_store_writer<T>::dimensions() const noexcept -> int {
+		return dimensions_;
+	};
+
+	template<euclidean_vector_value T>
+	auto basic_euclidean_vector_store_writer<T>::stride() const noexcept -> int {
+		return stride_;
+	};
+
+	// helper functions
+	template<euclidean_vector_value T>
+	auto basic_euclidean_vector_store_writer<T>::append(T const* magnitudes, int dimensions)
+	   -> void {
+		// Rows are written in batches of about 1 MiB.
+		constexpr auto flush_size = (std::size_t{1} << 20U) / sizeof(T);
+		check_dimensions_equal(dimensions_, dimensions);
+		pending_.insert(pending_.end(), magnitudes, magnitudes + dimensions);
+		pending_.resize(pending_.size() + static_cast<std::size_t>(stride_ - dimensions_), T{0});
+		++rows_;
+		if (pending_.size() >= flush_size) {
+			flush();
+		}
+	};
+
+	template<euclidean_vector_value T>
+	auto basic_euclidean_vector_store_writer<T>::close() noexcept -> void {
+		if (fd_ < 0) {
+			return;
+		}
+		try {
+			flush();
+		} catch (...) {
+			// The destructor cannot report this; callers who care call flush() first.
+		}
+		::close(std::exchange(fd_, -1));
+	};
+
+	// Explicit instantiations for every element type
+	template class basic_euclidean_vector_store<double>;
+	template class basic_euclidean_vector_store<float>;
+	template class basic_euclidean_vector_store<std::int16_t>;
+	template class basic_euclidean_vector_store<std::int8_t>;
+	template class basic_euclidean_vector_store_writer<double>;
+	template class basic_euclidean_vector_store_writer<float>;
+	template class basic_euclidean_vector_store_writer<std::int16_t>;
+	template class basic_euclidean_vector_store_writer<std::int8_t>;
+} // namespace comp6771
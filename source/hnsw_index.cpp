@@ -0,0 +1,608 @@
+// Copyright (c) Christopher Di Bella.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+#include <comp6771/hnsw_index.hpp>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cerrno>
+#include <cmath>
+#include <comp6771/serialisation.hpp>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <span>
+#include <system_error>
+
+namespace comp6771 {
+	namespace {
+		constexpr auto magic = std::array<std::byte, 4>{std::byte{'E'},
+		                                                std::byte{'V'},
+		                                                std::byte{'H'},
+		                                                std::byte{'N'}};
+		constexpr auto version = std::uint8_t{1};
+		constexpr auto header_size = std::size_t{64};
+		constexpr auto no_node = std::uint32_t{0xFFFFFFFF};
+		// Levels are drawn from a geometric distribution, so this is never reached in practice.
+		constexpr auto max_level = 30;
+		// Nodes inserted by each task of a parallel build
+		constexpr auto build_chunk = std::size_t{64};
+
+		// Marks the nodes one search has visited. Each thread keeps one, and starting a search bumps
+		// the generation rather than clearing every mark.
+		class visited_nodes {
+		public:
+			auto reset(int size) -> void {
+				if (marks_.size() < static_cast<std::size_t>(size)) {
+					marks_.resize(static_cast<std::size_t>(size));
+				}
+				if (++generation_ == 0) {
+					std::fill(marks_.begin(), marks_.end(), 0);
+					generation_ = 1;
+				}
+			}
+
+			// False if `node` was already visited
+			auto insert(int node) noexcept -> bool {
+				auto& mark = marks_[static_cast<std::size_t>(node)];
+				if (mark == generation_) {
+					return false;
+				}
+				mark = generation_;
+				return true;
+			}
+
+		private:
+			std::vector<std::uint32_t> marks_;
+			std::uint32_t generation_ = 0;
+		};
+
+		auto visited_for_thread() -> visited_nodes& {
+			thread_local auto visited = visited_nodes();
+			return visited;
+		}
+
+		// Nearest on top
+		auto further(neighbour const& a, neighbour const& b) noexcept -> bool {
+			return detail::nearer(b, a);
+		}
+
+		auto check_parameters(hnsw_parameters const& parameters) -> void {
+			if (parameters.m < 2 or parameters.ef_construction < 1 or parameters.ef_search < 1) {
+				throw euclidean_vector_error("hnsw_index parameters are not valid");
+			}
+		}
+
+		[[noreturn]] auto throw_system_error(std::string const& what) -> void {
+			throw std::system_error(errno, std::generic_category(), what);
+		}
+
+		template<typename U>
+		auto write_array(std::ofstream& file, std::vector<U> const& values) -> void {
+			// NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+			file.write(reinterpret_cast<char const*>(values.data()),
+			           static_cast<std::streamsize>(values.size() * sizeof(U)));
+		}
+
+		template<typename U>
+		auto read_array(std::ifstream& file, std::vector<U>& values) -> void {
+			// NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+			file.read(reinterpret_cast<char*>(values.data()),
+			          static_cast<std::streamsize>(values.size() * sizeof(U)));
+			if (file.gcount() != static_cast<std::streamsize>(values.size() * sizeof(U))) {
+				throw euclidean_vector_error("hnsw_index is truncated");
+			}
+		}
+
+		// Throws unless every link in `links` names one of the `nodes` nodes, so that a damaged
+		// file cannot send a search out of bounds.
+		auto check_links(std::span<int const> links, int max_links, int nodes) -> void {
+			for (auto list = std::size_t{0}; list < links.size();
+			     list += static_cast<std::size_t>(max_links) + 1) {
+				auto const count = links[list];
+				if (count < 0 or count > max_links) {
+					throw euclidean_vector_error("File is not an hnsw_index");
+				}
+				for (auto i = 1; i <= count; ++i) {
+					auto const node = links[list + static_cast<std::size_t>(i)];
+					if (node < 0 or node >= nodes) {
+						throw euclidean_vector_error("File is not an hnsw_index");
+					}
+				}
+			}
+		}
+	} // namespace
+
+	// Constructors
+	template<euclidean_vector_value T>
+	basic_hnsw_index<T>::basic_hnsw_index(int dimensions,
+	                                      metric measure,
+	                                      hnsw_parameters parameters)
+	: dimensions_{dimensions}
+	, measure_{measure}
+	, parameters_{parameters}
+	, engine_{parameters.seed} {
+		check_parameters(parameters);
+	};
+
+	template<euclidean_vector_value T>
+	auto basic_hnsw_index<T>::load(std::string const& path) -> basic_hnsw_index {
+		auto file = std::ifstream(path, std::ios::binary);
+		if (not file) {
+			throw_system_error("Could not open hnsw_index " + path);
+		}
+		auto header = std::array<std::byte, header_size>();
+		// NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+		file.read(reinterpret_cast<char*>(header.data()), header_size);
+		if (file.gcount() != header_size or not std::equal(magic.begin(), magic.end(), header.begin())
+		    or std::to_integer<std::uint8_t>(header[4]) != version
+		    or std::to_integer<std::uint8_t>(header[7]) > 2)
+		{
+			throw euclidean_vector_error("File is not an hnsw_index");
+		}
+		if (static_cast<element_type>(std::to_integer<std::uint8_t>(header[5]))
+		    != detail::element_type_of<T>) {
+			throw euclidean_vector_error("hnsw_index does not hold this element type");
+		}
+		auto const big_endian = std::to_integer<std::uint8_t>(header[6]) != 0;
+		if (big_endian != (std::endian::native == std::endian::big)) {
+			throw euclidean_vector_error("hnsw_index is not in native byte order");
+		}
+
+		auto const* const fields = header.data();
+		auto const dimensions = detail::load_little_endian<std::uint32_t>(fields + 8);
+		auto const nodes = detail::load_little_endian<std::uint64_t>(fields + 16);
+		auto const entry_point = detail::load_little_endian<std::uint32_t>(fields + 36);
+		auto const top_level = detail::load_little_endian<std::uint32_t>(fields + 40);
+		constexpr auto max = static_cast<std::uint64_t>(std::numeric_limits<int>::max());
+		if (dimensions > max or nodes > max or (nodes == 0) != (entry_point == no_node)
+		    or (entry_point != no_node and (entry_point >= nodes or top_level > max_level)))
+		{
+			throw euclidean_vector_error("File is not an hnsw_index");
+		}
+		auto const field = [fields](std::size_t at) {
+			return static_cast<int>(detail::load_little_endian<std::uint32_t>(fields + at));
+		};
+		auto parameters = hnsw_parameters{
+		   .m = field(12),
+		   .ef_construction = field(24),
+		   .ef_search = field(28),
+		   .seed = detail::load_little_endian<std::uint32_t>(fields + 32),
+		};
+		if (parameters.m < 2 or parameters.m > (1 << 16)) {
+			throw euclidean_vector_error("File is not an hnsw_index");
+		}
+
+		auto index = basic_hnsw_index(static_cast<int>(dimensions),
+		                              static_cast<metric>(std::to_integer<std::uint8_t>(header[7])),
+		                              parameters);
+		// Nothing is allocated for the nodes until the file is known to hold their vectors, levels
+		// and base links, so a damaged count cannot ask for more memory than the file could fill.
+		auto const size = static_cast<std::size_t>(nodes);
+		auto const node_bytes = dimensions * sizeof(T) + sizeof(int)
+		                        + static_cast<std::size_t>(index.max_links(0) + 1) * sizeof(int);
+		if (auto const available = detail::remaining_bytes(file);
+		    available.has_value() and size > *available / node_bytes)
+		{
+			throw euclidean_vector_error("hnsw_index is truncated");
+		}
+		index.vectors_.resize(size * dimensions);
+		read_array(file, index.vectors_);
+		index.levels_.resize(size);
+		read_array(file, index.levels_);
+		index.base_links_.resize(size * static_cast<std::size_t>(index.max_links(0) + 1));
+		read_array(file, index.base_links_);
+		check_links(index.base_links_, index.max_links(0), static_cast<int>(nodes));
+		index.upper_links_.resize(size);
+		index.norms_.resize(size);
+		for (auto node = 0; node < static_cast<int>(nodes); ++node) {
+			auto const level = index.levels_[static_cast<std::size_t>(node)];
+			if (level < 0 or level > static_cast<int>(top_level)) {
+				throw euclidean_vector_error("File is not an hnsw_index");
+			}
+			auto& upper = index.upper_links_[static_cast<std::size_t>(node)];
+			upper.resize(static_cast<std::size_t>(level * (parameters.m + 1)));
+			read_array(file, upper);
+			check_links(upper, parameters.m, static_cast<int>(nodes));
+			auto const* const row = index.vectors_.data() + index.offset(node);
+			index.norms_[static_cast<std::size_t>(node)] =
+			   index.measure_ == metric::inner_product
+			      ? 0
+			      : detail::metric_norm(index.measure_, detail::inner_product(row, row, dimensions));
+		}
+		if (nodes != 0) {
+			index.entry_point_ = static_cast<int>(entry_point);
+			index.max_level_ = static_cast<int>(top_level);
+			if (index.levels_[entry_point] != index.max_level_) {
+				throw euclidean_vector_error("File is not an hnsw_index");
+			}
+		}
+		return index;
+	};
+
+	// Member functions
+	template<euclidean_vector_value T>
+	auto basic_hnsw_index<T>::save(std::string const& path) const -> void {
+		auto file = std::ofstream(path, std::ios::binary | std::ios::trunc);
+		if (not file) {
+			throw_system_error("Could not open hnsw_index " + path);
+		}
+		auto header = std::array<std::byte, header_size>();
+		std::copy(magic.begin(), magic.end(), header.begin());
+		header[4] = std::byte{version};
+		header[5] = static_cast<std::byte>(detail::element_type_of<T>);
+		header[6] = std::byte{std::endian::native == std::endian::little ? std::uint8_t{0}
+		                                                                  : std::uint8_t{1}};
+		header[7] = static_cast<std::byte>(measure_);
+		auto* const fields = header.data();
+		detail::store_little_endian(fields + 8, static_cast<std::uint32_t>(dimensions_));
+		detail::store_little_endian(fields + 12, static_cast<std::uint32_t>(parameters_.m));
+		detail::store_little_endian(fields + 16, static_cast<std::uint64_t>(size()));
+		detail::store_little_endian(fields + 24,
+		                            static_cast<std::uint32_t>(parameters_.ef_construction));
+		detail::store_little_endian(fields + 28, static_cast<std::uint32_t>(parameters_.ef_search));
+		detail::store_little_endian(fields + 32, parameters_.seed);
+		detail::store_little_endian(fields + 36,
+		                            entry_point_ < 0 ? no_node
+		                                             : static_cast<std::uint32_t>(entry_point_));
+		detail::store_little_endian(fields + 40,
+		                            max_level_ < 0 ? no_node
+		                                           : static_cast<std::uint32_t>(max_level_));
+		// NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+		file.write(reinterpret_cast<char const*>(header.data()), header_size);
+		write_array(file, vectors_);
+		write_array(file, levels_);
+		write_array(file, base_links_);
+		for (auto const& upper : upper_links_) {
+			write_array(file, upper);
+		}
+		file.flush();
+		if (not file) {
+			throw_system_error("Could not write hnsw_index " + path);
+		}
+	};
+
+	template<euclidean_vector_value T>
+	auto basic_hnsw_index<T>::size() const noexcept -> int {
+		return static_cast<int>(levels_.size());
+	};
+
+	template<euclidean_vector_value T>
+	auto basic_hnsw_index<T>::dimensions() const noexcept -> int {
+		return dimensions_;
+	};
+
+	template<euclidean_vector_value T>
+	auto basic_hnsw_index<T>::measure() const noexcept -> metric {
+		return measure_;
+	};
+
+	template<euclidean_vector_value T>
+	auto basic_hnsw_index<T>::parameters() const noexcept -> hnsw_parameters {
+		return parameters_;
+	};
+
+	template<euclidean_vector_value T>
+	auto basic_hnsw_index<T>::set_ef_search(int ef_search) -> void {
+		auto parameters = parameters_;
+		parameters.ef_search = ef_search;
+		check_parameters(parameters);
+		parameters_ = parameters;
+	};
+
+	// helper functions
+	template<euclidean_vector_value T>
+	auto basic_hnsw_index<T>::links(int node, int level) noexcept -> int* {
+		if (level == 0) {
+			return base_links_.data()
+			       + static_cast<std::size_t>(node) * static_cast<std::size_t>(max_links(0) + 1);
+		}
+		auto& upper = upper_links_[static_cast<std::size_t>(node)];
+		return upper.data() + (level - 1) * (max_links(level) + 1);
+	};
+
+	template<euclidean_vector_value T>
+	auto basic_hnsw_index<T>::links(int node, int level) const noexcept -> int const* {
+		// NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+		return const_cast<basic_hnsw_index*>(this)->links(node, level);
+	};
+
+	template<euclidean_vector_value T>
+	auto basic_hnsw_index<T>::max_links(int level) const noexcept -> int {
+		return level == 0 ? 2 * parameters_.m : parameters_.m;
+	};
+
+	template<euclidean_vector_value T>
+	auto basic_hnsw_index<T>::reserve(int nodes) -> void {
+		auto const size = static_cast<std::size_t>(nodes);
+		vectors_.reserve(size * static_cast<std::size_t>(dimensions_));
+		norms_.reserve(size);
+		levels_.reserve(size);
+		base_links_.reserve(size * static_cast<std::size_t>(max_links(0) + 1));
+		upper_links_.reserve(size);
+	};
+
+	template<euclidean_vector_value T>
+	auto basic_hnsw_index<T>::append(T const* magnitudes, int dimensions) -> void {
+		check_dimensions_equal(dimensions_, dimensions);
+		if (size() == std::numeric_limits<int>::max()) {
+			throw euclidean_vector_error("hnsw_index is full");
+		}
+		// Each level holds about 1/m of the nodes on the level below.
+		auto uniform = std::uniform_real_distribution<double>(0.0, 1.0);
+		auto const scale = 1 / std::log(static_cast<double>(parameters_.m));
+		auto const level =
+		   std::min(max_level, static_cast<int>(-std::log(1 - uniform(engine_)) * scale));
+
+		vectors_.insert(vectors_.end(), magnitudes, magnitudes + dimensions);
+		norms_.push_back(measure_ == metric::inner_product
+		                    ? 0
+		                    : detail::metric_norm(measure_,
+		                                          detail::inner_product(magnitudes,
+		                                                                magnitudes,
+		                                                                static_cast<std::size_t>(
+		                                                                   dimensions))));
+		levels_.push_back(level);
+		base_links_.resize(base_links_.size() + static_cast<std::size_t>(max_links(0) + 1));
+		upper_links_.emplace_back(static_cast<std::size_t>(level * (parameters_.m + 1)));
+	};
+
+	template<euclidean_vector_value T>
+	auto basic_hnsw_index<T>::build(thread_pool* pool, int first) -> void {
+		if (pool == nullptr or pool->size() == 1 or size() - first < 2) {
+			for (auto node = first; node < size(); ++node) {
+				insert(node, nullptr, nullptr);
+			}
+			return;
+		}
+		// Every thread may read the links of any node, so each node has a lock, and the entry point
+		// has one more. The first node becomes the entry point before any thread starts.
+		if (entry_point_ < 0) {
+			insert(first++, nullptr, nullptr);
+		}
+		auto locks = std::make_unique<std::mutex[]>(static_cast<std::size_t>(size()));
+		auto entry_lock = std::mutex();
+		auto const nodes = static_cast<std::size_t>(size() - first);
+		pool->run((nodes + build_chunk - 1) / build_chunk, [&](std::size_t chunk) {
+			auto const begin = first + static_cast<int>(chunk * build_chunk);
+			auto const end = std::min(size(), begin + static_cast<int>(build_chunk));
+			for (auto node = begin; node < end; ++node) {
+				insert(node, locks.get(), &entry_lock);
+			}
+		});
+	};
+
+	template<euclidean_vector_value T>
+	auto basic_hnsw_index<T>::insert(int node, std::mutex* locks, std::mutex* entry_lock) -> void {
+		auto const level = levels_[static_cast<std::size_t>(node)];
+		// A node that becomes the new entry point holds the lock until it is linked in.
+		auto entry_guard = entry_lock == nullptr ? std::unique_lock<std::mutex>()
+		                                         : std::unique_lock<std::mutex>(*entry_lock);
+		auto const entry_point = entry_point_;
+		auto const top_level = max_level_;
+		if (entry_guard and level <= top_level) {
+			entry_guard.unlock();
+		}
+		if (entry_point < 0) {
+			entry_point_ = node;
+			max_level_ = level;
+			return;
+		}
+
+		auto const* const query = vectors_.data() + offset(node);
+		auto const query_norm = norms_[static_cast<std::size_t>(node)];
+		auto nearest = neighbour{entry_point, distance(query, query_norm, entry_point)};
+		for (auto current = top_level; current > level; --current) {
+			nearest = greedy_search(query, query_norm, nearest, current, locks);
+		}
+		for (auto current = std::min(level, top_level); current >= 0; --current) {
+			auto candidates = search_level(query,
+			                               query_norm,
+			                               nearest,
+			                               parameters_.ef_construction,
+			                               current,
+			                               locks);
+			std::sort(candidates.begin(), candidates.end(), detail::nearer);
+			auto const selected = select_neighbours(candidates, parameters_.m);
+			{
+				auto guard = locks == nullptr ? std::unique_lock<std::mutex>()
+				                              : std::unique_lock<std::mutex>(locks[node]);
+				auto* const list = links(node, current);
+				list[0] = static_cast<int>(selected.size());
+				std::copy(selected.begin(), selected.end(), list + 1);
+			}
+			for (auto const other : selected) {
+				connect(other, node, current, locks);
+			}
+			nearest = candidates.front();
+		}
+		if (level > top_level) {
+			entry_point_ = node;
+			max_level_ = level;
+		}
+	};
+
+	// Links `node` to `neighbour`, pruning node's links if it already has as many as it may.
+	template<euclidean_vector_value T>
+	auto basic_hnsw_index<T>::connect(int node, int neighbour, int level, std::mutex* locks)
+	   -> void {
+		auto guard = locks == nullptr ? std::unique_lock<std::mutex>()
+		                              : std::unique_lock<std::mutex>(locks[node]);
+		auto* const list = links(node, level);
+		auto const count = list[0];
+		if (count < max_links(level)) {
+			list[count + 1] = neighbour;
+			++list[0];
+			return;
+		}
+
+		auto const* const row = vectors_.data() + offset(node);
+		auto const row_norm = norms_[static_cast<std::size_t>(node)];
+		auto candidates = std::vector<comp6771::neighbour>();
+		candidates.reserve(static_cast<std::size_t>(count) + 1);
+		for (auto i = 1; i <= count; ++i) {
+			candidates.push_back({list[i], distance(row, row_norm, list[i])});
+		}
+		candidates.push_back({neighbour, distance(row, row_norm, neighbour)});
+		std::sort(candidates.begin(), candidates.end(), detail::nearer);
+		auto const selected = select_neighbours(candidates, max_links(level));
+		list[0] = static_cast<int>(selected.size());
+		std::copy(selected.begin(), selected.end(), list + 1);
+	};
+
+	template<euclidean_vector_value T>
+	auto basic_hnsw_index<T>::check_search(int dimensions, int k) const -> void {
+		check_dimensions_equal(dimensions_, dimensions);
+		if (k < 0) {
+			throw euclidean_vector_error("Cannot search for a negative number of neighbours");
+		}
+	};
+
+	template<euclidean_vector_value T>
+	auto basic_hnsw_index<T>::search(T const* query, int k) const -> std::vector<neighbour> {
+		if (entry_point_ < 0 or k == 0) {
+			return {};
+		}
+		auto const query_norm =
+		   measure_ == metric::inner_product
+		      ? 0
+		      : detail::metric_norm(measure_,
+		                            detail::inner_product(query,
+		                                                  query,
+		                                                  static_cast<std::size_t>(dimensions_)));
+		auto nearest = neighbour{entry_point_, distance(query, query_norm, entry_point_)};
+		for (auto level = max_level_; level > 0; --level) {
+			nearest = greedy_search(query, query_norm, nearest, level, nullptr);
+		}
+		auto found =
+		   search_level(query, query_norm, nearest, std::max(parameters_.ef_search, k), 0, nullptr);
+		std::sort(found.begin(), found.end(), detail::nearer);
+		found.resize(std::min(found.size(), static_cast<std::size_t>(k)));
+		if (measure_ == metric::l2) {
+			for (auto& result : found) {
+				result.distance = std::sqrt(result.distance);
+			}
+		}
+		return found;
+	};
+
+	template<euclidean_vector_value T>
+	auto basic_hnsw_index<T>::distance(T const* query, double query_norm, int node) const noexcept
+	   -> double {
+		auto const product = detail::inner_product(query,
+		                                           vectors_.data() + offset(node),
+		                                           static_cast<std::size_t>(dimensions_));
+		return detail::metric_distance(measure_,
+		                               product,
+		                               query_norm,
+		                               norms_[static_cast<std::size_t>(node)]);
+	};
+
+	// Follows links on `level` to ever nearer nodes until none of them is nearer.
+	template<euclidean_vector_value T>
+	auto basic_hnsw_index<T>::greedy_search(T const* query,
+	                                        double query_norm,
+	                                        neighbour nearest,
+	                                        int level,
+	                                        std::mutex* locks) const -> neighbour {
+		auto neighbours = std::vector<int>();
+		for (auto changed = true; changed;) {
+			changed = false;
+			{
+				auto guard = locks == nullptr ? std::unique_lock<std::mutex>()
+				                              : std::unique_lock<std::mutex>(locks[nearest.index]);
+				auto const* const list = links(nearest.index, level);
+				neighbours.assign(list + 1, list + 1 + list[0]);
+			}
+			for (auto const node : neighbours) {
+				auto const candidate = neighbour{node, distance(query, query_norm, node)};
+				if (detail::nearer(candidate, nearest)) {
+					nearest = candidate;
+					changed = true;
+				}
+			}
+		}
+		return nearest;
+	};
+
+	// The `ef` nearest nodes on `level` found by a best-first search from `entry`, in no order.
+	template<euclidean_vector_value T>
+	auto basic_hnsw_index<T>::search_level(T const* query,
+	                                       double query_norm,
+	                                       neighbour entry,
+	                                       int ef,
+	                                       int level,
+	                                       std::mutex* locks) const -> std::vector<neighbour> {
+		auto& visited = visited_for_thread();
+		visited.reset(size());
+		visited.insert(entry.index);
+		// Nearest on top
+		auto candidates = std::vector<neighbour>{entry};
+		// Furthest on top
+		auto found = std::vector<neighbour>{entry};
+		found.reserve(static_cast<std::size_t>(ef) + 1);
+		auto neighbours = std::vector<int>();
+
+		while (not candidates.empty()) {
+			std::pop_heap(candidates.begin(), candidates.end(), further);
+			auto const current = candidates.back();
+			candidates.pop_back();
+			if (static_cast<int>(found.size()) >= ef and detail::nearer(found.front(), current)) {
+				break;
+			}
+			{
+				auto guard = locks == nullptr ? std::unique_lock<std::mutex>()
+				                              : std::unique_lock<std::mutex>(locks[current.index]);
+				auto const* const list = links(current.index, level);
+				neighbours.assign(list + 1, list + 1 + list[0]);
+			}
+			for (auto const node : neighbours) {
+				if (not visited.insert(node)) {
+					continue;
+				}
+				auto const candidate = neighbour{node, distance(query, query_norm, node)};
+				if (static_cast<int>(found.size()) < ef or detail::nearer(candidate, found.front())) {
+					candidates.push_back(candidate);
+					std::push_heap(candidates.begin(), candidates.end(), further);
+					found.push_back(candidate);
+					std::push_heap(found.begin(), found.end(), detail::nearer);
+					if (static_cast<int>(found.size()) > ef) {
+						std::pop_heap(found.begin(), found.end(), detail::nearer);
+						found.pop_back();
+					}
+				}
+			}
+		}
+		return found;
+	};
+
+	// Keeps up to m of `candidates`, nearest first, skipping any that is nearer to a node already
+	// kept than to the query. This keeps links pointing in different directions, which matters
+	// for clustered data.
+	template<euclidean_vector_value T>
+	auto basic_hnsw_index<T>::select_neighbours(std::vector<neighbour> const& candidates,
+	                                            int m) const -> std::vector<int> {
+		auto selected = std::vector<int>();
+		selected.reserve(static_cast<std::size_t>(m));
+		for (auto const& candidate : candidates) {
+			if (static_cast<int>(selected.size()) >= m) {
+				break;
+			}
+			auto const* const row = vectors_.data() + offset(candidate.index);
+			auto const row_norm = norms_[static_cast<std::size_t>(candidate.index)];
+			auto const diverse = std::none_of(selected.begin(), selected.end(), [&](int kept) {
+				return distance(row, row_norm, kept) < candidate.distance;
+			});
+			if (diverse) {
+				selected.push_back(candidate.index);
+			}
+		}
+		return selected;
+	};
+
+	template class basic_hnsw_index<double>;
+	template class basic_hnsw_index<float>;
+	template class basic_hnsw_index<std::int16_t>;
+	template class basic_hnsw_index<std::int8_t>;
+} // namespace comp6771
@@ -0,0 +1,417 @@
+// Copyright (c) Christopher Di Bella.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+#include <comp6771/ivf_index.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <comp6771/kernels.hpp>
+#include <comp6771/kmeans.hpp>
+#include <iterator>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <string>
+
+namespace comp6771 {
+	namespace {
+		auto check_parameters(int lists, ivf_parameters const& parameters) -> void {
+			if (lists < 1 or parameters.nprobe < 1 or parameters.iterations < 1
+			    or parameters.sample_per_list < 1) {
+				throw euclidean_vector_error("ivf_index parameters are not valid");
+			}
+		}
+	} // namespace
+
+	// Constructors
+	template<euclidean_vector_value T>
+	basic_ivf_index<T>::basic_ivf_index(int dimensions,
+	                                    int lists,
+	                                    metric measure,
+	                                    ivf_parameters parameters)
+	: dimensions_{dimensions}
+	, lists_{lists}
+	, measure_{measure}
+	, parameters_{parameters} {
+		check_parameters(lists, parameters);
+	};
+
+	// Member functions
+	template<euclidean_vector_value T>
+	auto basic_ivf_index<T>::trained() const noexcept -> bool {
+		return not inverted_lists_.empty();
+	};
+
+	template<euclidean_vector_value T>
+	auto basic_ivf_index<T>::remove(int id) -> bool {
+		if (not contains(id)) {
+			return false;
+		}
+		auto const found = locations_[static_cast<std::size_t>(id)];
+		auto& list = inverted_lists_[static_cast<std::size_t>(found.list)];
+		auto const last = static_cast<int>(list.ids.size()) - 1;
+		// The last vector in the list takes the place of the removed one.
+		if (found.position != last) {
+			auto const moved = list.ids.back();
+			std::copy_n(list.vectors.begin() + static_cast<std::ptrdiff_t>(offset(last)),
+			            dimensions_,
+			            list.vectors.begin() + static_cast<std::ptrdiff_t>(offset(found.position)));
+			list.norms[static_cast<std::size_t>(found.position)] = list.norms.back();
+			list.ids[static_cast<std::size_t>(found.position)] = moved;
+			locations_[static_cast<std::size_t>(moved)].position = found.position;
+		}
+		list.vectors.resize(offset(last));
+		list.norms.pop_back();
+		list.ids.pop_back();
+		locations_[static_cast<std::size_t>(id)] = location{};
+		--size_;
+		return true;
+	};
+
+	template<euclidean_vector_value T>
+	auto basic_ivf_index<T>::contains(int id) const noexcept -> bool {
+		return id >= 0 and static_cast<std::size_t>(id) < locations_.size()
+		       and locations_[static_cast<std::size_t>(id)].list >= 0;
+	};
+
+	template<euclidean_vector_value T>
+	auto basic_ivf_index<T>::size() const noexcept -> int {
+		return size_;
+	};
+
+	template<euclidean_vector_value T>
+	auto basic_ivf_index<T>::dimensions() const noexcept -> int {
+		return dimensions_;
+	};
+
+	template<euclidean_vector_value T>
+	auto basic_ivf_index<T>::lists() const noexcept -> int {
+		return lists_;
+	};
+
+	template<euclidean_vector_value T>
+	auto basic_ivf_index<T>::measure() const noexcept -> metric {
+		return measure_;
+	};
+
+	template<euclidean_vector_value T>
+	auto basic_ivf_index<T>::parameters() const noexcept -> ivf_parameters {
+		return parameters_;
+	};
+
+	template<euclidean_vector_value T>
+	auto basic_ivf_index<T>::list_size(int list) const -> int {
+		if (list < 0 or list >= lists_) {
+			throw euclidean_vector_error("List " + std::to_string(list)
+			                             + " is not valid for this ivf_index object");
+		}
+		return inverted_lists_.empty()
+		          ? 0
+		          : static_cast<int>(inverted_lists_[static_cast<std::size_t>(list)].ids.size());
+	};
+
+	template<euclidean_vector_value T>
+	auto basic_ivf_index<T>::centroid(int list) const -> row_type {
+		if (list < 0 or list >= lists_ or not trained()) {
+			throw euclidean_vector_error("List " + std::to_string(list)
+			                             + " is not valid for this ivf_index object");
+		}
+		return {centroids_.data() + offset(list), dimensions_};
+	};
+
+	template<euclidean_vector_value T>
+	auto basic_ivf_index<T>::set_nprobe(int nprobe) -> void {
+		auto parameters = parameters_;
+		parameters.nprobe = nprobe;
+		check_parameters(lists_, parameters);
+		parameters_ = parameters;
+	};
+
+	// helper functions
+	template<euclidean_vector_value T>
+	auto basic_ivf_index<T>::check_trainable(int rows) const -> void {
+		if (size_ > 0) {
+			throw euclidean_vector_error("Cannot train an ivf_index that holds vectors");
+		}
+		if (rows < lists_) {
+			throw euclidean_vector_error("Cannot train an ivf_index on fewer vectors than lists");
+		}
+	};
+
+	template<euclidean_vector_value T>
+	auto basic_ivf_index<T>::check_search(int dimensions, int k) const -> void {
+		check_dimensions_equal(dimensions_, dimensions);
+		if (k < 0) {
+			throw euclidean_vector_error("Cannot search for a negative number of neighbours");
+		}
+	};
+
+	// Up to sample_per_list rows for each list, chosen at random, in increasing order
+	template<euclidean_vector_value T>
+	auto basic_ivf_index<T>::sample_rows(int rows) const -> std::vector<int> {
+		auto const wanted = static_cast<std::size_t>(lists_)
+		                    * static_cast<std::size_t>(parameters_.sample_per_list);
+		auto all = std::vector<int>(static_cast<std::size_t>(rows));
+		std::iota(all.begin(), all.end(), 0);
+		if (all.size() <= wanted) {
+			return all;
+		}
+		auto chosen = std::vector<int>();
+		chosen.reserve(wanted);
+		std::sample(all.begin(),
+		            all.end(),
+		            std::back_inserter(chosen),
+		            wanted,
+		            std::mt19937(parameters_.seed));
+		return chosen;
+	};
+
+	// The lists are the clusters k-means finds in `sample`.
+	template<euclidean_vector_value T>
+	auto basic_ivf_index<T>::train(std::vector<double> const& sample) -> void {
+		auto const dimensions = static_cast<std::size_t>(dimensions_);
+		auto const lists = static_cast<std::size_t>(lists_);
+		if (dimensions == 0) {
+			centroid_norms_.assign(lists, 0.0);
+			inverted_lists_.resize(lists);
+			return;
+		}
+
+		auto rows = std::vector<double const*>(sample.size() / dimensions);
+		for (auto row = std::size_t{0}; row < rows.size(); ++row) {
+			rows[row] = sample.data() + row * dimensions;
+		}
+		auto const found = detail::kmeans(rows,
+		                                  dimensions_,
+		                                  lists_,
+		                                  {.iterations = parameters_.iterations,
+		                                   .tolerance = 0,
+		                                   .seed = parameters_.seed},
+		                                  nullptr);
+
+		centroids_.resize(lists * dimensions);
+		for (auto list = 0; list < lists_; ++list) {
+			auto const centroid = found.centroids[list];
+			std::transform(centroid.data(),
+			               centroid.data() + dimensions,
+			               centroids_.begin() + static_cast<std::ptrdiff_t>(list) * dimensions_,
+			               [](double magnitude) { return kernels::narrow<T>(magnitude); });
+		}
+		centroid_norms_.resize(lists);
+		for (auto list = std::size_t{0}; list < lists; ++list) {
+			centroid_norms_[list] = norm(centroids_.data() + list * dimensions);
+		}
+		inverted_lists_.resize(lists);
+	};
+
+	template<euclidean_vector_value T>
+	auto basic_ivf_index<T>::append(T const* magnitudes, int dimensions) -> int {
+		check_dimensions_equal(dimensions_, dimensions);
+		if (not trained()) {
+			throw euclidean_vector_error("ivf_index is not trained");
+		}
+		if (locations_.size() == static_cast<std::size_t>(std::numeric_limits<int>::max())) {
+			throw euclidean_vector_error("ivf_index is full");
+		}
+		auto const row_norm = norm(magnitudes);
+		auto const nearest = nearest_lists(magnitudes, row_norm, 1).front();
+		auto& list = inverted_lists_[static_cast<std::size_t>(nearest)];
+		auto const id = static_cast<int>(locations_.size());
+		locations_.push_back({nearest, static_cast<int>(list.ids.size())});
+		list.vectors.insert(list.vectors.end(), magnitudes, magnitudes + dimensions);
+		list.norms.push_back(row_norm);
+		list.ids.push_back(id);
+		++size_;
+		return id;
+	};
+
+	template<euclidean_vector_value T>
+	auto basic_ivf_index<T>::norm(T const* magnitudes) const noexcept -> double {
+		if (measure_ == metric::inner_product) {
+			return 0;
+		}
+		auto const squared =
+		   detail::inner_product(magnitudes, magnitudes, static_cast<std::size_t>(dimensions_));
+		return detail::metric_norm(measure_, squared);
+	};
+
+	// The `count` lists whose centroids are nearest to `query` under the index's metric
+	template<euclidean_vector_value T>
+	auto basic_ivf_index<T>::nearest_lists(T const* query, double query_norm, int count) const
+	   -> std::vector<int> {
+		auto found = detail::top_k(count);
+		for (auto list = 0; list < lists_; ++list) {
+			auto const product = detail::inner_product(query,
+			                                           centroids_.data() + offset(list),
+			                                           static_cast<std::size_t>(dimensions_));
+			found.push({list,
+			            detail::metric_distance(measure_,
+			                                    product,
+			                                    query_norm,
+			                                    centroid_norms_[static_cast<std::size_t>(list)])});
+		}
+		auto const nearest = std::move(found).take();
+		auto lists = std::vector<int>(nearest.size());
+		std::transform(nearest.begin(), nearest.end(), lists.begin(), [](neighbour const& list) {
+			return list.index;
+		});
+		return lists;
+	};
+
+	template<euclidean_vector_value T>
+	auto basic_ivf_index<T>::scan(int list,
+	                              T const* query,
+	                              double query_norm,
+	                              detail::top_k& found) const -> void {
+		auto const& scanned = inverted_lists_[static_cast<std::size_t>(list)];
+		auto const dimensions = static_cast<std::size_t>(dimensions_);
+		for (auto position = std::size_t{0}; position < scanned.ids.size(); ++position) {
+			auto const* const row = scanned.vectors.data() + position * dimensions;
+			auto const product = detail::inner_product(query, row, dimensions);
+			auto const row_norm = scanned.norms[position];
+			found.push({scanned.ids[position],
+			            detail::metric_distance(measure_, product, query_norm, row_norm)});
+		}
+	};
+
+	template<euclidean_vector_value T>
+	auto basic_ivf_index<T>::search(T const* query, int k, thread_pool* pool) const
+	   -> std::vector<neighbour> {
+		if (not trained() or k == 0) {
+			return {};
+		}
+		auto const query_norm = norm(query);
+		auto const probed = nearest_lists(query, query_norm, parameters_.nprobe);
+		auto scanned = std::size_t{0};
+		for (auto const list : probed) {
+			scanned += inverted_lists_[static_cast<std::size_t>(list)].ids.size();
+		}
+
+		auto found = detail::top_k(k);
+		if (pool == nullptr or pool->size() == 1 or probed.size() == 1
+		    or scanned * static_cast<std::size_t>(dimensions_) < parallel_threshold())
+		{
+			for (auto const list : probed) {
+				scan(list, query, query_norm, found);
+			}
+		}
+		else {
+			// Each list is scanned into its own top k, which are merged once every scan is done.
+			auto partial = std::vector<std::vector<neighbour>>(probed.size());
+			pool->run(probed.size(), [&](std::size_t list) {
+				auto nearest = detail::top_k(k);
+				scan(probed[list], query, query_norm, nearest);
+				partial[list] = std::move(nearest).take();
+			});
+			for (auto const& nearest : partial) {
+				for (auto const& candidate : nearest) {
+					found.push(candidate);
+				}
+			}
+		}
+
+		auto result = std::move(found).take();
+		if (measure_ == metric::l2) {
+			for (auto& nearest : result) {
+				nearest.distance = std::sqrt(nearest.distance);
+			}
+		}
+		return result;
+	};
+
+	// Queries are grouped by the lists they probe, so that each list is read once for a block of
+	// queries rather than once for every query, and lists are scanned in parallel. Each scan keeps
+	// a top k for every query in the block, and those are merged once every list is done.
+	template<euclidean_vector_value T>
+	auto basic_ivf_index<T>::search(std::vector<T const*> const& queries,
+	                                int k,
+	                                thread_pool* pool) const -> std::vector<std::vector<neighbour>> {
+		constexpr auto query_block = std::size_t{16};
+		auto results = std::vector<std::vector<neighbour>>(queries.size());
+		if (not trained() or k == 0 or queries.empty()) {
+			return results;
+		}
+		auto query_norms = std::vector<double>(queries.size());
+		auto probes = std::vector<std::vector<int>>(queries.size());
+		auto probe_lists = [&](std::size_t query) {
+			query_norms[query] = norm(queries[query]);
+			probes[query] = nearest_lists(queries[query], query_norms[query], parameters_.nprobe);
+		};
+		auto const serial = pool == nullptr or pool->size() == 1;
+		if (serial) {
+			for (auto query = std::size_t{0}; query < queries.size(); ++query) {
+				probe_lists(query);
+			}
+		}
+		else {
+			pool->run(queries.size(), probe_lists);
+		}
+
+		// The queries that probe each list, and the top k each of them found there
+		auto probing = std::vector<std::vector<std::size_t>>(inverted_lists_.size());
+		for (auto query = std::size_t{0}; query < queries.size(); ++query) {
+			for (auto const list : probes[query]) {
+				probing[static_cast<std::size_t>(list)].push_back(query);
+			}
+		}
+		auto partial = std::vector<std::vector<std::vector<neighbour>>>(inverted_lists_.size());
+		auto const dimensions = static_cast<std::size_t>(dimensions_);
+		auto scan_list = [&](std::size_t list) {
+			auto const& scanned = inverted_lists_[list];
+			auto const& probers = probing[list];
+			auto& nearest = partial[list];
+			nearest.reserve(probers.size());
+			for (auto first = std::size_t{0}; first < probers.size(); first += query_block) {
+				auto const last = std::min(first + query_block, probers.size());
+				auto block = std::vector<detail::top_k>(last - first, detail::top_k(k));
+				for (auto position = std::size_t{0}; position < scanned.ids.size(); ++position) {
+					auto const* const row = scanned.vectors.data() + position * dimensions;
+					auto const row_norm = scanned.norms[position];
+					for (auto query = first; query < last; ++query) {
+						auto const prober = probers[query];
+						auto const product = detail::inner_product(queries[prober], row, dimensions);
+						auto const distance =
+						   detail::metric_distance(measure_, product, query_norms[prober], row_norm);
+						block[query - first].push({scanned.ids[position], distance});
+					}
+				}
+				for (auto& found : block) {
+					nearest.push_back(std::move(found).take());
+				}
+			}
+		};
+		if (serial) {
+			for (auto list = std::size_t{0}; list < inverted_lists_.size(); ++list) {
+				scan_list(list);
+			}
+		}
+		else {
+			pool->run(inverted_lists_.size(), scan_list);
+		}
+
+		// Merged in the order the lists were probed, so results match searching one query at a time
+		auto merged = std::vector<std::size_t>(inverted_lists_.size());
+		for (auto query = std::size_t{0}; query < queries.size(); ++query) {
+			auto found = detail::top_k(k);
+			for (auto const list : probes[query]) {
+				auto const index = static_cast<std::size_t>(list);
+				for (auto const& candidate : partial[index][merged[index]]) {
+					found.push(candidate);
+				}
+				++merged[index];
+			}
+			results[query] = std::move(found).take();
+			if (measure_ == metric::l2) {
+				for (auto& nearest : results[query]) {
+					nearest.distance = std::sqrt(nearest.distance);
+				}
+			}
+		}
+		return results;
+	};
+
+	template class basic_ivf_index<double>;
+	template class basic_ivf_index<float>;
+	template class basic_ivf_index<std::int16_t>;
+	template class basic_ivf_index<std::int8_t>;
+} // namespace comp6771
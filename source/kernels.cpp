@@ -0,0 +1,1159 @@
+// Copyright (c) Christopher Di Bella.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+#include <comp6771/kernels.hpp>
+
+#include <array>
+#include <atomic>
+#include <comp6771/euclidean_vector.hpp>
+
+#if defined(__x86_64__) or defined(__i386__)
+#	define COMP6771_KERNELS_X86 1
+#	include <immintrin.h>
+#else
+#	define COMP6771_KERNELS_X86 0
+#endif
+
+namespace comp6771::kernels {
+	namespace {
+		template<typename T>
+		struct kernel_set {
+			T (*dot)(T const*, T const*, std::size_t) noexcept;
+			void (*add)(T*, T const*, std::size_t) noexcept;
+			void (*subtract)(T*, T const*, std::size_t) noexcept;
+			void (*multiply)(T*, T, std::size_t) noexcept;
+			void (*divide)(T*, T, std::size_t) noexcept;
+			bool (*approx_equal)(T const*, T const*, std::size_t, T, T) noexcept;
+		};
+
+		using lookup_kernel = void (*)(std::uint8_t const*,
+		                               std::uint8_t const*,
+		                               std::size_t,
+		                               std::size_t,
+		                               std::uint16_t*) noexcept;
+
+		using tile_kernel = void (*)(double const*, double const*, std::size_t, double*) noexcept;
+
+		struct kernel_table {
+			isa level;
+			kernel_set<double> f64;
+			kernel_set<float> f32;
+			lookup_kernel lookup_accumulate;
+			tile_kernel dot_tile;
+		};
+
+		// Plain loops. The reduction still uses four accumulators so that it is not latency bound.
+		namespace portable {
+			template<typename T>
+			auto dot(T const* x, T const* y, std::size_t size) noexcept -> T {
+				auto sum = std::array<T, 4>{};
+				auto i = std::size_t{0};
+				for (; i + 4 <= size; i += 4) {
+					sum[0] += x[i] * y[i];
+					sum[1] += x[i + 1] * y[i + 1];
+					sum[2] += x[i + 2] * y[i + 2];
+					sum[3] += x[i + 3] * y[i + 3];
+				}
+				auto total = (sum[0] + sum[1]) + (sum[2] + sum[3]);
+				for (; i < size; ++i) {
+					total += x[i] * y[i];
+				}
+				return total;
+			}
+
+			template<typename T>
+			auto add(T* x, T const* y, std::size_t size) noexcept -> void {
+				for (auto i = std::size_t{0}; i < size; ++i) {
+					x[i] += y[i];
+				}
+			}
+
+			template<typename T>
+			auto subtract(T* x, T const* y, std::size_t size) noexcept -> void {
+				for (auto i = std::size_t{0}; i < size; ++i) {
+					x[i] -= y[i];
+				}
+			}
+
+			template<typename T>
+			auto multiply(T* x, T scalar, std::size_t size) noexcept -> void {
+				for (auto i = std::size_t{0}; i < size; ++i) {
+					x[i] *= scalar;
+				}
+			}
+
+			template<typename T>
+			auto divide(T* x, T scalar, std::size_t size) noexcept -> void {
+				for (auto i = std::size_t{0}; i < size; ++i) {
+					x[i] /= scalar;
+				}
+			}
+
+			// Branch-free within each block of 64 so the comparison vectorises.
+			template<typename T>
+			auto approx_equal(T const* x, T const* y, std::size_t size, T abs_tol, T rel_tol) noexcept
+			   -> bool {
+				constexpr auto block = std::size_t{64};
+				auto i = std::size_t{0};
+				for (; i + block <= size; i += block) {
+					auto all_close = true;
+					for (auto j = i; j < i + block; ++j) {
+						all_close &= close(x[j], y[j], abs_tol, rel_tol);
+					}
+					if (not all_close) {
+						return false;
+					}
+				}
+				for (; i < size; ++i) {
+					if (not close(x[i], y[i], abs_tol, rel_tol)) {
+						return false;
+					}
+				}
+				return true;
+			}
+
+			auto lookup_accumulate(std::uint8_t const* codes,
+			                       std::uint8_t const* tables,
+			                       std::size_t pairs,
+			                       std::size_t blocks,
+			                       std::uint16_t* sums) noexcept -> void {
+				constexpr auto half = lookup_block / 2;
+				for (auto block = std::size_t{0}; block < blocks; ++block) {
+					auto* const out = sums + block * lookup_block;
+					std::fill_n(out, lookup_block, std::uint16_t{0});
+					for (auto pair = std::size_t{0}; pair < pairs; ++pair) {
+						auto const* const row = codes + (block * pairs + pair) * lookup_block;
+						auto const* const low = tables + 2 * pair * 16;
+						auto const* const high = low + 16;
+						for (auto v = std::size_t{0}; v < lookup_block; ++v) {
+							auto const position = v < half ? 2 * v : 2 * (v - half) + 1;
+							auto const byte = static_cast<unsigned>(row[position]);
+							auto const sum = out[v] + low[byte & 0xFU] + high[byte >> 4U];
+							out[v] = static_cast<std::uint16_t>(sum);
+						}
+					}
+				}
+			}
+
+			auto dot_tile(double const* a, double const* b, std::size_t depth, double* tile) noexcept
+			   -> void {
+				auto sums = std::array<double, tile_size * tile_size>{};
+				for (auto k = std::size_t{0}; k < depth; ++k) {
+					auto const* const column = b + k * tile_size;
+					for (auto i = std::size_t{0}; i < tile_size; ++i) {
+						auto const magnitude = a[k * tile_size + i];
+						for (auto j = std::size_t{0}; j < tile_size; ++j) {
+							sums[i * tile_size + j] += magnitude * column[j];
+						}
+					}
+				}
+				std::copy(sums.begin(), sums.end(), tile);
+			}
+
+			template<typename T>
+			constexpr auto kernels =
+			   kernel_set<T>{dot<T>, add<T>, subtract<T>, multiply<T>, divide<T>, approx_equal<T>};
+		} // namespace portable
+
+		constexpr auto portable_kernels = kernel_table{isa::portable,
+		                                               portable::kernels<double>,
+		                                               portable::kernels<float>,
+		                                               portable::lookup_accumulate,
+		                                               portable::dot_tile};
+
+#if COMP6771_KERNELS_X86
+		// 2 doubles per register, 4 accumulators.
+		namespace sse2 {
+			__attribute__((target("sse2"))) auto
+			dot(double const* x, double const* y, std::size_t size) noexcept -> double {
+				auto sum0 = _mm_setzero_pd();
+				auto sum1 = _mm_setzero_pd();
+				auto sum2 = _mm_setzero_pd();
+				auto sum3 = _mm_setzero_pd();
+				auto i = std::size_t{0};
+				for (; i + 8 <= size; i += 8) {
+					sum0 = _mm_add_pd(sum0, _mm_mul_pd(_mm_loadu_pd(x + i), _mm_loadu_pd(y + i)));
+					sum1 =
+					   _mm_add_pd(sum1, _mm_mul_pd(_mm_loadu_pd(x + i + 2), _mm_loadu_pd(y + i + 2)));
+					sum2 =
+					   _mm_add_pd(sum2, _mm_mul_pd(_mm_loadu_pd(x + i + 4), _mm_loadu_pd(y + i + 4)));
+					sum3 =
+					   _mm_add_pd(sum3, _mm_mul_pd(_mm_loadu_pd(x + i + 6), _mm_loadu_pd(y + i + 6)));
+				}
+				for (; i + 2 <= size; i += 2) {
+					sum0 = _mm_add_pd(sum0, _mm_mul_pd(_mm_loadu_pd(x + i), _mm_loadu_pd(y + i)));
+				}
+				auto const sum = _mm_add_pd(_mm_add_pd(sum0, sum1), _mm_add_pd(sum2, sum3));
+				auto total = _mm_cvtsd_f64(_mm_add_sd(sum, _mm_unpackhi_pd(sum, sum)));
+				for (; i < size; ++i) {
+					total += x[i] * y[i];
+				}
+				return total;
+			}
+
+			__attribute__((target("sse2"))) auto
+			add(double* x, double const* y, std::size_t size) noexcept -> void {
+				auto i = std::size_t{0};
+				for (; i + 2 <= size; i += 2) {
+					_mm_storeu_pd(x + i, _mm_add_pd(_mm_loadu_pd(x + i), _mm_loadu_pd(y + i)));
+				}
+				for (; i < size; ++i) {
+					x[i] += y[i];
+				}
+			}
+
+			__attribute__((target("sse2"))) auto
+			subtract(double* x, double const* y, std::size_t size) noexcept -> void {
+				auto i = std::size_t{0};
+				for (; i + 2 <= size; i += 2) {
+					_mm_storeu_pd(x + i, _mm_sub_pd(_mm_loadu_pd(x + i), _mm_loadu_pd(y + i)));
+				}
+				for (; i < size; ++i) {
+					x[i] -= y[i];
+				}
+			}
+
+			__attribute__((target("sse2"))) auto
+			multiply(double* x, double scalar, std::size_t size) noexcept -> void {
+				auto const factor = _mm_set1_pd(scalar);
+				auto i = std::size_t{0};
+				for (; i + 2 <= size; i += 2) {
+					_mm_storeu_pd(x + i, _mm_mul_pd(_mm_loadu_pd(x + i), factor));
+				}
+				for (; i < size; ++i) {
+					x[i] *= scalar;
+				}
+			}
+
+			__attribute__((target("sse2"))) auto
+			divide(double* x, double scalar, std::size_t size) noexcept -> void {
+				auto const divisor = _mm_set1_pd(scalar);
+				auto i = std::size_t{0};
+				for (; i + 2 <= size; i += 2) {
+					_mm_storeu_pd(x + i, _mm_div_pd(_mm_loadu_pd(x + i), divisor));
+				}
+				for (; i < size; ++i) {
+					x[i] /= scalar;
+				}
+			}
+			// 4 floats per register
+			__attribute__((target("sse2"))) auto
+			dot(float const* x, float const* y, std::size_t size) noexcept -> float {
+				auto sum0 = _mm_setzero_ps();
+				auto sum1 = _mm_setzero_ps();
+				auto sum2 = _mm_setzero_ps();
+				auto sum3 = _mm_setzero_ps();
+				auto i = std::size_t{0};
+				for (; i + 16 <= size; i += 16) {
+					sum0 = _mm_add_ps(sum0, _mm_mul_ps(_mm_loadu_ps(x + i), _mm_loadu_ps(y + i)));
+					sum1 =
+					   _mm_add_ps(sum1, _mm_mul_ps(_mm_loadu_ps(x + i + 4), _mm_loadu_ps(y + i + 4)));
+					sum2 =
+					   _mm_add_ps(sum2, _mm_mul_ps(_mm_loadu_ps(x + i + 8), _mm_loadu_ps(y + i + 8)));
+					sum3 =
+					   _mm_add_ps(sum3, _mm_mul_ps(_mm_loadu_ps(x + i + 12), _mm_loadu_ps(y + i + 12)));
+				}
+				for (; i + 4 <= size; i += 4) {
+					sum0 = _mm_add_ps(sum0, _mm_mul_ps(_mm_loadu_ps(x + i), _mm_loadu_ps(y + i)));
+				}
+				auto const sum = _mm_add_ps(_mm_add_ps(sum0, sum1), _mm_add_ps(sum2, sum3));
+				auto const half = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+				auto total = _mm_cvtss_f32(_mm_add_ss(half, _mm_shuffle_ps(half, half, 1)));
+				for (; i < size; ++i) {
+					total += x[i] * y[i];
+				}
+				return total;
+			}
+
+			__attribute__((target("sse2"))) auto
+			add(float* x, float const* y, std::size_t size) noexcept -> void {
+				auto i = std::size_t{0};
+				for (; i + 4 <= size; i += 4) {
+					_mm_storeu_ps(x + i, _mm_add_ps(_mm_loadu_ps(x + i), _mm_loadu_ps(y + i)));
+				}
+				for (; i < size; ++i) {
+					x[i] += y[i];
+				}
+			}
+
+			__attribute__((target("sse2"))) auto
+			subtract(float* x, float const* y, std::size_t size) noexcept -> void {
+				auto i = std::size_t{0};
+				for (; i + 4 <= size; i += 4) {
+					_mm_storeu_ps(x + i, _mm_sub_ps(_mm_loadu_ps(x + i), _mm_loadu_ps(y + i)));
+				}
+				for (; i < size; ++i) {
+					x[i] -= y[i];
+				}
+			}
+
+			__attribute__((target("sse2"))) auto
+			multiply(float* x, float scalar, std::size_t size) noexcept -> void {
+				auto const factor = _mm_set1_ps(scalar);
+				auto i = std::size_t{0};
+				for (; i + 4 <= size; i += 4) {
+					_mm_storeu_ps(x + i, _mm_mul_ps(_mm_loadu_ps(x + i), factor));
+				}
+				for (; i < size; ++i) {
+					x[i] *= scalar;
+				}
+			}
+
+			__attribute__((target("sse2"))) auto
+			divide(float* x, float scalar, std::size_t size) noexcept -> void {
+				auto const divisor = _mm_set1_ps(scalar);
+				auto i = std::size_t{0};
+				for (; i + 4 <= size; i += 4) {
+					_mm_storeu_ps(x + i, _mm_div_ps(_mm_loadu_ps(x + i), divisor));
+				}
+				for (; i < size; ++i) {
+					x[i] /= scalar;
+				}
+			}
+
+			// Compares 8 doubles per block, then finishes with the portable loop.
+			__attribute__((target("sse2"))) auto approx_equal(double const* x,
+			                                                  double const* y,
+			                                                  std::size_t size,
+			                                                  double abs_tol,
+			                                                  double rel_tol) noexcept -> bool {
+				auto const sign = _mm_set1_pd(-0.0);
+				auto const absolute = _mm_set1_pd(abs_tol);
+				auto const relative = _mm_set1_pd(rel_tol);
+				auto const largest_finite = _mm_set1_pd(std::numeric_limits<double>::max());
+				auto const close = [&](std::size_t offset) {
+					auto const a = _mm_loadu_pd(x + offset);
+					auto const b = _mm_loadu_pd(y + offset);
+					auto const difference = _mm_andnot_pd(sign, _mm_sub_pd(a, b));
+					auto const largest = _mm_max_pd(_mm_andnot_pd(sign, a), _mm_andnot_pd(sign, b));
+					auto const tolerance = _mm_min_pd(
+					   _mm_max_pd(absolute, _mm_mul_pd(relative, largest)), largest_finite);
+					return _mm_or_pd(_mm_cmpeq_pd(a, b), _mm_cmple_pd(difference, tolerance));
+				};
+				auto i = std::size_t{0};
+				for (; i + 8 <= size; i += 8) {
+					auto const all_close = _mm_and_pd(_mm_and_pd(close(i), close(i + 2)),
+					                                  _mm_and_pd(close(i + 4), close(i + 6)));
+					if (_mm_movemask_pd(all_close) != 0x3) {
+						return false;
+					}
+				}
+				return portable::approx_equal(x + i, y + i, size - i, abs_tol, rel_tol);
+			}
+
+			__attribute__((target("sse2"))) auto approx_equal(float const* x,
+			                                                  float const* y,
+			                                                  std::size_t size,
+			                                                  float abs_tol,
+			                                                  float rel_tol) noexcept -> bool {
+				auto const sign = _mm_set1_ps(-0.0F);
+				auto const absolute = _mm_set1_ps(abs_tol);
+				auto const relative = _mm_set1_ps(rel_tol);
+				auto const largest_finite = _mm_set1_ps(std::numeric_limits<float>::max());
+				auto const close = [&](std::size_t offset) {
+					auto const a = _mm_loadu_ps(x + offset);
+					auto const b = _mm_loadu_ps(y + offset);
+					auto const difference = _mm_andnot_ps(sign, _mm_sub_ps(a, b));
+					auto const largest = _mm_max_ps(_mm_andnot_ps(sign, a), _mm_andnot_ps(sign, b));
+					auto const tolerance = _mm_min_ps(
+					   _mm_max_ps(absolute, _mm_mul_ps(relative, largest)), largest_finite);
+					return _mm_or_ps(_mm_cmpeq_ps(a, b), _mm_cmple_ps(difference, tolerance));
+				};
+				auto i = std::size_t{0};
+				for (; i + 16 <= size; i += 16) {
+					auto const all_close = _mm_and_ps(_mm_and_ps(close(i), close(i + 4)),
+					                                  _mm_and_ps(close(i + 8), close(i + 12)));
+					if (_mm_movemask_ps(all_close) != 0xF) {
+						return false;
+					}
+				}
+				return portable::approx_equal(x + i, y + i, size - i, abs_tol, rel_tol);
+			}
+		} // namespace sse2
+
+		// 4 doubles per register, 4 fused multiply-add accumulators.
+		namespace avx2 {
+			__attribute__((target("avx2,fma"))) auto
+			dot(double const* x, double const* y, std::size_t size) noexcept -> double {
+				auto sum0 = _mm256_setzero_pd();
+				auto sum1 = _mm256_setzero_pd();
+				auto sum2 = _mm256_setzero_pd();
+				auto sum3 = _mm256_setzero_pd();
+				auto i = std::size_t{0};
+				for (; i + 16 <= size; i += 16) {
+					sum0 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i), sum0);
+					sum1 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i + 4), _mm256_loadu_pd(y + i + 4), sum1);
+					sum2 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i + 8), _mm256_loadu_pd(y + i + 8), sum2);
+					sum3 =
+					   _mm256_fmadd_pd(_mm256_loadu_pd(x + i + 12), _mm256_loadu_pd(y + i + 12), sum3);
+				}
+				for (; i + 4 <= size; i += 4) {
+					sum0 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i), sum0);
+				}
+				auto const sum = _mm256_add_pd(_mm256_add_pd(sum0, sum1), _mm256_add_pd(sum2, sum3));
+				auto const half =
+				   _mm_add_pd(_mm256_castpd256_pd128(sum), _mm256_extractf128_pd(sum, 1));
+				auto total = _mm_cvtsd_f64(_mm_add_sd(half, _mm_unpackhi_pd(half, half)));
+				for (; i < size; ++i) {
+					total += x[i] * y[i];
+				}
+				return total;
+			}
+
+			__attribute__((target("avx2"))) auto
+			add(double* x, double const* y, std::size_t size) noexcept -> void {
+				auto i = std::size_t{0};
+				for (; i + 4 <= size; i += 4) {
+					_mm256_storeu_pd(x + i,
+					                 _mm256_add_pd(_mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i)));
+				}
+				for (; i < size; ++i) {
+					x[i] += y[i];
+				}
+			}
+
+			__attribute__((target("avx2"))) auto
+			subtract(double* x, double const* y, std::size_t size) noexcept -> void {
+				auto i = std::size_t{0};
+				for (; i + 4 <= size; i += 4) {
+					_mm256_storeu_pd(x + i,
+					                 _mm256_sub_pd(_mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i)));
+				}
+				for (; i < size; ++i) {
+					x[i] -= y[i];
+				}
+			}
+
+			__attribute__((target("avx2"))) auto
+			multiply(double* x, double scalar, std::size_t size) noexcept -> void {
+				auto const factor = _mm256_set1_pd(scalar);
+				auto i = std::size_t{0};
+				for (; i + 4 <= size; i += 4) {
+					_mm256_storeu_pd(x + i, _mm256_mul_pd(_mm256_loadu_pd(x + i), factor));
+				}
+				for (; i < size; ++i) {
+					x[i] *= scalar;
+				}
+			}
+
+			__attribute__((target("avx2"))) auto
+			divide(double* x, double scalar, std::size_t size) noexcept -> void {
+				auto const divisor = _mm256_set1_pd(scalar);
+				auto i = std::size_t{0};
+				for (; i + 4 <= size; i += 4) {
+					_mm256_storeu_pd(x + i, _mm256_div_pd(_mm256_loadu_pd(x + i), divisor));
+				}
+				for (; i < size; ++i) {
+					x[i] /= scalar;
+				}
+			}
+			// 8 floats per register
+			__attribute__((target("avx2,fma"))) auto
+			dot(float const* x, float const* y, std::size_t size) noexcept -> float {
+				auto sum0 = _mm256_setzero_ps();
+				auto sum1 = _mm256_setzero_ps();
+				auto sum2 = _mm256_setzero_ps();
+				auto sum3 = _mm256_setzero_ps();
+				auto i = std::size_t{0};
+				for (; i + 32 <= size; i += 32) {
+					sum0 = _mm256_fmadd_ps(_mm256_loadu_ps(x + i), _mm256_loadu_ps(y + i), sum0);
+					sum1 = _mm256_fmadd_ps(_mm256_loadu_ps(x + i + 8), _mm256_loadu_ps(y + i + 8), sum1);
+					sum2 =
+					   _mm256_fmadd_ps(_mm256_loadu_ps(x + i + 16), _mm256_loadu_ps(y + i + 16), sum2);
+					sum3 =
+					   _mm256_fmadd_ps(_mm256_loadu_ps(x + i + 24), _mm256_loadu_ps(y + i + 24), sum3);
+				}
+				for (; i + 8 <= size; i += 8) {
+					sum0 = _mm256_fmadd_ps(_mm256_loadu_ps(x + i), _mm256_loadu_ps(y + i), sum0);
+				}
+				auto const sum = _mm256_add_ps(_mm256_add_ps(sum0, sum1), _mm256_add_ps(sum2, sum3));
+				auto const quarter =
+				   _mm_add_ps(_mm256_castps256_ps128(sum), _mm256_extractf128_ps(sum, 1));
+				auto const half = _mm_add_ps(quarter, _mm_movehl_ps(quarter, quarter));
+				auto total = _mm_cvtss_f32(_mm_add_ss(half, _mm_shuffle_ps(half, half, 1)));
+				for (; i < size; ++i) {
+					total += x[i] * y[i];
+				}
+				return total;
+			}
+
+			__attribute__((target("avx2"))) auto
+			add(float* x, float const* y, std::size_t size) noexcept -> void {
+				auto i = std::size_t{0};
+				for (; i + 8 <= size; i += 8) {
+					_mm256_storeu_ps(x + i,
+					                 _mm256_add_ps(_mm256_loadu_ps(x + i), _mm256_loadu_ps(y + i)));
+				}
+				for (; i < size; ++i) {
+					x[i] += y[i];
+				}
+			}
+
+			__attribute__((target("avx2"))) auto
+			subtract(float* x, float const* y, std::size_t size) noexcept -> void {
+				auto i = std::size_t{0};
+				for (; i + 8 <= size; i += 8) {
+					_mm256_storeu_ps(x + i,
+					                 _mm256_sub_ps(_mm256_loadu_ps(x + i), _mm256_loadu_ps(y + i)));
+				}
+				for (; i < size; ++i) {
+					x[i] -= y[i];
+				}
+			}
+
+			__attribute__((target("avx2"))) auto
+			multiply(float* x, float scalar, std::size_t size) noexcept -> void {
+				auto const factor = _mm256_set1_ps(scalar);
+				auto i = std::size_t{0};
+				for (; i + 8 <= size; i += 8) {
+					_mm256_storeu_ps(x + i, _mm256_mul_ps(_mm256_loadu_ps(x + i), factor));
+				}
+				for (; i < size; ++i) {
+					x[i] *= scalar;
+				}
+			}
+
+			__attribute__((target("avx2"))) auto
+			divide(float* x, float scalar, std::size_t size) noexcept -> void {
+				auto const divisor = _mm256_set1_ps(scalar);
+				auto i = std::size_t{0};
+				for (; i + 8 <= size; i += 8) {
+					_mm256_storeu_ps(x + i, _mm256_div_ps(_mm256_loadu_ps(x + i), divisor));
+				}
+				for (; i < size; ++i) {
+					x[i] /= scalar;
+				}
+			}
+
+			// Compares 16 doubles per block, then finishes with the portable loop.
+			__attribute__((target("avx2"))) auto approx_equal(double const* x,
+			                                                  double const* y,
+			                                                  std::size_t size,
+			                                                  double abs_tol,
+			                                                  double rel_tol) noexcept -> bool {
+				auto const sign = _mm256_set1_pd(-0.0);
+				auto const absolute = _mm256_set1_pd(abs_tol);
+				auto const relative = _mm256_set1_pd(rel_tol);
+				auto const largest_finite = _mm256_set1_pd(std::numeric_limits<double>::max());
+				auto const close = [&](std::size_t offset) __attribute__((target("avx2"))) {
+					auto const a = _mm256_loadu_pd(x + offset);
+					auto const b = _mm256_loadu_pd(y + offset);
+					auto const difference = _mm256_andnot_pd(sign, _mm256_sub_pd(a, b));
+					auto const largest =
+					   _mm256_max_pd(_mm256_andnot_pd(sign, a), _mm256_andnot_pd(sign, b));
+					auto const tolerance = _mm256_min_pd(
+					   _mm256_max_pd(absolute, _mm256_mul_pd(relative, largest)), largest_finite);
+					return _mm256_or_pd(_mm256_cmp_pd(a, b, _CMP_EQ_OQ),
+					                    _mm256_cmp_pd(difference, tolerance, _CMP_LE_OQ));
+				};
+				auto i = std::size_t{0};
+				for (; i + 16 <= size; i += 16) {
+					auto const all_close = _mm256_and_pd(_mm256_and_pd(close(i), close(i + 4)),
+					                                     _mm256_and_pd(close(i + 8), close(i + 12)));
+					if (_mm256_movemask_pd(all_close) != 0xF) {
+						return false;
+					}
+				}
+				return portable::approx_equal(x + i, y + i, size - i, abs_tol, rel_tol);
+			}
+
+			__attribute__((target("avx2"))) auto approx_equal(float const* x,
+			                                                  float const* y,
+			                                                  std::size_t size,
+			                                                  float abs_tol,
+			                                                  float rel_tol) noexcept -> bool {
+				auto const sign = _mm256_set1_ps(-0.0F);
+				auto const absolute = _mm256_set1_ps(abs_tol);
+				auto const relative = _mm256_set1_ps(rel_tol);
+				auto const largest_finite = _mm256_set1_ps(std::numeric_limits<float>::max());
+				auto const close = [&](std::size_t offset) __attribute__((target("avx2"))) {
+					auto const a = _mm256_loadu_ps(x + offset);
+					auto const b = _mm256_loadu_ps(y + offset);
+					auto const difference = _mm256_andnot_ps(sign, _mm256_sub_ps(a, b));
+					auto const largest =
+					   _mm256_max_ps(_mm256_andnot_ps(sign, a), _mm256_andnot_ps(sign, b));
+					auto const tolerance = _mm256_min_ps(
+					   _mm256_max_ps(absolute, _mm256_mul_ps(relative, largest)), largest_finite);
+					return _mm256_or_ps(_mm256_cmp_ps(a, b, _CMP_EQ_OQ),
+					                    _mm256_cmp_ps(difference, tolerance, _CMP_LE_OQ));
+				};
+				auto i = std::size_t{0};
+				for (; i + 32 <= size; i += 32) {
+					auto const all_close = _mm256_and_ps(_mm256_and_ps(close(i), close(i + 8)),
+					                                     _mm256_and_ps(close(i + 16), close(i + 24)));
+					if (_mm256_movemask_ps(all_close) != 0xFF) {
+						return false;
+					}
+				}
+				return portable::approx_equal(x + i, y + i, size - i, abs_tol, rel_tol);
+			}
+
+			// Each byte shuffle looks up the codes of 32 vectors in one subspace's table, which is
+			// repeated in both halves of the register. The byte results are summed as 16-bit lanes:
+			// the even bytes hold vectors 0 to 15 and the odd bytes hold vectors 16 to 31.
+			__attribute__((target("avx2"))) auto lookup_accumulate(std::uint8_t const* codes,
+			                                                      std::uint8_t const* tables,
+			                                                      std::size_t pairs,
+			                                                      std::size_t blocks,
+			                                                      std::uint16_t* sums) noexcept
+			   -> void {
+				auto const nibble = _mm256_set1_epi8(0xF);
+				auto const low_byte = _mm256_set1_epi16(0xFF);
+				for (auto block = std::size_t{0}; block < blocks; ++block) {
+					auto even = _mm256_setzero_si256();
+					auto odd = _mm256_setzero_si256();
+					for (auto pair = std::size_t{0}; pair < pairs; ++pair) {
+						auto const* const row = codes + (block * pairs + pair) * lookup_block;
+						auto const* const table = tables + 2 * pair * 16;
+						auto const packed = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(row));
+						auto const low_codes = _mm256_and_si256(packed, nibble);
+						auto const high_codes = _mm256_and_si256(_mm256_srli_epi16(packed, 4), nibble);
+						auto const low_table = _mm256_broadcastsi128_si256(
+						   _mm_loadu_si128(reinterpret_cast<__m128i const*>(table)));
+						auto const high_table = _mm256_broadcastsi128_si256(
+						   _mm_loadu_si128(reinterpret_cast<__m128i const*>(table + 16)));
+						auto const low = _mm256_shuffle_epi8(low_table, low_codes);
+						auto const high = _mm256_shuffle_epi8(high_table, high_codes);
+						even = _mm256_add_epi16(even, _mm256_and_si256(low, low_byte));
+						even = _mm256_add_epi16(even, _mm256_and_si256(high, low_byte));
+						odd = _mm256_add_epi16(odd, _mm256_srli_epi16(low, 8));
+						odd = _mm256_add_epi16(odd, _mm256_srli_epi16(high, 8));
+					}
+					auto* const out = sums + block * lookup_block;
+					_mm256_storeu_si256(reinterpret_cast<__m256i*>(out), even);
+					_mm256_storeu_si256(reinterpret_cast<__m256i*>(out + lookup_block / 2), odd);
+				}
+			}
+
+			// Each half of the tile is 4 rows of 2 registers, 8 accumulators that leave room for
+			// the columns and the broadcast row element.
+			__attribute__((target("avx2,fma"))) auto
+			dot_tile(double const* a, double const* b, std::size_t depth, double* tile) noexcept
+			   -> void {
+				for (auto half = std::size_t{0}; half < tile_size; half += 4) {
+					auto sum00 = _mm256_setzero_pd();
+					auto sum01 = _mm256_setzero_pd();
+					auto sum10 = _mm256_setzero_pd();
+					auto sum11 = _mm256_setzero_pd();
+					auto sum20 = _mm256_setzero_pd();
+					auto sum21 = _mm256_setzero_pd();
+					auto sum30 = _mm256_setzero_pd();
+					auto sum31 = _mm256_setzero_pd();
+					for (auto k = std::size_t{0}; k < depth; ++k) {
+						auto const left = _mm256_loadu_pd(b + k * tile_size);
+						auto const right = _mm256_loadu_pd(b + k * tile_size + 4);
+						auto const* const rows = a + k * tile_size + half;
+						auto const row0 = _mm256_broadcast_sd(rows);
+						sum00 = _mm256_fmadd_pd(row0, left, sum00);
+						sum01 = _mm256_fmadd_pd(row0, right, sum01);
+						auto const row1 = _mm256_broadcast_sd(rows + 1);
+						sum10 = _mm256_fmadd_pd(row1, left, sum10);
+						sum11 = _mm256_fmadd_pd(row1, right, sum11);
+						auto const row2 = _mm256_broadcast_sd(rows + 2);
+						sum20 = _mm256_fmadd_pd(row2, left, sum20);
+						sum21 = _mm256_fmadd_pd(row2, right, sum21);
+						auto const row3 = _mm256_broadcast_sd(rows + 3);
+						sum30 = _mm256_fmadd_pd(row3, left, sum30);
+						sum31 = _mm256_fmadd_pd(row3, right, sum31);
+					}
+					auto* const out = tile + half * tile_size;
+					_mm256_storeu_pd(out, sum00);
+					_mm256_storeu_pd(out + 4, sum01);
+					_mm256_storeu_pd(out + tile_size, sum10);
+					_mm256_storeu_pd(out + tile_size + 4, sum11);
+					_mm256_storeu_pd(out + 2 * tile_size, sum20);
+					_mm256_storeu_pd(out + 2 * tile_size + 4, sum21);
+					_mm256_storeu_pd(out + 3 * tile_size, sum30);
+					_mm256_storeu_pd(out + 3 * tile_size + 4, sum31);
+				}
+			}
+		} // namespace avx2
+
+		// 8 doubles per register, 4 fused multiply-add accumulators. Tails use masked loads and
+		// stores instead of a scalar loop.
+		namespace avx512 {
+			__attribute__((target("avx512f"))) auto tail_mask(std::size_t remaining) noexcept
+			   -> __mmask8 {
+				return static_cast<__mmask8>((1U << remaining) - 1U);
+			}
+
+			__attribute__((target("avx512f"))) auto
+			dot(double const* x, double const* y, std::size_t size) noexcept -> double {
+				auto sum0 = _mm512_setzero_pd();
+				auto sum1 = _mm512_setzero_pd();
+				auto sum2 = _mm512_setzero_pd();
+				auto sum3 = _mm512_setzero_pd();
+				auto i = std::size_t{0};
+				for (; i + 32 <= size; i += 32) {
+					sum0 = _mm512_fmadd_pd(_mm512_loadu_pd(x + i), _mm512_loadu_pd(y + i), sum0);
+					sum1 = _mm512_fmadd_pd(_mm512_loadu_pd(x + i + 8), _mm512_loadu_pd(y + i + 8), sum1);
+					sum2 =
+					   _mm512_fmadd_pd(_mm512_loadu_pd(x + i + 16), _mm512_loadu_pd(y + i + 16), sum2);
+					sum3 =
+					   _mm512_fmadd_pd(_mm512_loadu_pd(x + i + 24), _mm512_loadu_pd(y + i + 24), sum3);
+				}
+				for (; i + 8 <= size; i += 8) {
+					sum0 = _mm512_fmadd_pd(_mm512_loadu_pd(x + i), _mm512_loadu_pd(y + i), sum0);
+				}
+				if (i < size) {
+					auto const mask = tail_mask(size - i);
+					sum1 = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(mask, x + i),
+					                       _mm512_maskz_loadu_pd(mask, y + i),
+					                       sum1);
+				}
+				return _mm512_reduce_add_pd(_mm512_add_pd(_mm512_add_pd(sum0, sum1),
+				                                          _mm512_add_pd(sum2, sum3)));
+			}
+
+			__attribute__((target("avx512f"))) auto
+			add(double* x, double const* y, std::size_t size) noexcept -> void {
+				auto i = std::size_t{0};
+				for (; i + 8 <= size; i += 8) {
+					_mm512_storeu_pd(x + i,
+					                 _mm512_add_pd(_mm512_loadu_pd(x + i), _mm512_loadu_pd(y + i)));
+				}
+				if (i < size) {
+					auto const mask = tail_mask(size - i);
+					_mm512_mask_storeu_pd(x + i,
+					                      mask,
+					                      _mm512_add_pd(_mm512_maskz_loadu_pd(mask, x + i),
+					                                    _mm512_maskz_loadu_pd(mask, y + i)));
+				}
+			}
+
+			__attribute__((target("avx512f"))) auto
+			subtract(double* x, double const* y, std::size_t size) noexcept -> void {
+				auto i = std::size_t{0};
+				for (; i + 8 <= size; i += 8) {
+					_mm512_storeu_pd(x + i,
+					                 _mm512_sub_pd(_mm512_loadu_pd(x + i), _mm512_loadu_pd(y + i)));
+				}
+				if (i < size) {
+					auto const mask = tail_mask(size - i);
+					_mm512_mask_storeu_pd(x + i,
+					                      mask,
+					                      _mm512_sub_pd(_mm512_maskz_loadu_pd(mask, x + i),
+					                                    _mm512_maskz_loadu_pd(mask, y + i)));
+				}
+			}
+
+			__attribute__((target("avx512f"))) auto
+			multiply(double* x, double scalar, std::size_t size) noexcept -> void {
+				auto const factor = _mm512_set1_pd(scalar);
+				auto i = std::size_t{0};
+				for (; i + 8 <= size; i += 8) {
+					_mm512_storeu_pd(x + i, _mm512_mul_pd(_mm512_loadu_pd(x + i), factor));
+				}
+				if (i < size) {
+					auto const mask = tail_mask(size - i);
+					_mm512_mask_storeu_pd(x + i,
+					                      mask,
+					                      _mm512_mul_pd(_mm512_maskz_loadu_pd(mask, x + i), factor));
+				}
+			}
+
+			// Masked-off lanes divide 0 by the divisor, which cannot raise a spurious exception flag
+			// for the non-zero divisors euclidean_vector allows.
+			__attribute__((target("avx512f"))) auto
+			divide(double* x, double scalar, std::size_t size) noexcept -> void {
+				auto const divisor = _mm512_set1_pd(scalar);
+				auto i = std::size_t{0};
+				for (; i + 8 <= size; i += 8) {
+					_mm512_storeu_pd(x + i, _mm512_div_pd(_mm512_loadu_pd(x + i), divisor));
+				}
+				if (i < size) {
+					auto const mask = tail_mask(size - i);
+					_mm512_mask_storeu_pd(x + i,
+					                      mask,
+					                      _mm512_div_pd(_mm512_maskz_loadu_pd(mask, x + i), divisor));
+				}
+			}
+			// 16 floats per register
+			__attribute__((target("avx512f"))) auto tail_mask_f32(std::size_t remaining) noexcept
+			   -> __mmask16 {
+				return static_cast<__mmask16>((1U << remaining) - 1U);
+			}
+
+			__attribute__((target("avx512f"))) auto
+			dot(float const* x, float const* y, std::size_t size) noexcept -> float {
+				auto sum0 = _mm512_setzero_ps();
+				auto sum1 = _mm512_setzero_ps();
+				auto sum2 = _mm512_setzero_ps();
+				auto sum3 = _mm512_setzero_ps();
+				auto i = std::size_t{0};
+				for (; i + 64 <= size; i += 64) {
+					sum0 = _mm512_fmadd_ps(_mm512_loadu_ps(x + i), _mm512_loadu_ps(y + i), sum0);
+					sum1 =
+					   _mm512_fmadd_ps(_mm512_loadu_ps(x + i + 16), _mm512_loadu_ps(y + i + 16), sum1);
+					sum2 =
+					   _mm512_fmadd_ps(_mm512_loadu_ps(x + i + 32), _mm512_loadu_ps(y + i + 32), sum2);
+					sum3 =
+					   _mm512_fmadd_ps(_mm512_loadu_ps(x + i + 48), _mm512_loadu_ps(y + i + 48), sum3);
+				}
+				for (; i + 16 <= size; i += 16) {
+					sum0 = _mm512_fmadd_ps(_mm512_loadu_ps(x + i), _mm512_loadu_ps(y + i), sum0);
+				}
+				if (i < size) {
+					auto const mask = tail_mask_f32(size - i);
+					sum1 = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(mask, x + i),
+					                       _mm512_maskz_loadu_ps(mask, y + i),
+					                       sum1);
+				}
+				return _mm512_reduce_add_ps(_mm512_add_ps(_mm512_add_ps(sum0, sum1),
+				                                          _mm512_add_ps(sum2, sum3)));
+			}
+
+			__attribute__((target("avx512f"))) auto
+			add(float* x, float const* y, std::size_t size) noexcept -> void {
+				auto i = std::size_t{0};
+				for (; i + 16 <= size; i += 16) {
+					_mm512_storeu_ps(x + i,
+					                 _mm512_add_ps(_mm512_loadu_ps(x + i), _mm512_loadu_ps(y + i)));
+				}
+				if (i < size) {
+					auto const mask = tail_mask_f32(size - i);
+					_mm512_mask_storeu_ps(x + i,
+					                      mask,
+					                      _mm512_add_ps(_mm512_maskz_loadu_ps(mask, x + i),
+					                                    _mm512_maskz_loadu_ps(mask, y + i)));
+				}
+			}
+
+			__attribute__((target("avx512f"))) auto
+			subtract(float* x, float const* y, std::size_t size) noexcept -> void {
+				auto i = std::size_t{0};
+				for (; i + 16 <= size; i += 16) {
+					_mm512_storeu_ps(x + i,
+					                 _mm512_sub_ps(_mm512_loadu_ps(x + i), _mm512_loadu_ps(y + i)));
+				}
+				if (i < size) {
+					auto const mask = tail_mask_f32(size - i);
+					_mm512_mask_storeu_ps(x + i,
+					                      mask,
+					                      _mm512_sub_ps(_mm512_maskz_loadu_ps(mask, x + i),
+					                                    _mm512_maskz_loadu_ps(mask, y + i)));
+				}
+			}
+
+			__attribute__((target("avx512f"))) auto
+			multiply(float* x, float scalar, std::size_t size) noexcept -> void {
+				auto const factor = _mm512_set1_ps(scalar);
+				auto i = std::size_t{0};
+				for (; i + 16 <= size; i += 16) {
+					_mm512_storeu_ps(x + i, _mm512_mul_ps(_mm512_loadu_ps(x + i), factor));
+				}
+				if (i < size) {
+					auto const mask = tail_mask_f32(size - i);
+					_mm512_mask_storeu_ps(x + i,
+					                      mask,
+					                      _mm512_mul_ps(_mm512_maskz_loadu_ps(mask, x + i), factor));
+				}
+			}
+
+			__attribute__((target("avx512f"))) auto
+			divide(float* x, float scalar, std::size_t size) noexcept -> void {
+				auto const divisor = _mm512_set1_ps(scalar);
+				auto i = std::size_t{0};
+				for (; i + 16 <= size; i += 16) {
+					_mm512_storeu_ps(x + i, _mm512_div_ps(_mm512_loadu_ps(x + i), divisor));
+				}
+				if (i < size) {
+					auto const mask = tail_mask_f32(size - i);
+					_mm512_mask_storeu_ps(x + i,
+					                      mask,
+					                      _mm512_div_ps(_mm512_maskz_loadu_ps(mask, x + i), divisor));
+				}
+			}
+
+			// Compares 32 doubles per block, with a masked tail.
+			__attribute__((target("avx512f"))) auto approx_equal(double const* x,
+			                                                     double const* y,
+			                                                     std::size_t size,
+			                                                     double abs_tol,
+			                                                     double rel_tol) noexcept -> bool {
+				auto const absolute = _mm512_set1_pd(abs_tol);
+				auto const relative = _mm512_set1_pd(rel_tol);
+				auto const largest_finite = _mm512_set1_pd(std::numeric_limits<double>::max());
+				auto const close = [&](__m512d a, __m512d b) __attribute__((target("avx512f"))) {
+					auto const difference = _mm512_abs_pd(_mm512_sub_pd(a, b));
+					auto const largest = _mm512_max_pd(_mm512_abs_pd(a), _mm512_abs_pd(b));
+					auto const tolerance = _mm512_min_pd(
+					   _mm512_max_pd(absolute, _mm512_mul_pd(relative, largest)), largest_finite);
+					return static_cast<__mmask8>(
+					   _mm512_cmp_pd_mask(a, b, _CMP_EQ_OQ)
+					   | _mm512_cmp_pd_mask(difference, tolerance, _CMP_LE_OQ));
+				};
+				auto const at = [&](std::size_t offset) __attribute__((target("avx512f"))) {
+					return close(_mm512_loadu_pd(x + offset), _mm512_loadu_pd(y + offset));
+				};
+				auto i = std::size_t{0};
+				for (; i + 32 <= size; i += 32) {
+					if ((at(i) & at(i + 8) & at(i + 16) & at(i + 24)) != 0xFF) {
+						return false;
+					}
+				}
+				for (; i + 8 <= size; i += 8) {
+					if (at(i) != 0xFF) {
+						return false;
+					}
+				}
+				if (i < size) {
+					auto const mask = tail_mask(size - i);
+					auto const lanes =
+					   close(_mm512_maskz_loadu_pd(mask, x + i), _mm512_maskz_loadu_pd(mask, y + i));
+					return (lanes & mask) == mask;
+				}
+				return true;
+			}
+
+			// Compares 64 floats per block, with a masked tail.
+			__attribute__((target("avx512f"))) auto approx_equal(float const* x,
+			                                                     float const* y,
+			                                                     std::size_t size,
+			                                                     float abs_tol,
+			                                                     float rel_tol) noexcept -> bool {
+				auto const absolute = _mm512_set1_ps(abs_tol);
+				auto const relative = _mm512_set1_ps(rel_tol);
+				auto const largest_finite = _mm512_set1_ps(std::numeric_limits<float>::max());
+				auto const close = [&](__m512 a, __m512 b) __attribute__((target("avx512f"))) {
+					auto const difference = _mm512_abs_ps(_mm512_sub_ps(a, b));
+					auto const largest = _mm512_max_ps(_mm512_abs_ps(a), _mm512_abs_ps(b));
+					auto const tolerance = _mm512_min_ps(
+					   _mm512_max_ps(absolute, _mm512_mul_ps(relative, largest)), largest_finite);
+					return static_cast<__mmask16>(
+					   _mm512_cmp_ps_mask(a, b, _CMP_EQ_OQ)
+					   | _mm512_cmp_ps_mask(difference, tolerance, _CMP_LE_OQ));
+				};
+				auto const at = [&](std::size_t offset) __attribute__((target("avx512f"))) {
+					return close(_mm512_loadu_ps(x + offset), _mm512_loadu_ps(y + offset));
+				};
+				auto i = std::size_t{0};
+				for (; i + 64 <= size; i += 64) {
+					if ((at(i) & at(i + 16) & at(i + 32) & at(i + 48)) != 0xFFFF) {
+						return false;
+					}
+				}
+				for (; i + 16 <= size; i += 16) {
+					if (at(i) != 0xFFFF) {
+						return false;
+					}
+				}
+				if (i < size) {
+					auto const mask = tail_mask_f32(size - i);
+					auto const lanes =
+					   close(_mm512_maskz_loadu_ps(mask, x + i), _mm512_maskz_loadu_ps(mask, y + i));
+					return (lanes & mask) == mask;
+				}
+				return true;
+			}
+
+			// One register per row of the tile, 8 independent accumulators
+			__attribute__((target("avx512f"))) auto
+			dot_tile(double const* a, double const* b, std::size_t depth, double* tile) noexcept
+			   -> void {
+				auto sum0 = _mm512_setzero_pd();
+				auto sum1 = _mm512_setzero_pd();
+				auto sum2 = _mm512_setzero_pd();
+				auto sum3 = _mm512_setzero_pd();
+				auto sum4 = _mm512_setzero_pd();
+				auto sum5 = _mm512_setzero_pd();
+				auto sum6 = _mm512_setzero_pd();
+				auto sum7 = _mm512_setzero_pd();
+				for (auto k = std::size_t{0}; k < depth; ++k) {
+					auto const columns = _mm512_loadu_pd(b + k * tile_size);
+					auto const* const rows = a + k * tile_size;
+					sum0 = _mm512_fmadd_pd(_mm512_set1_pd(rows[0]), columns, sum0);
+					sum1 = _mm512_fmadd_pd(_mm512_set1_pd(rows[1]), columns, sum1);
+					sum2 = _mm512_fmadd_pd(_mm512_set1_pd(rows[2]), columns, sum2);
+					sum3 = _mm512_fmadd_pd(_mm512_set1_pd(rows[3]), columns, sum3);
+					sum4 = _mm512_fmadd_pd(_mm512_set1_pd(rows[4]), columns, sum4);
+					sum5 = _mm512_fmadd_pd(_mm512_set1_pd(rows[5]), columns, sum5);
+					sum6 = _mm512_fmadd_pd(_mm512_set1_pd(rows[6]), columns, sum6);
+					sum7 = _mm512_fmadd_pd(_mm512_set1_pd(rows[7]), columns, sum7);
+				}
+				_mm512_storeu_pd(tile, sum0);
+				_mm512_storeu_pd(tile + tile_size, sum1);
+				_mm512_storeu_pd(tile + 2 * tile_size, sum2);
+				_mm512_storeu_pd(tile + 3 * tile_size, sum3);
+				_mm512_storeu_pd(tile + 4 * tile_size, sum4);
+				_mm512_storeu_pd(tile + 5 * tile_size, sum5);
+				_mm512_storeu_pd(tile + 6 * tile_size, sum6);
+				_mm512_storeu_pd(tile + 7 * tile_size, sum7);
+			}
+		} // namespace avx512
+
+		template<typename T>
+		constexpr auto sse2_set =
+		   kernel_set<T>{sse2::dot,
+		                 sse2::add,
+		                 sse2::subtract,
+		                 sse2::multiply,
+		                 sse2::divide,
+		                 sse2::approx_equal};
+
+		// SSE2 has no byte shuffle, so it looks up codes with the portable loop. Its tiles also use
+		// the portable loop, which the compiler vectorises with SSE2 anyway.
+		constexpr auto sse2_kernels = kernel_table{isa::sse2,
+		                                           sse2_set<double>,
+		                                           sse2_set<float>,
+		                                           portable::lookup_accumulate,
+		                                           portable::dot_tile};
+
+		template<typename T>
+		constexpr auto avx2_set =
+		   kernel_set<T>{avx2::dot,
+		                 avx2::add,
+		                 avx2::subtract,
+		                 avx2::multiply,
+		                 avx2::divide,
+		                 avx2::approx_equal};
+
+		constexpr auto avx2_kernels = kernel_table{isa::avx2,
+		                                           avx2_set<double>,
+		                                           avx2_set<float>,
+		                                           avx2::lookup_accumulate,
+		                                           avx2::dot_tile};
+
+		template<typename T>
+		constexpr auto avx512_set =
+		   kernel_set<T>{avx512::dot,
+		                 avx512::add,
+		                 avx512::subtract,
+		                 avx512::multiply,
+		                 avx512::divide,
+		                 avx512::approx_equal};
+
+		// AVX-512F has no byte shuffle of its own, so it shares the AVX2 lookups.
+		constexpr auto avx512_kernels = kernel_table{isa::avx512,
+		                                             avx512_set<double>,
+		                                             avx512_set<float>,
+		                                             avx2::lookup_accumulate,
+		                                             avx512::dot_tile};
+#endif
+
+		auto table_for(isa level) noexcept -> kernel_table const* {
+			switch (level) {
+#if COMP6771_KERNELS_X86
+			case isa::sse2: return &sse2_kernels;
+			case isa::avx2: return &avx2_kernels;
+			case isa::avx512: return &avx512_kernels;
+#endif
+			default: return &portable_kernels;
+			}
+		}
+
+		auto best_isa() noexcept -> isa {
+			for (auto const level : {isa::avx512, isa::avx2, isa::sse2}) {
+				if (supported(level)) {
+					return level;
+				}
+			}
+			return isa::portable;
+		}
+
+		auto active_table() noexcept -> std::atomic<kernel_table const*>& {
+			static auto table = std::atomic<kernel_table const*>(table_for(best_isa()));
+			return table;
+		}
+
+		auto kernels() noexcept -> kernel_table const& {
+			return *active_table().load(std::memory_order_relaxed);
+		}
+	} // namespace
+
+	auto active_isa() noexcept -> isa {
+		return kernels().level;
+	}
+
+	auto supported(isa level) noexcept -> bool {
+#if COMP6771_KERNELS_X86
+		__builtin_cpu_init();
+		switch (level) {
+		case isa::portable: return true;
+		case isa::sse2: return __builtin_cpu_supports("sse2") != 0;
+		case isa::avx2:
+			return __builtin_cpu_supports("avx2") != 0 and __builtin_cpu_supports("fma") != 0;
+		case isa::avx512: return __builtin_cpu_supports("avx512f") != 0;
+		}
+		return false;
+#else
+		return level == isa::portable;
+#endif
+	}
+
+	auto use_isa(isa level) -> void {
+		if (not supported(level)) {
+			throw euclidean_vector_error("Instruction set is not supported by this CPU");
+		}
+		active_table().store(table_for(level), std::memory_order_relaxed);
+	}
+
+	auto dot(double const* x, double const* y, std::size_t size) noexcept -> double {
+		return kernels().f64.dot(x, y, size);
+	}
+
+	auto dot(float const* x, float const* y, std::size_t size) noexcept -> float {
+		return kernels().f32.dot(x, y, size);
+	}
+
+	auto add(double* x, double const* y, std::size_t size) noexcept -> void {
+		kernels().f64.add(x, y, size);
+	}
+
+	auto add(float* x, float const* y, std::size_t size) noexcept -> void {
+		kernels().f32.add(x, y, size);
+	}
+
+	auto subtract(double* x, double const* y, std::size_t size) noexcept -> void {
+		kernels().f64.subtract(x, y, size);
+	}
+
+	auto subtract(float* x, float const* y, std::size_t size) noexcept -> void {
+		kernels().f32.subtract(x, y, size);
+	}
+
+	auto multiply(double* x, double scalar, std::size_t size) noexcept -> void {
+		kernels().f64.multiply(x, scalar, size);
+	}
+
+	auto multiply(float* x, float scalar, std::size_t size) noexcept -> void {
+		kernels().f32.multiply(x, scalar, size);
+	}
+
+	auto divide(double* x, double scalar, std::size_t size) noexcept -> void {
+		kernels().f64.divide(x, scalar, size);
+	}
+
+	auto divide(float* x, float scalar, std::size_t size) noexcept -> void {
+		kernels().f32.divide(x, scalar, size);
+	}
+
+	auto approx_equal(double const* x,
+	                  double const* y,
+	                  std::size_t size,
+	                  double abs_tol,
+	                  double rel_tol) noexcept -> bool {
+		return kernels().f64.approx_equal(x, y, size, abs_tol, rel_tol);
+	}
+
+	auto approx_equal(float const* x,
+	                  float const* y,
+	                  std::size_t size,
+	                  float abs_tol,
+	                  float rel_tol) noexcept -> bool {
+		return kernels().f32.approx_equal(x, y, size, abs_tol, rel_tol);
+	}
+
+	auto lookup_accumulate(std::uint8_t const* codes,
+	                       std::uint8_t const* tables,
+	                       std::size_t pairs,
+	                       std::size_t blocks,
+	                       std::uint16_t* sums) noexcept -> void {
+		kernels().lookup_accumulate(codes, tables, pairs, blocks, sums);
+	}
+
+	auto dot_tile(double const* a, double const* b, std::size_t depth, double* tile) noexcept
+	   -> void {
+		kernels().dot_tile(a, b, depth, tile);
+	}
+} // namespace comp6771::kernels
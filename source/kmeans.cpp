@@ -0,0 +1,600 @@
+// Copyright (c) Christopher Di Bella.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+#include <comp6771/kmeans.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <comp6771/pairwise.hpp>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <span>
+
+namespace comp6771 {
+	namespace {
+		// Rows compared with each block of centroids at once
+		constexpr auto row_block = std::size_t{64};
+		// Centroids are taken in blocks of about this many bytes, which stay in L2 while every row
+		// in a block of rows is compared with them.
+		constexpr auto centroid_block_bytes = std::size_t{128} << 10U;
+		// Passes that choose candidates for k-means|| seeding, and the candidates each chooses
+		// for every centroid wanted
+		constexpr auto seeding_rounds = 2;
+		constexpr auto seeding_oversampling = 2.0;
+		// Mini-batches whose smoothed inertia may fail to improve before mini-batch k-means stops
+		constexpr auto mini_batch_patience = 10;
+
+		auto check_parameters(std::size_t rows, int k, kmeans_parameters const& parameters) -> void {
+			if (k < 1 or parameters.iterations < 1 or not(parameters.tolerance >= 0)
+			    or parameters.batch_size < 0) {
+				throw euclidean_vector_error("kmeans parameters are not valid");
+			}
+			if (rows < static_cast<std::size_t>(k)) {
+				throw euclidean_vector_error("Cannot cluster fewer vectors than clusters");
+			}
+		}
+
+		// Centroids back to back, and the squared norm of each
+		struct centroid_set {
+			explicit centroid_set(std::size_t width)
+			: dimensions{width} {}
+
+			[[nodiscard]] auto size() const noexcept -> std::size_t {
+				return norms.size();
+			}
+
+			[[nodiscard]] auto operator[](std::size_t centroid) const noexcept -> double const* {
+				return magnitudes.data() + centroid * dimensions;
+			}
+
+			auto add(double const* centroid) -> void {
+				magnitudes.insert(magnitudes.end(), centroid, centroid + dimensions);
+				norms.push_back(detail::inner_product(centroid, centroid, dimensions));
+			}
+
+			auto update_norms() -> void {
+				for (auto centroid = std::size_t{0}; centroid < norms.size(); ++centroid) {
+					auto const* const values = (*this)[centroid];
+					norms[centroid] = detail::inner_product(values, values, dimensions);
+				}
+			}
+
+			std::size_t dimensions;
+			std::vector<double> magnitudes;
+			std::vector<double> norms;
+		};
+
+		// A row found nearest to a centroid
+		struct assigned {
+			// Thread that found it
+			std::size_t chunk;
+			// Index of the row among those searched, and in the dataset
+			std::size_t position;
+			std::size_t row;
+			std::size_t centroid;
+			double distance;
+			// The row as doubles
+			double const* magnitudes;
+		};
+
+		// The sums of the rows one thread assigned to each centroid. Each thread has its own, so
+		// they are added without locks once every thread is done.
+		struct accumulator {
+			std::vector<double> sums;
+			std::vector<std::size_t> counts;
+			double inertia = 0;
+		};
+
+		template<euclidean_vector_value T>
+		class kmeans_engine {
+		public:
+			kmeans_engine(std::vector<T const*> const& rows, std::size_t dimensions, thread_pool* pool)
+			: rows_{rows}
+			, dimensions_{dimensions}
+			, pool_{pool}
+			, chunks_{pool == nullptr ? std::size_t{1} : static_cast<std::size_t>(pool->size())}
+			, buffers_(chunks_)
+			, products_(chunks_)
+			, pairwise_buffers_(chunks_)
+			, norms_(rows.size()) {
+				if constexpr (not std::same_as<T, double>) {
+					for (auto& buffer : buffers_) {
+						buffer.resize(row_block * dimensions);
+					}
+				}
+				for_each_chunk(rows.size(), [&](std::size_t chunk, std::size_t first, std::size_t end) {
+					for (auto row = first; row < end; ++row) {
+						auto const* const magnitudes = as_double(chunk, 0, row);
+						norms_[row] = detail::inner_product(magnitudes, magnitudes, dimensions_);
+					}
+				});
+			}
+
+			[[nodiscard]] auto size() const noexcept -> std::size_t {
+				return rows_.size();
+			}
+
+			// Copies `row` as doubles to `out`.
+			auto copy_row(std::size_t row, double* out) const -> void {
+				std::copy(rows_[row], rows_[row] + dimensions_, out);
+			}
+
+			// Calls f(chunk, first, last) for each chunk of [0, size), one per thread.
+			template<typename F>
+			auto for_each_chunk(std::size_t size, F const& f) -> void {
+				if (chunks_ == 1) {
+					f(std::size_t{0}, std::size_t{0}, size);
+					return;
+				}
+				auto const chunk_size = (size + chunks_ - 1) / chunks_;
+				pool_->run(chunks_, [&](std::size_t chunk) {
+					auto const first = std::min(size, chunk * chunk_size);
+					f(chunk, first, std::min(size, first + chunk_size));
+				});
+			}
+
+			// Finds the centroid nearest each of `size` rows, which are subset[i], or row i without a
+			// subset, and calls visit with what it found for each. Each block of rows is multiplied
+			// with a block of centroids at a time by detail::pairwise, so that centroids are read
+			// from memory once per block of rows rather than once per row.
+			template<typename F>
+			auto nearest(centroid_set const& centroids,
+			             std::vector<std::size_t> const* subset,
+			             std::size_t size,
+			             F const& visit) -> void {
+				auto const row_bytes = std::max(std::size_t{1}, dimensions_ * sizeof(double));
+				auto const fits = std::max(std::size_t{1}, centroid_block_bytes / row_bytes);
+				auto const centroid_block = std::min(centroids.size(), fits);
+				auto pointers = std::vector<double const*>(centroids.size());
+				for (auto centroid = std::size_t{0}; centroid < centroids.size(); ++centroid) {
+					pointers[centroid] = centroids[centroid];
+				}
+				for (auto& products : products_) {
+					products.resize(row_block * centroid_block);
+				}
+
+				for_each_chunk(size, [&](std::size_t chunk, std::size_t first, std::size_t last) {
+					auto block = std::array<double const*, row_block>{};
+					auto best = std::array<double, row_block>{};
+					auto best_centroid = std::array<std::size_t, row_block>{};
+					auto& products = products_[chunk];
+					for (auto start = first; start < last; start += row_block) {
+						auto const count = std::min(row_block, last - start);
+						for (auto i = std::size_t{0}; i < count; ++i) {
+							block[i] = as_double(chunk, i, row_at(subset, start + i));
+							best[i] = std::numeric_limits<double>::infinity();
+							best_centroid[i] = 0;
+						}
+						for (auto begin = std::size_t{0}; begin < centroids.size();
+						     begin += centroid_block)
+						{
+							auto const width = std::min(centroid_block, centroids.size() - begin);
+							auto const columns = std::span<double const* const>(pointers);
+							detail::pairwise(std::span<double const* const>(block.data(), count),
+							                 columns.subspan(begin, width),
+							                 dimensions_,
+							                 detail::pairwise_measure::dot,
+							                 products.data(),
+							                 pairwise_buffers_[chunk]);
+							for (auto i = std::size_t{0}; i < count; ++i) {
+								auto const* const row = products.data() + i * width;
+								for (auto centroid = begin; centroid < begin + width; ++centroid) {
+									// The squared distance, less the squared norm of the row
+									auto const distance =
+									   centroids.norms[centroid] - 2 * row[centroid - begin];
+									if (distance < best[i]) {
+										best[i] = distance;
+										best_centroid[i] = centroid;
+									}
+								}
+							}
+						}
+						for (auto i = std::size_t{0}; i < count; ++i) {
+							auto const row = row_at(subset, start + i);
+							auto const distance = std::max(0.0, norms_[row] + best[i]);
+							visit(assigned{chunk, start + i, row, best_centroid[i], distance, block[i]});
+						}
+					}
+				});
+			}
+
+			// Lowers distances[row] to the squared distance from each row to its nearest centre.
+			auto lower_distances(centroid_set const& centres, std::vector<double>& distances) -> void {
+				nearest(centres, nullptr, size(), [&](assigned const& found) {
+					distances[found.row] = std::min(distances[found.row], found.distance);
+				});
+			}
+
+		private:
+			[[nodiscard]] static auto row_at(std::vector<std::size_t> const* subset,
+			                                 std::size_t position) noexcept -> std::size_t {
+				return subset == nullptr ? position : (*subset)[position];
+			}
+
+			// `row` as doubles, converted into slot `slot` of the buffer of `chunk` when it holds
+			// another type
+			[[nodiscard]] auto as_double(std::size_t chunk, std::size_t slot, std::size_t row) noexcept
+			   -> double const* {
+				if constexpr (std::same_as<T, double>) {
+					return rows_[row];
+				}
+				else {
+					auto* const out = buffers_[chunk].data() + slot * dimensions_;
+					std::copy(rows_[row], rows_[row] + dimensions_, out);
+					return out;
+				}
+			}
+
+			std::vector<T const*> const& rows_;
+			std::size_t dimensions_;
+			thread_pool* pool_;
+			std::size_t chunks_;
+			std::vector<std::vector<double>> buffers_;
+			// Products of each thread's block of rows with a block of centroids, and what
+			// detail::pairwise packs to find them
+			std::vector<std::vector<double>> products_;
+			std::vector<detail::pairwise_buffers> pairwise_buffers_;
+			// Squared norm of each row
+			std::vector<double> norms_;
+		};
+
+		// Index of the row chosen with probability proportional to weights[row], or the first row
+		// not yet chosen when every weight is 0.
+		auto choose_weighted(std::vector<double> const& weights,
+		                     std::vector<bool> const& chosen,
+		                     std::mt19937& engine) -> std::size_t {
+			auto const total = std::accumulate(weights.begin(), weights.end(), 0.0);
+			if (total > 0) {
+				auto target = std::uniform_real_distribution<double>(0.0, total)(engine);
+				auto last = std::size_t{0};
+				for (auto row = std::size_t{0}; row < weights.size(); ++row) {
+					if (weights[row] > 0) {
+						last = row;
+						target -= weights[row];
+						if (target < 0) {
+							return row;
+						}
+					}
+				}
+				return last;
+			}
+			auto const first = std::find(chosen.begin(), chosen.end(), false);
+			return static_cast<std::size_t>(first - chosen.begin());
+		}
+
+		// Adds rows chosen as k-means++ does to `seeds` until there are k of them. `distances`
+		// holds the squared distance from each row to its nearest seed, and the first seed is
+		// chosen uniformly when there is none yet.
+		template<euclidean_vector_value T>
+		auto seed_plus_plus(kmeans_engine<T>& engine,
+		                    std::size_t k,
+		                    std::vector<std::size_t>& seeds,
+		                    std::vector<bool>& chosen,
+		                    std::vector<double>& distances,
+		                    std::size_t dimensions,
+		                    std::mt19937& random) -> void {
+			auto centre = centroid_set(dimensions);
+			auto magnitudes = std::vector<double>(dimensions);
+			auto const add = [&](std::size_t row) {
+				seeds.push_back(row);
+				chosen[row] = true;
+				engine.copy_row(row, magnitudes.data());
+				centre.magnitudes.clear();
+				centre.norms.clear();
+				centre.add(magnitudes.data());
+				engine.lower_distances(centre, distances);
+			};
+
+			if (seeds.empty()) {
+				add(std::uniform_int_distribution<std::size_t>(0, engine.size() - 1)(random));
+			}
+			while (seeds.size() < k) {
+				add(choose_weighted(distances, chosen, random));
+			}
+		}
+
+		// Chooses candidates as k-means|| does, and then k of them with k-means++, each weighted
+		// by the rows nearest it.
+		template<euclidean_vector_value T>
+		auto seed_parallel(kmeans_engine<T>& engine,
+		                   std::size_t k,
+		                   std::vector<std::size_t>& seeds,
+		                   std::vector<bool>& chosen,
+		                   std::vector<double>& distances,
+		                   std::size_t dimensions,
+		                   std::mt19937& random) -> void {
+			auto candidates = centroid_set(dimensions);
+			auto magnitudes = std::vector<double>(dimensions);
+			auto rows = std::vector<std::size_t>();
+			auto const add = [&](std::size_t row) {
+				rows.push_back(row);
+				chosen[row] = true;
+				engine.copy_row(row, magnitudes.data());
+				candidates.add(magnitudes.data());
+			};
+
+			add(std::uniform_int_distribution<std::size_t>(0, engine.size() - 1)(random));
+			engine.lower_distances(candidates, distances);
+			auto const expected = seeding_oversampling * static_cast<double>(k);
+			auto uniform = std::uniform_real_distribution<double>(0.0, 1.0);
+			for (auto round = 0; round < seeding_rounds; ++round) {
+				auto const cost = std::accumulate(distances.begin(), distances.end(), 0.0);
+				if (cost == 0) {
+					break;
+				}
+				auto round_candidates = centroid_set(dimensions);
+				for (auto row = std::size_t{0}; row < engine.size(); ++row) {
+					if (distances[row] > 0 and uniform(random) * cost < expected * distances[row]) {
+						add(row);
+						round_candidates.add(candidates[candidates.size() - 1]);
+					}
+				}
+				engine.lower_distances(round_candidates, distances);
+			}
+
+			if (rows.size() <= k) {
+				seeds = rows;
+				seed_plus_plus(engine, k, seeds, chosen, distances, dimensions, random);
+				return;
+			}
+
+			// Each candidate is weighted by the rows nearest it. Threads only record the nearest
+			// candidate, and the weights are counted serially afterwards.
+			auto nearest = std::vector<std::size_t>(engine.size());
+			engine.nearest(candidates, nullptr, engine.size(), [&](assigned const& found) {
+				nearest[found.row] = found.centroid;
+			});
+			auto weights = std::vector<double>(rows.size());
+			for (auto const candidate : nearest) {
+				weights[candidate] += 1;
+			}
+
+			// Weighted k-means++ over the candidates
+			auto picked = std::vector<bool>(rows.size());
+			auto candidate_distances =
+			   std::vector<double>(rows.size(), std::numeric_limits<double>::infinity());
+			auto scores = weights;
+			seeds.clear();
+			while (seeds.size() < k) {
+				auto const candidate = choose_weighted(scores, picked, random);
+				picked[candidate] = true;
+				seeds.push_back(rows[candidate]);
+				for (auto other = std::size_t{0}; other < rows.size(); ++other) {
+					auto const product =
+					   detail::inner_product(candidates[other], candidates[candidate], dimensions);
+					auto const distance = std::max(
+					   0.0,
+					   candidates.norms[other] + candidates.norms[candidate] - 2 * product);
+					candidate_distances[other] = std::min(candidate_distances[other], distance);
+					scores[other] = picked[other] ? 0.0 : weights[other] * candidate_distances[other];
+				}
+			}
+		}
+	} // namespace
+
+	namespace detail {
+		template<euclidean_vector_value T>
+		auto kmeans(std::vector<T const*> const& rows,
+		            int dimensions,
+		            int k,
+		            kmeans_parameters const& parameters,
+		            thread_pool* pool) -> kmeans_result {
+			check_parameters(rows.size(), k, parameters);
+			auto const size = rows.size();
+			auto const width = static_cast<std::size_t>(dimensions);
+			auto const clusters = static_cast<std::size_t>(k);
+			if (pool != nullptr and (pool->size() == 1 or size * width < parallel_threshold())) {
+				pool = nullptr;
+			}
+			auto engine = kmeans_engine<T>(rows, width, pool);
+			auto random = std::mt19937(parameters.seed);
+
+			// Seeding
+			auto seeds = std::vector<std::size_t>();
+			auto chosen = std::vector<bool>(size);
+			if (parameters.seeding == kmeans_seeding::random) {
+				auto all = std::vector<std::size_t>(size);
+				std::iota(all.begin(), all.end(), std::size_t{0});
+				std::shuffle(all.begin(), all.end(), random);
+				seeds.assign(all.begin(), all.begin() + k);
+			}
+			else {
+				auto distances = std::vector<double>(size, std::numeric_limits<double>::infinity());
+				if (parameters.seeding == kmeans_seeding::plus_plus) {
+					seed_plus_plus(engine, clusters, seeds, chosen, distances, width, random);
+				}
+				else {
+					seed_parallel(engine, clusters, seeds, chosen, distances, width, random);
+				}
+			}
+			auto centroids = centroid_set(width);
+			{
+				auto magnitudes = std::vector<double>(width);
+				for (auto const seed : seeds) {
+					engine.copy_row(seed, magnitudes.data());
+					centroids.add(magnitudes.data());
+				}
+			}
+
+			auto result = kmeans_result();
+			result.assignment.resize(size);
+			auto distances = std::vector<double>(size);
+			auto const assign_all = [&] {
+				engine.nearest(centroids, nullptr, size, [&](assigned const& found) {
+					result.assignment[found.row] = static_cast<int>(found.centroid);
+					distances[found.row] = found.distance;
+				});
+				return std::accumulate(distances.begin(), distances.end(), 0.0);
+			};
+			auto const largest_shift = [&](std::vector<double> const& previous) {
+				auto shift = 0.0;
+				for (auto centroid = std::size_t{0}; centroid < clusters; ++centroid) {
+					auto squared = 0.0;
+					for (auto i = std::size_t{0}; i < width; ++i) {
+						auto const difference = centroids.magnitudes[centroid * width + i]
+						                        - previous[centroid * width + i];
+						squared += difference * difference;
+					}
+					shift = std::max(shift, std::sqrt(squared));
+				}
+				return shift;
+			};
+
+			if (parameters.batch_size == 0) {
+				// Lloyd's algorithm. Each iteration assigns every row to its nearest centroid and then
+				// moves each centroid to the mean of its rows, unless it is the last iteration.
+				auto accumulators = std::vector<accumulator>(
+				   pool == nullptr ? std::size_t{1} : static_cast<std::size_t>(pool->size()));
+				for (auto& partial : accumulators) {
+					partial.sums.resize(clusters * width);
+					partial.counts.resize(clusters);
+				}
+				auto previous = std::vector<double>();
+				for (auto iteration = 0; iteration < parameters.iterations; ++iteration) {
+					for (auto& partial : accumulators) {
+						std::fill(partial.sums.begin(), partial.sums.end(), 0.0);
+						std::fill(partial.counts.begin(), partial.counts.end(), std::size_t{0});
+						partial.inertia = 0;
+					}
+					engine.nearest(centroids, nullptr, size, [&](assigned const& found) {
+						auto& partial = accumulators[found.chunk];
+						auto* const sum = partial.sums.data() + found.centroid * width;
+						for (auto i = std::size_t{0}; i < width; ++i) {
+							sum[i] += found.magnitudes[i];
+						}
+						++partial.counts[found.centroid];
+						partial.inertia += found.distance;
+						result.assignment[found.row] = static_cast<int>(found.centroid);
+						distances[found.row] = found.distance;
+					});
+					auto& total = accumulators.front();
+					for (auto chunk = std::size_t{1}; chunk < accumulators.size(); ++chunk) {
+						auto const& partial = accumulators[chunk];
+						for (auto i = std::size_t{0}; i < total.sums.size(); ++i) {
+							total.sums[i] += partial.sums[i];
+						}
+						for (auto centroid = std::size_t{0}; centroid < clusters; ++centroid) {
+							total.counts[centroid] += partial.counts[centroid];
+						}
+						total.inertia += partial.inertia;
+					}
+
+					auto const inertia = total.inertia;
+					result.converged = iteration > 0
+					                   and result.history.back().inertia - inertia
+					                          <= parameters.tolerance * result.history.back().inertia;
+					result.history.push_back({inertia, 0.0});
+					result.inertia = inertia;
+					if (result.converged or iteration + 1 == parameters.iterations) {
+						break;
+					}
+
+					previous = centroids.magnitudes;
+					for (auto centroid = std::size_t{0}; centroid < clusters; ++centroid) {
+						auto* const magnitudes = centroids.magnitudes.data() + centroid * width;
+						if (total.counts[centroid] == 0) {
+							// An empty cluster takes the row furthest from its centroid, and rows
+							// nearer it, such as copies of that row, are not taken by the next.
+							auto const furthest = static_cast<std::size_t>(
+							   std::max_element(distances.begin(), distances.end()) - distances.begin());
+							engine.copy_row(furthest, magnitudes);
+							auto centre = centroid_set(width);
+							centre.add(magnitudes);
+							engine.lower_distances(centre, distances);
+							continue;
+						}
+						auto const scale = 1 / static_cast<double>(total.counts[centroid]);
+						auto const* const sum = total.sums.data() + centroid * width;
+						for (auto i = std::size_t{0}; i < width; ++i) {
+							magnitudes[i] = sum[i] * scale;
+						}
+					}
+					centroids.update_norms();
+					result.history.back().shift = largest_shift(previous);
+				}
+			}
+			else {
+				// Mini-batch k-means. Each iteration assigns a random batch of rows, and moves each
+				// centroid towards each of its rows by the inverse of the rows it has had so far.
+				// Stops once the inertia per row, smoothed over recent batches, stops falling.
+				auto const batch_size = static_cast<std::size_t>(parameters.batch_size);
+				auto const smoothing =
+				   std::min(1.0, 2.0 * static_cast<double>(batch_size) / static_cast<double>(size + 1));
+				auto pick = std::uniform_int_distribution<std::size_t>(0, size - 1);
+				auto batch = std::vector<std::size_t>(batch_size);
+				auto batch_centroids = std::vector<std::size_t>(batch_size);
+				auto batch_distances = std::vector<double>(batch_size);
+				auto counts = std::vector<std::size_t>(clusters);
+				auto magnitudes = std::vector<double>(width);
+				auto smoothed = 0.0;
+				auto best = std::numeric_limits<double>::infinity();
+				auto stalled = 0;
+				for (auto iteration = 0; iteration < parameters.iterations; ++iteration) {
+					std::generate(batch.begin(), batch.end(), [&] { return pick(random); });
+					engine.nearest(centroids, &batch, batch_size, [&](assigned const& found) {
+						batch_centroids[found.position] = found.centroid;
+						batch_distances[found.position] = found.distance;
+					});
+
+					auto const previous = centroids.magnitudes;
+					for (auto position = std::size_t{0}; position < batch_size; ++position) {
+						auto const centroid = batch_centroids[position];
+						auto const rate = 1 / static_cast<double>(++counts[centroid]);
+						auto* const moved = centroids.magnitudes.data() + centroid * width;
+						engine.copy_row(batch[position], magnitudes.data());
+						for (auto i = std::size_t{0}; i < width; ++i) {
+							moved[i] += rate * (magnitudes[i] - moved[i]);
+						}
+					}
+					centroids.update_norms();
+
+					auto const inertia =
+					   std::accumulate(batch_distances.begin(), batch_distances.end(), 0.0);
+					result.history.push_back({inertia, largest_shift(previous)});
+					auto const per_row = inertia / static_cast<double>(batch_size);
+					smoothed = iteration == 0 ? per_row : smoothed + smoothing * (per_row - smoothed);
+					if (smoothed < best * (1 - parameters.tolerance)) {
+						best = smoothed;
+						stalled = 0;
+					}
+					else if (++stalled == mini_batch_patience) {
+						result.converged = true;
+						break;
+					}
+				}
+				result.inertia = assign_all();
+			}
+
+			result.centroids = euclidean_vector_batch(k, dimensions);
+			for (auto centroid = 0; centroid < k; ++centroid) {
+				std::copy_n(centroids[static_cast<std::size_t>(centroid)],
+				            width,
+				            result.centroids[centroid].data());
+			}
+			return result;
+		}
+
+		template auto kmeans(std::vector<double const*> const& rows,
+		                     int dimensions,
+		                     int k,
+		                     kmeans_parameters const& parameters,
+		                     thread_pool* pool) -> kmeans_result;
+		template auto kmeans(std::vector<float const*> const& rows,
+		                     int dimensions,
+		                     int k,
+		                     kmeans_parameters const& parameters,
+		                     thread_pool* pool) -> kmeans_result;
+		template auto kmeans(std::vector<std::int16_t const*> const& rows,
+		                     int dimensions,
+		                     int k,
+		                     kmeans_parameters const& parameters,
+		                     thread_pool* pool) -> kmeans_result;
+		template auto kmeans(std::vector<std::int8_t const*> const& rows,
+		                     int dimensions,
+		                     int k,
+		                     kmeans_parameters const& parameters,
+		                     thread_pool* pool) -> kmeans_result;
+	} // namespace detail
+} // namespace comp6771
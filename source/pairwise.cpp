@@ -0,0 +1,302 @@
+// Copyright (c) Christopher Di Bella.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+#include <comp6771/pairwise.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <comp6771/kernels.hpp>
+
+namespace comp6771 {
+	namespace {
+		using kernels::tile_size;
+
+		// Elements multiplied in each pass. A packed tile of rows and one of columns take 32 KiB,
+		// which stays in L1 while the tile is computed.
+		constexpr auto depth_block = std::size_t{256};
+		// Rows packed at once, 128 KiB per pass, which stay in L2 while every tile of columns is
+		// multiplied with them
+		constexpr auto row_block = std::size_t{64};
+		// Columns packed at once, 2 MiB per pass, which stay in L3 while every block of rows is
+		// multiplied with them
+		constexpr auto column_block = std::size_t{1024};
+
+		auto tiles(std::size_t size) noexcept -> std::size_t {
+			return (size + tile_size - 1) / tile_size;
+		}
+
+		// Packs elements [depth, depth + size) of vectors [first, first + count) for dot_tile, in
+		// tiles of tile_size vectors padded with zeros.
+		template<euclidean_vector_value T>
+		auto pack(std::span<T const* const> vectors,
+		          std::size_t first,
+		          std::size_t count,
+		          std::size_t depth,
+		          std::size_t size,
+		          double* out) noexcept -> void {
+			for (auto tile = std::size_t{0}; tile < tiles(count); ++tile) {
+				auto* const packed = out + tile * tile_size * size;
+				for (auto i = std::size_t{0}; i < tile_size; ++i) {
+					auto const vector = tile * tile_size + i;
+					if (vector >= count) {
+						for (auto k = std::size_t{0}; k < size; ++k) {
+							packed[k * tile_size + i] = 0;
+						}
+						continue;
+					}
+					auto const* const magnitudes = vectors[first + vector] + depth;
+					for (auto k = std::size_t{0}; k < size; ++k) {
+						packed[k * tile_size + i] = static_cast<double>(magnitudes[k]);
+					}
+				}
+			}
+		}
+
+		template<euclidean_vector_value T>
+		auto squared_norm(T const* magnitudes, std::size_t dimensions) noexcept -> double {
+			auto sum = 0.0;
+			for (auto i = std::size_t{0}; i < dimensions; ++i) {
+				sum += static_cast<double>(magnitudes[i]) * static_cast<double>(magnitudes[i]);
+			}
+			return sum;
+		}
+
+		// Multiplies a and b as blocks of packed columns, each multiplied with every block of packed
+		// rows. Threads take blocks of rows in turn, and when there are fewer blocks of rows than
+		// threads, each block is also split by columns. Every product is summed in the same order
+		// whatever the split.
+		template<euclidean_vector_value T>
+		class multiplication {
+		public:
+			multiplication(std::span<T const* const> a,
+			               std::span<T const* const> b,
+			               std::size_t dimensions,
+			               detail::pairwise_measure measure,
+			               double* out)
+			: a_{a}
+			, b_{b}
+			, dimensions_{dimensions}
+			, measure_{measure}
+			, out_{out} {}
+
+			template<typename RunChunks>
+			auto run(std::size_t chunks,
+			         RunChunks const& run_chunks,
+			         std::vector<double>& columns,
+			         std::vector<std::vector<double>*> const& rows) -> void {
+				if (dimensions_ == 0) {
+					std::fill_n(out_, a_.size() * b_.size(), 0.0);
+					return;
+				}
+				if (measure_ == detail::pairwise_measure::l2) {
+					row_norms_.resize(a_.size());
+					column_norms_.resize(b_.size());
+					run_chunks(chunks, [&](std::size_t chunk) {
+						for (auto row = chunk; row < a_.size(); row += chunks) {
+							row_norms_[row] = squared_norm(a_[row], dimensions_);
+						}
+						for (auto column = chunk; column < b_.size(); column += chunks) {
+							column_norms_[column] = squared_norm(b_[column], dimensions_);
+						}
+					});
+				}
+
+				auto const depth_size = std::min(depth_block, dimensions_);
+				columns.resize(column_block * depth_size);
+				for (auto& buffer : rows) {
+					buffer->resize(row_block * depth_size);
+				}
+				auto const row_blocks = (a_.size() + row_block - 1) / row_block;
+				auto const splits = (chunks + row_blocks - 1) / row_blocks;
+				for (auto first_column = std::size_t{0}; first_column < b_.size();
+				     first_column += column_block)
+				{
+					auto const column_count = std::min(column_block, b_.size() - first_column);
+					auto const column_tiles = tiles(column_count);
+					for (auto depth = std::size_t{0}; depth < dimensions_; depth += depth_block) {
+						auto const size = std::min(depth_block, dimensions_ - depth);
+						run_chunks(chunks, [&](std::size_t chunk) {
+							for (auto tile = chunk; tile < column_tiles; tile += chunks) {
+								auto const first = tile * tile_size;
+								pack(b_,
+								     first_column + first,
+								     std::min(tile_size, column_count - first),
+								     depth,
+								     size,
+								     columns.data() + tile * tile_size * size);
+							}
+						});
+						auto const block = pass{first_column, column_tiles, depth, size};
+						run_chunks(chunks, [&](std::size_t chunk) {
+							for (auto item = chunk; item < row_blocks * splits; item += chunks) {
+								auto const split = item % splits;
+								multiply(block, item / splits, split, splits, columns, *rows[chunk]);
+							}
+						});
+					}
+				}
+			}
+
+		private:
+			// The columns and elements packed for one pass
+			struct pass {
+				std::size_t first_column;
+				std::size_t column_tiles;
+				std::size_t depth;
+				std::size_t size;
+			};
+
+			// Multiplies block `block` of rows with split `split` of the packed columns.
+			auto multiply(pass const& packed,
+			              std::size_t block,
+			              std::size_t split,
+			              std::size_t splits,
+			              std::vector<double> const& columns,
+			              std::vector<double>& rows) const noexcept -> void {
+				auto const first_tile = split * packed.column_tiles / splits;
+				auto const last_tile = (split + 1) * packed.column_tiles / splits;
+				if (first_tile == last_tile) {
+					return;
+				}
+				auto const first_row = block * row_block;
+				auto const row_count = std::min(row_block, a_.size() - first_row);
+				pack(a_, first_row, row_count, packed.depth, packed.size, rows.data());
+
+				auto const stride = b_.size();
+				auto const first_pass = packed.depth == 0;
+				auto tile = std::array<double, tile_size * tile_size>{};
+				for (auto column_tile = first_tile; column_tile < last_tile; ++column_tile) {
+					auto const first_column = packed.first_column + column_tile * tile_size;
+					auto const column_count = std::min(tile_size, b_.size() - first_column);
+					for (auto row_tile = std::size_t{0}; row_tile < tiles(row_count); ++row_tile) {
+						kernels::dot_tile(rows.data() + row_tile * tile_size * packed.size,
+						                  columns.data() + column_tile * tile_size * packed.size,
+						                  packed.size,
+						                  tile.data());
+						auto const tile_rows = std::min(tile_size, row_count - row_tile * tile_size);
+						for (auto i = std::size_t{0}; i < tile_rows; ++i) {
+							auto* const out =
+							   out_ + (first_row + row_tile * tile_size + i) * stride + first_column;
+							auto const* const products = tile.data() + i * tile_size;
+							for (auto j = std::size_t{0}; j < column_count; ++j) {
+								out[j] = first_pass ? products[j] : out[j] + products[j];
+							}
+						}
+					}
+				}
+
+				if (measure_ == detail::pairwise_measure::l2
+				    and packed.depth + packed.size == dimensions_) {
+					auto const first_column = packed.first_column + first_tile * tile_size;
+					auto const last_column =
+					   std::min(b_.size(), packed.first_column + last_tile * tile_size);
+					for (auto row = first_row; row < first_row + row_count; ++row) {
+						for (auto column = first_column; column < last_column; ++column) {
+							auto& out = out_[row * stride + column];
+							out = std::sqrt(
+							   std::max(0.0, row_norms_[row] + column_norms_[column] - 2 * out));
+						}
+					}
+				}
+			}
+
+			std::span<T const* const> a_;
+			std::span<T const* const> b_;
+			std::size_t dimensions_;
+			detail::pairwise_measure measure_;
+			double* out_;
+			std::vector<double> row_norms_;
+			std::vector<double> column_norms_;
+		};
+	} // namespace
+
+	namespace detail {
+		template<euclidean_vector_value T>
+		auto pairwise(std::span<T const* const> a,
+		              std::span<T const* const> b,
+		              std::size_t dimensions,
+		              pairwise_measure measure,
+		              double* out,
+		              thread_pool* pool) -> void {
+			if (pool == nullptr or pool->size() == 1) {
+				auto buffers = pairwise_buffers();
+				pairwise(a, b, dimensions, measure, out, buffers);
+				return;
+			}
+			auto const chunks = static_cast<std::size_t>(pool->size());
+			auto columns = std::vector<double>();
+			auto buffers = std::vector<std::vector<double>>(chunks);
+			auto rows = std::vector<std::vector<double>*>();
+			for (auto& buffer : buffers) {
+				rows.push_back(&buffer);
+			}
+			auto const run_chunks = [pool](std::size_t size, auto const& task) {
+				pool->run(size, task);
+			};
+			multiplication<T>(a, b, dimensions, measure, out).run(chunks, run_chunks, columns, rows);
+		}
+
+		template<euclidean_vector_value T>
+		auto pairwise(std::span<T const* const> a,
+		              std::span<T const* const> b,
+		              std::size_t dimensions,
+		              pairwise_measure measure,
+		              double* out,
+		              pairwise_buffers& buffers) -> void {
+			auto const run_chunks = [](std::size_t, auto const& task) { task(std::size_t{0}); };
+			multiplication<T>(a, b, dimensions, measure, out)
+			   .run(std::size_t{1}, run_chunks, buffers.columns, {&buffers.rows});
+		}
+
+		template auto pairwise(std::span<double const* const> a,
+		                       std::span<double const* const> b,
+		                       std::size_t dimensions,
+		                       pairwise_measure measure,
+		                       double* out,
+		                       thread_pool* pool) -> void;
+		template auto pairwise(std::span<float const* const> a,
+		                       std::span<float const* const> b,
+		                       std::size_t dimensions,
+		                       pairwise_measure measure,
+		                       double* out,
+		                       thread_pool* pool) -> void;
+		template auto pairwise(std::span<std::int16_t const* const> a,
+		                       std::span<std::int16_t const* const> b,
+		                       std::size_t dimensions,
+		                       pairwise_measure measure,
+		                       double* out,
+		                       thread_pool* pool) -> void;
+		template auto pairwise(std::span<std::int8_t const* const> a,
+		                       std::span<std::int8_t const* const> b,
+		                       std::size_t dimensions,
+		                       pairwise_measure measure,
+		                       double* out,
+		                       thread_pool* pool) -> void;
+
+		template auto pairwise(std::span<double const* const> a,
+		                       std::span<double const* const> b,
+		                       std::size_t dimensions,
+		                       pairwise_measure measure,
+		                       double* out,
+		                       pairwise_buffers& buffers) -> void;
+		template auto pairwise(std::span<float const* const> a,
+		                       std::span<float const* const> b,
+		                       std::size_t dimensions,
+		                       pairwise_measure measure,
+		                       double* out,
+		                       pairwise_buffers& buffers) -> void;
+		template auto pairwise(std::span<std::int16_t const* const> a,
+		                       std::span<std::int16_t const* const> b,
+		                       std::size_t dimensions,
+		                       pairwise_measure measure,
+		                       double* out,
+		                       pairwise_buffers& buffers) -> void;
+		template auto pairwise(std::span<std::int8_t const* const> a,
+		                       std::span<std::int8_t const* const> b,
+		                       std::size_t dimensions,
+		                       pairwise_measure measure,
+		                       double* out,
+		                       pairwise_buffers& buffers) -> void;
+	} // namespace detail
+} // namespace comp6771
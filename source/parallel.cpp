@@ -0,0 +1,22 @@
+// Copyright (c) Christopher Di Bella.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+#include <comp6771/parallel.hpp>
+
+#include <atomic>
+
+namespace comp6771 {
+	namespace {
+		// Below about 2^17 doubles (1 MiB) a vector fits in a core's L2 and waking the pool costs
+		// more than it saves.
+		auto threshold = std::atomic<std::size_t>(std::size_t{1} << 17U);
+	} // namespace
+
+	auto parallel_threshold() noexcept -> std::size_t {
+		return threshold.load(std::memory_order_relaxed);
+	};
+
+	auto set_parallel_threshold(std::size_t dimensions) noexcept -> void {
+		threshold.store(dimensions, std::memory_order_relaxed);
+	};
+} // namespace comp6771
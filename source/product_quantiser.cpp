@@ -0,0 +1,454 @@
+// Copyright (c) Christopher Di Bella.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+#include <comp6771/product_quantiser.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <comp6771/kernels.hpp>
+#include <comp6771/kmeans.hpp>
+#include <iterator>
+#include <limits>
+#include <numeric>
+#include <random>
+
+namespace comp6771 {
+	namespace {
+		// Codes whose fast-scan sums are kept in a buffer at once, small enough to stay in L1
+		constexpr auto scan_blocks = std::size_t{64};
+
+		auto check_parameters(int dimensions, int subspaces, metric measure, pq_parameters parameters)
+		   -> void {
+			if (measure == metric::cosine) {
+				throw euclidean_vector_error("product_quantiser cannot measure cosine distances");
+			}
+			if (subspaces < 1 or dimensions < subspaces or dimensions % subspaces != 0
+			    or (parameters.bits != 4 and parameters.bits != 8) or parameters.iterations < 1
+			    or parameters.sample_per_centroid < 1
+			    or (parameters.bits == 4 and subspaces > 2 * 128)) {
+				throw euclidean_vector_error("product_quantiser parameters are not valid");
+			}
+		}
+
+		// The 4-bit code of `subspace` in a byte holding it and its neighbour: even subspaces take
+		// the low nibble and odd ones the high nibble.
+		auto nibble(std::uint8_t byte, std::size_t subspace) noexcept -> std::size_t {
+			return (static_cast<std::size_t>(byte) >> (4 * (subspace % 2))) & 0xFU;
+		}
+
+		// Pushes the distance to each code in `codes`, the sum of entry(code, j) over subspaces j.
+		// Four codes are summed at once so that their additions overlap rather than wait on each
+		// other, but each sum still adds its subspaces in order.
+		template<typename Entry>
+		auto scan_codes(std::span<std::uint8_t const> codes,
+		                std::size_t code_size,
+		                std::size_t subspaces,
+		                detail::top_k& found,
+		                Entry entry) -> void {
+			auto const rows = codes.size() / code_size;
+			auto row = std::size_t{0};
+			for (; row + 4 <= rows; row += 4) {
+				auto const* const code = codes.data() + row * code_size;
+				auto distances = std::array<double, 4>{};
+				for (auto subspace = std::size_t{0}; subspace < subspaces; ++subspace) {
+					distances[0] += entry(code, subspace);
+					distances[1] += entry(code + code_size, subspace);
+					distances[2] += entry(code + 2 * code_size, subspace);
+					distances[3] += entry(code + 3 * code_size, subspace);
+				}
+				for (auto i = std::size_t{0}; i < 4; ++i) {
+					found.push({static_cast<int>(row + i), distances[i]});
+				}
+			}
+			for (; row < rows; ++row) {
+				auto distance = 0.0;
+				for (auto subspace = std::size_t{0}; subspace < subspaces; ++subspace) {
+					distance += entry(codes.data() + row * code_size, subspace);
+				}
+				found.push({static_cast<int>(row), distance});
+			}
+		}
+	} // namespace
+
+	// Constructors
+	template<euclidean_vector_value T>
+	basic_product_quantiser<T>::basic_product_quantiser(int dimensions,
+	                                                    int subspaces,
+	                                                    metric measure,
+	                                                    pq_parameters parameters)
+	: dimensions_{dimensions}
+	, subspaces_{subspaces}
+	, measure_{measure}
+	, parameters_{parameters} {
+		check_parameters(dimensions, subspaces, measure, parameters);
+	};
+
+	// Member functions
+	template<euclidean_vector_value T>
+	auto basic_product_quantiser<T>::trained() const noexcept -> bool {
+		return not centroids_.empty();
+	};
+
+	template<euclidean_vector_value T>
+	auto basic_product_quantiser<T>::code_size() const noexcept -> int {
+		return (subspaces_ * parameters_.bits + 7) / 8;
+	};
+
+	template<euclidean_vector_value T>
+	auto basic_product_quantiser<T>::decode(std::span<std::uint8_t const> code) const
+	   -> basic_euclidean_vector<T> {
+		check_codes(code.size());
+		if (code.size() != static_cast<std::size_t>(code_size())) {
+			throw euclidean_vector_error("Codes do not match the code size of this product_quantiser");
+		}
+		auto result = basic_euclidean_vector<T>(dimensions_);
+		auto const dimensions = subspace_dimensions();
+		for (auto subspace = std::size_t{0}; subspace < static_cast<std::size_t>(subspaces_);
+		     ++subspace)
+		{
+			auto const centroid = subspace * centroids() + code_of(code.data(), subspace);
+			std::copy_n(centroids_.begin() + static_cast<std::ptrdiff_t>(centroid * dimensions),
+			            dimensions,
+			            result.data() + subspace * dimensions);
+		}
+		return result;
+	};
+
+	template<euclidean_vector_value T>
+	auto basic_product_quantiser<T>::pack(std::span<std::uint8_t const> codes) const
+	   -> pq_packed_codes {
+		check_codes(codes.size());
+		if (parameters_.bits != 4) {
+			throw euclidean_vector_error("Only 4-bit codes can be packed for fast scans");
+		}
+		constexpr auto block = kernels::lookup_block;
+		auto const code_size = static_cast<std::size_t>(this->code_size());
+		auto const size = codes.size() / code_size;
+		auto packed = pq_packed_codes();
+		packed.size_ = static_cast<int>(size);
+		packed.code_size_ = code_size;
+		packed.codes_.resize((size + block - 1) / block * block * code_size);
+		// Byte p of a 4-bit code already holds subspaces 2p and 2p + 1 as lookup_accumulate() wants,
+		// so packing only moves each byte to its vector's place in row p of its block.
+		for (auto vector = std::size_t{0}; vector < size; ++vector) {
+			auto const position = vector % block;
+			auto const byte = position < block / 2 ? 2 * position : 2 * (position - block / 2) + 1;
+			auto* const rows = packed.codes_.data() + vector / block * code_size * block + byte;
+			for (auto pair = std::size_t{0}; pair < code_size; ++pair) {
+				rows[pair * block] = codes[vector * code_size + pair];
+			}
+		}
+		return packed;
+	};
+
+	template<euclidean_vector_value T>
+	auto basic_product_quantiser<T>::dimensions() const noexcept -> int {
+		return dimensions_;
+	};
+
+	template<euclidean_vector_value T>
+	auto basic_product_quantiser<T>::subspaces() const noexcept -> int {
+		return subspaces_;
+	};
+
+	template<euclidean_vector_value T>
+	auto basic_product_quantiser<T>::measure() const noexcept -> metric {
+		return measure_;
+	};
+
+	template<euclidean_vector_value T>
+	auto basic_product_quantiser<T>::parameters() const noexcept -> pq_parameters {
+		return parameters_;
+	};
+
+	template<euclidean_vector_value T>
+	auto basic_product_quantiser<T>::centroid(int subspace, int index) const -> row_type {
+		if (not trained() or subspace < 0 or subspace >= subspaces_ or index < 0
+		    or static_cast<std::size_t>(index) >= centroids()) {
+			throw euclidean_vector_error("Centroid is not valid for this product_quantiser object");
+		}
+		auto const centroid =
+		   static_cast<std::size_t>(subspace) * centroids() + static_cast<std::size_t>(index);
+		return {centroids_.data() + centroid * subspace_dimensions(),
+		        static_cast<int>(subspace_dimensions())};
+	};
+
+	// helper functions
+	template<euclidean_vector_value T>
+	auto basic_product_quantiser<T>::check_trainable(int rows) const -> void {
+		if (static_cast<std::size_t>(rows) < centroids()) {
+			throw euclidean_vector_error("Cannot train a product_quantiser on fewer vectors than "
+			                             "centroids");
+		}
+	};
+
+	template<euclidean_vector_value T>
+	auto basic_product_quantiser<T>::check_encodable(int dimensions) const -> void {
+		check_dimensions_equal(dimensions_, dimensions);
+		if (not trained()) {
+			throw euclidean_vector_error("product_quantiser is not trained");
+		}
+	};
+
+	template<euclidean_vector_value T>
+	auto basic_product_quantiser<T>::check_search(int dimensions, int k) const -> void {
+		check_encodable(dimensions);
+		if (k < 0) {
+			throw euclidean_vector_error("Cannot search for a negative number of neighbours");
+		}
+	};
+
+	template<euclidean_vector_value T>
+	auto basic_product_quantiser<T>::check_codes(std::size_t bytes) const -> void {
+		if (not trained()) {
+			throw euclidean_vector_error("product_quantiser is not trained");
+		}
+		if (bytes % static_cast<std::size_t>(code_size()) != 0) {
+			throw euclidean_vector_error("Codes do not match the code size of this product_quantiser");
+		}
+	};
+
+	// Up to sample_per_centroid rows for each centroid, chosen at random, in increasing order
+	template<euclidean_vector_value T>
+	auto basic_product_quantiser<T>::sample_rows(int rows) const -> std::vector<int> {
+		auto const wanted = centroids() * static_cast<std::size_t>(parameters_.sample_per_centroid);
+		auto all = std::vector<int>(static_cast<std::size_t>(rows));
+		std::iota(all.begin(), all.end(), 0);
+		if (all.size() <= wanted) {
+			return all;
+		}
+		auto chosen = std::vector<int>();
+		chosen.reserve(wanted);
+		std::sample(all.begin(),
+		            all.end(),
+		            std::back_inserter(chosen),
+		            wanted,
+		            std::mt19937(parameters_.seed));
+		return chosen;
+	};
+
+	// Each subspace is clustered on its own, and its centroids stored as T.
+	template<euclidean_vector_value T>
+	auto basic_product_quantiser<T>::train(std::vector<double> const& sample) -> void {
+		auto const dimensions = subspace_dimensions();
+		auto const subspaces = static_cast<std::size_t>(subspaces_);
+		auto const rows = sample.size() / static_cast<std::size_t>(dimensions_);
+		auto codebooks = std::vector<T>(subspaces * centroids() * dimensions);
+		auto part = std::vector<double>(rows * dimensions);
+		auto rows_of_part = std::vector<double const*>(rows);
+		for (auto row = std::size_t{0}; row < rows; ++row) {
+			rows_of_part[row] = part.data() + row * dimensions;
+		}
+		for (auto subspace = std::size_t{0}; subspace < subspaces; ++subspace) {
+			for (auto row = std::size_t{0}; row < rows; ++row) {
+				auto const first = sample.begin()
+				                   + static_cast<std::ptrdiff_t>(row * subspaces * dimensions
+				                                                 + subspace * dimensions);
+				std::copy_n(first,
+				            dimensions,
+				            part.begin() + static_cast<std::ptrdiff_t>(row * dimensions));
+			}
+			// Each subspace is seeded differently, so that identical subspaces need not share
+			// codebooks.
+			auto const found = detail::kmeans(
+			   rows_of_part,
+			   static_cast<int>(dimensions),
+			   static_cast<int>(centroids()),
+			   {.iterations = parameters_.iterations,
+			    .tolerance = 0,
+			    .seed = parameters_.seed + static_cast<std::uint32_t>(subspace)},
+			   nullptr);
+			for (auto centroid = std::size_t{0}; centroid < centroids(); ++centroid) {
+				auto const magnitudes = found.centroids[static_cast<int>(centroid)];
+				std::transform(magnitudes.data(),
+				               magnitudes.data() + dimensions,
+				               codebooks.begin()
+				                  + static_cast<std::ptrdiff_t>((subspace * centroids() + centroid)
+				                                                * dimensions),
+				               [](double magnitude) { return kernels::narrow<T>(magnitude); });
+			}
+		}
+
+		centroids_ = std::move(codebooks);
+		centroid_norms_.resize(subspaces * centroids());
+		for (auto centroid = std::size_t{0}; centroid < centroid_norms_.size(); ++centroid) {
+			auto const* const magnitudes = centroids_.data() + centroid * dimensions;
+			centroid_norms_[centroid] = detail::inner_product(magnitudes, magnitudes, dimensions);
+		}
+	};
+
+	// Each part of `magnitudes` is encoded as its nearest centroid in L2, whatever the metric.
+	template<euclidean_vector_value T>
+	auto basic_product_quantiser<T>::encode(T const* magnitudes, std::uint8_t* code) const noexcept
+	   -> void {
+		auto const dimensions = subspace_dimensions();
+		std::fill_n(code, code_size(), std::uint8_t{0});
+		for (auto subspace = std::size_t{0}; subspace < static_cast<std::size_t>(subspaces_);
+		     ++subspace)
+		{
+			auto const* const part = magnitudes + subspace * dimensions;
+			auto const first = subspace * centroids();
+			auto nearest = std::size_t{0};
+			auto nearest_distance = std::numeric_limits<double>::infinity();
+			for (auto centroid = std::size_t{0}; centroid < centroids(); ++centroid) {
+				auto const* const candidate = centroids_.data() + (first + centroid) * dimensions;
+				auto const product = detail::inner_product(part, candidate, dimensions);
+				// The squared distance, less the squared norm of the part
+				auto const distance = centroid_norms_[first + centroid] - 2 * product;
+				if (distance < nearest_distance) {
+					nearest = centroid;
+					nearest_distance = distance;
+				}
+			}
+			if (parameters_.bits == 8) {
+				code[subspace] = static_cast<std::uint8_t>(nearest);
+			}
+			else {
+				code[subspace / 2] |= static_cast<std::uint8_t>(nearest << (4 * (subspace % 2)));
+			}
+		}
+	};
+
+	template<euclidean_vector_value T>
+	auto basic_product_quantiser<T>::code_of(std::uint8_t const* code, std::size_t subspace) const
+	   noexcept -> std::size_t {
+		if (parameters_.bits == 8) {
+			return code[subspace];
+		}
+		return nibble(code[subspace / 2], subspace);
+	};
+
+	// The distance from each part of `query` to each centroid of its subspace, so that the
+	// distance to a code is the sum of one entry per subspace: squared L2 distances, or negated
+	// inner products.
+	template<euclidean_vector_value T>
+	auto basic_product_quantiser<T>::distance_tables(T const* query) const -> std::vector<double> {
+		auto const dimensions = subspace_dimensions();
+		auto tables = std::vector<double>(centroid_norms_.size());
+		for (auto subspace = std::size_t{0}; subspace < static_cast<std::size_t>(subspaces_);
+		     ++subspace)
+		{
+			auto const* const part = query + subspace * dimensions;
+			auto const part_norm = detail::inner_product(part, part, dimensions);
+			for (auto centroid = subspace * centroids(); centroid < (subspace + 1) * centroids();
+			     ++centroid) {
+				auto const product =
+				   detail::inner_product(part, centroids_.data() + centroid * dimensions, dimensions);
+				auto const squared = part_norm + centroid_norms_[centroid] - 2 * product;
+				tables[centroid] = measure_ == metric::l2 ? std::max(0.0, squared) : -product;
+			}
+		}
+		return tables;
+	};
+
+	template<euclidean_vector_value T>
+	auto basic_product_quantiser<T>::search(T const* query,
+	                                        std::span<std::uint8_t const> codes,
+	                                        int k) const -> std::vector<neighbour> {
+		check_codes(codes.size());
+		if (k == 0) {
+			return {};
+		}
+		auto const tables = distance_tables(query);
+		auto const code_size = static_cast<std::size_t>(this->code_size());
+		auto const subspaces = static_cast<std::size_t>(subspaces_);
+		auto found = detail::top_k(k);
+		if (parameters_.bits == 8) {
+			auto const entry = [&](std::uint8_t const* code, std::size_t subspace) {
+				return tables[subspace * 256 + code[subspace]];
+			};
+			scan_codes(codes, code_size, subspaces, found, entry);
+		}
+		else {
+			auto const entry = [&](std::uint8_t const* code, std::size_t subspace) {
+				return tables[subspace * 16 + nibble(code[subspace / 2], subspace)];
+			};
+			scan_codes(codes, code_size, subspaces, found, entry);
+		}
+		return finish(std::move(found));
+	};
+
+	// The tables are shifted so that each one's least entry is 0, and scaled by one factor so that
+	// the largest entry of any is 255. Rounding then moves each entry by at most half a step, so a
+	// sum of quantised entries bounds the exact distance from below to within half a step per
+	// subspace. Codes are summed exactly, in the same order as above, only while that bound is
+	// within the k nearest so far.
+	template<euclidean_vector_value T>
+	auto basic_product_quantiser<T>::search(T const* query,
+	                                        pq_packed_codes const& codes,
+	                                        int k) const -> std::vector<neighbour> {
+		check_codes(0);
+		if (codes.code_size_ != static_cast<std::size_t>(code_size())) {
+			throw euclidean_vector_error("Codes do not match the code size of this product_quantiser");
+		}
+		if (k == 0) {
+			return {};
+		}
+		constexpr auto block = kernels::lookup_block;
+		auto const tables = distance_tables(query);
+		auto const subspaces = static_cast<std::size_t>(subspaces_);
+		auto const pairs = codes.code_size_;
+
+		auto bias = 0.0;
+		auto range = 0.0;
+		auto least = std::vector<double>(subspaces);
+		for (auto subspace = std::size_t{0}; subspace < subspaces; ++subspace) {
+			auto const first = tables.begin() + static_cast<std::ptrdiff_t>(subspace * 16);
+			auto const [low, high] = std::minmax_element(first, first + 16);
+			least[subspace] = *low;
+			bias += *low;
+			range = std::max(range, *high - *low);
+		}
+		auto const scale = range > 0 ? 255 / range : 1.0;
+		// An odd last subspace is paired with a table of zeros.
+		auto quantised = std::vector<std::uint8_t>(2 * pairs * 16);
+		for (auto entry = std::size_t{0}; entry < tables.size(); ++entry) {
+			auto const step = std::nearbyint((tables[entry] - least[entry / 16]) * scale);
+			quantised[entry] = static_cast<std::uint8_t>(std::clamp(step, 0.0, 255.0));
+		}
+		auto const slack = 0.5 * static_cast<double>(subspaces) + 0.5;
+
+		auto found = detail::top_k(k);
+		auto const size = static_cast<std::size_t>(codes.size());
+		auto const blocks = (size + block - 1) / block;
+		auto sums = std::vector<std::uint16_t>(scan_blocks * block);
+		for (auto first = std::size_t{0}; first < blocks; first += scan_blocks) {
+			auto const count = std::min(scan_blocks, blocks - first);
+			auto const* const packed = codes.codes_.data() + first * pairs * block;
+			kernels::lookup_accumulate(packed, quantised.data(), pairs, count, sums.data());
+			auto const last = std::min(size, (first + count) * block);
+			for (auto vector = first * block; vector < last; ++vector) {
+				auto const sum = static_cast<double>(sums[vector - first * block]);
+				if (not found.accepts(bias + (sum - slack) / scale)) {
+					continue;
+				}
+				auto const position = vector % block;
+				auto const byte = position < block / 2 ? 2 * position : 2 * (position - block / 2) + 1;
+				auto const* const rows = codes.codes_.data() + vector / block * pairs * block + byte;
+				auto distance = 0.0;
+				for (auto subspace = std::size_t{0}; subspace < subspaces; ++subspace) {
+					distance += tables[subspace * 16 + nibble(rows[subspace / 2 * block], subspace)];
+				}
+				found.push({static_cast<int>(vector), distance});
+			}
+		}
+		return finish(std::move(found));
+	};
+
+	template<euclidean_vector_value T>
+	auto basic_product_quantiser<T>::finish(detail::top_k&& found) const -> std::vector<neighbour> {
+		auto result = std::move(found).take();
+		if (measure_ == metric::l2) {
+			for (auto& nearest : result) {
+				nearest.distance = std::sqrt(nearest.distance);
+			}
+		}
+		return result;
+	};
+
+	template class basic_product_quantiser<double>;
+	template class basic_product_quantiser<float>;
+	template class basic_product_quantiser<std::int16_t>;
+	template class basic_product_quantiser<std::int8_t>;
+} // namespace comp6771
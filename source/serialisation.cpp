@@ -0,0 +1,240 @@
+// Copyright (c) Christopher Di Bella.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+#include <comp6771/serialisation.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <limits>
+#include <system_error>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#if defined(__x86_64__)
+#	define COMP6771_SERIALISATION_CRC32C 1
+#	include <immintrin.h>
+#else
+#	define COMP6771_SERIALISATION_CRC32C 0
+#endif
+
+namespace comp6771 {
+	namespace {
+		constexpr auto magic = std::array<std::byte, 4>{std::byte{'E'},
+		                                                std::byte{'V'},
+		                                                std::byte{'E'},
+		                                                std::byte{'C'}};
+
+		auto element_size(element_type type) noexcept -> std::size_t {
+			switch (type) {
+			case element_type::float64: return sizeof(double);
+			case element_type::float32: return sizeof(float);
+			case element_type::int16: return sizeof(std::int16_t);
+			case element_type::int8: return sizeof(std::int8_t);
+			}
+			return 0;
+		}
+
+		// Reflected CRC-32C, one byte at a time
+		constexpr auto crc32c_table = [] {
+			auto table = std::array<std::uint32_t, 256>();
+			for (auto i = std::uint32_t{0}; i < table.size(); ++i) {
+				auto crc = i;
+				for (auto bit = 0; bit < 8; ++bit) {
+					crc = (crc & 1U) != 0 ? (crc >> 1U) ^ 0x82F63B78U : crc >> 1U;
+				}
+				table[i] = crc;
+			}
+			return table;
+		}();
+
+		auto crc32c_portable(std::byte const* data, std::size_t size, std::uint32_t crc) noexcept
+		   -> std::uint32_t {
+			for (auto i = std::size_t{0}; i < size; ++i) {
+				auto const index = (crc ^ std::to_integer<std::uint32_t>(data[i])) & 0xFFU;
+				crc = crc32c_table[index] ^ (crc >> 8U);
+			}
+			return crc;
+		}
+
+#if COMP6771_SERIALISATION_CRC32C
+		// SSE4.2 has an instruction for CRC-32C, taking eight bytes at a time.
+		__attribute__((target("sse4.2"))) auto
+		crc32c_sse42(std::byte const* data, std::size_t size, std::uint32_t crc) noexcept
+		   -> std::uint32_t {
+			auto wide = std::uint64_t{crc};
+			auto i = std::size_t{0};
+			for (; i + 8 <= size; i += 8) {
+				auto word = std::uint64_t{0};
+				std::copy(data + i, data + i + 8, reinterpret_cast<std::byte*>(&word));
+				wide = _mm_crc32_u64(wide, word);
+			}
+			return crc32c_portable(data + i, size - i, static_cast<std::uint32_t>(wide));
+		}
+
+		auto const has_sse42 = [] {
+			__builtin_cpu_init();
+			return __builtin_cpu_supports("sse4.2") != 0;
+		}();
+#endif
+	} // namespace
+
+	auto binary_header::payload_size() const noexcept -> std::size_t {
+		return static_cast<std::size_t>(dimensions) * element_size(type);
+	}
+
+	auto binary_header::record_size() const noexcept -> std::size_t {
+		return binary_header_size + (payload_size() + 7) / 8 * 8;
+	}
+
+	auto read_binary_header(std::span<std::byte const> buffer) -> binary_header {
+		if (buffer.size() < binary_header_size) {
+			throw euclidean_vector_error("Binary euclidean_vector is truncated");
+		}
+		auto const type = std::to_integer<std::uint8_t>(buffer[5]);
+		auto const byte_order = std::to_integer<std::uint8_t>(buffer[6]);
+		auto const checksum_type = std::to_integer<std::uint8_t>(buffer[7]);
+		auto const dimensions = detail::load_little_endian<std::uint32_t>(buffer.data() + 8);
+		if (not std::equal(magic.begin(), magic.end(), buffer.begin()) or type < 1 or type > 4
+		    or byte_order > 1 or checksum_type > 1
+		    or dimensions > static_cast<std::uint32_t>(std::numeric_limits<int>::max()))
+		{
+			throw euclidean_vector_error("Binary euclidean_vector header is not valid");
+		}
+		auto const version = std::to_integer<std::uint8_t>(buffer[4]);
+		if (version != binary_format_version) {
+			throw euclidean_vector_error("Binary euclidean_vector version is not supported");
+		}
+		return {
+		   .version = version,
+		   .type = static_cast<element_type>(type),
+		   .byte_order = byte_order == 0 ? std::endian::little : std::endian::big,
+		   .checksum_type = static_cast<checksum>(checksum_type),
+		   .dimensions = static_cast<int>(dimensions),
+		   .payload_checksum = detail::load_little_endian<std::uint32_t>(buffer.data() + 12),
+		};
+	}
+
+	namespace detail {
+		auto crc32c(std::span<std::byte const> bytes, std::uint32_t crc) noexcept -> std::uint32_t {
+#if COMP6771_SERIALISATION_CRC32C
+			if (has_sse42) {
+				return ~crc32c_sse42(bytes.data(), bytes.size(), ~crc);
+			}
+#endif
+			return ~crc32c_portable(bytes.data(), bytes.size(), ~crc);
+		}
+
+		auto encode_binary_header(binary_header const& header)
+		   -> std::array<std::byte, binary_header_size> {
+			auto bytes = std::array<std::byte, binary_header_size>();
+			std::copy(magic.begin(), magic.end(), bytes.begin());
+			bytes[4] = std::byte{header.version};
+			bytes[5] = static_cast<std::byte>(header.type);
+			bytes[6] = std::byte{header.byte_order == std::endian::little ? std::uint8_t{0}
+			                                                               : std::uint8_t{1}};
+			bytes[7] = static_cast<std::byte>(header.checksum_type);
+			store_little_endian(bytes.data() + 8, static_cast<std::uint32_t>(header.dimensions));
+			store_little_endian(bytes.data() + 12, header.payload_checksum);
+			return bytes;
+		}
+
+		auto check_element_type(binary_header const& header, element_type type) -> void {
+			if (header.type != type) {
+				throw euclidean_vector_error("Binary euclidean_vector does not hold this "
+				                             "element type");
+			}
+		}
+
+		auto check_payload(binary_header const& header, std::span<std::byte const> payload) -> void {
+			if (header.checksum_type == checksum::crc32c
+			    and crc32c(payload) != header.payload_checksum) {
+				throw euclidean_vector_error("Binary euclidean_vector checksum does not match");
+			}
+		}
+
+		auto write_all(int fd, std::span<std::span<std::byte const> const> parts) -> void {
+			constexpr auto max_parts = std::size_t{4};
+			while (not parts.empty()) {
+				auto pending = std::array<std::span<std::byte const>, max_parts>();
+				auto const count = std::min(parts.size(), max_parts);
+				auto const group = parts.first(count);
+				std::copy(group.begin(), group.end(), pending.begin());
+				parts = parts.subspan(count);
+
+				// writev may stop part way through any part, so resume from where it got to.
+				auto first = std::size_t{0};
+				while (first < count) {
+					auto vectors = std::array<iovec, max_parts>();
+					for (auto i = first; i < count; ++i) {
+						// NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+						vectors[i - first] = {const_cast<std::byte*>(pending[i].data()),
+						                      pending[i].size()};
+					}
+					auto const written = ::writev(fd, vectors.data(), static_cast<int>(count - first));
+					if (written < 0) {
+						if (errno == EINTR) {
+							continue;
+						}
+						throw std::system_error(errno,
+						                        std::generic_category(),
+						                        "Could not write binary euclidean_vector");
+					}
+					auto remaining = static_cast<std::size_t>(written);
+					for (; first < count and remaining >= pending[first].size(); ++first) {
+						remaining -= pending[first].size();
+					}
+					if (first < count) {
+						pending[first] = pending[first].subspan(remaining);
+					}
+				}
+			}
+		}
+
+		auto read_all(int fd, std::span<std::byte> bytes) -> void {
+			while (not bytes.empty()) {
+				auto const got = ::read(fd, bytes.data(), bytes.size());
+				if (got < 0) {
+					if (errno == EINTR) {
+						continue;
+					}
+					throw std::system_error(errno,
+					                        std::generic_category(),
+					                        "Could not read binary euclidean_vector");
+				}
+				if (got == 0) {
+					throw euclidean_vector_error("Binary euclidean_vector is truncated");
+				}
+				bytes = bytes.subspan(static_cast<std::size_t>(got));
+			}
+		}
+
+		auto remaining_bytes(std::istream& is) -> std::optional<std::size_t> {
+			auto const here = is.tellg();
+			if (here == std::istream::pos_type(-1)) {
+				return std::nullopt;
+			}
+			is.seekg(0, std::ios::end);
+			auto const end = is.tellg();
+			is.clear();
+			is.seekg(here);
+			if (end == std::istream::pos_type(-1) or end < here) {
+				return std::nullopt;
+			}
+			return static_cast<std::size_t>(end - here);
+		}
+
+		auto remaining_bytes(int fd) -> std::optional<std::size_t> {
+			struct stat status = {};
+			if (::fstat(fd, &status) != 0 or not S_ISREG(status.st_mode)) {
+				return std::nullopt;
+			}
+			auto const here = ::lseek(fd, 0, SEEK_CUR);
+			if (here < 0 or status.st_size < here) {
+				return std::nullopt;
+			}
+			return static_cast<std::size_t>(status.st_size - here);
+		}
+	} // namespace detail
+} // namespace comp6771
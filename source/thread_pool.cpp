@@ -0,0 +1,107 @@
+// Copyright (c) Christopher Di Bella.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+#include <comp6771/thread_pool.hpp>
+
+#include <algorithm>
+
+namespace comp6771 {
+	// Constructors
+	thread_pool::thread_pool(unsigned threads) {
+		auto const workers = std::max(threads, 1U) - 1;
+		workers_.reserve(workers);
+		for (auto i = 0U; i < workers; ++i) {
+			workers_.emplace_back([this] { work(); });
+		}
+	};
+
+	// Destructor
+	thread_pool::~thread_pool() {
+		{
+			auto const lock = std::lock_guard(mutex_);
+			stopping_ = true;
+		}
+		wake_.notify_all();
+		for (auto& worker : workers_) {
+			worker.join();
+		}
+	};
+
+	// Member functions
+	auto thread_pool::size() const noexcept -> unsigned {
+		return static_cast<unsigned>(workers_.size()) + 1;
+	};
+
+	auto thread_pool::shared() -> thread_pool& {
+		static auto pool = thread_pool();
+		return pool;
+	};
+
+	auto thread_pool::run_chunks(std::size_t chunks, task_function function, void const* context)
+	   -> void {
+		if (workers_.empty() or chunks <= 1) {
+			for (auto chunk = std::size_t{0}; chunk < chunks; ++chunk) {
+				function(context, chunk);
+			}
+			return;
+		}
+
+		auto const run_lock = std::lock_guard(run_mutex_);
+		{
+			auto lock = std::unique_lock(mutex_);
+			// A worker that woke too late for the previous job may still be looking at it.
+			done_.wait(lock, [this] { return active_ == 0; });
+			function_ = function;
+			context_ = context;
+			chunks_ = chunks;
+			remaining_ = chunks;
+			next_chunk_.store(0);
+			++generation_;
+		}
+		wake_.notify_all();
+
+		auto const finished = drain(function, context, chunks);
+
+		auto lock = std::unique_lock(mutex_);
+		remaining_ -= finished;
+		done_.wait(lock, [this] { return remaining_ == 0 and active_ == 0; });
+	};
+
+	auto thread_pool::work() -> void {
+		auto seen = std::uint64_t{0};
+		auto lock = std::unique_lock(mutex_);
+		while (true) {
+			wake_.wait(lock, [&] { return stopping_ or generation_ != seen; });
+			if (stopping_) {
+				return;
+			}
+			seen = generation_;
+			auto const function = function_;
+			auto const* const context = context_;
+			auto const chunks = chunks_;
+			++active_;
+			lock.unlock();
+
+			auto const finished = drain(function, context, chunks);
+
+			lock.lock();
+			remaining_ -= finished;
+			--active_;
+			if (active_ == 0) {
+				done_.notify_all();
+			}
+		}
+	};
+
+	auto thread_pool::drain(task_function function, void const* context, std::size_t chunks) noexcept
+	   -> std::size_t {
+		auto finished = std::size_t{0};
+		for (auto chunk = next_chunk_.fetch_add(1); chunk < chunks;
+		     chunk = next_chunk_.fetch_add(1))
+		{
+			function(context, chunk);
+			++finished;
+		}
+		return finished;
+	};
+} // namespace comp6771
@@ -0,0 +1,183 @@
+#include <catch2/catch.hpp>
+#include <comp6771/euclidean_vector.hpp>
+#include <comp6771/euclidean_vector_batch.hpp>
+#include <cstdint>
+#include <sstream>
+#include <utility>
+#include <vector>
+
+/*
+This file is to test euclidean_vector_batch and its rows.
+It assumes euclidean_vector itself is correctly implemented.
+
+Approach:
+    - Construct a batch, either empty or from a list of euclidean vectors
+    - Use its rows with the euclidean_vector operators and utility functions
+    - Check the rows and the batched kernels against the equivalent euclidean_vector results
+*/
+
+/*
+Rationale:
+    Rows must be contiguous in one allocation starting on a 64-byte boundary and, when padding is
+    requested, be padded to whole cache lines. Negative shapes are rejected.
+*/
+TEST_CASE("Batch construction and layout") {
+	SECTION("Zero-initialised batch") {
+		auto const batch = comp6771::euclidean_vector_batch(3, 5);
+		CHECK(batch.rows() == 3);
+		CHECK(batch.dimensions() == 5);
+		CHECK(batch.stride() == 5);
+		for (auto row = 0; row < batch.rows(); ++row) {
+			CHECK(batch[row] == comp6771::euclidean_vector(5));
+		}
+	}
+
+	SECTION("Padded rows") {
+		using padding = comp6771::euclidean_vector_batch::row_padding;
+		auto const batch = comp6771::euclidean_vector_batch(3, 5, padding::cache_line);
+		CHECK(batch.stride() == 8);
+		for (auto row = 0; row < batch.rows(); ++row) {
+			auto const address = reinterpret_cast<std::uintptr_t>(batch[row].data());
+			CHECK(address % comp6771::euclidean_vector_batch::alignment == 0);
+		}
+	}
+
+	SECTION("Negative rows or dimensions") {
+		CHECK_THROWS_MATCHES(comp6771::euclidean_vector_batch(-1, 0),
+		                     comp6771::euclidean_vector_error,
+		                     Catch::Matchers::Message("euclidean_vector_batch cannot have negative "
+		                                              "rows"));
+		CHECK_THROWS_MATCHES(comp6771::euclidean_vector_batch(2, -3),
+		                     comp6771::euclidean_vector_error,
+		                     Catch::Matchers::Message("euclidean_vector cannot have negative "
+		                                              "dimensions"));
+		CHECK_THROWS_AS(comp6771::euclidean_vector_batch(-1, 3), comp6771::euclidean_vector_error);
+	}
+
+	SECTION("From euclidean vectors") {
+		auto const vectors = std::vector<comp6771::euclidean_vector>{{1, 2, 3}, {4, 5, 6}};
+		auto const batch = comp6771::euclidean_vector_batch(vectors);
+		CHECK(batch.rows() == 2);
+		CHECK(batch[0] == vectors[0]);
+		CHECK(batch[1] == vectors[1]);
+	}
+
+	SECTION("From euclidean vectors of different dimensions") {
+		auto const vectors = std::vector<comp6771::euclidean_vector>{{1, 2, 3}, {4, 5}};
+		CHECK_THROWS_MATCHES(comp6771::euclidean_vector_batch(vectors),
+		                     comp6771::euclidean_vector_error,
+		                     Catch::Matchers::Message("Dimensions of LHS(3) and RHS(2) do not "
+		                                              "match"));
+	}
+
+	SECTION("Copy and move") {
+		auto batch = comp6771::euclidean_vector_batch({{1, 2}, {3, 4}});
+		auto copy = batch;
+		copy[0][0] = 10;
+		CHECK(batch[0][0] == Approx(1).margin(1e-6));
+
+		auto moved = std::move(batch);
+		CHECK(moved[1] == comp6771::euclidean_vector{3, 4});
+		// NOLINTNEXTLINE(bugprone-use-after-move)
+		CHECK(batch.rows() == 0);
+	}
+}
+
+/*
+Rationale:
+    Rows behave like euclidean vectors: they work with every operator and utility function, and
+    writing through a mutable row changes the batch. The batch itself is not a vector, so it
+    cannot be mistaken for its first row.
+*/
+TEST_CASE("Batch rows as euclidean vectors") {
+	auto batch = comp6771::euclidean_vector_batch({{1, 2, 2}, {3, 4, 0}});
+	auto const ev = comp6771::euclidean_vector{1, 1, 1};
+
+	SECTION("Arithmetic and comparison") {
+		auto const sum = comp6771::euclidean_vector(batch[0] + batch[1] * 2 - ev);
+		CHECK(sum == comp6771::euclidean_vector{6, 9, 1});
+		CHECK(batch[0] != batch[1]);
+		CHECK(comp6771::euclidean_vector(batch[1]) == comp6771::euclidean_vector{3, 4, 0});
+	}
+
+	SECTION("Utility functions") {
+		CHECK(comp6771::euclidean_norm(batch[0]) == Approx(3).margin(1e-6));
+		CHECK(comp6771::dot(batch[0], batch[1]) == Approx(11).margin(1e-6));
+		CHECK(comp6771::dot(batch[0], ev) == Approx(5).margin(1e-6));
+		CHECK(comp6771::unit(batch[1]) == comp6771::euclidean_vector{0.6, 0.8, 0});
+		CHECK_THROWS_MATCHES(comp6771::dot(batch[0], comp6771::euclidean_vector{1, 2}),
+		                     comp6771::euclidean_vector_error,
+		                     Catch::Matchers::Message("Dimensions of LHS(3) and RHS(2) do not "
+		                                              "match"));
+	}
+
+	SECTION("Writing through rows") {
+		batch[0] += ev;
+		batch[1] -= batch[0];
+		batch[1] *= 2;
+		batch[1] /= 4;
+		CHECK(batch[0] == comp6771::euclidean_vector{2, 3, 3});
+		CHECK(batch[1] == comp6771::euclidean_vector{0.5, 0.5, -1.5});
+
+		batch.at(0).assign(ev * 3);
+		batch.at(1).at(2) = 7;
+		CHECK(batch[0] == comp6771::euclidean_vector{3, 3, 3});
+		CHECK(batch[1][2] == Approx(7).margin(1e-6));
+	}
+
+	SECTION("Batches are not vectors") {
+		static_assert(comp6771::contiguous_euclidean_vector<decltype(batch[0])>);
+		static_assert(not comp6771::contiguous_euclidean_vector<comp6771::euclidean_vector_batch>);
+		static_assert(not comp6771::euclidean_vector_operand<comp6771::euclidean_vector_batch>);
+	}
+
+	SECTION("Output") {
+		auto oss = std::ostringstream{};
+		oss << batch[1];
+		CHECK(oss.str() == "[3 4 0]");
+	}
+
+	SECTION("Invalid indices") {
+		CHECK_THROWS_MATCHES(batch.at(2),
+		                     comp6771::euclidean_vector_error,
+		                     Catch::Matchers::Message("Row 2 is not valid for this "
+		                                              "euclidean_vector_batch object"));
+		CHECK_THROWS_MATCHES(batch[0].at(3),
+		                     comp6771::euclidean_vector_error,
+		                     Catch::Matchers::Message("Index 3 is not valid for this "
+		                                              "euclidean_vector_view object"));
+	}
+}
+
+/*
+Rationale:
+    The batched kernels must give the same results as calling the utility functions row by row.
+*/
+TEST_CASE("Batched kernels") {
+	auto batch = comp6771::euclidean_vector_batch({{1, 2, 2}, {3, 4, 0}, {0, 0, 5}});
+
+	SECTION("Norms") {
+		CHECK_THAT(batch.euclidean_norms(), Catch::Approx(std::vector<double>{3, 5, 5}).margin(1e-6));
+	}
+
+	SECTION("Dot products against a query") {
+		auto const query = comp6771::euclidean_vector{1, 0, -1};
+		CHECK_THAT(batch.dot(query), Catch::Approx(std::vector<double>{-1, 3, -5}).margin(1e-6));
+		CHECK_THAT(batch.dot(batch[1]), Catch::Approx(std::vector<double>{11, 25, 0}).margin(1e-6));
+	}
+
+	SECTION("Normalise") {
+		batch.normalise();
+		CHECK_THAT(batch.euclidean_norms(), Catch::Approx(std::vector<double>{1, 1, 1}).margin(1e-6));
+		CHECK(batch[1] == comp6771::euclidean_vector{0.6, 0.8, 0});
+	}
+
+	SECTION("Normalise with a zero row") {
+		batch[2] *= 0;
+		CHECK_THROWS_MATCHES(batch.normalise(),
+		                     comp6771::euclidean_vector_error,
+		                     Catch::Matchers::Message("euclidean_vector with zero euclidean normal "
+		                                              "does not have a unit vector"));
+		CHECK(batch[0] == comp6771::euclidean_vector{1, 2, 2});
+	}
+}
@@ -1,5 +1,19 @@
+#include <algorithm>
+#include <array>
 #include <catch2/catch.hpp>
 #include <comp6771/euclidean_vector.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <iterator>
+#include <list>
+#include <memory>
+#include <memory_resource>
+#include <numeric>
+#include <ranges>
+#include <span>
+#include <sstream>
 #include <vector>
 
 /*
@@ -34,6 +48,14 @@ TEST_CASE("Single-argument Constructor") {
 		auto const vec_exp = std::vector<double>{0, 0};
 		CHECK_THAT(static_cast<std::vector<double>>(ev), Catch::Approx(vec_exp).margin(1e-6));
 	}
+
+	SECTION("Negative dimension") {
+		CHECK_THROWS_MATCHES(comp6771::euclidean_vector(-3),
+		                     comp6771::euclidean_vector_error,
+		                     Catch::Matchers::Message("euclidean_vector cannot have negative "
+		                                              "dimensions"));
+		CHECK_THROWS_AS(comp6771::euclidean_vector(-1, 2.0), comp6771::euclidean_vector_error);
+	}
 }
 
 TEST_CASE("Constructor: dimensions and magnitude") {
@@ -66,6 +88,82 @@ TEST_CASE("Constructor: start and end iterator of an vector") {
 	}
 }
 
+/*
+Rationale:
+    Any iterator pair or input range of arithmetic elements can be used, without first copying it
+    into a std::vector<double>. Single-pass ranges longer than the inline capacity must grow the
+    storage while reading.
+*/
+TEST_CASE("Constructor: any range or iterator pair") {
+	auto const vec_exp = std::vector<double>{1.5, -2.5, 3.5, -4.5, 5.5, -6.5, 7.5, -8.5, 9.5};
+
+	SECTION("Contiguous ranges") {
+		auto const array = std::array<double, 9>{1.5, -2.5, 3.5, -4.5, 5.5, -6.5, 7.5, -8.5, 9.5};
+		auto const from_array = comp6771::euclidean_vector(array);
+		CHECK_THAT(static_cast<std::vector<double>>(from_array), Catch::Approx(vec_exp).margin(1e-6));
+
+		auto const from_span = comp6771::euclidean_vector(std::span<double const>(vec_exp));
+		CHECK_THAT(static_cast<std::vector<double>>(from_span), Catch::Approx(vec_exp).margin(1e-6));
+
+		auto const* const buffer = vec_exp.data();
+		auto const from_pointers = comp6771::euclidean_vector(buffer, buffer + 3);
+		CHECK_THAT(static_cast<std::vector<double>>(from_pointers),
+		           Catch::Approx(std::vector<double>{1.5, -2.5, 3.5}).margin(1e-6));
+	}
+
+	SECTION("Non-contiguous ranges") {
+		auto const deque = std::deque<double>(vec_exp.begin(), vec_exp.end());
+		auto const from_deque = comp6771::euclidean_vector(deque.begin(), deque.end());
+		CHECK_THAT(static_cast<std::vector<double>>(from_deque), Catch::Approx(vec_exp).margin(1e-6));
+
+		auto const list = std::list<double>(vec_exp.begin(), vec_exp.end());
+		auto const from_list = comp6771::euclidean_vector(list);
+		CHECK_THAT(static_cast<std::vector<double>>(from_list), Catch::Approx(vec_exp).margin(1e-6));
+
+		auto const from_view = comp6771::euclidean_vector(vec_exp | std::views::take(2));
+		CHECK_THAT(static_cast<std::vector<double>>(from_view),
+		           Catch::Approx(std::vector<double>{1.5, -2.5}).margin(1e-6));
+	}
+
+	SECTION("Other element types are converted") {
+		auto const floats =
+		   std::vector<float>{1.5F, -2.5F, 3.5F, -4.5F, 5.5F, -6.5F, 7.5F, -8.5F, 9.5F};
+		auto const from_floats = comp6771::euclidean_vector(floats);
+		CHECK_THAT(static_cast<std::vector<double>>(from_floats),
+		           Catch::Approx(vec_exp).margin(1e-6));
+
+		auto const ints = std::array<int, 3>{1, 300, -300};
+		auto const quantised = comp6771::basic_euclidean_vector<std::int8_t>(ints);
+		CHECK(static_cast<std::vector<std::int8_t>>(quantised)
+		      == std::vector<std::int8_t>{1, 127, -128});
+	}
+
+	SECTION("Single-pass ranges") {
+		auto input = std::istringstream("1.5 -2.5 3.5 -4.5 5.5 -6.5 7.5 -8.5 9.5");
+		auto const ev = comp6771::euclidean_vector(std::istream_iterator<double>(input),
+		                                           std::istream_iterator<double>());
+		CHECK_THAT(static_cast<std::vector<double>>(ev), Catch::Approx(vec_exp).margin(1e-6));
+
+		auto arena = std::pmr::monotonic_buffer_resource();
+		auto empty = std::istringstream();
+		auto const from_resource = comp6771::euclidean_vector(std::istream_iterator<double>(empty),
+		                                                      std::istream_iterator<double>(),
+		                                                      &arena);
+		CHECK(from_resource.dimensions() == 0);
+		CHECK(from_resource.resource() == &arena);
+
+		auto many = std::istringstream("1 2 3 4 5 6 7 8 9 10 11 12 13 14 15 16 17 18 19 20");
+		auto const grown = comp6771::euclidean_vector(
+		   std::ranges::subrange(std::istream_iterator<double>(many),
+		                         std::istream_iterator<double>()),
+		   &arena);
+		auto expected = std::vector<double>(20);
+		std::iota(expected.begin(), expected.end(), 1.0);
+		CHECK(grown.resource() == &arena);
+		CHECK_THAT(static_cast<std::vector<double>>(grown), Catch::Approx(expected).margin(1e-6));
+	}
+}
+
 TEST_CASE("Constructor: an initialiser list") {
 	SECTION("Empty initialiser list without parentheses") {
 		// This should call default constructor
@@ -134,3 +232,180 @@ TEST_CASE("Move Constructor") {
 		CHECK(ev.dimensions() == 0);
 	}
 }
+
+/*
+Rationale:
+    Vectors with at most inline_capacity dimensions keep their magnitudes inside the object.
+    This test ensures construction, copy and move give the same results on both sides of the
+    inline capacity, and that small vectors really do not point outside the object.
+*/
+TEST_CASE("Inline storage for small vectors") {
+	auto const small = comp6771::euclidean_vector::inline_capacity;
+	auto const large = small + 1;
+
+	SECTION("Small vectors store magnitudes inside the object") {
+		auto const ev = comp6771::euclidean_vector(small, 1.5);
+		auto const* const begin = static_cast<void const*>(std::addressof(ev));
+		auto const* const end = static_cast<void const*>(std::addressof(ev) + 1);
+		CHECK(std::less_equal<>{}(begin, static_cast<void const*>(ev.data())));
+		CHECK(std::less<>{}(static_cast<void const*>(ev.data()), end));
+	}
+
+	for (auto const dimensions : {small, large}) {
+		auto const input_vec = std::vector<double>(static_cast<std::size_t>(dimensions), -2.5);
+
+		SECTION("Copy keeps both objects independent") {
+			auto ev = comp6771::euclidean_vector(input_vec.cbegin(), input_vec.cend());
+			auto copy = ev;
+			copy[0] = 1.0;
+			CHECK_THAT(static_cast<std::vector<double>>(ev), Catch::Approx(input_vec).margin(1e-6));
+			CHECK(copy[0] == Approx(1.0).margin(1e-6));
+		}
+
+		SECTION("Move constructor and move assignment keep magnitudes") {
+			auto ev = comp6771::euclidean_vector(input_vec.cbegin(), input_vec.cend());
+			auto moved = std::move(ev);
+			CHECK_THAT(static_cast<std::vector<double>>(moved), Catch::Approx(input_vec).margin(1e-6));
+			// NOLINTNEXTLINE(bugprone-use-after-move)
+			CHECK(ev.dimensions() == 0);
+
+			auto assigned = comp6771::euclidean_vector(large + 1);
+			assigned = std::move(moved);
+			CHECK_THAT(static_cast<std::vector<double>>(assigned),
+			           Catch::Approx(input_vec).margin(1e-6));
+		}
+	}
+}
+
+/*
+Rationale:
+    Large vectors can take their storage from a std::pmr::memory_resource instead of the global
+    heap. This test ensures every constructor draws from the given resource, that small vectors
+    never touch it, and that copy assignment and expression assignment keep the destination's
+    resource while moves carry the source's along.
+*/
+TEST_CASE("Memory resource") {
+	auto const large = comp6771::euclidean_vector::inline_capacity + 4;
+	auto const input_vec = std::vector<double>(static_cast<std::size_t>(large), 3.5);
+	auto arena = std::pmr::monotonic_buffer_resource();
+
+	SECTION("Default vectors use the global heap") {
+		CHECK(comp6771::euclidean_vector(large).resource() == nullptr);
+	}
+
+	SECTION("Constructors allocate from the resource") {
+		// No upstream, so anything not served from the buffer would throw
+		auto buffer = std::array<std::byte, 4096>{};
+		auto bounded = std::pmr::monotonic_buffer_resource(buffer.data(),
+		                                                   buffer.size(),
+		                                                   std::pmr::null_memory_resource());
+		auto const ev = comp6771::euclidean_vector(input_vec.cbegin(), input_vec.cend(), &bounded);
+		CHECK(ev.resource() == &bounded);
+		auto const* const magnitude = static_cast<void const*>(ev.data());
+		CHECK(std::less_equal<>{}(static_cast<void const*>(buffer.data()), magnitude));
+		CHECK(std::less<>{}(magnitude, static_cast<void const*>(buffer.data() + buffer.size())));
+		CHECK_THAT(static_cast<std::vector<double>>(ev), Catch::Approx(input_vec).margin(1e-6));
+
+		auto const filled = comp6771::euclidean_vector(large, 1.0, &bounded);
+		auto const listed = comp6771::euclidean_vector({1.0, 2.0, 3.0, 4.0, 5.0, 6.0}, &bounded);
+		auto const copied = comp6771::euclidean_vector(ev, &bounded);
+		auto const evaluated = comp6771::euclidean_vector(ev + filled, &bounded);
+		CHECK(copied == ev);
+		CHECK(evaluated == comp6771::euclidean_vector(large, 4.5));
+		CHECK(listed[5] == Approx(6.0).margin(1e-6));
+	}
+
+	SECTION("Small vectors do not allocate") {
+		auto const ev = comp6771::euclidean_vector(comp6771::euclidean_vector::inline_capacity,
+		                                           2.0,
+		                                           std::pmr::null_memory_resource());
+		CHECK(ev.resource() == std::pmr::null_memory_resource());
+		CHECK(ev[0] == Approx(2.0).margin(1e-6));
+	}
+
+	SECTION("Copies use the global heap unless given a resource") {
+		auto buffer = std::array<std::byte, 1024>{};
+		auto bounded = std::pmr::monotonic_buffer_resource(buffer.data(),
+		                                                   buffer.size(),
+		                                                   std::pmr::null_memory_resource());
+		auto const ev = comp6771::euclidean_vector(large, 1.0, &bounded);
+		auto const copy = ev;
+		CHECK(copy.resource() == nullptr);
+		CHECK(copy == ev);
+	}
+
+	SECTION("Assignment keeps the destination's resource") {
+		auto buffer = std::array<std::byte, 4096>{};
+		auto bounded = std::pmr::monotonic_buffer_resource(buffer.data(),
+		                                                   buffer.size(),
+		                                                   std::pmr::null_memory_resource());
+		auto ev = comp6771::euclidean_vector(1, 0.0, &bounded);
+		ev = comp6771::euclidean_vector(input_vec.cbegin(), input_vec.cend());
+		CHECK(ev.resource() == &bounded);
+		CHECK_THAT(static_cast<std::vector<double>>(ev), Catch::Approx(input_vec).margin(1e-6));
+
+		auto other = comp6771::euclidean_vector(1, 0.0, &bounded);
+		other = ev * 2;
+		CHECK(other.resource() == &bounded);
+		CHECK(other == comp6771::euclidean_vector(large, 7.0));
+	}
+
+	SECTION("Moves carry the resource along") {
+		auto ev = comp6771::euclidean_vector(large, 1.0, &arena);
+		auto const* const magnitude = ev.data();
+		auto moved = comp6771::euclidean_vector(std::move(ev));
+		CHECK(moved.resource() == &arena);
+		CHECK(moved.data() == magnitude);
+	}
+}
+
+/*
+Rationale:
+    uninitialized() only allocates, leaving the caller to write each magnitude, and otherwise
+    behaves like any other vector of that many dimensions.
+*/
+TEST_CASE("Uninitialised construction") {
+	SECTION("Small and large vectors") {
+		for (auto const dimensions : {0, 3, comp6771::euclidean_vector::inline_capacity + 5}) {
+			auto ev = comp6771::euclidean_vector::uninitialized(dimensions);
+			REQUIRE(ev.dimensions() == dimensions);
+			std::iota(ev.data(), ev.data() + dimensions, 1.0);
+			auto expected = std::vector<double>(static_cast<std::size_t>(dimensions));
+			std::iota(expected.begin(), expected.end(), 1.0);
+			CHECK_THAT(static_cast<std::vector<double>>(ev), Catch::Approx(expected).margin(1e-6));
+		}
+	}
+
+	SECTION("From a memory resource") {
+		auto arena = std::pmr::monotonic_buffer_resource();
+		auto const large = comp6771::euclidean_vector::inline_capacity + 5;
+		auto ev = comp6771::euclidean_vector::uninitialized(large, &arena);
+		CHECK(ev.resource() == &arena);
+		std::fill(ev.data(), ev.data() + large, 2.0);
+		CHECK(ev == comp6771::euclidean_vector(large, 2.0));
+	}
+}
+
+/*
+Rationale:
+    adopt() takes a caller's buffer as it is, so it must reject dimensions that no buffer could
+    hold and null buffers that claim to hold magnitudes.
+*/
+TEST_CASE("Adopt: invalid buffers") {
+	SECTION("Negative dimensions") {
+		// NOLINTNEXTLINE(modernize-avoid-c-arrays)
+		CHECK_THROWS_MATCHES(comp6771::euclidean_vector::adopt(std::make_unique<double[]>(1), -2),
+		                     comp6771::euclidean_vector_error,
+		                     Catch::Matchers::Message("euclidean_vector cannot have negative "
+		                                              "dimensions"));
+	}
+
+	SECTION("Null buffers") {
+		auto const large = comp6771::euclidean_vector::inline_capacity + 4;
+		for (auto const dimensions : {1, large}) {
+			CHECK_THROWS_AS(comp6771::euclidean_vector::adopt(nullptr, dimensions),
+			                comp6771::euclidean_vector_error);
+		}
+		CHECK(comp6771::euclidean_vector::adopt(nullptr, 0).dimensions() == 0);
+	}
+}
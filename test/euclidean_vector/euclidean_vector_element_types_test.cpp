@@ -0,0 +1,112 @@
+#include <catch2/catch.hpp>
+#include <comp6771/euclidean_vector.hpp>
+#include <comp6771/euclidean_vector_batch.hpp>
+#include <comp6771/euclidean_vector_view.hpp>
+#include <cstdint>
+#include <sstream>
+#include <vector>
+
+/*
+This file is to test basic_euclidean_vector with element types other than double.
+It assumes the double instantiation, euclidean_vector, is correctly implemented.
+
+Approach:
+    - Construct float and quantised vectors, views and batches
+    - Use them with the operators and utility functions
+    - Compare against the same computation done in double
+*/
+
+/*
+Rationale:
+    float vectors support everything double ones do, in half the memory. Results should match
+    double up to float precision, and norms and inner products are still returned as double.
+*/
+TEST_CASE("Float vectors") {
+	auto const ev1 = comp6771::basic_euclidean_vector<float>{1.5F, -2.25F, 3.0F, 0.5F, 8.0F};
+	auto const ev2 = comp6771::basic_euclidean_vector<float>{-4.0F, 1.0F, 0.25F, 2.0F, -1.0F};
+	auto const dv1 = comp6771::euclidean_vector{1.5, -2.25, 3.0, 0.5, 8.0};
+	auto const dv2 = comp6771::euclidean_vector{-4.0, 1.0, 0.25, 2.0, -1.0};
+
+	SECTION("Storage is float") {
+		CHECK(std::same_as<decltype(ev1.data()), float const*>);
+		CHECK(std::same_as<decltype(ev1)::value_type, float>);
+	}
+
+	SECTION("Arithmetic matches double") {
+		auto const sum = comp6771::basic_euclidean_vector<float>(ev1 * 2 - ev2 / 4);
+		CHECK(sum == comp6771::euclidean_vector(dv1 * 2 - dv2 / 4));
+
+		auto compound = ev1;
+		compound += ev2;
+		compound *= 3;
+		CHECK(compound == comp6771::euclidean_vector((dv1 + dv2) * 3));
+	}
+
+	SECTION("Utility functions return double") {
+		CHECK(std::same_as<decltype(comp6771::euclidean_norm(ev1)), double>);
+		CHECK(comp6771::euclidean_norm(ev1) == Approx(comp6771::euclidean_norm(dv1)).margin(1e-5));
+		CHECK(comp6771::dot(ev1, ev2) == Approx(comp6771::dot(dv1, dv2)).margin(1e-5));
+		CHECK(comp6771::unit(ev1) == comp6771::unit(dv1));
+	}
+
+	SECTION("Converting between element types") {
+		auto const converted = comp6771::basic_euclidean_vector<float>(dv1);
+		CHECK(converted == ev1);
+		CHECK(comp6771::euclidean_vector(converted) == dv1);
+	}
+
+	SECTION("Views and batches") {
+		auto magnitudes = std::vector<float>{3, 4};
+		auto const view = comp6771::basic_euclidean_vector_view<float>(magnitudes);
+		CHECK(comp6771::euclidean_norm(view) == Approx(5).margin(1e-6));
+
+		auto batch = comp6771::basic_euclidean_vector_batch<float>(
+		   std::vector<comp6771::basic_euclidean_vector<float>>{ev1, ev2});
+		CHECK(batch[1] == ev2);
+		CHECK(batch.dot(ev1)[0] == Approx(comp6771::dot(dv1, dv1)).margin(1e-4));
+	}
+}
+
+/*
+Rationale:
+    Quantised vectors hold small integers. Arithmetic rounds to nearest and saturates at the limits
+    of the element type instead of wrapping, and inner products are computed exactly.
+*/
+TEST_CASE("Quantised vectors") {
+	using int8_vector = comp6771::basic_euclidean_vector<std::int8_t>;
+	auto const ev1 = int8_vector{100, -100, 3, 4, 0};
+	auto const ev2 = int8_vector{100, -100, -3, 4, 1};
+
+	SECTION("Arithmetic saturates") {
+		CHECK(static_cast<std::vector<std::int8_t>>(int8_vector(ev1 + ev2))
+		      == std::vector<std::int8_t>{127, -128, 0, 8, 1});
+		auto compound = ev1;
+		compound += ev2;
+		CHECK(static_cast<std::vector<std::int8_t>>(compound)
+		      == std::vector<std::int8_t>{127, -128, 0, 8, 1});
+		CHECK(-int8_vector{-128, 5} == int8_vector{127, -5});
+	}
+
+	SECTION("Scaling rounds to nearest") {
+		auto const scaled = int8_vector(ev1 * 0.25);
+		CHECK(static_cast<std::vector<std::int8_t>>(scaled)
+		      == std::vector<std::int8_t>{25, -25, 1, 1, 0});
+		auto compound = ev1;
+		compound /= 3;
+		CHECK(static_cast<std::vector<std::int8_t>>(compound)
+		      == std::vector<std::int8_t>{33, -33, 1, 1, 0});
+	}
+
+	SECTION("Inner products are exact") {
+		CHECK(comp6771::dot(ev1, ev2) == 20007);
+		CHECK(comp6771::euclidean_norm(int8_vector{3, 4}) == Approx(5).margin(1e-9));
+		auto const wide = comp6771::basic_euclidean_vector<std::int16_t>(4, 30000);
+		CHECK(comp6771::dot(wide, wide) == 3600000000.0);
+	}
+
+	SECTION("Output prints numbers") {
+		auto oss = std::ostringstream();
+		oss << int8_vector{65, -1, 0};
+		CHECK(oss.str() == "[65 -1 0]");
+	}
+}
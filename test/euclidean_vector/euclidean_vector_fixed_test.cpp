@@ -0,0 +1,151 @@
+#include <catch2/catch.hpp>
+#include <comp6771/euclidean_vector.hpp>
+#include <comp6771/fixed_euclidean_vector.hpp>
+#include <cstdint>
+#include <list>
+#include <sstream>
+#include <type_traits>
+#include <vector>
+
+/*
+This file is to test fixed_euclidean_vector.
+It assumes euclidean_vector itself is correctly implemented.
+
+Approach:
+    - Evaluate the operators and utility functions at compile time where they are constexpr
+    - Compare the results against euclidean_vector at run time
+    - Check the conversions to and from euclidean_vector
+*/
+
+namespace {
+	using vec3 = comp6771::fixed_euclidean_vector<3>;
+
+	constexpr auto a = vec3{1.5, -2.0, 3.0};
+	constexpr auto b = vec3{0.5, 4.0, -1.0};
+} // namespace
+
+/*
+Rationale:
+    Fixed vectors hold their magnitudes inline, with no dimension count or pointer, and can be
+    built and used in constant expressions.
+*/
+TEST_CASE("Fixed vector construction") {
+	STATIC_REQUIRE(sizeof(vec3) == 3 * sizeof(double));
+	STATIC_REQUIRE(std::is_trivially_copyable_v<vec3>);
+	STATIC_REQUIRE(vec3::dimensions() == 3);
+	STATIC_REQUIRE(vec3() == vec3{0, 0, 0});
+	STATIC_REQUIRE(a[1] == -2.0);
+	STATIC_REQUIRE(vec3(std::array<double, 3>{1, 2, 3})[2] == 3);
+
+	SECTION("From a euclidean_vector of the same dimensions") {
+		auto const ev = comp6771::euclidean_vector{1.5, -2.0, 3.0};
+		CHECK(vec3(ev) == a);
+		CHECK(vec3(ev * 2 + ev) == a * 3);
+	}
+
+	SECTION("From a euclidean_vector of other dimensions") {
+		CHECK_THROWS_MATCHES(vec3(comp6771::euclidean_vector{1, 2}),
+		                     comp6771::euclidean_vector_error,
+		                     Catch::Matchers::Message("Dimensions of LHS(3) and RHS(2) do not "
+		                                              "match"));
+	}
+
+	SECTION("To a euclidean_vector") {
+		auto const ev = comp6771::euclidean_vector(a);
+		CHECK(ev == comp6771::euclidean_vector{1.5, -2.0, 3.0});
+		CHECK(static_cast<std::vector<double>>(a) == std::vector<double>{1.5, -2.0, 3.0});
+		CHECK(static_cast<std::list<double>>(a) == std::list<double>{1.5, -2.0, 3.0});
+	}
+}
+
+/*
+Rationale:
+    Arithmetic between fixed vectors is evaluated eagerly into another fixed vector, at compile
+    time when possible, and agrees with euclidean_vector. Comparison uses the same tolerance at
+    compile time and at run time.
+*/
+TEST_CASE("Fixed vector operators") {
+	STATIC_REQUIRE(std::is_same_v<decltype(a + b), vec3>);
+	STATIC_REQUIRE(std::is_same_v<decltype(vec3(a) * 2 - vec3(b) / 4), vec3>);
+	STATIC_REQUIRE(a + b == vec3{2.0, 2.0, 2.0});
+	STATIC_REQUIRE(a - b == vec3{1.0, -6.0, 4.0});
+	STATIC_REQUIRE(-a == vec3{-1.5, 2.0, -3.0});
+	STATIC_REQUIRE(+a == a);
+	STATIC_REQUIRE(2 * a == a * 2);
+	STATIC_REQUIRE(a / 0.5 == vec3{3.0, -4.0, 6.0});
+	STATIC_REQUIRE(a != b);
+
+	using vec1 = comp6771::fixed_euclidean_vector<1>;
+	STATIC_REQUIRE(vec1{0.0} == vec1{1e-6});
+	auto const tiny = vec1{1e-6};
+	CHECK(vec1{0.0} == tiny);
+	CHECK(comp6771::euclidean_vector{0.0} == comp6771::euclidean_vector(tiny) * 1.0);
+
+	auto const ev_a = comp6771::euclidean_vector(a);
+	auto const ev_b = comp6771::euclidean_vector(b);
+	CHECK(comp6771::euclidean_vector(a * 5.16 + b / -10.11)
+	      == comp6771::euclidean_vector(ev_a * 5.16 + ev_b / -10.11));
+
+	SECTION("Compound assignment") {
+		auto v = a;
+		v += b;
+		v *= 2;
+		v -= b;
+		v /= 4;
+		CHECK(v == vec3(((ev_a + ev_b) * 2 - ev_b) / 4));
+	}
+
+	SECTION("Division by zero") {
+		auto v = a;
+		CHECK_THROWS_MATCHES(v /= 0,
+		                     comp6771::euclidean_vector_error,
+		                     Catch::Matchers::Message("Invalid vector division by 0"));
+		CHECK_THROWS_MATCHES(a / 0,
+		                     comp6771::euclidean_vector_error,
+		                     Catch::Matchers::Message("Invalid vector division by 0"));
+	}
+
+	SECTION("Mixing with euclidean_vector gives an expression") {
+		CHECK(comp6771::euclidean_vector(a + ev_b) == ev_a + ev_b);
+	}
+
+	SECTION("Checked access") {
+		CHECK(a.at(2) == 3.0);
+		CHECK_THROWS_MATCHES(a.at(3),
+		                     comp6771::euclidean_vector_error,
+		                     Catch::Matchers::Message("Index 3 is not valid for this "
+		                                              "fixed_euclidean_vector object"));
+	}
+
+	SECTION("Output") {
+		auto oss = std::ostringstream();
+		oss << a;
+		CHECK(oss.str() == "[1.5 -2 3]");
+	}
+}
+
+/*
+Rationale:
+    The utility functions agree with euclidean_vector, and the inner product is constexpr.
+*/
+TEST_CASE("Fixed vector utility functions") {
+	STATIC_REQUIRE(comp6771::dot(a, b) == 0.75 - 8.0 - 3.0);
+	STATIC_REQUIRE(comp6771::euclidean_inner_product(a, a) == 2.25 + 4.0 + 9.0);
+
+	auto const ev_a = comp6771::euclidean_vector(a);
+	CHECK(comp6771::euclidean_norm(a) == Approx(comp6771::euclidean_norm(ev_a)).margin(1e-9));
+	CHECK(comp6771::unit(a) == vec3(comp6771::unit(ev_a)));
+	CHECK_THROWS_MATCHES(comp6771::unit(vec3()),
+	                     comp6771::euclidean_vector_error,
+	                     Catch::Matchers::Message("euclidean_vector with zero euclidean "
+	                                              "normal does not have a unit vector"));
+
+	SECTION("Other element types") {
+		constexpr auto f = comp6771::fixed_euclidean_vector<2, float>{3.0F, 4.0F};
+		STATIC_REQUIRE(sizeof(f) == 2 * sizeof(float));
+		CHECK(comp6771::euclidean_norm(f) == Approx(5).margin(1e-6));
+
+		auto const q = comp6771::fixed_euclidean_vector<2, std::int8_t>{100, -100};
+		CHECK(q + q == comp6771::fixed_euclidean_vector<2, std::int8_t>{127, -128});
+	}
+}
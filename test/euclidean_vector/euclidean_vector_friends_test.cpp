@@ -1,6 +1,14 @@
+#include <array>
 #include <catch2/catch.hpp>
 #include <comp6771/euclidean_vector.hpp>
+#include <cstdint>
+#include <limits>
+#include <memory_resource>
 #include <sstream>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
 #include <vector>
 
 /*
@@ -75,6 +83,63 @@ TEST_CASE("Not Equal vec1 != vec2") {
 	}
 }
 
+/*
+Rationale:
+   operator== allows an absolute difference of up to 1e-6 per magnitude. approx_equal takes its
+   own absolute and relative tolerances, and exact_equal compares bits, so it tells 0.0 from -0.0
+   but treats identical NaNs as equal. Neither throws on different dimensions. Expressions and
+   vectors of other element types are compared with the same rule as vectors.
+*/
+TEST_CASE("Approximate and exact equality") {
+	auto const ev = comp6771::euclidean_vector{1000.0, -2.0, 0.0};
+	auto const near = comp6771::euclidean_vector{1000.0005, -2.0, -0.0};
+	auto const nan = comp6771::euclidean_vector{std::numeric_limits<double>::quiet_NaN()};
+
+	CHECK(ev != near);
+	CHECK(comp6771::euclidean_vector{1.0} == comp6771::euclidean_vector{1.0 + 5e-7});
+
+	SECTION("Absolute and relative tolerances") {
+		CHECK(comp6771::approx_equal(ev, ev));
+		CHECK(not comp6771::approx_equal(ev, near));
+		CHECK(comp6771::approx_equal(ev, near, 1e-3));
+		CHECK(comp6771::approx_equal(ev, near, 0, 1e-6));
+		CHECK(not comp6771::approx_equal(ev, near, 0, 1e-7));
+		CHECK(not comp6771::approx_equal(nan, nan, 1));
+		CHECK(not comp6771::approx_equal(ev, comp6771::euclidean_vector{1000.0, -2.0}, 1));
+	}
+
+	SECTION("Every comparison uses the same rule") {
+		auto const y = comp6771::euclidean_vector{0.0};
+		auto const z = comp6771::euclidean_vector{1e-6};
+		CHECK(y == z);
+		CHECK(y == z * 1.0);
+		CHECK(z * 1.0 == y / 1.0);
+		CHECK(y == comp6771::basic_euclidean_vector<float>{1e-6F});
+		CHECK(y != z * 1.5);
+
+		auto const infinity = comp6771::euclidean_vector{std::numeric_limits<double>::infinity()};
+		CHECK(not comp6771::approx_equal(infinity, comp6771::euclidean_vector{1e300}, 0, 1e-6));
+		CHECK(comp6771::approx_equal(infinity, infinity, 0, 1e-6));
+		CHECK(infinity == infinity * 1.0);
+	}
+
+	SECTION("Bitwise") {
+		CHECK(comp6771::exact_equal(ev, comp6771::euclidean_vector(ev)));
+		CHECK(not comp6771::exact_equal(ev, comp6771::euclidean_vector{1000.0, -2.0, -0.0}));
+		CHECK(comp6771::exact_equal(nan, comp6771::euclidean_vector(nan)));
+		CHECK(comp6771::exact_equal(comp6771::euclidean_vector({}), comp6771::euclidean_vector({})));
+		CHECK(not comp6771::exact_equal(ev, comp6771::euclidean_vector{1000.0, -2.0}));
+	}
+
+	SECTION("Other element types") {
+		auto const f = comp6771::basic_euclidean_vector<float>{1.0F, 2.0F};
+		CHECK(comp6771::approx_equal(f, comp6771::basic_euclidean_vector<float>{1.0F, 2.001F}, 1e-2));
+		auto const q = comp6771::basic_euclidean_vector<std::int8_t>{1, 2};
+		CHECK(comp6771::approx_equal(q, comp6771::basic_euclidean_vector<std::int8_t>{1, 3}, 1));
+		CHECK(not comp6771::exact_equal(q, comp6771::basic_euclidean_vector<std::int8_t>{1, 3}));
+	}
+}
+
 /*
 Rationale:
    Test for addtion ensures it returns a new object
@@ -265,7 +330,210 @@ TEST_CASE("Output Stream << ") {
 		auto const double_ev =
 		   comp6771::euclidean_vector{1.1, 2.000001, 3.1234567, 4.123451, 5.111, 6.10000};
 		auto oss = std::ostringstream{};
-		oss << int_ev << double_ev;=
+		oss << int_ev << double_ev;
 		CHECK(oss.str() == "[1 2 3 4 5][1.1 2 3.12346 4.12345 5.111 6.1]");
 	}
-}
\ No newline at end of file
+}
+
+/*
+Rationale:
+   to_chars writes the same text as operator<< into a caller's buffer and reports a buffer that
+   is too small rather than overrunning it. max_formatted_size is always big enough.
+*/
+TEST_CASE("Formatting into a buffer") {
+	auto const ev = comp6771::euclidean_vector{1.1, -2.000001, 3.1234567, -1e-300};
+	auto buffer = std::array<char, 64>();
+	REQUIRE(comp6771::max_formatted_size<double>(ev.dimensions()) <= buffer.size());
+
+	auto const result = comp6771::to_chars(buffer.data(), buffer.data() + buffer.size(), ev);
+	CHECK(result.ec == std::errc());
+	CHECK(std::string_view(buffer.data(), result.ptr) == "[1.1 -2 3.12346 -1e-300]");
+
+	SECTION("Buffer too small") {
+		for (auto size = std::size_t{0}; size < 24; ++size) {
+			auto const small = comp6771::to_chars(buffer.data(), buffer.data() + size, ev);
+			CHECK(small.ec == std::errc::value_too_large);
+			CHECK(small.ptr == buffer.data() + size);
+		}
+	}
+
+	SECTION("Other element types") {
+		auto const q = comp6771::basic_euclidean_vector<std::int8_t>{-128, 0, 127};
+		auto const q_result = comp6771::to_chars(buffer.data(), buffer.data() + buffer.size(), q);
+		CHECK(std::string_view(buffer.data(), q_result.ptr) == "[-128 0 127]");
+		auto oss = std::ostringstream{};
+		oss << q << comp6771::basic_euclidean_vector<float>{0.1F, 2.5F};
+		CHECK(oss.str() == "[-128 0 127][0.1 2.5]");
+	}
+
+	SECTION("Large vectors") {
+		auto const large = comp6771::euclidean_vector(100, -1.234567e-200);
+		auto text = std::string(comp6771::max_formatted_size<double>(100), '\0');
+		auto const large_result = comp6771::to_chars(text.data(), text.data() + text.size(), large);
+		REQUIRE(large_result.ec == std::errc());
+		text.resize(static_cast<std::size_t>(large_result.ptr - text.data()));
+		auto oss = std::ostringstream{};
+		oss << large;
+		CHECK(oss.str() == text);
+	}
+}
+
+/*
+Rationale:
+   from_chars reads back what to_chars and operator<< write, and reports where malformed text
+   goes wrong without touching the vector.
+*/
+TEST_CASE("Parsing from characters") {
+	auto ev = comp6771::euclidean_vector();
+	auto const parse = [&ev](std::string_view text) {
+		return comp6771::from_chars(text.data(), text.data() + text.size(), ev);
+	};
+
+	SECTION("Well formed") {
+		auto const text = std::string_view("[1.5  -2 3e2 ]tail");
+		auto const result = parse(text);
+		CHECK(result.ec == std::errc());
+		CHECK(result.ptr == text.data() + 14);
+		CHECK(ev == comp6771::euclidean_vector{1.5, -2, 300});
+		CHECK(parse("[]").ec == std::errc());
+		CHECK(ev.dimensions() == 0);
+	}
+
+	SECTION("Round trip") {
+		auto const original = comp6771::euclidean_vector{0.25, -7, 1e-300, 123456};
+		auto oss = std::ostringstream{};
+		oss << original;
+		CHECK(parse(oss.str()).ec == std::errc());
+		CHECK(ev == original);
+	}
+
+	SECTION("Malformed") {
+		for (auto const* const text : {"", "1 2]", "[1 2", "[1,2]", "[1 x]", "[1 2 "}) {
+			CHECK(parse(text).ec == std::errc::invalid_argument);
+			CHECK(ev == comp6771::euclidean_vector());
+		}
+		auto const text = std::string_view("[1 x]");
+		CHECK(parse(text).ptr == text.data() + 3);
+	}
+
+	SECTION("Out of range") {
+		auto q = comp6771::basic_euclidean_vector<std::int8_t>();
+		auto const text = std::string_view("[1 200]");
+		auto const result = comp6771::from_chars(text.data(), text.data() + text.size(), q);
+		CHECK(result.ec == std::errc::result_out_of_range);
+		CHECK(result.ptr == text.data() + 3);
+		CHECK(q.dimensions() == 1);
+	}
+}
+/*
+Rationale:
+   The arithmetic operators return lazy expressions that are evaluated in one pass when assigned.
+   This test ensures chained expressions give the same result as evaluating each step eagerly,
+   including when the destination also appears as an operand or an operand is a temporary.
+   Dimension mismatches anywhere in the chain must still throw as soon as the operator is applied.
+*/
+TEST_CASE("Chained arithmetic expressions") {
+	auto const ev1 = comp6771::euclidean_vector{1.5, -2.5, 3.0};
+	auto const ev2 = comp6771::euclidean_vector{-4.0, 0.5, 2.0};
+	auto const ev_zero = comp6771::euclidean_vector({});
+
+	SECTION("Evaluate a chain into a new euclidean vector") {
+		auto const new_ev = comp6771::euclidean_vector(ev1 * 2 + ev2 / 4 - (-ev1));
+		auto const exp = std::vector<double>{3.5, -7.375, 9.5};
+		CHECK_THAT(static_cast<std::vector<double>>(new_ev), Catch::Approx(exp).margin(1e-6));
+		CHECK(new_ev.dimensions() == 3);
+	}
+
+	SECTION("Temporary operands are kept alive by the expression") {
+		auto const expr = comp6771::euclidean_vector{1, 2, 3} + ev1;
+		auto const exp = std::vector<double>{2.5, -0.5, 6.0};
+		CHECK_THAT(static_cast<std::vector<double>>(expr), Catch::Approx(exp).margin(1e-6));
+	}
+
+	SECTION("Assign an expression that refers to the destination") {
+		auto ev = ev1;
+		ev = ev2 - ev * 2;
+		auto const exp = std::vector<double>{-7.0, 5.5, -4.0};
+		CHECK_THAT(static_cast<std::vector<double>>(ev), Catch::Approx(exp).margin(1e-6));
+	}
+
+	SECTION("Assign an expression with different dimensions") {
+		auto ev = comp6771::euclidean_vector(1);
+		ev = ev1 + ev2;
+		auto const exp = std::vector<double>{-2.5, -2.0, 5.0};
+		CHECK_THAT(static_cast<std::vector<double>>(ev), Catch::Approx(exp).margin(1e-6));
+	}
+
+	SECTION("Compound assignment with an expression") {
+		auto ev = ev1;
+		ev += ev2 * 2;
+		ev -= ev1 / 2;
+		auto const exp = std::vector<double>{-7.25, -0.25, 5.5};
+		CHECK_THAT(static_cast<std::vector<double>>(ev), Catch::Approx(exp).margin(1e-6));
+	}
+
+	SECTION("Compare and print expressions without evaluating them first") {
+		CHECK(ev1 + ev2 == ev2 + ev1);
+		CHECK(ev1 - ev2 != ev2 - ev1);
+		auto oss = std::ostringstream{};
+		oss << ev1 + ev2;
+		CHECK(oss.str() == "[-2.5 -2 5]");
+	}
+
+	SECTION("Dimension mismatch inside a chain") {
+		CHECK_THROWS_MATCHES(ev1 * 2 + ev_zero,
+		                     comp6771::euclidean_vector_error,
+		                     Catch::Matchers::Message("Dimensions of LHS(3) and RHS(0) do not "
+		                                              "match"));
+		CHECK_THROWS_MATCHES((ev1 + ev2) / 0,
+		                     comp6771::euclidean_vector_error,
+		                     Catch::Matchers::Message("Invalid vector division by 0"));
+	}
+}
+
+/*
+Rationale:
+   Evaluating an expression that holds a temporary euclidean vector reuses that vector's storage
+   instead of allocating, as does unary plus or minus on a temporary. This test checks the result
+   against lvalue operands and that the temporary's buffer is the one returned.
+*/
+TEST_CASE("Arithmetic on expiring vectors") {
+	auto const large = comp6771::euclidean_vector::inline_capacity + 4;
+	auto const ev1 = comp6771::euclidean_vector(large, 1.5);
+	auto const ev2 = comp6771::euclidean_vector(large, -4.0);
+
+	SECTION("Binary and scalar operators reuse a temporary operand") {
+		auto temporary = ev1;
+		auto const* const magnitude = temporary.data();
+		auto const result = comp6771::euclidean_vector(ev2 * 2 - std::move(temporary) / 3 + ev1);
+		CHECK(result.data() == magnitude);
+		CHECK(result == comp6771::euclidean_vector(ev2 * 2 - ev1 / 3 + ev1));
+	}
+
+	SECTION("Unary operators reuse a temporary") {
+		auto temporary = ev1;
+		auto const* const magnitude = temporary.data();
+		auto const negated = -std::move(temporary);
+		CHECK(negated.data() == magnitude);
+		CHECK(negated == -ev1);
+		auto const same = +comp6771::euclidean_vector(negated);
+		CHECK(same == negated);
+	}
+
+	SECTION("Lvalue operands are never reused") {
+		auto const result = comp6771::euclidean_vector(ev1 + ev2);
+		CHECK(result.data() != ev1.data());
+		CHECK(result.data() != ev2.data());
+		CHECK(ev1 == comp6771::euclidean_vector(large, 1.5));
+	}
+
+	SECTION("A temporary from another memory resource is not reused") {
+		auto arena = std::pmr::monotonic_buffer_resource();
+		auto pooled = comp6771::euclidean_vector(ev1, &arena);
+		auto const* const magnitude = pooled.data();
+		auto const result = comp6771::euclidean_vector(std::move(pooled) + ev2);
+		CHECK(result.data() != magnitude);
+		CHECK(result.resource() == nullptr);
+		CHECK(result == comp6771::euclidean_vector(large, -2.5));
+	}
+}
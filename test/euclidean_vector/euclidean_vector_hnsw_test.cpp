@@ -0,0 +1,243 @@
+#include "euclidean_vector_test.hpp"
+
+#include <catch2/catch.hpp>
+#include <comp6771/euclidean_vector.hpp>
+#include <comp6771/euclidean_vector_batch.hpp>
+#include <comp6771/hnsw_index.hpp>
+#include <comp6771/knn.hpp>
+#include <comp6771/parallel.hpp>
+#include <comp6771/thread_pool.hpp>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <system_error>
+#include <unistd.h>
+#include <vector>
+
+/*
+This file is to test hnsw_index.
+It assumes euclidean_vector, euclidean_vector_batch and knn_search are correctly implemented.
+
+Approach:
+    - Index random vectors, and compare searches against the exact results of knn_search
+    - As the index is approximate, check recall over many queries rather than each result
+    - Check building in parallel, adding vectors, saving and loading, and invalid arguments
+*/
+
+using comp6771::tests::random_vectors;
+
+namespace {
+	// Fraction of the exact neighbours of each query that the index found
+	template<typename Index, typename Dataset>
+	auto recall(Index const& index,
+	            Dataset const& dataset,
+	            std::vector<comp6771::euclidean_vector> const& queries,
+	            int k,
+	            comp6771::metric measure) -> double {
+		auto const exact = comp6771::knn_search(queries, dataset, k, measure);
+		return comp6771::tests::recall(exact, index.search(queries, k));
+	}
+
+	// A path in the temporary directory that is removed when it goes out of scope
+	class temporary_path {
+	public:
+		explicit temporary_path(std::string const& name)
+		: path_{std::filesystem::temp_directory_path()
+		        / (name + "." + std::to_string(::getpid()) + ".evhn")} {
+			std::filesystem::remove(path_);
+		}
+
+		temporary_path(temporary_path const&) = delete;
+		temporary_path(temporary_path&&) = delete;
+		~temporary_path() {
+			auto error = std::error_code();
+			std::filesystem::remove(path_, error);
+		}
+		auto operator=(temporary_path const&) -> temporary_path& = delete;
+		auto operator=(temporary_path&&) -> temporary_path& = delete;
+
+		[[nodiscard]] auto string() const -> std::string {
+			return path_.string();
+		}
+
+	private:
+		std::filesystem::path path_;
+	};
+
+	// Small enough to keep debug builds quick, while still reaching high recall on these datasets
+	constexpr auto test_parameters = comp6771::hnsw_parameters{.m = 12, .ef_construction = 64};
+} // namespace
+
+/*
+Rationale:
+    An index is only useful if it finds nearly all of the exact neighbours. With modest
+    parameters and a few thousand vectors, recall should be close to 1 for each metric, and an
+    indexed vector should find itself at the distance knn_search measures.
+*/
+TEST_CASE("HNSW recall") {
+	auto const dataset = random_vectors(1500, 16, 1);
+	auto const queries = random_vectors(50, 16, 2);
+
+	for (auto const measure : {comp6771::metric::l2,
+	                           comp6771::metric::inner_product,
+	                           comp6771::metric::cosine})
+	{
+		auto const index = comp6771::hnsw_index(dataset, measure, test_parameters);
+		REQUIRE(index.size() == 1500);
+		CHECK(index.dimensions() == 16);
+		CHECK(index.measure() == measure);
+		CHECK(recall(index, dataset, queries, 10, measure) > 0.95);
+	}
+
+	auto const index = comp6771::hnsw_index(dataset, comp6771::metric::l2, test_parameters);
+	CHECK(index[42] == dataset[42]);
+	auto const found = index.search(dataset[42], 1);
+	REQUIRE(found.size() == 1);
+	CHECK(found.front().index == 42);
+	CHECK(found.front().distance == Approx(0).margin(1e-6));
+
+	auto const exact = comp6771::knn_search(queries[0], dataset, 5);
+	auto const approximate = index.search(queries[0], 5);
+	REQUIRE(approximate.size() == 5);
+	CHECK(approximate.front().index == exact.front().index);
+	CHECK(approximate.front().distance == Approx(exact.front().distance).margin(1e-9));
+}
+
+/*
+Rationale:
+    Searching with a larger ef_search compares the query with more vectors, so it finds at least
+    as many of the exact neighbours.
+*/
+TEST_CASE("HNSW search parameters") {
+	auto const dataset = random_vectors(1000, 16, 7);
+	auto const queries = random_vectors(50, 16, 8);
+	auto index = comp6771::hnsw_index(dataset,
+	                                  comp6771::metric::l2,
+	                                  {.m = 4, .ef_construction = 16, .ef_search = 1});
+	auto const low = recall(index, dataset, queries, 10, comp6771::metric::l2);
+	index.set_ef_search(200);
+	CHECK(index.parameters().ef_search == 200);
+	CHECK(recall(index, dataset, queries, 10, comp6771::metric::l2) > low);
+}
+
+/*
+Rationale:
+    Building in parallel and adding vectors one at a time must give indexes as good as a serial
+    build, and searching in parallel must agree with searching serially.
+*/
+TEST_CASE("HNSW building and searching in parallel") {
+	auto const dataset = random_vectors(2000, 8, 3);
+	auto const queries = random_vectors(40, 8, 4);
+	auto const previous = comp6771::parallel_threshold();
+	comp6771::set_parallel_threshold(1);
+
+	auto pool = comp6771::thread_pool(4);
+	auto const parallel = comp6771::hnsw_index(pool,
+	                                           comp6771::euclidean_vector_batch(dataset),
+	                                           comp6771::metric::l2,
+	                                           test_parameters);
+	CHECK(parallel.size() == 2000);
+	CHECK(recall(parallel, dataset, queries, 10, comp6771::metric::l2) > 0.95);
+	CHECK(parallel.search(pool, queries, 10) == parallel.search(queries, 10));
+
+	auto incremental = comp6771::hnsw_index(8, comp6771::metric::l2, test_parameters);
+	for (auto const& vec : dataset) {
+		incremental.add(vec);
+	}
+	CHECK(incremental.size() == 2000);
+	auto const serial = comp6771::hnsw_index(dataset, comp6771::metric::l2, test_parameters);
+	CHECK(incremental.search(queries, 10) == serial.search(queries, 10));
+	comp6771::set_parallel_threshold(previous);
+}
+
+/*
+Rationale:
+    A saved index loads with the same vectors, graph and parameters, so it answers every search
+    the same way. Files that are not indexes of the element type are rejected, as are files
+    claiming more nodes than they hold, before anything is allocated for them.
+*/
+TEST_CASE("HNSW saving and loading") {
+	auto const path = temporary_path("hnsw_saving_and_loading");
+	auto const dataset = random_vectors(500, 6, 5);
+	auto const queries = random_vectors(20, 6, 6);
+	auto const index =
+	   comp6771::hnsw_index(dataset, comp6771::metric::cosine, {.m = 8, .ef_search = 32});
+	index.save(path.string());
+
+	auto const loaded = comp6771::hnsw_index::load(path.string());
+	CHECK(loaded.size() == index.size());
+	CHECK(loaded.dimensions() == 6);
+	CHECK(loaded.measure() == comp6771::metric::cosine);
+	CHECK(loaded.parameters().m == 8);
+	CHECK(loaded.parameters().ef_search == 32);
+	CHECK(loaded.search(queries, 5) == index.search(queries, 5));
+
+	auto const empty = comp6771::basic_hnsw_index<float>(3);
+	empty.save(path.string());
+	CHECK(comp6771::basic_hnsw_index<float>::load(path.string()).size() == 0);
+	CHECK_THROWS_MATCHES(comp6771::hnsw_index::load(path.string()),
+	                     comp6771::euclidean_vector_error,
+	                     Catch::Matchers::Message("hnsw_index does not hold this element type"));
+
+	index.save(path.string());
+	std::filesystem::resize_file(path.string(), std::filesystem::file_size(path.string()) - 4);
+	CHECK_THROWS_MATCHES(comp6771::hnsw_index::load(path.string()),
+	                     comp6771::euclidean_vector_error,
+	                     Catch::Matchers::Message("hnsw_index is truncated"));
+
+	index.save(path.string());
+	{
+		auto file = std::fstream(path.string(), std::ios::in | std::ios::out | std::ios::binary);
+		file.seekp(16);
+		file.write("\xFF\xFF\xFF\x7F\0\0\0\0", 8);
+	}
+	CHECK_THROWS_MATCHES(comp6771::hnsw_index::load(path.string()),
+	                     comp6771::euclidean_vector_error,
+	                     Catch::Matchers::Message("hnsw_index is truncated"));
+
+	{
+		auto file = std::ofstream(path.string());
+		file << "not an hnsw_index, though long enough to hold the header of one, just about";
+	}
+	CHECK_THROWS_MATCHES(comp6771::hnsw_index::load(path.string()),
+	                     comp6771::euclidean_vector_error,
+	                     Catch::Matchers::Message("File is not an hnsw_index"));
+	std::filesystem::remove(path.string());
+	CHECK_THROWS_AS(comp6771::hnsw_index::load(path.string()), std::system_error);
+}
+
+/*
+Rationale:
+    Empty indexes have no neighbours, k may exceed the number of vectors, every element type can
+    be indexed, and invalid parameters, dimensions and k are errors.
+*/
+TEST_CASE("HNSW edge cases") {
+	auto index = comp6771::hnsw_index(2);
+	CHECK(index.search(comp6771::euclidean_vector{0, 0}, 3).empty());
+	CHECK(index.add(comp6771::euclidean_vector{3, 4}) == 0);
+	CHECK(index.add(comp6771::euclidean_vector{1, 0}) == 1);
+	CHECK(index.search(comp6771::euclidean_vector{0, 0}, 5)
+	      == std::vector<comp6771::neighbour>{{1, 1.0}, {0, 5.0}});
+	CHECK(index.search(comp6771::euclidean_vector{0, 0}, 0).empty());
+
+	auto const quantised = comp6771::basic_hnsw_index<std::int8_t>(
+	   std::vector<comp6771::basic_euclidean_vector<std::int8_t>>{{10, 10}, {-3, 4}, {100, -100}});
+	CHECK(quantised.search(comp6771::basic_euclidean_vector<std::int8_t>{0, 0}, 1)
+	      == std::vector<comp6771::neighbour>{{1, 5.0}});
+
+	CHECK_THROWS_MATCHES(comp6771::hnsw_index(2, comp6771::metric::l2, {.m = 1}),
+	                     comp6771::euclidean_vector_error,
+	                     Catch::Matchers::Message("hnsw_index parameters are not valid"));
+	CHECK_THROWS_MATCHES(index.set_ef_search(0),
+	                     comp6771::euclidean_vector_error,
+	                     Catch::Matchers::Message("hnsw_index parameters are not valid"));
+	CHECK_THROWS_MATCHES(index.add(comp6771::euclidean_vector{1, 2, 3}),
+	                     comp6771::euclidean_vector_error,
+	                     Catch::Matchers::Message("Dimensions of LHS(2) and RHS(3) do not match"));
+	CHECK_THROWS_MATCHES(index.search(comp6771::euclidean_vector{0, 0}, -1),
+	                     comp6771::euclidean_vector_error,
+	                     Catch::Matchers::Message("Cannot search for a negative number of "
+	                                              "neighbours"));
+	CHECK(index.size() == 2);
+}
@@ -0,0 +1,198 @@
+#include "euclidean_vector_test.hpp"
+
+#include <catch2/catch.hpp>
+#include <comp6771/euclidean_vector.hpp>
+#include <comp6771/euclidean_vector_batch.hpp>
+#include <comp6771/euclidean_vector_view.hpp>
+#include <comp6771/ivf_index.hpp>
+#include <comp6771/knn.hpp>
+#include <comp6771/parallel.hpp>
+#include <comp6771/thread_pool.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <execution>
+#include <ranges>
+#include <vector>
+
+/*
+This file is to test ivf_index.
+It assumes euclidean_vector, euclidean_vector_batch and knn_search are correctly implemented.
+
+Approach:
+    - Train on vectors drawn around a few centres, so that the lists have something to find
+    - Check that probing every list gives the exact results of knn_search, and that probing a
+      few lists still finds most neighbours
+    - Add and remove vectors after training, and check the searches that follow
+*/
+
+using comp6771::tests::clustered_vectors;
+using comp6771::tests::recall;
+
+/*
+Rationale:
+    Training must use every list, and each vector must be in the list of its nearest centroid.
+    Probing every list is an exact search, and probing a few still finds most neighbours.
+*/
+TEST_CASE("IVF training and searching") {
+	auto const dataset = clustered_vectors(3000, 12, 1);
+	auto const queries = clustered_vectors(50, 12, 2);
+
+	for (auto const measure : {comp6771::metric::l2,
+	                           comp6771::metric::inner_product,
+	                           comp6771::metric::cosine})
+	{
+		auto index = comp6771::ivf_index(dataset, 32, measure, {.nprobe = 32});
+		REQUIRE(index.trained());
+		CHECK(index.size() == 3000);
+		CHECK(index.lists() == 32);
+		CHECK(index.measure() == measure);
+
+		auto const exact = comp6771::knn_search(queries, dataset, 10, measure);
+		auto const everything = index.search(queries, 10);
+		for (auto query = std::size_t{0}; query < queries.size(); ++query) {
+			REQUIRE(everything[query].size() == exact[query].size());
+			for (auto i = std::size_t{0}; i < exact[query].size(); ++i) {
+				CHECK(everything[query][i].index == exact[query][i].index);
+				CHECK(everything[query][i].distance
+				      == Approx(exact[query][i].distance).margin(1e-9));
+			}
+		}
+		index.set_nprobe(8);
+		CHECK(recall(exact, index.search(queries, 10)) > 0.9);
+	}
+
+	auto index = comp6771::ivf_index(dataset, 32);
+	auto total = 0;
+	for (auto list = 0; list < index.lists(); ++list) {
+		CHECK(index.list_size(list) > 0);
+		total += index.list_size(list);
+	}
+	CHECK(total == 3000);
+	// Probing one list finds a vector only if it is in the list of its nearest centroid.
+	index.set_nprobe(1);
+	for (auto id = 0; id < 3000; id += 97) {
+		CHECK(index[id] == dataset[static_cast<std::size_t>(id)]);
+		CHECK(index.search(dataset[static_cast<std::size_t>(id)], 1)
+		      == std::vector<comp6771::neighbour>{{id, 0.0}});
+	}
+}
+
+/*
+Rationale:
+    Vectors added after training are found by later searches, and removed vectors never are.
+    Removing a vector moves another within its list, which must stay reachable by its id.
+*/
+TEST_CASE("IVF adding and removing") {
+	auto const dataset = clustered_vectors(1000, 6, 3);
+	auto index = comp6771::ivf_index(6, 8, comp6771::metric::l2, {.nprobe = 8});
+	CHECK(not index.trained());
+	index.train(dataset);
+	CHECK(index.trained());
+	CHECK(index.size() == 0);
+	CHECK(index.search(dataset[0], 3).empty());
+
+	CHECK(index.add(comp6771::euclidean_vector_batch(dataset)) == 0);
+	auto const extra = comp6771::euclidean_vector(6, 10.0);
+	CHECK(index.add(extra) == 1000);
+	CHECK(index.size() == 1001);
+	CHECK(index.search(extra, 1) == std::vector<comp6771::neighbour>{{1000, 0.0}});
+
+	for (auto id = 0; id < 1000; id += 2) {
+		CHECK(index.remove(id));
+	}
+	CHECK(not index.remove(0));
+	CHECK(not index.remove(5000));
+	CHECK(not index.remove(-1));
+	CHECK(index.size() == 501);
+	CHECK(not index.contains(998));
+	CHECK(index.contains(999));
+
+	auto remaining = std::vector<comp6771::euclidean_vector>();
+	for (auto id = 1; id < 1000; id += 2) {
+		CHECK(index[id] == dataset[static_cast<std::size_t>(id)]);
+		remaining.push_back(dataset[static_cast<std::size_t>(id)]);
+	}
+	remaining.push_back(extra);
+	auto const queries = clustered_vectors(20, 6, 4);
+	auto const exact = comp6771::knn_search(queries, remaining, 5);
+	auto const found = index.search(queries, 5);
+	for (auto query = std::size_t{0}; query < queries.size(); ++query) {
+		REQUIRE(found[query].size() == 5);
+		for (auto i = std::size_t{0}; i < 5; ++i) {
+			auto const position = exact[query][i].index;
+			CHECK(found[query][i].index == (position == 500 ? 1000 : 2 * position + 1));
+		}
+	}
+}
+
+/*
+Rationale:
+    Scanning lists in parallel, or searching for queries in parallel, must give the same results
+    as searching serially. Queries made as views on access are searched like the vectors they
+    view.
+*/
+TEST_CASE("IVF searching in parallel") {
+	auto const dataset = comp6771::euclidean_vector_batch(clustered_vectors(2000, 10, 5));
+	auto const queries = clustered_vectors(30, 10, 6);
+	auto const index = comp6771::ivf_index(dataset, 16, comp6771::metric::l2, {.nprobe = 6});
+	auto const previous = comp6771::parallel_threshold();
+	comp6771::set_parallel_threshold(1);
+
+	auto pool = comp6771::thread_pool(3);
+	auto const serial = index.search(queries, 7);
+	for (auto query = std::size_t{0}; query < queries.size(); ++query) {
+		CHECK(index.search(pool, queries[query], 7) == serial[query]);
+		CHECK(index.search(std::execution::par, queries[query], 7) == serial[query]);
+	}
+	CHECK(index.search(pool, queries, 7) == serial);
+	CHECK(index.search(std::execution::seq, queries, 7) == serial);
+	auto const view_of = [](comp6771::euclidean_vector const& vec) {
+		return comp6771::const_euclidean_vector_view(vec);
+	};
+	CHECK(index.search(pool, queries | std::views::transform(view_of), 7) == serial);
+	comp6771::set_parallel_threshold(previous);
+}
+
+/*
+Rationale:
+    Untrained indexes cannot hold vectors, training needs enough vectors and an empty index, and
+    invalid parameters, dimensions, lists and k are errors. Every element type can be indexed.
+*/
+TEST_CASE("IVF edge cases") {
+	auto index = comp6771::ivf_index(2, 2);
+	CHECK_THROWS_MATCHES(index.add(comp6771::euclidean_vector{1, 2}),
+	                     comp6771::euclidean_vector_error,
+	                     Catch::Matchers::Message("ivf_index is not trained"));
+	CHECK(index.list_size(1) == 0);
+	CHECK_THROWS_MATCHES(index.train(std::vector<comp6771::euclidean_vector>{{1, 2}}),
+	                     comp6771::euclidean_vector_error,
+	                     Catch::Matchers::Message("Cannot train an ivf_index on fewer vectors "
+	                                              "than lists"));
+	auto const points = std::vector<comp6771::euclidean_vector>{{0, 0}, {10, 10}, {3, 4}, {11, 10}};
+	index.train(points);
+	index.add(points);
+	CHECK(index.search(comp6771::euclidean_vector{0, 0}, 10).size() == 4);
+	CHECK_THROWS_MATCHES(index.train(points),
+	                     comp6771::euclidean_vector_error,
+	                     Catch::Matchers::Message("Cannot train an ivf_index that holds vectors"));
+	CHECK_THROWS_MATCHES(index.list_size(2),
+	                     comp6771::euclidean_vector_error,
+	                     Catch::Matchers::Message("List 2 is not valid for this ivf_index object"));
+	CHECK_THROWS_MATCHES(index.add(comp6771::euclidean_vector{1, 2, 3}),
+	                     comp6771::euclidean_vector_error,
+	                     Catch::Matchers::Message("Dimensions of LHS(2) and RHS(3) do not match"));
+	CHECK_THROWS_MATCHES(index.search(comp6771::euclidean_vector{0, 0}, -1),
+	                     comp6771::euclidean_vector_error,
+	                     Catch::Matchers::Message("Cannot search for a negative number of "
+	                                              "neighbours"));
+	CHECK_THROWS_MATCHES(index.set_nprobe(0),
+	                     comp6771::euclidean_vector_error,
+	                     Catch::Matchers::Message("ivf_index parameters are not valid"));
+	CHECK_THROWS_AS(comp6771::ivf_index(2, 0), comp6771::euclidean_vector_error);
+
+	auto const quantised = comp6771::basic_ivf_index<std::int8_t>(
+	   std::vector<comp6771::basic_euclidean_vector<std::int8_t>>{{10, 10}, {-3, 4}, {100, -100}},
+	   3);
+	CHECK(quantised.search(comp6771::basic_euclidean_vector<std::int8_t>{0, 0}, 1)
+	      == std::vector<comp6771::neighbour>{{1, 5.0}});
+}
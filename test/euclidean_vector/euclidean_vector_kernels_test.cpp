@@ -0,0 +1,306 @@
+#include <catch2/catch.hpp>
+#include <comp6771/euclidean_vector.hpp>
+#include <comp6771/kernels.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+/*
+This file is to test the vectorised kernels behind the arithmetic operators and dot product.
+
+Approach:
+    - Pin the kernels to each instruction set the CPU supports
+    - Run every kernel over sizes that cover the unrolled body and every tail length
+    - Compare against a plain serial loop
+*/
+
+namespace {
+	template<typename T = double>
+	auto make_values(std::size_t size, T offset) -> std::vector<T> {
+		auto values = std::vector<T>(size);
+		for (auto i = std::size_t{0}; i < size; ++i) {
+			values[i] = offset + static_cast<T>(i % 7) * T{0.5} - static_cast<T>(i % 3);
+		}
+		return values;
+	}
+} // namespace
+
+/*
+Rationale:
+    Every instruction set must give the same results as the serial loop: exactly for the
+    element-wise kernels, and within rounding for the dot product, whose accumulation order differs.
+*/
+TEST_CASE("Kernels agree with a serial loop on every instruction set") {
+	auto const original = comp6771::kernels::active_isa();
+	using comp6771::kernels::isa;
+
+	for (auto const level : {isa::portable, isa::sse2, isa::avx2, isa::avx512}) {
+		if (not comp6771::kernels::supported(level)) {
+			continue;
+		}
+		comp6771::kernels::use_isa(level);
+		CHECK(comp6771::kernels::active_isa() == level);
+
+		for (auto size = std::size_t{0}; size < 70; ++size) {
+			auto const x = make_values(size, 1.25);
+			auto const y = make_values(size, -0.75);
+
+			auto expected_dot = 0.0;
+			for (auto i = std::size_t{0}; i < size; ++i) {
+				expected_dot += x[i] * y[i];
+			}
+			CHECK(comp6771::kernels::dot(x.data(), y.data(), size)
+			      == Approx(expected_dot).margin(1e-9));
+
+			auto sum = x;
+			comp6771::kernels::add(sum.data(), y.data(), size);
+			auto difference = x;
+			comp6771::kernels::subtract(difference.data(), y.data(), size);
+			auto product = x;
+			comp6771::kernels::multiply(product.data(), -3.5, size);
+			auto quotient = x;
+			comp6771::kernels::divide(quotient.data(), 3.0, size);
+			for (auto i = std::size_t{0}; i < size; ++i) {
+				CHECK(sum[i] == x[i] + y[i]);
+				CHECK(difference[i] == x[i] - y[i]);
+				CHECK(product[i] == x[i] * -3.5);
+				CHECK(quotient[i] == x[i] / 3.0);
+			}
+		}
+	}
+
+	comp6771::kernels::use_isa(original);
+}
+
+/*
+Rationale:
+    The float kernels use twice as many lanes per register, so their unrolled bodies and tails
+    cover different sizes. They must also agree with a serial loop on every instruction set.
+*/
+TEST_CASE("Float kernels agree with a serial loop on every instruction set") {
+	auto const original = comp6771::kernels::active_isa();
+	using comp6771::kernels::isa;
+
+	for (auto const level : {isa::portable, isa::sse2, isa::avx2, isa::avx512}) {
+		if (not comp6771::kernels::supported(level)) {
+			continue;
+		}
+		comp6771::kernels::use_isa(level);
+
+		for (auto size = std::size_t{0}; size < 140; ++size) {
+			auto const x = make_values(size, 1.25F);
+			auto const y = make_values(size, -0.75F);
+
+			auto expected_dot = 0.0;
+			for (auto i = std::size_t{0}; i < size; ++i) {
+				expected_dot += static_cast<double>(x[i] * y[i]);
+			}
+			CHECK(comp6771::kernels::dot(x.data(), y.data(), size)
+			      == Approx(expected_dot).margin(1e-3));
+
+			auto sum = x;
+			comp6771::kernels::add(sum.data(), y.data(), size);
+			auto difference = x;
+			comp6771::kernels::subtract(difference.data(), y.data(), size);
+			auto product = x;
+			comp6771::kernels::multiply(product.data(), -3.5F, size);
+			auto quotient = x;
+			comp6771::kernels::divide(quotient.data(), 3.0F, size);
+			for (auto i = std::size_t{0}; i < size; ++i) {
+				CHECK(sum[i] == x[i] + y[i]);
+				CHECK(difference[i] == x[i] - y[i]);
+				CHECK(product[i] == x[i] * -3.5F);
+				CHECK(quotient[i] == x[i] / 3.0F);
+			}
+		}
+	}
+
+	comp6771::kernels::use_isa(original);
+}
+
+/*
+Rationale:
+    The comparison kernel stops at the first block with a mismatch, so a single differing element
+    must be found wherever it sits: in an unrolled block, in a single register or in the tail.
+    NaNs are never close, and the relative tolerance scales with the larger magnitude. Infinities
+    are close only to themselves, however large the relative tolerance.
+*/
+TEST_CASE("Approximate equality agrees on every instruction set") {
+	auto const original = comp6771::kernels::active_isa();
+	using comp6771::kernels::isa;
+
+	for (auto const level : {isa::portable, isa::sse2, isa::avx2, isa::avx512}) {
+		if (not comp6771::kernels::supported(level)) {
+			continue;
+		}
+		comp6771::kernels::use_isa(level);
+
+		for (auto size = std::size_t{1}; size < 140; size += 3) {
+			auto const x = make_values(size, 1.25);
+			auto const xf = make_values(size, 1.25F);
+			CHECK(comp6771::kernels::approx_equal(x.data(), x.data(), size, 1e-6, 0.0));
+			CHECK(comp6771::kernels::approx_equal(xf.data(), xf.data(), size, 1e-6F, 0.0F));
+
+			for (auto const i : {std::size_t{0}, size / 2, size - 1}) {
+				auto y = x;
+				y[i] += 5e-7;
+				CHECK(comp6771::kernels::approx_equal(x.data(), y.data(), size, 1e-6, 0.0));
+				y[i] += 1e-6;
+				CHECK(not comp6771::kernels::approx_equal(x.data(), y.data(), size, 1e-6, 0.0));
+				CHECK(comp6771::kernels::approx_equal(x.data(), y.data(), size, 0.0, 1e-3));
+				y[i] = std::numeric_limits<double>::infinity();
+				CHECK(not comp6771::kernels::approx_equal(x.data(), y.data(), size, 1e-6, 1.0));
+				CHECK(comp6771::kernels::approx_equal(y.data(), y.data(), size, 1e-6, 1.0));
+				y[i] = std::numeric_limits<double>::quiet_NaN();
+				CHECK(not comp6771::kernels::approx_equal(y.data(), y.data(), size, 1.0, 1.0));
+
+				auto yf = xf;
+				yf[i] += 0.25F;
+				CHECK(not comp6771::kernels::approx_equal(xf.data(), yf.data(), size, 1e-6F, 0.0F));
+				CHECK(comp6771::kernels::approx_equal(xf.data(), yf.data(), size, 0.25F, 0.0F));
+				yf[i] = -std::numeric_limits<float>::infinity();
+				CHECK(not comp6771::kernels::approx_equal(xf.data(), yf.data(), size, 1e-6F, 1.0F));
+				CHECK(comp6771::kernels::approx_equal(yf.data(), yf.data(), size, 1e-6F, 1.0F));
+			}
+		}
+	}
+
+	comp6771::kernels::use_isa(original);
+}
+
+/*
+Rationale:
+    The lookup kernels read codes from an interleaved layout. Every instruction set must find
+    each vector's codes in it and sum the largest table entries without overflowing.
+*/
+TEST_CASE("Table lookups agree with a serial loop on every instruction set") {
+	auto const original = comp6771::kernels::active_isa();
+	using comp6771::kernels::isa;
+	constexpr auto block = comp6771::kernels::lookup_block;
+
+	for (auto const pairs : {std::size_t{1}, std::size_t{5}, std::size_t{128}}) {
+		auto const blocks = std::size_t{3};
+		auto tables = std::vector<std::uint8_t>(2 * pairs * 16);
+		for (auto i = std::size_t{0}; i < tables.size(); ++i) {
+			tables[i] = static_cast<std::uint8_t>(pairs == 128 ? 255 : (i * 37) % 256);
+		}
+		// code[b][v][j] is the code of vector v of block b in subspace j.
+		auto const code = [](std::size_t b, std::size_t v, std::size_t j) {
+			return static_cast<std::uint8_t>((b * 7 + v * 3 + j * 5) % 16);
+		};
+		auto codes = std::vector<std::uint8_t>(blocks * pairs * block);
+		auto expected = std::vector<std::uint16_t>(blocks * block);
+		for (auto b = std::size_t{0}; b < blocks; ++b) {
+			for (auto v = std::size_t{0}; v < block; ++v) {
+				auto const byte = v < block / 2 ? 2 * v : 2 * (v - block / 2) + 1;
+				for (auto pair = std::size_t{0}; pair < pairs; ++pair) {
+					auto const low = code(b, v, 2 * pair);
+					auto const high = code(b, v, 2 * pair + 1);
+					auto const packed = static_cast<std::uint8_t>(low | high << 4U);
+					codes[(b * pairs + pair) * block + byte] = packed;
+					expected[b * block + v] = static_cast<std::uint16_t>(
+					   expected[b * block + v] + tables[2 * pair * 16 + low]
+					   + tables[(2 * pair + 1) * 16 + high]);
+				}
+			}
+		}
+
+		for (auto const level : {isa::portable, isa::sse2, isa::avx2, isa::avx512}) {
+			if (not comp6771::kernels::supported(level)) {
+				continue;
+			}
+			comp6771::kernels::use_isa(level);
+			auto sums = std::vector<std::uint16_t>(blocks * block);
+			comp6771::kernels::lookup_accumulate(codes.data(),
+			                                     tables.data(),
+			                                     pairs,
+			                                     blocks,
+			                                     sums.data());
+			CHECK(sums == expected);
+		}
+	}
+
+	comp6771::kernels::use_isa(original);
+}
+
+/*
+Rationale:
+    The tile kernels read rows and columns from a packed layout. Every instruction set must
+    multiply each row with each column, including over no elements. Values are multiples of a
+    half, so the products are exact whatever the order of the sums.
+*/
+TEST_CASE("Tile products agree with a serial loop on every instruction set") {
+	auto const original = comp6771::kernels::active_isa();
+	using comp6771::kernels::isa;
+	constexpr auto size = comp6771::kernels::tile_size;
+
+	for (auto const depth : {std::size_t{0}, std::size_t{1}, std::size_t{37}}) {
+		auto const a = make_values(depth * size, 1.0);
+		auto const b = make_values(depth * size + 3, -2.0);
+		auto expected = std::vector<double>(size * size);
+		for (auto i = std::size_t{0}; i < size; ++i) {
+			for (auto j = std::size_t{0}; j < size; ++j) {
+				for (auto k = std::size_t{0}; k < depth; ++k) {
+					expected[i * size + j] += a[k * size + i] * b[k * size + j];
+				}
+			}
+		}
+
+		for (auto const level : {isa::portable, isa::sse2, isa::avx2, isa::avx512}) {
+			if (not comp6771::kernels::supported(level)) {
+				continue;
+			}
+			comp6771::kernels::use_isa(level);
+			auto tile = std::vector<double>(size * size, -1.0);
+			comp6771::kernels::dot_tile(a.data(), b.data(), depth, tile.data());
+			CHECK(tile == expected);
+		}
+	}
+
+	comp6771::kernels::use_isa(original);
+}
+
+/*
+Rationale:
+    Quantised kernels must not wrap around: sums, differences and scaled values saturate at the
+    limits of the element type, scaled values round to nearest, and the dot product is exact.
+*/
+TEST_CASE("Quantised kernels saturate and round") {
+	auto x = std::vector<std::int8_t>{100, -100, 7, -7};
+	auto const y = std::vector<std::int8_t>{100, -100, 1, 1};
+	CHECK(comp6771::kernels::dot(x.data(), y.data(), x.size()) == 20000 + 7 - 7);
+
+	comp6771::kernels::add(x.data(), y.data(), x.size());
+	CHECK(x == std::vector<std::int8_t>{127, -128, 8, -6});
+
+	comp6771::kernels::subtract(x.data(), y.data(), x.size());
+	CHECK(x == std::vector<std::int8_t>{27, -28, 7, -7});
+
+	comp6771::kernels::multiply(x.data(), 0.5, x.size());
+	CHECK(x == std::vector<std::int8_t>{14, -14, 4, -4});
+
+	comp6771::kernels::divide(x.data(), 0.01, x.size());
+	CHECK(x == std::vector<std::int8_t>{127, -128, 127, -128});
+
+	auto wide = std::vector<std::int16_t>{30000, -30000};
+	comp6771::kernels::multiply(wide.data(), 2.0, wide.size());
+	CHECK(wide == std::vector<std::int16_t>{32767, -32768});
+}
+
+/*
+Rationale:
+    The widest supported instruction set is chosen by default, and it is always at least the
+    portable one. Pinning an unsupported instruction set must throw.
+*/
+TEST_CASE("Kernel dispatch") {
+	CHECK(comp6771::kernels::supported(comp6771::kernels::active_isa()));
+	CHECK(comp6771::kernels::supported(comp6771::kernels::isa::portable));
+
+	if (not comp6771::kernels::supported(comp6771::kernels::isa::avx512)) {
+		CHECK_THROWS_MATCHES(comp6771::kernels::use_isa(comp6771::kernels::isa::avx512),
+		                     comp6771::euclidean_vector_error,
+		                     Catch::Matchers::Message("Instruction set is not supported by this "
+		                                              "CPU"));
+	}
+}
@@ -0,0 +1,258 @@
+#include <catch2/catch.hpp>
+#include <comp6771/euclidean_vector.hpp>
+#include <comp6771/euclidean_vector_batch.hpp>
+#include <comp6771/euclidean_vector_view.hpp>
+#include <comp6771/kmeans.hpp>
+#include <comp6771/parallel.hpp>
+#include <comp6771/thread_pool.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <execution>
+#include <random>
+#include <ranges>
+#include <set>
+#include <vector>
+
+/*
+This file is to test kmeans.
+It assumes euclidean_vector and euclidean_vector_batch are correctly implemented.
+
+Approach:
+    - Cluster vectors drawn tightly around centres far apart, whose clusters are known
+    - Check that the inertia reported is the inertia of the centroids and assignment returned
+    - Check that clustering in parallel, or in mini-batches, finds the same clusters
+*/
+
+namespace {
+	constexpr auto centres_size = 8;
+	constexpr auto rows_per_centre = 100;
+
+	// rows_per_centre rows around each centre, in order of centre
+	auto separated_vectors(int dimensions, unsigned seed)
+	   -> std::vector<comp6771::euclidean_vector> {
+		auto engine = std::mt19937(seed);
+		auto noise = std::normal_distribution<double>(0.0, 0.05);
+		auto vectors = std::vector<comp6771::euclidean_vector>();
+		for (auto centre = 0; centre < centres_size; ++centre) {
+			for (auto row = 0; row < rows_per_centre; ++row) {
+				auto vec = comp6771::euclidean_vector(dimensions);
+				for (auto i = 0; i < dimensions; ++i) {
+					vec[i] = (i % centres_size == centre ? 10.0 : 0.0) + noise(engine);
+				}
+				vectors.push_back(vec);
+			}
+		}
+		return vectors;
+	}
+
+	// Whether rows of the same centre, and only those, share a cluster
+	auto finds_centres(std::vector<int> const& assignment) -> bool {
+		auto clusters = std::set<int>();
+		for (auto centre = 0; centre < centres_size; ++centre) {
+			auto const first = static_cast<std::size_t>(centre * rows_per_centre);
+			for (auto row = first; row < first + rows_per_centre; ++row) {
+				if (assignment[row] != assignment[first]) {
+					return false;
+				}
+			}
+			clusters.insert(assignment[first]);
+		}
+		return clusters.size() == centres_size;
+	}
+
+	auto inertia_of(std::vector<comp6771::euclidean_vector> const& dataset,
+	                comp6771::kmeans_result const& result) -> double {
+		auto inertia = 0.0;
+		for (auto row = std::size_t{0}; row < dataset.size(); ++row) {
+			auto const centroid = comp6771::euclidean_vector(result.centroids[result.assignment[row]]);
+			auto const distance = comp6771::euclidean_norm(dataset[row] - centroid);
+			inertia += distance * distance;
+		}
+		return inertia;
+	}
+} // namespace
+
+/*
+Rationale:
+    Seeding with k-means++ or k-means|| puts a centroid in every cluster of well separated data,
+    and Lloyd's algorithm then finds the clusters exactly. Each centroid is the mean of its rows,
+    and the inertia never rises from one iteration to the next.
+*/
+TEST_CASE("k-means finds separated clusters") {
+	auto const dataset = separated_vectors(16, 1);
+	for (auto const seeding : {comp6771::kmeans_seeding::plus_plus,
+	                           comp6771::kmeans_seeding::parallel})
+	{
+		auto const result = comp6771::kmeans(dataset, centres_size, {.seeding = seeding});
+		CHECK(result.centroids.rows() == centres_size);
+		CHECK(result.centroids.dimensions() == 16);
+		REQUIRE(result.assignment.size() == dataset.size());
+		CHECK(finds_centres(result.assignment));
+		CHECK(result.converged);
+		CHECK(result.inertia == Approx(inertia_of(dataset, result)));
+		REQUIRE(not result.history.empty());
+		CHECK(result.history.back().inertia == Approx(result.inertia));
+		for (auto iteration = std::size_t{1}; iteration < result.history.size(); ++iteration) {
+			CHECK(result.history[iteration].inertia
+			      <= result.history[iteration - 1].inertia * (1 + 1e-12));
+		}
+
+		auto const first = comp6771::euclidean_vector(result.centroids[result.assignment[0]]);
+		auto mean = comp6771::euclidean_vector(16);
+		for (auto row = 0; row < rows_per_centre; ++row) {
+			mean += dataset[static_cast<std::size_t>(row)];
+		}
+		mean /= rows_per_centre;
+		CHECK(comp6771::euclidean_norm(first - mean) < 1e-9);
+	}
+
+	auto const random = comp6771::kmeans(dataset,
+	                                     centres_size,
+	                                     {.seeding = comp6771::kmeans_seeding::random});
+	CHECK(random.inertia == Approx(inertia_of(dataset, random)));
+	CHECK(random.inertia >= comp6771::kmeans(dataset, centres_size).inertia * (1 - 1e-9));
+}
+
+/*
+Rationale:
+    The same seed gives the same clusters. Assigning and seeding in parallel gives the same
+    assignment as serially, and centroids that differ only by the order their rows were summed.
+*/
+TEST_CASE("k-means in parallel") {
+	auto const dataset = comp6771::euclidean_vector_batch(separated_vectors(12, 2));
+	auto const previous = comp6771::parallel_threshold();
+	comp6771::set_parallel_threshold(1);
+
+	auto pool = comp6771::thread_pool(3);
+	for (auto const seeding : {comp6771::kmeans_seeding::random,
+	                           comp6771::kmeans_seeding::plus_plus,
+	                           comp6771::kmeans_seeding::parallel})
+	{
+		auto const parameters = comp6771::kmeans_parameters{.seeding = seeding, .seed = 9};
+		auto const serial = comp6771::kmeans(dataset, centres_size, parameters);
+		CHECK(comp6771::kmeans(dataset, centres_size, parameters).assignment == serial.assignment);
+		auto const in_pool = comp6771::kmeans(pool, dataset, centres_size, parameters);
+		auto const in_par = comp6771::kmeans(std::execution::par, dataset, centres_size, parameters);
+		for (auto const* const result : {&in_pool, &in_par}) {
+			CHECK(result->assignment == serial.assignment);
+			CHECK(result->inertia == Approx(serial.inertia));
+			for (auto centroid = 0; centroid < centres_size; ++centroid) {
+				auto const difference = comp6771::euclidean_vector(result->centroids[centroid])
+				                        - comp6771::euclidean_vector(serial.centroids[centroid]);
+				CHECK(comp6771::euclidean_norm(difference) < 1e-9);
+			}
+		}
+	}
+	comp6771::set_parallel_threshold(previous);
+}
+
+/*
+Rationale:
+    k-means++ and k-means|| choose their first centroid uniformly, so different seeds can start
+    from different rows. With one cluster the first inertia is measured from that row, and it
+    differs between rows in a line.
+*/
+TEST_CASE("k-means chooses its first centroid at random") {
+	auto line = std::vector<comp6771::euclidean_vector>();
+	for (auto i = 0; i < 10; ++i) {
+		line.push_back(comp6771::euclidean_vector{static_cast<double>(i)});
+	}
+	for (auto const seeding : {comp6771::kmeans_seeding::plus_plus,
+	                           comp6771::kmeans_seeding::parallel})
+	{
+		auto first_inertias = std::set<double>();
+		for (auto seed = 0U; seed < 20; ++seed) {
+			auto const result =
+			   comp6771::kmeans(line, 1, {.seeding = seeding, .iterations = 1, .seed = seed});
+			first_inertias.insert(result.history.front().inertia);
+		}
+		CHECK(first_inertias.size() > 1);
+	}
+}
+
+/*
+Rationale:
+    k-means keeps pointers to every row, so a range that makes its rows on access must yield views
+    of memory that outlives it. Clustering views of vectors gives the same clusters as clustering
+    the vectors.
+*/
+TEST_CASE("k-means over a range of views") {
+	auto const dataset = separated_vectors(16, 5);
+	auto const view_of = [](comp6771::euclidean_vector const& vec) {
+		return comp6771::const_euclidean_vector_view(vec);
+	};
+	auto const views = dataset | std::views::transform(view_of);
+	auto const result = comp6771::kmeans(views, centres_size);
+	CHECK(result.assignment == comp6771::kmeans(dataset, centres_size).assignment);
+	CHECK(finds_centres(result.assignment));
+}
+
+/*
+Rationale:
+    Mini-batches see a fraction of the rows in each iteration, but on well separated data they
+    still find every cluster. The inertia reported is that of a final pass over every row.
+*/
+TEST_CASE("Mini-batch k-means") {
+	auto const dataset = separated_vectors(16, 3);
+	auto const result =
+	   comp6771::kmeans(dataset, centres_size, {.iterations = 200, .batch_size = 64});
+	CHECK(finds_centres(result.assignment));
+	CHECK(result.inertia == Approx(inertia_of(dataset, result)));
+	CHECK(result.inertia < 1.05 * comp6771::kmeans(dataset, centres_size).inertia);
+	CHECK(result.converged);
+	CHECK(result.history.size() < 200);
+	CHECK(result.history.front().shift > result.history.back().shift);
+}
+
+/*
+Rationale:
+    k must be positive and no more than the rows, and parameters must be in range. As many
+    clusters as rows fit exactly, copies of one row give no inertia however many clusters there
+    are, and every element type can be clustered.
+*/
+TEST_CASE("k-means edge cases") {
+	auto const dataset = separated_vectors(4, 4);
+	CHECK_THROWS_MATCHES(comp6771::kmeans(dataset, 0),
+	                     comp6771::euclidean_vector_error,
+	                     Catch::Matchers::Message("kmeans parameters are not valid"));
+	CHECK_THROWS_AS(comp6771::kmeans(dataset, 2, {.iterations = 0}),
+	                comp6771::euclidean_vector_error);
+	CHECK_THROWS_AS(comp6771::kmeans(dataset, 2, {.tolerance = -1}),
+	                comp6771::euclidean_vector_error);
+	CHECK_THROWS_AS(comp6771::kmeans(dataset, 2, {.batch_size = -1}),
+	                comp6771::euclidean_vector_error);
+	CHECK_THROWS_MATCHES(comp6771::kmeans(std::vector<comp6771::euclidean_vector>(), 1),
+	                     comp6771::euclidean_vector_error,
+	                     Catch::Matchers::Message("Cannot cluster fewer vectors than clusters"));
+	CHECK_THROWS_MATCHES(comp6771::kmeans(std::vector<comp6771::euclidean_vector>{{1, 2}, {3}}, 1),
+	                     comp6771::euclidean_vector_error,
+	                     Catch::Matchers::Message("Dimensions of LHS(2) and RHS(1) do not match"));
+
+	auto const few = std::vector<comp6771::euclidean_vector>(dataset.begin(), dataset.begin() + 5);
+	auto const exact = comp6771::kmeans(few, 5);
+	CHECK(exact.inertia == 0);
+	CHECK(std::set<int>(exact.assignment.begin(), exact.assignment.end()).size() == 5);
+
+	auto const copies =
+	   std::vector<comp6771::euclidean_vector>(20, comp6771::euclidean_vector{1, 2});
+	for (auto const seeding : {comp6771::kmeans_seeding::random,
+	                           comp6771::kmeans_seeding::plus_plus,
+	                           comp6771::kmeans_seeding::parallel})
+	{
+		auto const result = comp6771::kmeans(copies, 3, {.seeding = seeding});
+		CHECK(result.inertia == 0);
+		CHECK(result.converged);
+	}
+
+	auto quantised = std::vector<comp6771::basic_euclidean_vector<std::int8_t>>();
+	for (auto i = 0; i < 20; ++i) {
+		auto const offset = static_cast<std::int8_t>(i < 10 ? -100 : 100);
+		quantised.push_back({offset, static_cast<std::int8_t>(offset + i % 3)});
+	}
+	auto const result = comp6771::kmeans(quantised, 2);
+	CHECK(result.assignment[0] != result.assignment[19]);
+	CHECK(result.centroids[result.assignment[0]][0] == -100);
+	CHECK(comp6771::kmeans(std::vector<comp6771::basic_euclidean_vector<float>>{{1.5F}, {2.5F}}, 2)
+	         .inertia
+	      == 0);
+}
@@ -0,0 +1,195 @@
+#include "euclidean_vector_test.hpp"
+
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <comp6771/euclidean_vector.hpp>
+#include <comp6771/euclidean_vector_batch.hpp>
+#include <comp6771/euclidean_vector_view.hpp>
+#include <comp6771/knn.hpp>
+#include <comp6771/parallel.hpp>
+#include <comp6771/thread_pool.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <execution>
+#include <ranges>
+#include <vector>
+
+/*
+This file is to test knn_search.
+It assumes euclidean_vector, euclidean_vector_batch and the utility functions are correctly
+implemented.
+
+Approach:
+    - Search random datasets, large enough to span several blocks of rows and queries
+    - Compare every result against a brute force search using the utility functions
+    - Check the datasets and policies that can be searched, and the edge cases of k
+*/
+
+using comp6771::tests::random_vectors;
+
+namespace {
+	auto brute_force(comp6771::euclidean_vector const& query,
+	                 std::vector<comp6771::euclidean_vector> const& dataset,
+	                 int k,
+	                 comp6771::metric measure) -> std::vector<comp6771::neighbour> {
+		auto all = std::vector<comp6771::neighbour>();
+		for (auto row = 0; row < static_cast<int>(dataset.size()); ++row) {
+			auto const& vec = dataset[static_cast<std::size_t>(row)];
+			auto const distance = [&] {
+				switch (measure) {
+				case comp6771::metric::l2:
+					return comp6771::euclidean_norm(comp6771::euclidean_vector(query - vec));
+				case comp6771::metric::inner_product: return -comp6771::dot(query, vec);
+				case comp6771::metric::cosine:
+					return 1 - comp6771::dot(query, vec)
+					              / (comp6771::euclidean_norm(query) * comp6771::euclidean_norm(vec));
+				}
+				return 0.0;
+			}();
+			all.push_back({row, distance});
+		}
+		std::sort(all.begin(), all.end(), [](auto const& a, auto const& b) {
+			return a.distance < b.distance;
+		});
+		all.resize(std::min(all.size(), static_cast<std::size_t>(k)));
+		return all;
+	}
+
+	auto check_neighbours(std::vector<comp6771::neighbour> const& found,
+	                      std::vector<comp6771::neighbour> const& expected) -> void {
+		REQUIRE(found.size() == expected.size());
+		for (auto i = std::size_t{0}; i < found.size(); ++i) {
+			CHECK(found[i].index == expected[i].index);
+			CHECK(found[i].distance == Approx(expected[i].distance).margin(1e-9));
+		}
+	}
+} // namespace
+
+/*
+Rationale:
+    Every metric must find the same neighbours, in the same order, as comparing the query against
+    every row one at a time. The dataset holds more rows than fit in one block.
+*/
+TEST_CASE("Nearest neighbours of one query") {
+	auto const dataset = random_vectors(3000, 24, 1);
+	auto const batch = comp6771::euclidean_vector_batch(dataset);
+	auto const query = random_vectors(1, 24, 2).front();
+
+	for (auto const measure : {comp6771::metric::l2,
+	                           comp6771::metric::inner_product,
+	                           comp6771::metric::cosine})
+	{
+		auto const expected = brute_force(query, dataset, 10, measure);
+		check_neighbours(comp6771::knn_search(query, batch, 10, measure), expected);
+		check_neighbours(comp6771::knn_search(query, dataset, 10, measure), expected);
+	}
+
+	SECTION("Exact matches are at distance zero") {
+		auto const found = comp6771::knn_search(batch[1234], batch, 1);
+		REQUIRE(found.size() == 1);
+		CHECK(found.front().index == 1234);
+		CHECK(found.front().distance == Approx(0).margin(1e-6));
+	}
+
+	SECTION("Equally distant rows are ordered by index") {
+		auto const repeated =
+		   std::vector<comp6771::euclidean_vector>(5, comp6771::euclidean_vector{1, 1});
+		auto const found = comp6771::knn_search(comp6771::euclidean_vector{0, 0}, repeated, 3);
+		CHECK(found == std::vector<comp6771::neighbour>{{0, std::sqrt(2.0)},
+		                                                {1, std::sqrt(2.0)},
+		                                                {2, std::sqrt(2.0)}});
+	}
+
+	SECTION("Zero vectors have a cosine distance of one") {
+		auto const rows = std::vector<comp6771::euclidean_vector>{{0, 0}, {1, 0}};
+		auto const found = comp6771::knn_search(comp6771::euclidean_vector{1, 0},
+		                                        rows,
+		                                        2,
+		                                        comp6771::metric::cosine);
+		CHECK(found == std::vector<comp6771::neighbour>{{1, 0.0}, {0, 1.0}});
+	}
+}
+
+/*
+Rationale:
+    Searching many queries at once, serially or in parallel, must give each query the same
+    neighbours as searching for it alone. There are more queries than fit in one block, and the
+    last block is partial.
+*/
+TEST_CASE("Nearest neighbours of many queries") {
+	auto const dataset = comp6771::euclidean_vector_batch(random_vectors(500, 9, 3));
+	auto const queries = random_vectors(37, 9, 4);
+	auto const previous = comp6771::parallel_threshold();
+	comp6771::set_parallel_threshold(1);
+
+	auto const serial = comp6771::knn_search(queries, dataset, 7);
+	REQUIRE(serial.size() == queries.size());
+	for (auto query = std::size_t{0}; query < queries.size(); ++query) {
+		CHECK(serial[query] == comp6771::knn_search(queries[query], dataset, 7));
+	}
+
+	auto pool = comp6771::thread_pool(3);
+	CHECK(comp6771::knn_search(pool, queries, dataset, 7) == serial);
+	CHECK(comp6771::knn_search(std::execution::par, queries, dataset, 7) == serial);
+	CHECK(comp6771::knn_search(std::execution::seq, queries, dataset, 7) == serial);
+	CHECK(comp6771::knn_search(pool, comp6771::euclidean_vector_batch(queries), dataset, 7)
+	      == serial);
+	comp6771::set_parallel_threshold(previous);
+}
+
+/*
+Rationale:
+    k may exceed the number of rows or be zero, empty datasets have no neighbours, and every
+    element type can be searched. Mismatched dimensions and negative k are errors.
+*/
+TEST_CASE("Nearest neighbour edge cases") {
+	auto const dataset = std::vector<comp6771::euclidean_vector>{{0, 0}, {3, 4}, {1, 0}};
+	auto const query = comp6771::euclidean_vector{0, 0};
+	CHECK(comp6771::knn_search(query, dataset, 10)
+	      == std::vector<comp6771::neighbour>{{0, 0.0}, {2, 1.0}, {1, 5.0}});
+	CHECK(comp6771::knn_search(query, dataset, 0).empty());
+	CHECK(comp6771::knn_search(query, std::vector<comp6771::euclidean_vector>(), 3).empty());
+	CHECK(comp6771::knn_search(std::vector<comp6771::euclidean_vector>(), dataset, 3).empty());
+
+	auto const quantised = comp6771::basic_euclidean_vector_batch<std::int8_t>(
+	   std::vector<comp6771::basic_euclidean_vector<std::int8_t>>{{10, 10}, {-3, 4}, {100, -100}});
+	auto const found = comp6771::knn_search(comp6771::basic_euclidean_vector<std::int8_t>{0, 0},
+	                                        quantised,
+	                                        1,
+	                                        comp6771::metric::l2);
+	CHECK(found == std::vector<comp6771::neighbour>{{1, 5.0}});
+
+	CHECK_THROWS_MATCHES(comp6771::knn_search(query, dataset, -1),
+	                     comp6771::euclidean_vector_error,
+	                     Catch::Matchers::Message("Cannot search for a negative number of "
+	                                              "neighbours"));
+	CHECK_THROWS_MATCHES(comp6771::knn_search(comp6771::euclidean_vector{0, 0, 0}, dataset, 1),
+	                     comp6771::euclidean_vector_error,
+	                     Catch::Matchers::Message("Dimensions of LHS(3) and RHS(2) do not match"));
+}
+
+/*
+Rationale:
+    A dataset's rows must outlive the expression that produced them, because searches keep
+    pointers to their magnitudes. Ranges of references and of views qualify, and are searched
+    like the vectors they refer to. A range that makes a new vector for each row does not.
+*/
+TEST_CASE("Datasets that can be searched") {
+	auto const vectors = random_vectors(40, 5, 5);
+	auto const view_of = [](comp6771::euclidean_vector const& vec) {
+		return comp6771::const_euclidean_vector_view(vec);
+	};
+	auto const copy_of = [](comp6771::euclidean_vector const& vec) {
+		return comp6771::euclidean_vector(vec);
+	};
+	auto const as_views = vectors | std::views::transform(view_of);
+	auto const as_copies = vectors | std::views::transform(copy_of);
+	static_assert(comp6771::euclidean_vector_dataset<std::vector<comp6771::euclidean_vector>>);
+	static_assert(comp6771::euclidean_vector_dataset<comp6771::euclidean_vector_batch>);
+	static_assert(comp6771::euclidean_vector_dataset<decltype(as_views)>);
+	static_assert(not comp6771::euclidean_vector_dataset<decltype(as_copies)>);
+
+	auto const& query = vectors.front();
+	CHECK(comp6771::knn_search(query, as_views, 6) == comp6771::knn_search(query, vectors, 6));
+}
@@ -1,5 +1,9 @@
 #include <catch2/catch.hpp>
 #include <comp6771/euclidean_vector.hpp>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <memory_resource>
 #include <vector>
 
 /*
@@ -83,3 +87,55 @@ TEST_CASE("Dimensions") {
 	CHECK(ev.dimensions() == 2);
 	CHECK(const_ev.dimensions() == 2);
 }
+
+/*
+Rationale:
+   - This test ensures 'release' hands back the heap buffer itself when it can, and a copy of the
+   magnitudes otherwise, and that 'adopt' takes a buffer back without copying it. Small buffers
+   are copied inline instead, like every other small vector.
+*/
+TEST_CASE("Adopt and release") {
+	auto const large = comp6771::euclidean_vector::inline_capacity + 4;
+
+	SECTION("Heap magnitudes change hands without copying") {
+		auto ev = comp6771::euclidean_vector(large, 2.5);
+		auto const* const magnitude = ev.data();
+		auto released = ev.release();
+		CHECK(released.get() == magnitude);
+		CHECK(ev.dimensions() == 0);
+		CHECK(released[large - 1] == Approx(2.5));
+
+		auto const adopted = comp6771::euclidean_vector::adopt(std::move(released), large);
+		CHECK(adopted.data() == magnitude);
+		CHECK(adopted == comp6771::euclidean_vector(large, 2.5));
+	}
+
+	SECTION("Small magnitudes are adopted inline") {
+		auto const small = comp6771::euclidean_vector::inline_capacity;
+		// NOLINTNEXTLINE(modernize-avoid-c-arrays)
+		auto magnitudes = std::make_unique<double[]>(static_cast<std::size_t>(small));
+		magnitudes[0] = 4.0;
+		auto const adopted = comp6771::euclidean_vector::adopt(std::move(magnitudes), small);
+		auto const* const begin = static_cast<void const*>(std::addressof(adopted));
+		auto const* const end = static_cast<void const*>(std::addressof(adopted) + 1);
+		CHECK(std::less_equal<>{}(begin, static_cast<void const*>(adopted.data())));
+		CHECK(std::less<>{}(static_cast<void const*>(adopted.data()), end));
+		CHECK(adopted[0] == Approx(4.0));
+		CHECK(adopted.dimensions() == small);
+	}
+
+	SECTION("Other magnitudes are copied out") {
+		auto small = comp6771::euclidean_vector{1.0, 2.0};
+		auto const from_small = small.release();
+		CHECK(from_small[1] == Approx(2.0));
+		CHECK(small.dimensions() == 0);
+
+		auto arena = std::pmr::monotonic_buffer_resource();
+		auto pooled = comp6771::euclidean_vector(large, 3.0, &arena);
+		auto const* const magnitude = pooled.data();
+		auto const from_pool = pooled.release();
+		CHECK(from_pool.get() != magnitude);
+		CHECK(from_pool[0] == Approx(3.0));
+		CHECK(pooled.resource() == &arena);
+	}
+}
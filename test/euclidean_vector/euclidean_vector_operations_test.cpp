@@ -270,6 +270,41 @@ TEST_CASE("Vector Type Conversion") {
 		auto const exp = std::vector<double>{1.2, -2.3, 3.4};
 		CHECK(static_cast<std::vector<double>>(ev) == exp);
 	}
+
+	SECTION("Casting an rvalue hands back the std::vector it was built from") {
+		auto input = std::vector<double>(comp6771::euclidean_vector::inline_capacity + 4, 1.5);
+		auto const* const magnitude = input.data();
+		auto adopted = comp6771::euclidean_vector(std::move(input));
+		CHECK(adopted.data() == magnitude);
+
+		auto const output = static_cast<std::vector<double>>(std::move(adopted));
+		CHECK(output.data() == magnitude);
+		CHECK(output.size() == comp6771::euclidean_vector::inline_capacity + 4);
+		CHECK(adopted.dimensions() == 0); // NOLINT(bugprone-use-after-move)
+	}
+
+	SECTION("Casting a moved-from rvalue leaves the vector it moved to alone") {
+		auto input = std::vector<double>(comp6771::euclidean_vector::inline_capacity + 4, 1.5);
+		auto adopted = comp6771::euclidean_vector(std::move(input));
+		auto moved = std::move(adopted);
+		// NOLINTNEXTLINE(bugprone-use-after-move)
+		CHECK(static_cast<std::vector<double>>(std::move(adopted)).empty());
+		CHECK(moved[0] == Approx(1.5));
+
+		auto assigned = comp6771::euclidean_vector(1);
+		assigned = std::move(moved);
+		// NOLINTNEXTLINE(bugprone-use-after-move)
+		CHECK(static_cast<std::vector<double>>(std::move(moved)).empty());
+		CHECK(assigned[0] == Approx(1.5));
+		CHECK(assigned.dimensions() == comp6771::euclidean_vector::inline_capacity + 4);
+	}
+
+	SECTION("Casting any other rvalue copies") {
+		auto copied = ev;
+		CHECK(static_cast<std::vector<double>>(std::move(copied))
+		      == std::vector<double>{1.2, -2.3, 3.4});
+		CHECK(copied.dimensions() == 0); // NOLINT(bugprone-use-after-move)
+	}
 }
 
 /*
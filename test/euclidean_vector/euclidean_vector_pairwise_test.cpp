@@ -0,0 +1,132 @@
+#include "euclidean_vector_test.hpp"
+
+#include <catch2/catch.hpp>
+#include <comp6771/euclidean_vector.hpp>
+#include <comp6771/euclidean_vector_batch.hpp>
+#include <comp6771/kernels.hpp>
+#include <comp6771/pairwise.hpp>
+#include <comp6771/parallel.hpp>
+#include <comp6771/thread_pool.hpp>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <execution>
+#include <span>
+#include <vector>
+
+/*
+This file is to test pairwise_dot and pairwise_l2.
+It assumes euclidean_vector, euclidean_vector_batch, dot and the kernels are correctly implemented.
+
+Approach:
+    - Multiply sets whose sizes leave partial tiles and blocks, and vectors long enough to need
+      more than one pass over their elements
+    - Compare every entry with dot, and with the norm of the difference, on every instruction set
+    - Check that multiplying in parallel gives exactly the serial results
+*/
+
+using comp6771::tests::random_vectors;
+
+/*
+Rationale:
+    Every entry must be the product, or distance, of its pair of vectors, to within rounding.
+    37 rows leave a partial tile and block of rows, 1100 columns a partial block of columns, and
+    300 elements a second, partial pass over them.
+*/
+TEST_CASE("Pairwise products and distances") {
+	auto const original = comp6771::kernels::active_isa();
+	using comp6771::kernels::isa;
+	auto const a = random_vectors(37, 300, 1);
+	auto const b = comp6771::euclidean_vector_batch(random_vectors(1100, 300, 2));
+
+	for (auto const level : {isa::portable, isa::sse2, isa::avx2, isa::avx512}) {
+		if (not comp6771::kernels::supported(level)) {
+			continue;
+		}
+		comp6771::kernels::use_isa(level);
+		auto products = std::vector<double>(37 * 1100);
+		auto distances = std::vector<double>(37 * 1100);
+		comp6771::pairwise_dot(a, b, products);
+		comp6771::pairwise_l2(a, b, distances);
+		for (auto row = 0; row < 37; ++row) {
+			auto const& x = a[static_cast<std::size_t>(row)];
+			for (auto column = 0; column < 1100; ++column) {
+				auto const y = comp6771::euclidean_vector(b[column]);
+				auto const entry = static_cast<std::size_t>(row * 1100 + column);
+				CHECK(products[entry] == Approx(comp6771::dot(x, y)).margin(1e-9));
+				CHECK(distances[entry] == Approx(comp6771::euclidean_norm(x - y)).margin(1e-6));
+			}
+		}
+	}
+
+	comp6771::kernels::use_isa(original);
+}
+
+/*
+Rationale:
+    Threads split the rows, and the columns too when there are few rows, but every entry is
+    summed in the same order, so parallel results equal serial ones exactly.
+*/
+TEST_CASE("Pairwise products in parallel") {
+	auto const previous = comp6771::parallel_threshold();
+	comp6771::set_parallel_threshold(1);
+	auto pool = comp6771::thread_pool(3);
+
+	auto const b = random_vectors(300, 20, 3);
+	for (auto const rows : {1, 5, 200}) {
+		auto const a = random_vectors(rows, 20, 4);
+		auto const size = static_cast<std::size_t>(rows) * b.size();
+		auto serial = std::vector<double>(size);
+		comp6771::pairwise_l2(a, b, serial);
+		auto in_pool = std::vector<double>(size);
+		comp6771::pairwise_l2(pool, a, b, in_pool);
+		CHECK(in_pool == serial);
+		auto in_par = std::vector<double>(size);
+		comp6771::pairwise_l2(std::execution::par, a, b, in_par);
+		CHECK(in_par == serial);
+
+		comp6771::pairwise_dot(a, b, serial);
+		comp6771::pairwise_dot(pool, a, b, in_pool);
+		CHECK(in_pool == serial);
+	}
+	comp6771::set_parallel_threshold(previous);
+}
+
+/*
+Rationale:
+    Empty sets write nothing, and vectors with no dimensions are all 0 apart. Dimensions must
+    match and the output must hold every pair. Products of quantised vectors are exact, and a
+    larger output is only written at the start.
+*/
+TEST_CASE("Pairwise edge cases") {
+	auto const empty = std::vector<comp6771::euclidean_vector>();
+	auto const vectors = random_vectors(3, 4, 5);
+	auto out = std::vector<double>(9, -1.0);
+	comp6771::pairwise_dot(empty, vectors, out);
+	comp6771::pairwise_l2(vectors, empty, out);
+	CHECK(out == std::vector<double>(9, -1.0));
+
+	auto const none = std::vector<comp6771::euclidean_vector>(3, comp6771::euclidean_vector(0));
+	comp6771::pairwise_l2(none, none, out);
+	CHECK(out == std::vector<double>(9, 0.0));
+
+	CHECK_THROWS_MATCHES(comp6771::pairwise_dot(vectors, random_vectors(3, 5, 6), out),
+	                     comp6771::euclidean_vector_error,
+	                     Catch::Matchers::Message("Dimensions of LHS(4) and RHS(5) do not match"));
+	CHECK_THROWS_MATCHES(comp6771::pairwise_dot(vectors, vectors, std::span(out).first(8)),
+	                     comp6771::euclidean_vector_error,
+	                     Catch::Matchers::Message("Output is too small to hold every pair of "
+	                                              "vectors"));
+
+	auto const quantised = std::vector<comp6771::basic_euclidean_vector<std::int8_t>>{
+	   {127, -128, 3},
+	   {-128, -128, 0}};
+	auto larger = std::vector<double>(5, -1.0);
+	comp6771::pairwise_dot(quantised, quantised, larger);
+	auto const cross = -127.0 * 128 + 128 * 128;
+	CHECK(larger
+	      == std::vector<double>{127 * 127 + 128 * 128 + 9, cross, cross, 2 * 128 * 128, -1.0});
+	comp6771::pairwise_l2(quantised, quantised, larger);
+	CHECK(larger[0] == 0);
+	CHECK(larger[1] == Approx(std::sqrt(255.0 * 255.0 + 9.0)));
+}
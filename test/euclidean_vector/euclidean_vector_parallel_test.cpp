@@ -0,0 +1,141 @@
+#include <catch2/catch.hpp>
+#include <comp6771/euclidean_vector.hpp>
+#include <comp6771/euclidean_vector_view.hpp>
+#include <comp6771/parallel.hpp>
+#include <comp6771/thread_pool.hpp>
+#include <atomic>
+#include <cstddef>
+#include <execution>
+#include <vector>
+
+/*
+This file is to test the parallel overloads and the thread pool behind them.
+It assumes the serial operators and utility functions are correctly implemented.
+
+Approach:
+    - Lower the parallel threshold so that small vectors are split across threads
+    - Use odd dimensions so the last chunk is partial, and fewer dimensions than threads so some
+      chunks are empty
+    - Compare every parallel result against the serial one
+*/
+
+namespace {
+	// Splits everything with at least one dimension while in scope.
+	class threshold_override {
+	public:
+		threshold_override()
+		: previous_{comp6771::parallel_threshold()} {
+			comp6771::set_parallel_threshold(1);
+		}
+		threshold_override(threshold_override const&) = delete;
+		threshold_override(threshold_override&&) = delete;
+		auto operator=(threshold_override const&) -> threshold_override& = delete;
+		auto operator=(threshold_override&&) -> threshold_override& = delete;
+		~threshold_override() {
+			comp6771::set_parallel_threshold(previous_);
+		}
+
+	private:
+		std::size_t previous_;
+	};
+
+	auto make_vector(int dimensions, double scale) -> comp6771::euclidean_vector {
+		auto magnitudes = std::vector<double>(static_cast<std::size_t>(dimensions));
+		for (auto i = std::size_t{0}; i < magnitudes.size(); ++i) {
+			magnitudes[i] = scale * static_cast<double>(i % 17) - 8.0;
+		}
+		return comp6771::euclidean_vector(magnitudes.cbegin(), magnitudes.cend());
+	}
+} // namespace
+
+/*
+Rationale:
+    Every chunk runs exactly once, on the workers and the caller, and the pool can be reused.
+*/
+TEST_CASE("Thread pool") {
+	auto pool = comp6771::thread_pool(4);
+	CHECK(pool.size() == 4);
+	CHECK(comp6771::thread_pool(0).size() == 1);
+	CHECK(comp6771::thread_pool::shared().size() >= 1);
+
+	for (auto const chunks : {std::size_t{0}, std::size_t{1}, std::size_t{3}, std::size_t{100}}) {
+		auto counts = std::vector<std::atomic<int>>(chunks);
+		pool.run(chunks, [&](std::size_t chunk) { ++counts[chunk]; });
+		for (auto const& count : counts) {
+			CHECK(count == 1);
+		}
+	}
+}
+
+/*
+Rationale:
+    The parallel utility functions agree with the serial ones for every kind of policy.
+*/
+TEST_CASE("Parallel utility functions") {
+	auto const override = threshold_override();
+	auto pool = comp6771::thread_pool(4);
+	auto const dimensions = GENERATE(0, 3, 1001, 100'003);
+	auto const a = make_vector(dimensions, 0.5);
+	auto const b = make_vector(dimensions, -1.25);
+
+	auto const expected_dot = comp6771::dot(a, b);
+	CHECK(comp6771::dot(pool, a, b) == Approx(expected_dot));
+	CHECK(comp6771::dot(std::execution::par, a, b) == Approx(expected_dot));
+	CHECK(comp6771::dot(std::execution::par_unseq, a, b) == Approx(expected_dot));
+	CHECK(comp6771::dot(std::execution::seq, a, b) == expected_dot);
+
+	auto const expected_norm = comp6771::euclidean_norm(make_vector(dimensions, 0.5));
+	CHECK(comp6771::euclidean_norm(pool, a) == Approx(expected_norm));
+	CHECK(comp6771::euclidean_norm(pool, comp6771::const_euclidean_vector_view(a))
+	      == Approx(expected_norm));
+
+	if (dimensions > 0) {
+		CHECK(comp6771::unit(pool, a) == comp6771::unit(a));
+	}
+
+	SECTION("Mismatched dimensions") {
+		CHECK_THROWS_MATCHES(comp6771::dot(pool, a, comp6771::euclidean_vector(dimensions + 1)),
+		                     comp6771::euclidean_vector_error,
+		                     Catch::Matchers::Message(
+		                        "Dimensions of LHS(" + std::to_string(dimensions) + ") and RHS("
+		                        + std::to_string(dimensions + 1) + ") do not match"));
+	}
+}
+
+/*
+Rationale:
+    The parallel compound operators agree with the serial ones, for owning vectors and views, and
+    drop a cached norm like the operators do.
+*/
+TEST_CASE("Parallel compound operators") {
+	auto const override = threshold_override();
+	auto pool = comp6771::thread_pool(3);
+	auto const dimensions = GENERATE(5, 4099);
+	auto const a = make_vector(dimensions, 0.5);
+	auto const b = make_vector(dimensions, -1.25);
+
+	auto v = a;
+	CHECK(comp6771::euclidean_norm(v) == Approx(comp6771::euclidean_norm(a)));
+	comp6771::add_assign(pool, v, b);
+	CHECK(comp6771::euclidean_norm(v) == Approx(comp6771::euclidean_norm(a + b)));
+	comp6771::multiply_assign(std::execution::par, v, 2.5);
+	comp6771::subtract_assign(pool, v, a);
+	comp6771::divide_assign(pool, v, 4);
+	CHECK(v == comp6771::euclidean_vector(((a + b) * 2.5 - a) / 4));
+
+	SECTION("Through a view") {
+		auto magnitudes = static_cast<std::vector<double>>(a);
+		comp6771::add_assign(pool, comp6771::euclidean_vector_view(magnitudes), b);
+		CHECK(comp6771::euclidean_vector(magnitudes.cbegin(), magnitudes.cend()) == a + b);
+	}
+
+	SECTION("Errors") {
+		CHECK_THROWS_MATCHES(comp6771::divide_assign(pool, v, 0),
+		                     comp6771::euclidean_vector_error,
+		                     Catch::Matchers::Message("Invalid vector division by 0"));
+		CHECK_THROWS_MATCHES(comp6771::unit(pool, comp6771::euclidean_vector(dimensions)),
+		                     comp6771::euclidean_vector_error,
+		                     Catch::Matchers::Message("euclidean_vector with zero euclidean "
+		                                              "normal does not have a unit vector"));
+	}
+}
@@ -0,0 +1,207 @@
+#include "euclidean_vector_test.hpp"
+
+#include <catch2/catch.hpp>
+#include <comp6771/euclidean_vector.hpp>
+#include <comp6771/euclidean_vector_batch.hpp>
+#include <comp6771/kernels.hpp>
+#include <comp6771/knn.hpp>
+#include <comp6771/product_quantiser.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/*
+This file is to test product_quantiser.
+It assumes euclidean_vector, euclidean_vector_batch, the kernels and knn_search are correctly
+implemented.
+
+Approach:
+    - Train on data with as many distinct vectors as centroids, which must be encoded exactly
+    - Check that the distance to a code is the distance to the vector it decodes to
+    - Check that fast scans of packed codes find exactly what plain scans do, on every
+      instruction set
+*/
+
+using comp6771::tests::clustered_vectors;
+
+namespace {
+	auto code(std::vector<std::uint8_t> const& codes, int size, int row)
+	   -> std::span<std::uint8_t const> {
+		return std::span<std::uint8_t const>(codes).subspan(static_cast<std::size_t>(row * size),
+		                                                    static_cast<std::size_t>(size));
+	}
+} // namespace
+
+/*
+Rationale:
+    With no more distinct vectors than centroids, k-means puts a centroid on every one, so every
+    vector decodes to itself. Codes are one byte per subspace, or one per two with 4-bit codes.
+*/
+TEST_CASE("PQ encoding and decoding") {
+	auto const distinct = clustered_vectors(16, 8, 1);
+	auto dataset = std::vector<comp6771::euclidean_vector>();
+	for (auto copy = 0; copy < 4; ++copy) {
+		dataset.insert(dataset.end(), distinct.begin(), distinct.end());
+	}
+
+	auto const quantiser =
+	   comp6771::product_quantiser(dataset, 4, comp6771::metric::l2, {.bits = 4});
+	CHECK(quantiser.trained());
+	CHECK(quantiser.code_size() == 2);
+	CHECK(quantiser.dimensions() == 8);
+	CHECK(quantiser.subspaces() == 4);
+	CHECK(quantiser.centroid(3, 15).dimensions() == 2);
+	auto const codes = quantiser.encode(dataset);
+	REQUIRE(codes.size() == 128);
+	for (auto row = 0; row < 64; ++row) {
+		auto const& vec = dataset[static_cast<std::size_t>(row)];
+		CHECK(quantiser.decode(code(codes, 2, row)) == vec);
+		CHECK(quantiser.encode(vec) == std::vector<std::uint8_t>(codes.begin() + 2 * row,
+		                                                         codes.begin() + 2 * row + 2));
+	}
+
+	auto const wide = comp6771::product_quantiser(clustered_vectors(1000, 8, 2), 8);
+	CHECK(wide.code_size() == 8);
+	CHECK(wide.parameters().bits == 8);
+	auto const vec = clustered_vectors(1, 8, 3).front();
+	auto const decoded = wide.decode(wide.encode(vec));
+	CHECK(comp6771::euclidean_norm(decoded - vec) < 0.5 * comp6771::euclidean_norm(vec));
+}
+
+/*
+Rationale:
+    The distance to a code, found through the lookup tables, must be the distance to the vector
+    it decodes to. Searching codes should still find most of the exact neighbours.
+*/
+TEST_CASE("PQ asymmetric distances") {
+	auto const dataset = clustered_vectors(2000, 16, 4);
+	auto const queries = clustered_vectors(20, 16, 5);
+	for (auto const measure : {comp6771::metric::l2, comp6771::metric::inner_product}) {
+		auto const quantiser = comp6771::product_quantiser(dataset, 8, measure);
+		CHECK(quantiser.measure() == measure);
+		auto const codes = quantiser.encode(dataset);
+		auto decoded = std::vector<comp6771::euclidean_vector>();
+		for (auto row = 0; row < 2000; ++row) {
+			decoded.push_back(quantiser.decode(code(codes, 8, row)));
+		}
+
+		auto const exact = comp6771::knn_search(queries, dataset, 10, measure);
+		auto const to_decoded = comp6771::knn_search(queries, decoded, 10, measure);
+		auto hits = 0;
+		for (auto query = std::size_t{0}; query < queries.size(); ++query) {
+			auto const found = quantiser.search(queries[query], codes, 10);
+			REQUIRE(found.size() == 10);
+			for (auto i = std::size_t{0}; i < 10; ++i) {
+				CHECK(found[i].distance == Approx(to_decoded[query][i].distance).margin(1e-9));
+				for (auto const& expected : exact[query]) {
+					hits += found[i].index == expected.index ? 1 : 0;
+				}
+			}
+		}
+		CHECK(hits > 100);
+	}
+}
+
+/*
+Rationale:
+    A fast scan only skips codes its quantised tables prove cannot be among the k nearest, so it
+    must find exactly what a plain scan of the same codes does, on every instruction set and for
+    sizes that leave a partial block.
+*/
+TEST_CASE("PQ fast scan") {
+	auto const original = comp6771::kernels::active_isa();
+	using comp6771::kernels::isa;
+	auto const dataset = clustered_vectors(1000, 18, 6);
+	auto const queries = clustered_vectors(10, 18, 7);
+
+	for (auto const measure : {comp6771::metric::l2, comp6771::metric::inner_product}) {
+		// An odd number of subspaces leaves the last one unpaired.
+		auto const quantiser = comp6771::product_quantiser(dataset, 9, measure, {.bits = 4});
+		auto const codes = quantiser.encode(dataset);
+		REQUIRE(quantiser.code_size() == 5);
+		for (auto const rows : {1, 31, 32, 1000}) {
+			auto const some =
+			   std::span<std::uint8_t const>(codes).first(static_cast<std::size_t>(5 * rows));
+			auto const packed = quantiser.pack(some);
+			CHECK(packed.size() == rows);
+			for (auto const level : {isa::portable, isa::sse2, isa::avx2, isa::avx512}) {
+				if (not comp6771::kernels::supported(level)) {
+					continue;
+				}
+				comp6771::kernels::use_isa(level);
+				for (auto const& query : queries) {
+					for (auto const k : {1, 10, 40}) {
+						CHECK(quantiser.search(query, packed, k) == quantiser.search(query, some, k));
+					}
+				}
+			}
+		}
+	}
+
+	comp6771::kernels::use_isa(original);
+}
+
+/*
+Rationale:
+    Untrained quantisers cannot encode, training needs enough vectors, and invalid parameters,
+    dimensions, codes and k are errors. Every element type can be quantised.
+*/
+TEST_CASE("PQ edge cases") {
+	auto quantiser = comp6771::product_quantiser(4, 2, comp6771::metric::l2, {.bits = 4});
+	CHECK(not quantiser.trained());
+	CHECK_THROWS_MATCHES(quantiser.encode(comp6771::euclidean_vector{1, 2, 3, 4}),
+	                     comp6771::euclidean_vector_error,
+	                     Catch::Matchers::Message("product_quantiser is not trained"));
+	CHECK_THROWS_MATCHES(quantiser.train(clustered_vectors(15, 4, 8)),
+	                     comp6771::euclidean_vector_error,
+	                     Catch::Matchers::Message("Cannot train a product_quantiser on fewer "
+	                                              "vectors than centroids"));
+	quantiser.train(clustered_vectors(100, 4, 8));
+	auto const codes = quantiser.encode(clustered_vectors(3, 4, 9));
+	CHECK(quantiser.search(comp6771::euclidean_vector(4), codes, 0).empty());
+	CHECK(quantiser.search(comp6771::euclidean_vector(4), codes, 5).size() == 3);
+
+	CHECK_THROWS_MATCHES(quantiser.encode(comp6771::euclidean_vector{1, 2, 3}),
+	                     comp6771::euclidean_vector_error,
+	                     Catch::Matchers::Message("Dimensions of LHS(4) and RHS(3) do not match"));
+	CHECK_THROWS_MATCHES(quantiser.decode(codes),
+	                     comp6771::euclidean_vector_error,
+	                     Catch::Matchers::Message("Codes do not match the code size of this "
+	                                              "product_quantiser"));
+	CHECK_THROWS_MATCHES(quantiser.search(comp6771::euclidean_vector(4), codes, -1),
+	                     comp6771::euclidean_vector_error,
+	                     Catch::Matchers::Message("Cannot search for a negative number of "
+	                                              "neighbours"));
+	CHECK_THROWS_MATCHES(quantiser.centroid(2, 0),
+	                     comp6771::euclidean_vector_error,
+	                     Catch::Matchers::Message("Centroid is not valid for this "
+	                                              "product_quantiser object"));
+	CHECK_THROWS_MATCHES(comp6771::product_quantiser(4, 3),
+	                     comp6771::euclidean_vector_error,
+	                     Catch::Matchers::Message("product_quantiser parameters are not valid"));
+	CHECK_THROWS_AS(comp6771::product_quantiser(4, 2, comp6771::metric::l2, {.bits = 6}),
+	                comp6771::euclidean_vector_error);
+	CHECK_THROWS_MATCHES(comp6771::product_quantiser(4, 2, comp6771::metric::cosine),
+	                     comp6771::euclidean_vector_error,
+	                     Catch::Matchers::Message("product_quantiser cannot measure cosine "
+	                                              "distances"));
+
+	auto const wide = comp6771::product_quantiser(clustered_vectors(300, 4, 10), 2);
+	CHECK_THROWS_MATCHES(wide.pack(wide.encode(clustered_vectors(3, 4, 11))),
+	                     comp6771::euclidean_vector_error,
+	                     Catch::Matchers::Message("Only 4-bit codes can be packed for fast scans"));
+
+	auto quantised_data = std::vector<comp6771::basic_euclidean_vector<std::int8_t>>();
+	for (auto i = 0; i < 16; ++i) {
+		quantised_data.push_back({static_cast<std::int8_t>(i), static_cast<std::int8_t>(-i)});
+	}
+	auto const quantised = comp6771::basic_product_quantiser<std::int8_t>(quantised_data,
+	                                                                      1,
+	                                                                      comp6771::metric::l2,
+	                                                                      {.bits = 4});
+	auto const quantised_codes = quantised.encode(quantised_data);
+	CHECK(quantised.decode(code(quantised_codes, 1, 5)) == quantised_data[5]);
+	CHECK(quantised.search(quantised_data[7], quantised.pack(quantised_codes), 1)
+	      == std::vector<comp6771::neighbour>{{7, 0.0}});
+}
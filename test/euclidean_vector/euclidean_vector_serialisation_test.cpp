@@ -0,0 +1,232 @@
+#include <array>
+#include <catch2/catch.hpp>
+#include <comp6771/euclidean_vector.hpp>
+#include <comp6771/euclidean_vector_view.hpp>
+#include <comp6771/serialisation.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <span>
+#include <sstream>
+#include <string>
+#include <system_error>
+#include <unistd.h>
+#include <vector>
+
+/*
+This file is to test the binary serialisation of euclidean vectors.
+It assumes euclidean_vector and euclidean_vector_view are correctly implemented.
+
+Approach:
+    - Write vectors to streams, file descriptors and buffers
+    - Read them back, and view them in place
+    - Check the bytes of the header, and that damaged records are rejected
+*/
+
+namespace {
+	auto as_bytes(std::string const& text) -> std::span<std::byte const> {
+		return std::as_bytes(std::span(text));
+	}
+
+	// An 8-byte aligned buffer holding a copy of `text`
+	auto aligned_copy(std::string const& text) -> std::vector<double> {
+		auto buffer = std::vector<double>((text.size() + 7) / 8);
+		std::copy(text.begin(), text.end(), reinterpret_cast<char*>(buffer.data()));
+		return buffer;
+	}
+} // namespace
+
+/*
+Rationale:
+    The header is part of the format, so its bytes are checked directly. Payloads are
+    little-endian and padded so that the next record starts on an 8-byte boundary.
+*/
+TEST_CASE("Binary header layout") {
+	auto const ev = comp6771::basic_euclidean_vector<float>{1.0F, -2.0F, 0.5F};
+	auto oss = std::ostringstream();
+	comp6771::write_binary(oss, ev, comp6771::checksum::crc32c);
+	auto const text = oss.str();
+
+	REQUIRE(text.size() == comp6771::binary_size<float>(3));
+	CHECK(text.size() == 16 + 16);
+	CHECK(text.substr(0, 4) == "EVEC");
+	CHECK(text[4] == 1);
+	CHECK(text[5] == static_cast<char>(comp6771::element_type::float32));
+	CHECK(text[6] == 0);
+	CHECK(text[7] == static_cast<char>(comp6771::checksum::crc32c));
+	CHECK(text.substr(8, 4) == std::string("\x03\x00\x00\x00", 4));
+	CHECK(text.substr(28, 4) == std::string(4, '\0'));
+
+	auto const header = comp6771::read_binary_header(as_bytes(text));
+	CHECK(header.dimensions == 3);
+	CHECK(header.type == comp6771::element_type::float32);
+	CHECK(header.payload_size() == 12);
+	CHECK(header.record_size() == 32);
+
+	SECTION("CRC-32C of the payload") {
+		// The standard check value for CRC-32C
+		auto const digits = std::string("123456789");
+		CHECK(comp6771::detail::crc32c(as_bytes(digits)) == 0xE3069283);
+		auto const first = comp6771::detail::crc32c(as_bytes(digits.substr(0, 4)));
+		CHECK(comp6771::detail::crc32c(as_bytes(digits.substr(4)), first) == 0xE3069283);
+		CHECK(header.payload_checksum == comp6771::detail::crc32c(as_bytes(text.substr(16, 12))));
+	}
+}
+
+/*
+Rationale:
+    Every writer produces the same bytes and every reader gets back exactly the magnitudes that
+    were written, for each element type, unlike the 6 significant digits of operator<<.
+*/
+TEST_CASE("Binary round trips") {
+	auto const ev = comp6771::euclidean_vector{0.1, -1e-300, 123456.789012345, 0};
+	auto oss = std::ostringstream();
+	comp6771::write_binary(oss, ev);
+	auto const text = oss.str();
+
+	SECTION("Streams") {
+		auto iss = std::istringstream(text + text);
+		CHECK(comp6771::exact_equal(comp6771::read_binary<double>(iss), ev));
+		CHECK(comp6771::exact_equal(comp6771::read_binary<double>(iss), ev));
+		CHECK_THROWS_MATCHES(comp6771::read_binary<double>(iss),
+		                     comp6771::euclidean_vector_error,
+		                     Catch::Matchers::Message("Binary euclidean_vector is truncated"));
+	}
+
+	SECTION("Buffers") {
+		auto buffer = std::vector<std::byte>(comp6771::binary_size<double>(4));
+		CHECK(comp6771::write_binary(std::span(buffer), ev) == buffer.size());
+		CHECK(std::equal(buffer.begin(), buffer.end(), as_bytes(text).begin()));
+		CHECK(comp6771::exact_equal(comp6771::read_binary<double>(std::span<std::byte const>(buffer)),
+		                            ev));
+		CHECK_THROWS_MATCHES(comp6771::write_binary(std::span(buffer).first(40), ev),
+		                     comp6771::euclidean_vector_error,
+		                     Catch::Matchers::Message("Buffer is too small for a binary "
+		                                              "euclidean_vector"));
+	}
+
+	SECTION("File descriptors") {
+		auto* const file = std::tmpfile();
+		REQUIRE(file != nullptr);
+		auto const fd = fileno(file);
+		comp6771::write_binary(fd, ev, comp6771::checksum::crc32c);
+		comp6771::write_binary(fd, comp6771::basic_euclidean_vector<std::int8_t>{-128, 5, 127});
+		REQUIRE(::lseek(fd, 0, SEEK_SET) == 0);
+		CHECK(comp6771::exact_equal(comp6771::read_binary<double>(fd), ev));
+		CHECK(comp6771::exact_equal(comp6771::read_binary<std::int8_t>(fd),
+		                            comp6771::basic_euclidean_vector<std::int8_t>{-128, 5, 127}));
+		CHECK_THROWS_AS(comp6771::read_binary<double>(fd), comp6771::euclidean_vector_error);
+		std::fclose(file);
+		CHECK_THROWS_AS(comp6771::write_binary(fd, ev), std::system_error);
+	}
+
+	SECTION("Other element types") {
+		auto const q = comp6771::basic_euclidean_vector<std::int16_t>{-32768, 1, 32767};
+		auto q_stream = std::stringstream();
+		comp6771::write_binary(q_stream, q, comp6771::checksum::crc32c);
+		CHECK(q_stream.str().size() == 24);
+		CHECK(comp6771::exact_equal(comp6771::read_binary<std::int16_t>(q_stream), q));
+
+		auto const empty = comp6771::basic_euclidean_vector<float>(0);
+		auto empty_stream = std::stringstream();
+		comp6771::write_binary(empty_stream, empty);
+		CHECK(comp6771::read_binary<float>(empty_stream).dimensions() == 0);
+	}
+}
+
+/*
+Rationale:
+    view_binary() reads the magnitudes in place, so it must refuse anything it cannot view
+    safely, and every reader rejects damaged or mismatched records. A header claiming more
+    magnitudes than the source holds is truncated, whether or not the source's size is known.
+*/
+TEST_CASE("Binary views and damaged records") {
+	auto const ev = comp6771::euclidean_vector{1.5, -2.5, 3.5};
+	auto oss = std::ostringstream();
+	comp6771::write_binary(oss, ev, comp6771::checksum::crc32c);
+	comp6771::write_binary(oss, comp6771::euclidean_vector(ev * 2), comp6771::checksum::crc32c);
+	auto const text = oss.str();
+
+	SECTION("Views of records in a buffer") {
+		auto const buffer = aligned_copy(text);
+		auto const bytes = std::as_bytes(std::span(buffer));
+		auto const first = comp6771::view_binary<double>(bytes);
+		CHECK(first.data() == buffer.data() + 2);
+		CHECK(first == ev);
+		auto const size = comp6771::read_binary_header(bytes).record_size();
+		CHECK(comp6771::view_binary<double>(bytes.subspan(size)) == ev * 2);
+	}
+
+	SECTION("Misaligned") {
+		auto const buffer = aligned_copy(" " + text);
+		auto const bytes = std::as_bytes(std::span(buffer)).subspan(1);
+		CHECK_THROWS_MATCHES(comp6771::view_binary<double>(bytes),
+		                     comp6771::euclidean_vector_error,
+		                     Catch::Matchers::Message("Binary euclidean_vector is not aligned for a "
+		                                              "view"));
+		CHECK(comp6771::read_binary<double>(bytes) == ev);
+	}
+
+	SECTION("Damaged") {
+		auto corrupt = text;
+		corrupt[20] = static_cast<char>(corrupt[20] ^ 1);
+		CHECK_THROWS_MATCHES(comp6771::read_binary<double>(as_bytes(corrupt)),
+		                     comp6771::euclidean_vector_error,
+		                     Catch::Matchers::Message("Binary euclidean_vector checksum does not "
+		                                              "match"));
+		auto const buffer = aligned_copy(corrupt);
+		auto const bytes = std::as_bytes(std::span(buffer));
+		CHECK_THROWS_AS(comp6771::view_binary<double>(bytes), comp6771::euclidean_vector_error);
+		auto const unchecked = comp6771::view_binary<double>(bytes, comp6771::checksum::none);
+		CHECK(not comp6771::exact_equal(unchecked, ev));
+
+		CHECK_THROWS_MATCHES(comp6771::read_binary<double>(as_bytes(text.substr(0, 30))),
+		                     comp6771::euclidean_vector_error,
+		                     Catch::Matchers::Message("Binary euclidean_vector is truncated"));
+		auto huge = text.substr(0, 32);
+		huge.replace(8, 4, "\xFF\xFF\xFF\x7F");
+		CHECK_THROWS_MATCHES(comp6771::read_binary<double>(as_bytes(huge)),
+		                     comp6771::euclidean_vector_error,
+		                     Catch::Matchers::Message("Binary euclidean_vector is truncated"));
+		auto huge_stream = std::istringstream(huge);
+		CHECK_THROWS_MATCHES(comp6771::read_binary<double>(huge_stream),
+		                     comp6771::euclidean_vector_error,
+		                     Catch::Matchers::Message("Binary euclidean_vector is truncated"));
+		auto pipe = std::array<int, 2>();
+		REQUIRE(::pipe(pipe.data()) == 0);
+		REQUIRE(::write(pipe[1], huge.data(), huge.size()) == static_cast<ssize_t>(huge.size()));
+		::close(pipe[1]);
+		CHECK_THROWS_MATCHES(comp6771::read_binary<double>(pipe[0]),
+		                     comp6771::euclidean_vector_error,
+		                     Catch::Matchers::Message("Binary euclidean_vector is truncated"));
+		::close(pipe[0]);
+
+		CHECK_THROWS_MATCHES(comp6771::read_binary<double>(as_bytes("EVEX" + text.substr(4))),
+		                     comp6771::euclidean_vector_error,
+		                     Catch::Matchers::Message("Binary euclidean_vector header is not "
+		                                              "valid"));
+		auto future = text;
+		future[4] = 2;
+		CHECK_THROWS_MATCHES(comp6771::read_binary<double>(as_bytes(future)),
+		                     comp6771::euclidean_vector_error,
+		                     Catch::Matchers::Message("Binary euclidean_vector version is not "
+		                                              "supported"));
+		CHECK_THROWS_MATCHES(comp6771::read_binary<float>(as_bytes(text)),
+		                     comp6771::euclidean_vector_error,
+		                     Catch::Matchers::Message("Binary euclidean_vector does not hold this "
+		                                              "element type"));
+	}
+
+	SECTION("Big-endian records") {
+		// The record a big-endian host would write for {1.5}
+		auto big = std::string("EVEC\x01\x01\x01\x00\x01\x00\x00\x00\x00\x00\x00\x00", 16);
+		big += std::string("\x3F\xF8\x00\x00\x00\x00\x00\x00", 8);
+		CHECK(comp6771::read_binary<double>(as_bytes(big)) == comp6771::euclidean_vector{1.5});
+		auto const buffer = aligned_copy(big);
+		CHECK_THROWS_MATCHES(comp6771::view_binary<double>(std::as_bytes(std::span(buffer))),
+		                     comp6771::euclidean_vector_error,
+		                     Catch::Matchers::Message("Binary euclidean_vector is not in native "
+		                                              "byte order"));
+	}
+}
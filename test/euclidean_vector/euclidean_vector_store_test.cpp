@@ -0,0 +1,173 @@
+#include <catch2/catch.hpp>
+#include <comp6771/euclidean_vector.hpp>
+#include <comp6771/euclidean_vector_store.hpp>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <system_error>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+/*
+This file is to test euclidean_vector_store and euclidean_vector_store_writer.
+It assumes euclidean_vector and euclidean_vector_view are correctly implemented.
+
+Approach:
+    - Append vectors to a new store in a temporary file, then map it
+    - Use the rows with the operators and utility functions
+    - Check appending to an existing store, and that invalid files are rejected
+*/
+
+namespace {
+	// A path in the temporary directory that is removed when it goes out of scope
+	class temporary_path {
+	public:
+		explicit temporary_path(std::string const& name)
+		: path_{std::filesystem::temp_directory_path()
+		        / (name + "." + std::to_string(::getpid()) + ".evst")} {
+			std::filesystem::remove(path_);
+		}
+
+		temporary_path(temporary_path const&) = delete;
+		temporary_path(temporary_path&&) = delete;
+		~temporary_path() {
+			auto error = std::error_code();
+			std::filesystem::remove(path_, error);
+		}
+		auto operator=(temporary_path const&) -> temporary_path& = delete;
+		auto operator=(temporary_path&&) -> temporary_path& = delete;
+
+		[[nodiscard]] auto string() const -> std::string {
+			return path_.string();
+		}
+
+	private:
+		std::filesystem::path path_;
+	};
+} // namespace
+
+/*
+Rationale:
+    Rows appended through a writer can be mapped back and used like any other vector, without
+    being copied out of the mapping. Padded rows start on cache lines. The store itself is not a
+    vector.
+*/
+TEST_CASE("Store round trip") {
+	static_assert(not comp6771::contiguous_euclidean_vector<comp6771::euclidean_vector_store>);
+	auto const path = temporary_path("store_round_trip");
+	auto const vectors = std::vector<comp6771::euclidean_vector>{{1, 2, 3}, {-4, 5, -6}, {0, 0, 1}};
+	{
+		auto writer = comp6771::euclidean_vector_store_writer(path.string(), 3);
+		for (auto const& vec : vectors) {
+			writer.append(vec);
+		}
+		CHECK(writer.rows() == 3);
+	}
+
+	auto store = comp6771::euclidean_vector_store(path.string());
+	REQUIRE(store.rows() == 3);
+	CHECK(store.dimensions() == 3);
+	CHECK(store.stride() == 3);
+	CHECK(std::filesystem::file_size(path.string()) == 64 + 9 * sizeof(double));
+	for (auto row = 0; row < store.rows(); ++row) {
+		CHECK(store[row] == vectors[static_cast<std::size_t>(row)]);
+	}
+	CHECK(store[1].data() == store.data() + 3);
+	CHECK(comp6771::dot(store[0], store[1]) == Approx(-12).margin(1e-9));
+	CHECK(comp6771::euclidean_norm(store[2]) == Approx(1).margin(1e-9));
+	CHECK(comp6771::euclidean_vector(store[0] + store[1] * 2)
+	      == comp6771::euclidean_vector{-7, 12, -9});
+	CHECK_THROWS_MATCHES(store.at(3),
+	                     comp6771::euclidean_vector_error,
+	                     Catch::Matchers::Message("Row 3 is not valid for this "
+	                                              "euclidean_vector_store object"));
+
+	SECTION("Access hints") {
+		CHECK_NOTHROW(store.advise(comp6771::euclidean_vector_store::access_pattern::sequential));
+		CHECK_NOTHROW(store.advise(comp6771::euclidean_vector_store::access_pattern::random));
+		CHECK_NOTHROW(store.advise(comp6771::euclidean_vector_store::access_pattern::will_need));
+	}
+
+	SECTION("Moving keeps the mapping") {
+		auto const moved = comp6771::euclidean_vector_store(std::move(store));
+		CHECK(moved[2] == vectors[2]);
+	}
+}
+
+/*
+Rationale:
+    Writers append to existing stores, flushing in batches, and a store only maps the rows whose
+    count has been written to the header.
+*/
+TEST_CASE("Store appending") {
+	auto const path = temporary_path("store_appending");
+	using store_type = comp6771::basic_euclidean_vector_store<float>;
+	using writer_type = comp6771::basic_euclidean_vector_store_writer<float>;
+	{
+		auto writer = writer_type(path.string(), 5, writer_type::row_padding::cache_line);
+		CHECK(writer.stride() == 16);
+		writer.append(comp6771::basic_euclidean_vector<float>(5, 1.0F));
+	}
+
+	auto writer = writer_type(path.string(), 5);
+	CHECK(writer.rows() == 1);
+	CHECK(writer.stride() == 16);
+	for (auto i = 0; i < 20'000; ++i) {
+		writer.append(comp6771::basic_euclidean_vector<float>(5, static_cast<float>(i)));
+	}
+	CHECK(store_type(path.string()).rows() < writer.rows());
+	writer.flush();
+
+	auto const store = store_type(path.string());
+	REQUIRE(store.rows() == 20'001);
+	CHECK(store[0] == comp6771::basic_euclidean_vector<float>(5, 1.0F));
+	CHECK(store[20'000] == comp6771::basic_euclidean_vector<float>(5, 19'999.0F));
+	CHECK(reinterpret_cast<std::uintptr_t>(store[7].data()) % 64 == 0);
+
+	CHECK_THROWS_MATCHES(writer.append(comp6771::basic_euclidean_vector<float>(4)),
+	                     comp6771::euclidean_vector_error,
+	                     Catch::Matchers::Message("Dimensions of LHS(5) and RHS(4) do not match"));
+	CHECK_THROWS_MATCHES(writer_type(path.string(), 6),
+	                     comp6771::euclidean_vector_error,
+	                     Catch::Matchers::Message("Dimensions of LHS(5) and RHS(6) do not match"));
+}
+
+/*
+Rationale:
+    Files that are missing, are not stores or hold another element type are rejected rather
+    than mapped. Writers never create a store with negative dimensions.
+*/
+TEST_CASE("Store errors") {
+	auto const path = temporary_path("store_errors");
+	CHECK_THROWS_AS(comp6771::euclidean_vector_store(path.string()), std::system_error);
+
+	CHECK_THROWS_MATCHES(comp6771::euclidean_vector_store_writer(path.string(), -3),
+	                     comp6771::euclidean_vector_error,
+	                     Catch::Matchers::Message("euclidean_vector cannot have negative "
+	                                              "dimensions"));
+	CHECK_FALSE(std::filesystem::exists(path.string()));
+
+	{
+		auto file = std::ofstream(path.string());
+		file << "not a euclidean_vector_store, but long enough to hold its header, honestly";
+	}
+	CHECK_THROWS_MATCHES(comp6771::euclidean_vector_store(path.string()),
+	                     comp6771::euclidean_vector_error,
+	                     Catch::Matchers::Message("File is not a euclidean_vector_store"));
+
+	std::filesystem::remove(path.string());
+	comp6771::basic_euclidean_vector_store_writer<std::int8_t>(path.string(), 2)
+	   .append(comp6771::basic_euclidean_vector<std::int8_t>{1, 2});
+	CHECK(comp6771::basic_euclidean_vector_store<std::int8_t>(path.string()).rows() == 1);
+	CHECK_THROWS_MATCHES(comp6771::euclidean_vector_store(path.string()),
+	                     comp6771::euclidean_vector_error,
+	                     Catch::Matchers::Message("euclidean_vector_store does not hold this "
+	                                              "element type"));
+
+	std::filesystem::resize_file(path.string(), 64);
+	CHECK_THROWS_MATCHES(comp6771::basic_euclidean_vector_store<std::int8_t>(path.string()),
+	                     comp6771::euclidean_vector_error,
+	                     Catch::Matchers::Message("euclidean_vector_store is truncated"));
+}
@@ -0,0 +1,79 @@
+#ifndef COMP6771_EUCLIDEAN_VECTOR_TEST_HPP
+#define COMP6771_EUCLIDEAN_VECTOR_TEST_HPP
+
+#include <comp6771/euclidean_vector.hpp>
+#include <comp6771/knn.hpp>
+#include <cstddef>
+#include <random>
+#include <vector>
+
+/*
+Shared helpers for the euclidean_vector tests.
+
+Every dataset is drawn from a seed, so that a failing test fails the same way on every run.
+*/
+namespace comp6771::tests {
+	// `rows` vectors with magnitudes drawn uniformly from [-1, 1].
+	inline auto random_vectors(int rows, int dimensions, unsigned seed)
+	   -> std::vector<euclidean_vector> {
+		auto engine = std::mt19937(seed);
+		auto distribution = std::uniform_real_distribution<double>(-1.0, 1.0);
+		auto vectors = std::vector<euclidean_vector>();
+		for (auto row = 0; row < rows; ++row) {
+			auto vec = euclidean_vector(dimensions);
+			for (auto i = 0; i < dimensions; ++i) {
+				vec[i] = distribution(engine);
+			}
+			vectors.push_back(vec);
+		}
+		return vectors;
+	}
+
+	// `rows` vectors drawn around 16 random centres, so that approximate indexes have something to
+	// find. The centres come from a fixed seed, so datasets and queries drawn with different seeds
+	// share them.
+	inline auto clustered_vectors(int rows, int dimensions, unsigned seed)
+	   -> std::vector<euclidean_vector> {
+		auto engine = std::mt19937(6771);
+		auto uniform = std::uniform_real_distribution<double>(-1.0, 1.0);
+		auto centres = std::vector<euclidean_vector>();
+		for (auto centre = 0; centre < 16; ++centre) {
+			auto vec = euclidean_vector(dimensions);
+			for (auto i = 0; i < dimensions; ++i) {
+				vec[i] = uniform(engine);
+			}
+			centres.push_back(vec);
+		}
+
+		engine.seed(seed);
+		auto pick = std::uniform_int_distribution<std::size_t>(0, centres.size() - 1);
+		auto noise = std::normal_distribution<double>(0.0, 0.2);
+		auto vectors = std::vector<euclidean_vector>();
+		for (auto row = 0; row < rows; ++row) {
+			auto vec = centres[pick(engine)];
+			for (auto i = 0; i < dimensions; ++i) {
+				vec[i] += noise(engine);
+			}
+			vectors.push_back(vec);
+		}
+		return vectors;
+	}
+
+	// Fraction of the exact neighbours of each query that an approximate search found
+	inline auto recall(std::vector<std::vector<neighbour>> const& exact,
+	                   std::vector<std::vector<neighbour>> const& found) -> double {
+		auto hits = 0;
+		auto expected = std::size_t{0};
+		for (auto query = std::size_t{0}; query < exact.size(); ++query) {
+			expected += exact[query].size();
+			for (auto const& target : exact[query]) {
+				for (auto const& result : found[query]) {
+					hits += result.index == target.index ? 1 : 0;
+				}
+			}
+		}
+		return static_cast<double>(hits) / static_cast<double>(expected);
+	}
+} // namespace comp6771::tests
+
+#endif // COMP6771_EUCLIDEAN_VECTOR_TEST_HPP
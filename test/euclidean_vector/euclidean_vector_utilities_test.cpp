@@ -34,6 +34,50 @@ TEST_CASE("Euclidean norm") {
 	}
 }
 
+/*
+Rationale:
+    The norm is cached after the first call. This test ensures every way of mutating a euclidean
+    vector drops the cached value, so the next call sees the new magnitudes.
+*/
+TEST_CASE("Euclidean norm after mutation") {
+	auto ev = comp6771::euclidean_vector{3, 4};
+	REQUIRE(comp6771::euclidean_norm(ev) == Approx(5).margin(1e-6));
+
+	SECTION("Subscript") {
+		ev[0] = 0;
+		CHECK(comp6771::euclidean_norm(ev) == Approx(4).margin(1e-6));
+	}
+
+	SECTION("at()") {
+		ev.at(1) = 0;
+		CHECK(comp6771::euclidean_norm(ev) == Approx(3).margin(1e-6));
+	}
+
+	SECTION("Compound assignment") {
+		ev *= 2;
+		CHECK(comp6771::euclidean_norm(ev) == Approx(10).margin(1e-6));
+		ev /= 4;
+		CHECK(comp6771::euclidean_norm(ev) == Approx(2.5).margin(1e-6));
+		ev += comp6771::euclidean_vector{1.5, 2};
+		CHECK(comp6771::euclidean_norm(ev) == Approx(5).margin(1e-6));
+		ev -= comp6771::euclidean_vector{3, 4};
+		CHECK(comp6771::euclidean_norm(ev) == Approx(0).margin(1e-6));
+	}
+
+	SECTION("Assignment") {
+		ev = comp6771::euclidean_vector{1, 2, 2};
+		CHECK(comp6771::euclidean_norm(ev) == Approx(3).margin(1e-6));
+		ev = ev * 2;
+		CHECK(comp6771::euclidean_norm(ev) == Approx(6).margin(1e-6));
+		auto other = comp6771::euclidean_vector{6, 8};
+		CHECK(comp6771::euclidean_norm(other) == Approx(10).margin(1e-6));
+		ev = std::move(other);
+		CHECK(comp6771::euclidean_norm(ev) == Approx(10).margin(1e-6));
+		// NOLINTNEXTLINE(bugprone-use-after-move)
+		CHECK(comp6771::euclidean_norm(other) == 0);
+	}
+}
+
 /*
 Rationale:
     This test ensures a correct unit vector of an euclidean vector is returned.
@@ -0,0 +1,147 @@
+#include <array>
+#include <catch2/catch.hpp>
+#include <comp6771/euclidean_vector.hpp>
+#include <comp6771/euclidean_vector_view.hpp>
+#include <list>
+#include <span>
+#include <sstream>
+#include <vector>
+
+/*
+This file is to test euclidean_vector_view and const_euclidean_vector_view.
+It assumes euclidean_vector itself is correctly implemented.
+
+Approach:
+    - Create views over memory owned elsewhere
+    - Use them with the operators and utility functions
+    - Check the results, and that the viewed memory is read or written in place
+*/
+
+/*
+Rationale:
+    Views can be made over any contiguous memory without copying it.
+*/
+TEST_CASE("View construction") {
+	SECTION("Over a std::vector") {
+		auto magnitudes = std::vector<double>{1.5, -2.5, 3.0};
+		auto const view = comp6771::euclidean_vector_view(magnitudes);
+		CHECK(view.dimensions() == 3);
+		CHECK(view.data() == magnitudes.data());
+	}
+
+	SECTION("Over a const std::array") {
+		auto const magnitudes = std::array<double, 2>{3, 4};
+		auto const view = comp6771::const_euclidean_vector_view(magnitudes);
+		CHECK(view.data() == magnitudes.data());
+		CHECK(comp6771::euclidean_norm(view) == Approx(5).margin(1e-6));
+	}
+
+	SECTION("Over a raw buffer and a span") {
+		double buffer[] = {1, 2, 3, 4}; // NOLINT(modernize-avoid-c-arrays)
+		auto const from_pointer = comp6771::euclidean_vector_view(buffer, 3);
+		auto const from_span = comp6771::const_euclidean_vector_view(std::span<double const>(buffer));
+		CHECK(from_pointer.dimensions() == 3);
+		CHECK(from_span.dimensions() == 4);
+		CHECK(from_pointer.data() == from_span.data());
+	}
+
+	SECTION("Over a euclidean vector") {
+		auto ev = comp6771::euclidean_vector{1, 2};
+		auto const& const_ev = ev;
+		auto const view = comp6771::basic_euclidean_vector_view(ev);
+		auto const const_view = comp6771::basic_euclidean_vector_view(const_ev);
+		CHECK(view.data() == ev.data());
+		CHECK(const_view.data() == ev.data());
+		CHECK(static_cast<std::vector<double>>(const_view) == std::vector<double>{1, 2});
+		CHECK(static_cast<std::list<double>>(const_view) == std::list<double>{1, 2});
+	}
+
+	SECTION("Empty view") {
+		auto const view = comp6771::const_euclidean_vector_view();
+		CHECK(view.dimensions() == 0);
+		CHECK(comp6771::euclidean_norm(view) == 0);
+	}
+}
+
+/*
+Rationale:
+    Views work with every operator and utility function, mixed freely with euclidean vectors,
+    and give the same results as the equivalent euclidean vectors.
+*/
+TEST_CASE("Views with operators and utility functions") {
+	auto const lhs = std::vector<double>{1, 2, 2};
+	auto const rhs = std::vector<double>{3, 4, 0};
+	auto const x = comp6771::const_euclidean_vector_view(lhs);
+	auto const y = comp6771::const_euclidean_vector_view(rhs);
+	auto const ev = comp6771::euclidean_vector{1, 1, 1};
+
+	SECTION("Arithmetic") {
+		auto const result = comp6771::euclidean_vector(x * 2 - y / 2 + ev);
+		CHECK(result == comp6771::euclidean_vector{1.5, 3, 5});
+		CHECK(comp6771::euclidean_vector(-x) == comp6771::euclidean_vector{-1, -2, -2});
+	}
+
+	SECTION("Comparison and output") {
+		CHECK(x == comp6771::euclidean_vector{1, 2, 2});
+		CHECK(x != y);
+		auto oss = std::ostringstream{};
+		oss << y;
+		CHECK(oss.str() == "[3 4 0]");
+	}
+
+	SECTION("Utility functions") {
+		CHECK(comp6771::euclidean_norm(x) == Approx(3).margin(1e-6));
+		CHECK(comp6771::dot(x, y) == Approx(11).margin(1e-6));
+		CHECK(comp6771::dot(ev, y) == Approx(7).margin(1e-6));
+		CHECK(comp6771::euclidean_inner_product(x, ev) == Approx(5).margin(1e-6));
+		CHECK(comp6771::unit(y) == comp6771::euclidean_vector{0.6, 0.8, 0});
+	}
+
+	SECTION("Exceptions") {
+		auto const shorter = std::vector<double>{1, 2};
+		CHECK_THROWS_MATCHES(comp6771::dot(x, comp6771::const_euclidean_vector_view(shorter)),
+		                     comp6771::euclidean_vector_error,
+		                     Catch::Matchers::Message("Dimensions of LHS(3) and RHS(2) do not "
+		                                              "match"));
+		CHECK_THROWS_MATCHES(x.at(3),
+		                     comp6771::euclidean_vector_error,
+		                     Catch::Matchers::Message("Index 3 is not valid for this "
+		                                              "euclidean_vector_view object"));
+		CHECK_THROWS_MATCHES(comp6771::unit(comp6771::const_euclidean_vector_view()),
+		                     comp6771::euclidean_vector_error,
+		                     Catch::Matchers::Message("euclidean_vector with no dimensions does not "
+		                                              "have a unit vector"));
+	}
+}
+
+/*
+Rationale:
+    Writing through a mutable view changes the viewed memory in place, and a euclidean vector
+    viewed mutably reports its new norm afterwards.
+*/
+TEST_CASE("Writing through views") {
+	auto magnitudes = std::vector<double>{1, 2, 3};
+	auto const view = comp6771::euclidean_vector_view(magnitudes);
+
+	SECTION("Compound assignment") {
+		view += comp6771::euclidean_vector{1, 1, 1};
+		view *= 2;
+		view -= comp6771::euclidean_vector{1, 1, 1} * 2;
+		view /= 4;
+		CHECK(magnitudes == std::vector<double>{0.5, 1, 1.5});
+	}
+
+	SECTION("Element access and assign") {
+		view[0] = 5;
+		view.at(1) = 6;
+		view.assign(view * 2);
+		CHECK(magnitudes == std::vector<double>{10, 12, 6});
+	}
+
+	SECTION("Viewing a euclidean vector") {
+		auto ev = comp6771::euclidean_vector{3, 4};
+		CHECK(comp6771::euclidean_norm(ev) == Approx(5).margin(1e-6));
+		comp6771::euclidean_vector_view(ev) *= 2;
+		CHECK(comp6771::euclidean_norm(ev) == Approx(10).margin(1e-6));
+	}
+}